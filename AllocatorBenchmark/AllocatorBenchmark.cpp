@@ -0,0 +1,913 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+
+/**
+ * Allocator benchmark, runs the same allocation traces on all AzCore allocators (the SystemAllocator with and
+ * without its thread cache) and reports throughput, p99 latency, RSS and fragmentation for 1 to N threads.
+ *
+ * Usage: AllocatorBenchmark [--threads N] [--ops N] [--allocator name] [--workload name] [--trace file]
+ *  --threads   maximum number of threads, we run 1, 2, 4 ... N (default hardware concurrency)
+ *  --ops       operations per thread (default 200000)
+ *  --allocator only run allocators whose name contains this string
+ *  --workload  only run this workload (churn, producer-consumer, mixed, realloc, replay)
+ *  --trace     trace file for the replay workload, one operation per line:
+ *                  a <id> <size> <alignment>   allocate
+ *                  r <id> <newSize>            reallocate
+ *                  f <id>                      free
+ *              Every thread replays the whole trace with its own set of ids.
+ *
+ * Build and run it on Linux with the Makefile next to this file, e.g.
+ *  make -C AllocatorBenchmark run ARGS="--threads 8"
+ */
+
+#include <AzCore/Memory/SystemAllocator.h>
+#include <AzCore/Memory/PoolAllocator.h>
+#include <AzCore/Memory/HeapSchema.h>
+#include <AzCore/Memory/OSAllocator.h>
+#include <AzCore/Memory/BestFitExternalMapAllocator.h>
+#include <AzCore/std/parallel/thread.h>
+#include <AzCore/std/parallel/atomic.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/sort.h>
+#include <AzCore/std/time.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(AZ_PLATFORM_LINUX)
+#   include <unistd.h>
+#endif
+
+namespace AllocatorBenchmark
+{
+    using namespace AZ;
+
+    static const unsigned int MaxThreads = 64;
+    static const unsigned int LatencySampleMask = 7;   ///< Time one of every 8 operations.
+
+    struct Options
+    {
+        Options()
+            : m_maxThreads(AZStd::GetMax(AZStd::thread::hardware_concurrency(), 1u))
+            , m_opsPerThread(200000)
+            , m_allocatorFilter(nullptr)
+            , m_workloadFilter(nullptr)
+            , m_traceFile(nullptr)
+        {}
+
+        unsigned int    m_maxThreads;
+        unsigned int    m_opsPerThread;
+        const char*     m_allocatorFilter;
+        const char*     m_workloadFilter;
+        const char*     m_traceFile;
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    // Allocators
+
+    /// SystemAllocator instance running on a HeapSchema (dlmalloc) instead of the HPHA.
+    class HeapSystemAllocator
+        : public SystemAllocator
+    {
+    public:
+        AZ_TYPE_INFO(HeapSystemAllocator, "{3F0C5D0E-7B7A-4E54-9C5B-51A2B8E0D6C4}")
+        const char* GetName() const override { return "SystemAllocator(Heap)"; }
+    };
+
+    /// SystemAllocator instance running on its own HPHA with the per thread cache in front of the pools.
+    class ThreadCacheSystemAllocator
+        : public SystemAllocator
+    {
+    public:
+        AZ_TYPE_INFO(ThreadCacheSystemAllocator, "{8B1D2F4A-6C3E-4A9B-B7D5-2E0F9C81A4D3}")
+        const char* GetName() const override { return "SystemAllocator(HPHA+thread cache)"; }
+    };
+
+    struct Target
+    {
+        const char*         m_name;
+        bool                m_isThreadSafe;         ///< Can be used from many threads (and free from any thread).
+        bool                m_isReAllocate;         ///< Supports ReAllocate, otherwise we allocate, copy and free.
+        bool                (*m_create)(Target& target);
+        void                (*m_destroy)(Target& target);
+        IAllocatorAllocate* m_allocator;            ///< Valid between create and destroy.
+        size_t              m_maxAllocationSize;    ///< Set by create, workloads with bigger allocations are skipped.
+        void*               m_memoryBlock;
+        size_t              m_memoryBlockSize;
+        HeapSchema*         m_heapSchema;
+    };
+
+    static bool CreatePool(Target& target)
+    {
+        AllocatorInstance<PoolAllocator>::Create();
+        target.m_allocator = &AllocatorInstance<PoolAllocator>::Get();
+        target.m_maxAllocationSize = target.m_allocator->GetMaxAllocationSize();
+        return true;
+    }
+    static void DestroyPool(Target&)
+    {
+        AllocatorInstance<PoolAllocator>::Destroy();
+    }
+
+    static bool CreateThreadPool(Target& target)
+    {
+        AllocatorInstance<ThreadPoolAllocator>::Create();
+        target.m_allocator = &AllocatorInstance<ThreadPoolAllocator>::Get();
+        target.m_maxAllocationSize = target.m_allocator->GetMaxAllocationSize();
+        return true;
+    }
+    static void DestroyThreadPool(Target&)
+    {
+        AllocatorInstance<ThreadPoolAllocator>::Destroy();
+    }
+
+    static bool CreateSlab(Target& target)
+    {
+        AllocatorInstance<SlabAllocator>::Create();
+        target.m_allocator = &AllocatorInstance<SlabAllocator>::Get();
+        target.m_maxAllocationSize = target.m_allocator->GetMaxAllocationSize();
+        return true;
+    }
+    static void DestroySlab(Target&)
+    {
+        AllocatorInstance<SlabAllocator>::Destroy();
+    }
+
+    static bool CreateHpha(Target& target)
+    {
+        // the system allocator is created for the whole run
+        target.m_allocator = &AllocatorInstance<SystemAllocator>::Get();
+        target.m_maxAllocationSize = target.m_allocator->Capacity(); // GetMaxAllocationSize is the biggest free block right now
+        return true;
+    }
+    static void DestroyHpha(Target&)
+    {
+        AllocatorInstance<SystemAllocator>::Get().GarbageCollect();
+    }
+
+    static bool CreateThreadCache(Target& target)
+    {
+        SystemAllocator::Descriptor desc;
+        desc.m_heap.m_isThreadCache = true;
+        desc.m_allocationRecords = false;
+        AllocatorInstance<ThreadCacheSystemAllocator>::Create(desc);
+        target.m_allocator = &AllocatorInstance<ThreadCacheSystemAllocator>::Get();
+        target.m_maxAllocationSize = target.m_allocator->Capacity(); // GetMaxAllocationSize is the biggest free block right now
+        return true;
+    }
+    static void DestroyThreadCache(Target&)
+    {
+        AllocatorInstance<ThreadCacheSystemAllocator>::Destroy();
+    }
+
+    static bool CreateHeap(Target& target)
+    {
+        // reserve address space only, pages are committed when touched so the RSS stays honest
+        target.m_memoryBlockSize = 1024 * 1024 * 1024;
+        target.m_memoryBlock = OSAllocator::ReservePages(target.m_memoryBlockSize, HeapSchema::Descriptor::m_memoryBlockAlignment);
+        if (!target.m_memoryBlock)
+        {
+            return false;
+        }
+        HeapSchema::Descriptor heapDesc;
+        heapDesc.m_numMemoryBlocks = 1;
+        heapDesc.m_memoryBlocks[0] = target.m_memoryBlock;
+        heapDesc.m_memoryBlocksByteSize[0] = target.m_memoryBlockSize;
+        target.m_heapSchema = azcreate(HeapSchema, (heapDesc), SystemAllocator);
+
+        SystemAllocator::Descriptor desc;
+        desc.m_custom = target.m_heapSchema;
+        desc.m_allocationRecords = false;
+        AllocatorInstance<HeapSystemAllocator>::Create(desc);
+        target.m_allocator = &AllocatorInstance<HeapSystemAllocator>::Get();
+        target.m_maxAllocationSize = target.m_allocator->Capacity(); // GetMaxAllocationSize is the biggest free block right now
+        return true;
+    }
+    static void DestroyHeap(Target& target)
+    {
+        AllocatorInstance<HeapSystemAllocator>::Destroy();
+        azdestroy(target.m_heapSchema, SystemAllocator);
+        OSAllocator::ReleasePages(target.m_memoryBlock, target.m_memoryBlockSize);
+        target.m_heapSchema = nullptr;
+        target.m_memoryBlock = nullptr;
+    }
+
+    static bool CreateBestFit(Target& target)
+    {
+        target.m_memoryBlockSize = 1024 * 1024 * 1024;
+        target.m_memoryBlock = OSAllocator::ReservePages(target.m_memoryBlockSize, BestFitExternalMapAllocator::Descriptor::m_memoryBlockAlignment);
+        if (!target.m_memoryBlock)
+        {
+            return false;
+        }
+        BestFitExternalMapAllocator::Descriptor desc;
+        desc.m_memoryBlock = target.m_memoryBlock;
+        desc.m_memoryBlockByteSize = static_cast<unsigned int>(target.m_memoryBlockSize);
+        desc.m_allocationRecords = false;
+        AllocatorInstance<BestFitExternalMapAllocator>::Create(desc);
+        target.m_allocator = &AllocatorInstance<BestFitExternalMapAllocator>::Get();
+        target.m_maxAllocationSize = target.m_allocator->Capacity(); // GetMaxAllocationSize is the biggest free block right now
+        return true;
+    }
+    static void DestroyBestFit(Target& target)
+    {
+        AllocatorInstance<BestFitExternalMapAllocator>::Destroy();
+        OSAllocator::ReleasePages(target.m_memoryBlock, target.m_memoryBlockSize);
+        target.m_memoryBlock = nullptr;
+    }
+
+    static bool CreateOS(Target& target)
+    {
+        target.m_allocator = &AllocatorInstance<OSAllocator>::Get();
+        target.m_maxAllocationSize = target.m_allocator->Capacity(); // GetMaxAllocationSize is the biggest free block right now
+        return true;
+    }
+    static void DestroyOS(Target&)
+    {
+    }
+
+    static Target s_targets[] =
+    {
+        // name                                 thread safe realloc create              destroy
+        { "PoolAllocator",                      false,      true,   &CreatePool,        &DestroyPool,        nullptr, 0, nullptr, 0, nullptr },
+        { "ThreadPoolAllocator",                true,       true,   &CreateThreadPool,  &DestroyThreadPool,  nullptr, 0, nullptr, 0, nullptr },
+        { "SlabAllocator",                      false,      true,   &CreateSlab,        &DestroySlab,        nullptr, 0, nullptr, 0, nullptr },
+        { "SystemAllocator(HPHA)",              true,       true,   &CreateHpha,        &DestroyHpha,        nullptr, 0, nullptr, 0, nullptr },
+        { "SystemAllocator(HPHA+thread cache)", true,       true,   &CreateThreadCache, &DestroyThreadCache, nullptr, 0, nullptr, 0, nullptr },
+        { "SystemAllocator(Heap)",              true,       true,   &CreateHeap,        &DestroyHeap,        nullptr, 0, nullptr, 0, nullptr },
+        { "BestFitExternalMapAllocator",        false,      false,  &CreateBestFit,     &DestroyBestFit,     nullptr, 0, nullptr, 0, nullptr },
+        { "OSAllocator",                        true,       false,  &CreateOS,          &DestroyOS,          nullptr, 0, nullptr, 0, nullptr },
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    // Trace
+
+    struct TraceOp
+    {
+        enum Type
+        {
+            ALLOCATE,
+            REALLOCATE,
+            FREE,
+        };
+        Type        m_type;
+        AZ::u32     m_id;
+        AZ::u32     m_alignment;
+        size_t      m_size;
+    };
+
+    struct Trace
+    {
+        Trace()
+            : m_numIds(0)
+            , m_maxSize(0)
+        {}
+
+        AZStd::vector<TraceOp>  m_ops;
+        AZ::u32                 m_numIds;
+        size_t                  m_maxSize;
+    };
+
+    static bool LoadTrace(const char* fileName, Trace& trace)
+    {
+        FILE* file = fopen(fileName, "r");
+        if (!file)
+        {
+            fprintf(stderr, "Failed to open trace %s!\n", fileName);
+            return false;
+        }
+        char line[256];
+        while (fgets(line, sizeof(line), file))
+        {
+            TraceOp op;
+            unsigned long long id = 0, size = 0, alignment = 0;
+            if (sscanf(line, "a %llu %llu %llu", &id, &size, &alignment) == 3)
+            {
+                op.m_type = TraceOp::ALLOCATE;
+            }
+            else if (sscanf(line, "r %llu %llu", &id, &size) == 2)
+            {
+                op.m_type = TraceOp::REALLOCATE;
+            }
+            else if (sscanf(line, "f %llu", &id) == 1)
+            {
+                op.m_type = TraceOp::FREE;
+            }
+            else
+            {
+                continue; // comments and empty lines
+            }
+            op.m_id = static_cast<AZ::u32>(id);
+            op.m_size = static_cast<size_t>(size);
+            op.m_alignment = static_cast<AZ::u32>(alignment ? alignment : 8);
+            trace.m_ops.push_back(op);
+            trace.m_numIds = AZStd::GetMax(trace.m_numIds, op.m_id + 1);
+            trace.m_maxSize = AZStd::GetMax(trace.m_maxSize, op.m_size);
+        }
+        fclose(file);
+        return !trace.m_ops.empty();
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Workloads
+
+    /// Single producer single consumer queue for the cross thread frees.
+    class PointerQueue
+    {
+    public:
+        static const unsigned int Size = 1024;
+
+        PointerQueue()
+            : m_head(0)
+            , m_tail(0)
+        {}
+
+        bool Push(void* ptr)
+        {
+            unsigned int tail = m_tail.load(AZStd::memory_order_relaxed);
+            if (tail - m_head.load(AZStd::memory_order_acquire) == Size)
+            {
+                return false;
+            }
+            m_items[tail % Size] = ptr;
+            m_tail.store(tail + 1, AZStd::memory_order_release);
+            return true;
+        }
+
+        void* Pop()
+        {
+            unsigned int head = m_head.load(AZStd::memory_order_relaxed);
+            if (head == m_tail.load(AZStd::memory_order_acquire))
+            {
+                return nullptr;
+            }
+            void* ptr = m_items[head % Size];
+            m_head.store(head + 1, AZStd::memory_order_release);
+            return ptr;
+        }
+
+    private:
+        void*                       m_items[Size];
+        AZStd::atomic<unsigned int> m_head;
+        AZStd::atomic<unsigned int> m_tail;
+    };
+
+    struct Worker
+    {
+        Worker()
+            : m_target(nullptr)
+            , m_index(0)
+            , m_opsBudget(0)
+            , m_numOps(0)
+            , m_random(0)
+            , m_liveBytes(0)
+            , m_queue(nullptr)
+            , m_trace(nullptr)
+            , m_isFailed(false)
+        {}
+
+        AZ_FORCE_INLINE AZ::u32 Random()
+        {
+            // xorshift32
+            m_random ^= m_random << 13;
+            m_random ^= m_random >> 17;
+            m_random ^= m_random << 5;
+            return m_random;
+        }
+
+        AZ_FORCE_INLINE void* Allocate(size_t byteSize, size_t alignment = 8)
+        {
+            void* ptr;
+            if ((m_numOps & LatencySampleMask) == 0)
+            {
+                AZStd::sys_time_t start = AZStd::GetTimeNowTicks();
+                ptr = m_target->m_allocator->Allocate(byteSize, alignment);
+                m_latencies.push_back(AZStd::GetTimeNowTicks() - start);
+            }
+            else
+            {
+                ptr = m_target->m_allocator->Allocate(byteSize, alignment);
+            }
+            ++m_numOps;
+            if (!ptr)
+            {
+                m_isFailed = true;
+                return nullptr;
+            }
+            for (size_t i = 0; i < byteSize; i += 4096)
+            {
+                reinterpret_cast<char*>(ptr)[i] = 1; // touch all pages like a real user would, so the RSS is real
+            }
+            m_liveBytes += byteSize;
+            return ptr;
+        }
+
+        AZ_FORCE_INLINE void DeAllocate(void* ptr, size_t byteSize, size_t alignment = 8)
+        {
+            if ((m_numOps & LatencySampleMask) == 0)
+            {
+                AZStd::sys_time_t start = AZStd::GetTimeNowTicks();
+                m_target->m_allocator->DeAllocate(ptr, byteSize, alignment);
+                m_latencies.push_back(AZStd::GetTimeNowTicks() - start);
+            }
+            else
+            {
+                m_target->m_allocator->DeAllocate(ptr, byteSize, alignment);
+            }
+            ++m_numOps;
+            m_liveBytes -= byteSize;
+        }
+
+        void* ReAllocate(void* ptr, size_t oldSize, size_t newSize, size_t alignment = 8)
+        {
+            AZStd::sys_time_t start = AZStd::GetTimeNowTicks();
+            void* newPtr;
+            if (m_target->m_isReAllocate)
+            {
+                newPtr = m_target->m_allocator->ReAllocate(ptr, newSize, alignment);
+            }
+            else
+            {
+                newPtr = m_target->m_allocator->Allocate(newSize, alignment);
+                if (newPtr)
+                {
+                    memcpy(newPtr, ptr, AZStd::GetMin(oldSize, newSize));
+                    m_target->m_allocator->DeAllocate(ptr, oldSize, alignment);
+                }
+            }
+            m_latencies.push_back(AZStd::GetTimeNowTicks() - start);
+            ++m_numOps;
+            if (!newPtr)
+            {
+                m_isFailed = true;
+                return nullptr;
+            }
+            for (size_t i = oldSize; i < newSize; i += 4096)
+            {
+                reinterpret_cast<char*>(newPtr)[i] = 1;
+            }
+            m_liveBytes += newSize - oldSize;
+            return newPtr;
+        }
+
+        Target*                         m_target;
+        unsigned int                    m_index;
+        unsigned int                    m_opsBudget;
+        AZ::u64                         m_numOps;
+        AZ::u32                         m_random;
+        size_t                          m_liveBytes;
+        PointerQueue*                   m_queue;        ///< Producer/consumer queue shared with the paired thread.
+        const Trace*                    m_trace;
+        bool                            m_isFailed;
+        AZStd::vector<AZStd::sys_time_t> m_latencies;
+        AZStd::vector<void*>            m_live;         ///< Live set, released after the measurements.
+        AZStd::vector<size_t>           m_liveSizes;
+    };
+
+    struct Workload
+    {
+        const char* m_name;
+        size_t      m_maxSize;              ///< Biggest allocation, allocators that can't do it are skipped.
+        unsigned    m_minThreads;
+        bool        m_isCrossThread;        ///< Frees memory on a different thread.
+        void        (*m_run)(Worker& worker);
+    };
+
+    /// Random frees and allocations of small objects.
+    static void RunChurn(Worker& worker)
+    {
+        const unsigned int numSlots = 4096;
+        worker.m_live.resize(numSlots, nullptr);
+        worker.m_liveSizes.resize(numSlots, 0);
+        while (worker.m_numOps < worker.m_opsBudget && !worker.m_isFailed)
+        {
+            AZ::u32 random = worker.Random();
+            unsigned int slot = random % numSlots;
+            if (worker.m_live[slot])
+            {
+                worker.DeAllocate(worker.m_live[slot], worker.m_liveSizes[slot]);
+            }
+            size_t size = 8 + ((random >> 12) % 249);
+            worker.m_live[slot] = worker.Allocate(size);
+            worker.m_liveSizes[slot] = size;
+        }
+    }
+
+    static char s_endMarker; ///< Pushed by the producer after the last item.
+
+    /// Even threads allocate, odd threads free what their pair allocated.
+    static void RunProducerConsumer(Worker& worker)
+    {
+        bool isProducer = (worker.m_index & 1) == 0;
+        if (isProducer)
+        {
+            unsigned int numItems = worker.m_opsBudget / 2;
+            for (unsigned int i = 0; i < numItems && !worker.m_isFailed; ++i)
+            {
+                void* ptr = worker.Allocate(16 + (worker.Random() % 497));
+                while (ptr && !worker.m_queue->Push(ptr))
+                {
+                    AZStd::this_thread::yield();
+                }
+            }
+            while (!worker.m_queue->Push(&s_endMarker))
+            {
+                AZStd::this_thread::yield();
+            }
+            worker.m_liveBytes = 0; // the consumer owns the memory now
+        }
+        else
+        {
+            for (;; )
+            {
+                void* ptr = worker.m_queue->Pop();
+                if (ptr == &s_endMarker)
+                {
+                    break;
+                }
+                if (ptr == nullptr)
+                {
+                    AZStd::this_thread::yield();
+                    continue;
+                }
+                worker.DeAllocate(ptr, 0);
+            }
+            worker.m_liveBytes = 0;
+        }
+    }
+
+    /// Mostly small objects with some medium and a few large buffers, with a large live set.
+    static void RunMixed(Worker& worker)
+    {
+        const unsigned int numSlots = 1024;
+        worker.m_live.resize(numSlots, nullptr);
+        worker.m_liveSizes.resize(numSlots, 0);
+        while (worker.m_numOps < worker.m_opsBudget && !worker.m_isFailed)
+        {
+            AZ::u32 random = worker.Random();
+            unsigned int slot = random % numSlots;
+            if (worker.m_live[slot])
+            {
+                worker.DeAllocate(worker.m_live[slot], worker.m_liveSizes[slot]);
+            }
+            unsigned int kind = (random >> 10) % 100;
+            size_t size;
+            if (kind < 90)
+            {
+                size = 16 + worker.Random() % 497;                 // [16, 512]
+            }
+            else if (kind < 99)
+            {
+                size = 1024 + worker.Random() % (63 * 1024);       // [1KB, 64KB)
+            }
+            else
+            {
+                size = 256 * 1024 + worker.Random() % (3840 * 1024); // [256KB, 4MB)
+            }
+            worker.m_live[slot] = worker.Allocate(size);
+            worker.m_liveSizes[slot] = size;
+        }
+    }
+
+    /// Buffers growing by 1.5x from 64 bytes to 1MB, like a vector or a string builder.
+    static void RunReAllocate(Worker& worker)
+    {
+        while (worker.m_numOps < worker.m_opsBudget && !worker.m_isFailed)
+        {
+            size_t size = 64;
+            void* ptr = worker.Allocate(size);
+            while (ptr && size < 1024 * 1024)
+            {
+                size_t newSize = size + size / 2;
+                ptr = worker.ReAllocate(ptr, size, newSize);
+                size = newSize;
+            }
+            if (ptr)
+            {
+                worker.DeAllocate(ptr, size);
+            }
+        }
+    }
+
+    /// Replays the trace file, as many times as fit in the budget.
+    static void RunReplay(Worker& worker)
+    {
+        const Trace& trace = *worker.m_trace;
+        worker.m_live.resize(trace.m_numIds, nullptr);
+        worker.m_liveSizes.resize(trace.m_numIds, 0);
+        do
+        {
+            for (size_t i = 0; i < trace.m_ops.size() && !worker.m_isFailed; ++i)
+            {
+                const TraceOp& op = trace.m_ops[i];
+                void*& ptr = worker.m_live[op.m_id];
+                size_t& size = worker.m_liveSizes[op.m_id];
+                switch (op.m_type)
+                {
+                case TraceOp::ALLOCATE:
+                    if (ptr)
+                    {
+                        worker.DeAllocate(ptr, size); // the id was reused without a free in the trace
+                    }
+                    ptr = worker.Allocate(op.m_size, op.m_alignment);
+                    size = op.m_size;
+                    break;
+                case TraceOp::REALLOCATE:
+                    ptr = ptr ? worker.ReAllocate(ptr, size, op.m_size) : worker.Allocate(op.m_size);
+                    size = op.m_size;
+                    break;
+                case TraceOp::FREE:
+                    if (ptr)
+                    {
+                        worker.DeAllocate(ptr, size);
+                        ptr = nullptr;
+                    }
+                    break;
+                }
+            }
+        } while (worker.m_numOps < worker.m_opsBudget && !worker.m_isFailed);
+    }
+
+    static Workload s_workloads[] =
+    {
+        // name                 max size            min threads cross thread    run
+        { "churn",              256,                1,          false,          &RunChurn },
+        { "producer-consumer",  512,                2,          true,           &RunProducerConsumer },
+        { "mixed",              4 * 1024 * 1024,    1,          false,          &RunMixed },
+        { "realloc",            1536 * 1024,        1,          false,          &RunReAllocate },
+        { "replay",             0,                  1,          false,          &RunReplay },
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    // Runner
+
+    static size_t GetResidentBytes()
+    {
+#if defined(AZ_PLATFORM_LINUX)
+        FILE* file = fopen("/proc/self/statm", "r");
+        if (file)
+        {
+            unsigned long long totalPages = 0, residentPages = 0;
+            int numRead = fscanf(file, "%llu %llu", &totalPages, &residentPages);
+            fclose(file);
+            if (numRead == 2)
+            {
+                return static_cast<size_t>(residentPages * sysconf(_SC_PAGESIZE));
+            }
+        }
+#endif
+        return 0;
+    }
+
+    struct Result
+    {
+        double  m_opsPerSecond;
+        double  m_p99Nanoseconds;
+        size_t  m_liveBytes;            ///< Requested bytes the workload holds at the end.
+        size_t  m_residentBytes;        ///< RSS growth while the workload holds its live set.
+        double  m_fragmentation;        ///< Unallocated / (allocated + unallocated) bytes, negative if the allocator doesn't track it.
+        bool    m_isFailed;
+    };
+
+    class Runner
+    {
+    public:
+        Runner(Target& target, const Workload& workload, const Trace* trace, unsigned int numThreads, unsigned int opsPerThread)
+            : m_numThreads(numThreads)
+            , m_numFinished(0)
+            , m_isReleased(false)
+        {
+            for (unsigned int i = 0; i < numThreads; ++i)
+            {
+                Worker& worker = m_workers[i];
+                worker.m_target = &target;
+                worker.m_index = i;
+                worker.m_opsBudget = opsPerThread;
+                worker.m_random = 0x9E3779B9u * (i + 1);
+                worker.m_queue = workload.m_isCrossThread ? &m_queues[i / 2] : nullptr;
+                worker.m_trace = trace;
+                worker.m_latencies.reserve(opsPerThread / (LatencySampleMask + 1) + 1024);
+            }
+            m_workload = &workload;
+        }
+
+        Result Run()
+        {
+            Target& target = *m_workers[0].m_target;
+            size_t baseResident = GetResidentBytes();
+            AZStd::sys_time_t startTime = AZStd::GetTimeNowTicks();
+
+            AZStd::thread* threads[MaxThreads];
+            for (unsigned int i = 0; i < m_numThreads; ++i)
+            {
+                Worker* worker = &m_workers[i];
+                threads[i] = new AZStd::thread([this, worker]() { ThreadMain(*worker); });
+            }
+            // wait for all threads to finish, they hold their live sets until we measure
+            while (m_numFinished.load(AZStd::memory_order_acquire) != m_numThreads)
+            {
+                AZStd::this_thread::yield();
+            }
+            AZStd::sys_time_t endTime = m_endTime;
+
+            Result result;
+            result.m_residentBytes = GetResidentBytes();
+            result.m_residentBytes = result.m_residentBytes > baseResident ? result.m_residentBytes - baseResident : 0;
+            size_t allocated = target.m_allocator->NumAllocatedBytes();
+            size_t unallocated = target.m_allocator->GetUnAllocatedMemory(false);
+            result.m_fragmentation = unallocated ? double(unallocated) / double(allocated + unallocated) : -1.0;
+            result.m_liveBytes = 0;
+            for (unsigned int i = 0; i < m_numThreads; ++i)
+            {
+                result.m_liveBytes += m_workers[i].m_liveBytes;
+            }
+
+            m_isReleased.store(true, AZStd::memory_order_release);
+            for (unsigned int i = 0; i < m_numThreads; ++i)
+            {
+                threads[i]->join();
+                delete threads[i];
+            }
+
+            AZ::u64 numOps = 0;
+            AZStd::vector<AZStd::sys_time_t> latencies;
+            result.m_isFailed = false;
+            for (unsigned int i = 0; i < m_numThreads; ++i)
+            {
+                numOps += m_workers[i].m_numOps;
+                latencies.insert(latencies.end(), m_workers[i].m_latencies.begin(), m_workers[i].m_latencies.end());
+                result.m_isFailed |= m_workers[i].m_isFailed;
+            }
+            double seconds = double(endTime - startTime) / double(AZStd::GetTimeTicksPerSecond());
+            result.m_opsPerSecond = seconds > 0.0 ? double(numOps) / seconds : 0.0;
+            result.m_p99Nanoseconds = 0.0;
+            if (!latencies.empty())
+            {
+                AZStd::sort(latencies.begin(), latencies.end());
+                size_t p99 = AZStd::GetMin(latencies.size() - 1, latencies.size() * 99 / 100);
+                result.m_p99Nanoseconds = double(latencies[p99]) * 1e9 / double(AZStd::GetTimeTicksPerSecond());
+            }
+            return result;
+        }
+
+    private:
+        void ThreadMain(Worker& worker)
+        {
+            m_workload->m_run(worker);
+            // the last thread to finish stops the clock
+            m_endTime = AZStd::GetTimeNowTicks();
+            m_numFinished.fetch_add(1, AZStd::memory_order_acq_rel);
+            while (!m_isReleased.load(AZStd::memory_order_acquire))
+            {
+                AZStd::this_thread::yield();
+            }
+            for (size_t i = 0; i < worker.m_live.size(); ++i)
+            {
+                if (worker.m_live[i])
+                {
+                    worker.m_target->m_allocator->DeAllocate(worker.m_live[i], worker.m_liveSizes[i], 8);
+                }
+            }
+            worker.m_live.clear();
+            worker.m_liveSizes.clear();
+        }
+
+        Worker                          m_workers[MaxThreads];
+        PointerQueue                    m_queues[MaxThreads / 2];
+        const Workload*                 m_workload;
+        unsigned int                    m_numThreads;
+        AZStd::atomic<unsigned int>     m_numFinished;
+        AZStd::atomic<bool>             m_isReleased;
+        volatile AZStd::sys_time_t      m_endTime;
+    };
+
+    static bool IsFiltered(const char* name, const char* filter)
+    {
+        return filter != nullptr && strstr(name, filter) == nullptr;
+    }
+
+    static void Run(const Options& options)
+    {
+        Trace trace;
+        bool isTrace = options.m_traceFile && LoadTrace(options.m_traceFile, trace);
+
+        printf("%-34s %-18s %7s %10s %10s %10s %10s %8s\n", "allocator", "workload", "threads", "Mops/s", "p99(ns)", "live(MB)", "RSS(MB)", "frag(%)");
+        for (Target& target : s_targets)
+        {
+            if (IsFiltered(target.m_name, options.m_allocatorFilter))
+            {
+                continue;
+            }
+            if (!target.m_create(target))
+            {
+                printf("%-34s failed to create\n", target.m_name);
+                continue;
+            }
+            for (const Workload& workload : s_workloads)
+            {
+                if (IsFiltered(workload.m_name, options.m_workloadFilter))
+                {
+                    continue;
+                }
+                const Trace* workloadTrace = nullptr;
+                size_t maxSize = workload.m_maxSize;
+                if (workload.m_run == &RunReplay)
+                {
+                    if (!isTrace)
+                    {
+                        continue;
+                    }
+                    workloadTrace = &trace;
+                    maxSize = trace.m_maxSize;
+                }
+                if (maxSize > target.m_maxAllocationSize || (workload.m_isCrossThread && !target.m_isThreadSafe))
+                {
+                    continue;
+                }
+
+                for (unsigned int numThreads = workload.m_minThreads; ; numThreads *= 2)
+                {
+                    numThreads = AZStd::GetMin(numThreads, options.m_maxThreads);
+                    if (numThreads < workload.m_minThreads || (numThreads > 1 && !target.m_isThreadSafe))
+                    {
+                        break;
+                    }
+                    Runner* runner = new Runner(target, workload, workloadTrace, numThreads, options.m_opsPerThread);
+                    Result result = runner->Run();
+                    delete runner;
+                    char fragmentation[16] = "-";
+                    if (result.m_fragmentation >= 0.0)
+                    {
+                        snprintf(fragmentation, sizeof(fragmentation), "%.1f", result.m_fragmentation * 100.0);
+                    }
+                    printf("%-34s %-18s %7u %10.2f %10.0f %10.1f %10.1f %8s%s\n", target.m_name, workload.m_name, numThreads,
+                        result.m_opsPerSecond / 1e6, result.m_p99Nanoseconds, double(result.m_liveBytes) / (1024.0 * 1024.0),
+                        double(result.m_residentBytes) / (1024.0 * 1024.0), fragmentation, result.m_isFailed ? " (out of memory)" : "");
+                    fflush(stdout);
+                    if (numThreads == options.m_maxThreads)
+                    {
+                        break;
+                    }
+                }
+            }
+            target.m_destroy(target);
+        }
+    }
+
+    static int Main(int argc, char* argv[])
+    {
+        Options options;
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            if (strcmp(argv[i], "--threads") == 0)
+            {
+                options.m_maxThreads = AZStd::GetMin(AZStd::GetMax(static_cast<unsigned int>(atoi(argv[i + 1])), 1u), MaxThreads);
+            }
+            else if (strcmp(argv[i], "--ops") == 0)
+            {
+                options.m_opsPerThread = static_cast<unsigned int>(atoi(argv[i + 1]));
+            }
+            else if (strcmp(argv[i], "--allocator") == 0)
+            {
+                options.m_allocatorFilter = argv[i + 1];
+            }
+            else if (strcmp(argv[i], "--workload") == 0)
+            {
+                options.m_workloadFilter = argv[i + 1];
+            }
+            else if (strcmp(argv[i], "--trace") == 0)
+            {
+                options.m_traceFile = argv[i + 1];
+            }
+            else
+            {
+                fprintf(stderr, "Unknown option %s!\n", argv[i]);
+                return 1;
+            }
+        }
+
+        SystemAllocator::Descriptor systemDesc;
+        systemDesc.m_allocationRecords = false;
+        AllocatorInstance<SystemAllocator>::Create(systemDesc);
+
+        Run(options);
+
+        AllocatorInstance<SystemAllocator>::Destroy();
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    return AllocatorBenchmark::Main(argc, argv);
+}
@@ -0,0 +1,421 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZCORE_JOBS_ALGORITHMS_H
+#define AZCORE_JOBS_ALGORITHMS_H 1
+
+#include <AzCore/Jobs/Job.h>
+#include <AzCore/Jobs/JobEmpty.h>
+#include <AzCore/std/parallel/combinable.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/iterator.h>
+#include <AzCore/std/sort.h>
+
+/**
+ * Data parallel algorithms running on the job system. All functions block until the work is complete, the calling
+ * thread assists with the processing (or if called from a job, the job waits for the work as a child).
+ *
+ * Ranges are split lazily (lazy binary splitting): a job keeps processing its range in chunks of grainSize, and only
+ * gives away the upper half of what is left when its thread has no other queued jobs, i.e. when other threads are
+ * likely to be idle. This adapts to the load without having to tune the grain size much, grainSize 0 picks a default.
+ */
+
+namespace AZ
+{
+    namespace Internal
+    {
+        template<class IndexType>
+        inline IndexType GetParallelGrainSize(IndexType count, IndexType grainSize, JobContext* jobContext)
+        {
+            if (grainSize > 0)
+            {
+                return grainSize;
+            }
+            //small enough to keep all the threads busy, big enough to amortize the split checks
+            IndexType numThreads = static_cast<IndexType>(jobContext->GetJobManager().GetNumWorkerThreads() + 1);
+            grainSize = count / (numThreads * 16);
+            return grainSize > 0 ? grainSize : 1;
+        }
+
+        /**
+         * Calls function(chunkStart, chunkEnd) for chunks of [start, end). Split off jobs are continuations of this
+         * job, so nobody has to wait for them except the final dependent.
+         */
+        template<class IndexType, class RangeFunction>
+        class ParallelForJob
+            : public Job
+        {
+        public:
+            AZ_CLASS_ALLOCATOR(ParallelForJob, ThreadPoolAllocator, 0)
+
+            ParallelForJob(IndexType start, IndexType end, IndexType grainSize, const RangeFunction& function, JobContext* context)
+                : Job(true, context)
+                , m_start(start)
+                , m_end(end)
+                , m_grainSize(grainSize)
+                , m_function(function)
+            {
+            }
+
+        protected:
+            virtual void Process()
+            {
+                JobManager& jobManager = GetContext()->GetJobManager();
+                while (m_start < m_end)
+                {
+                    IndexType count = m_end - m_start;
+                    if (count > m_grainSize && jobManager.IsLocalQueueEmpty())
+                    {
+                        //nothing else queued on this thread, give the upper half away
+                        IndexType mid = m_start + count / 2;
+                        Job* job = aznew ParallelForJob(mid, m_end, m_grainSize, m_function, GetContext());
+                        SetContinuation(job);
+                        job->Start();
+                        m_end = mid;
+                        continue;
+                    }
+
+                    IndexType chunkEnd = (count > m_grainSize) ? (m_start + m_grainSize) : m_end;
+                    m_function(m_start, chunkEnd);
+                    m_start = chunkEnd;
+                }
+            }
+
+            IndexType m_start;
+            IndexType m_end;
+            IndexType m_grainSize;
+            const RangeFunction& m_function; //the caller blocks until we are done, no need to copy it for every job
+        };
+
+        /// Starts a job and blocks until it and all its continuations are complete.
+        inline void StartAndWaitForContinuations(Job* job)
+        {
+            JobEmpty join(false, job->GetContext());
+            job->SetDependent(&join);
+            job->Start();
+            join.StartAndWaitForCompletion();
+        }
+
+        template<class IndexType, class RangeFunction>
+        inline void ParallelForRange(IndexType start, IndexType end, const RangeFunction& function, JobContext* jobContext, IndexType grainSize)
+        {
+            if (!(start < end))
+            {
+                return;
+            }
+            if (!jobContext)
+            {
+                jobContext = JobContext::GetParentContext();
+            }
+
+            grainSize = GetParallelGrainSize<IndexType>(end - start, grainSize, jobContext);
+            if (!(grainSize < end - start) || !jobContext->GetJobManager().IsAsynchronous())
+            {
+                function(start, end);
+                return;
+            }
+
+            StartAndWaitForContinuations(aznew ParallelForJob<IndexType, RangeFunction>(start, end, grainSize, function, jobContext));
+        }
+
+        /**
+         * Merges the sorted ranges [first, mid) and [mid, last) in place. Big merges are split in two independent
+         * merges the same way merge_buffered does it, the upper one continues as a new job. Small merges use merge_buffered.
+         */
+        template<class RandomAccessIterator, class Compare>
+        class ParallelMergeJob
+            : public Job
+        {
+        public:
+            AZ_CLASS_ALLOCATOR(ParallelMergeJob, ThreadPoolAllocator, 0)
+
+            typedef typename AZStd::iterator_traits<RandomAccessIterator>::difference_type difference_type;
+            typedef typename AZStd::iterator_traits<RandomAccessIterator>::value_type value_type;
+
+            ParallelMergeJob(RandomAccessIterator first, RandomAccessIterator mid, RandomAccessIterator last, difference_type grainSize, const Compare& comp, JobContext* context)
+                : Job(true, context)
+                , m_first(first)
+                , m_mid(mid)
+                , m_last(last)
+                , m_grainSize(grainSize)
+                , m_comp(comp)
+            {
+            }
+
+        protected:
+            virtual void Process()
+            {
+                RandomAccessIterator first = m_first;
+                RandomAccessIterator mid = m_mid;
+                RandomAccessIterator last = m_last;
+                while (true)
+                {
+                    difference_type count1 = mid - first;
+                    difference_type count2 = last - mid;
+                    if (count1 == 0 || count2 == 0 || !m_comp(*mid, *(mid - 1)))
+                    {
+                        return; //already in order
+                    }
+
+                    if (count1 + count2 <= m_grainSize)
+                    {
+                        AZStd::Internal::TemporaryBuffer<value_type, AZStd::allocator> buffer(count1 < count2 ? count1 : count2);
+                        AZStd::merge_buffered(first, mid, last, count1, count2, buffer, m_comp);
+                        return;
+                    }
+
+                    //cut the larger part in half and partition the other to match
+                    RandomAccessIterator firstn, lastn;
+                    difference_type count2n;
+                    if (count2 < count1)
+                    {
+                        firstn = first + count1 / 2;
+                        lastn = AZStd::lower_bound(mid, last, *firstn, m_comp);
+                        count2n = lastn - mid;
+                    }
+                    else
+                    {
+                        count2n = count2 / 2;
+                        lastn = mid + count2n;
+                        firstn = AZStd::upper_bound(first, mid, *lastn, m_comp);
+                    }
+                    AZStd::rotate(firstn, mid, lastn);
+                    RandomAccessIterator midn = firstn + count2n;
+
+                    //[first, firstn) + [firstn, midn) and [midn, lastn) + [lastn, last) are now independent merges
+                    Job* job = aznew ParallelMergeJob(midn, lastn, last, m_grainSize, m_comp, GetContext());
+                    SetContinuation(job);
+                    job->Start();
+
+                    mid = firstn;
+                    last = midn;
+                }
+            }
+
+            RandomAccessIterator m_first;
+            RandomAccessIterator m_mid;
+            RandomAccessIterator m_last;
+            difference_type m_grainSize;
+            const Compare& m_comp;
+        };
+
+        /// Sorts both halves as separate jobs, then merges them with a ParallelMergeJob which continues this job.
+        template<class RandomAccessIterator, class Compare>
+        class ParallelSortJob
+            : public Job
+        {
+        public:
+            AZ_CLASS_ALLOCATOR(ParallelSortJob, ThreadPoolAllocator, 0)
+
+            typedef typename AZStd::iterator_traits<RandomAccessIterator>::difference_type difference_type;
+
+            ParallelSortJob(RandomAccessIterator first, RandomAccessIterator last, difference_type grainSize, const Compare& comp, JobContext* context)
+                : Job(true, context)
+                , m_first(first)
+                , m_last(last)
+                , m_grainSize(grainSize)
+                , m_comp(comp)
+            {
+            }
+
+        protected:
+            virtual void Process()
+            {
+                difference_type count = m_last - m_first;
+                if (count <= m_grainSize)
+                {
+                    AZStd::sort(m_first, m_last, m_comp);
+                    return;
+                }
+
+                RandomAccessIterator mid = m_first + count / 2;
+                Job* mergeJob = aznew ParallelMergeJob<RandomAccessIterator, Compare>(m_first, mid, m_last, m_grainSize, m_comp, GetContext());
+                SetContinuation(mergeJob);
+                Job* lowerJob = aznew ParallelSortJob(m_first, mid, m_grainSize, m_comp, GetContext());
+                Job* upperJob = aznew ParallelSortJob(mid, m_last, m_grainSize, m_comp, GetContext());
+                lowerJob->SetDependent(mergeJob);
+                upperJob->SetDependent(mergeJob);
+                mergeJob->Start();
+                upperJob->Start();
+                lowerJob->Start();
+            }
+
+            RandomAccessIterator m_first;
+            RandomAccessIterator m_last;
+            difference_type m_grainSize;
+            const Compare& m_comp;
+        };
+    }
+
+    /**
+     * Calls function(i) for every i in [start, end), in parallel.
+     */
+    template<class IndexType, class Function>
+    inline void parallel_for(IndexType start, IndexType end, const Function& function, JobContext* jobContext = nullptr, IndexType grainSize = 0)
+    {
+        auto rangeFunction = [&function](IndexType chunkStart, IndexType chunkEnd)
+            {
+                for (IndexType i = chunkStart; i < chunkEnd; ++i)
+                {
+                    function(i);
+                }
+            };
+        Internal::ParallelForRange(start, end, rangeFunction, jobContext, grainSize);
+    }
+
+    /**
+     * Calls function(element) for every element in [first, last), in parallel. Iterators must be random access.
+     */
+    template<class RandomAccessIterator, class Function>
+    inline void parallel_for_each(RandomAccessIterator first, RandomAccessIterator last, const Function& function, JobContext* jobContext = nullptr,
+        typename AZStd::iterator_traits<RandomAccessIterator>::difference_type grainSize = 0)
+    {
+        typedef typename AZStd::iterator_traits<RandomAccessIterator>::difference_type difference_type;
+        auto rangeFunction = [first, &function](difference_type chunkStart, difference_type chunkEnd)
+            {
+                for (RandomAccessIterator it = first + chunkStart, end = first + chunkEnd; it != end; ++it)
+                {
+                    function(*it);
+                }
+            };
+        Internal::ParallelForRange<difference_type>(0, last - first, rangeFunction, jobContext, grainSize);
+    }
+
+    /**
+     * Returns identity reduced with function(i) for every i in [start, end), in parallel. Each thread reduces into its
+     * own AZStd::combinable value, which are reduced together at the end. The reduce function must be associative and
+     * commutative, as the order of the reduction is not defined. reduce has the signature T (const T&, const T&).
+     */
+    template<class IndexType, class T, class Function, class Reduce>
+    inline T parallel_reduce(IndexType start, IndexType end, const T& identity, const Function& function, const Reduce& reduce, JobContext* jobContext = nullptr, IndexType grainSize = 0)
+    {
+        AZStd::combinable<T> partialResults([&identity]() { return identity; });
+        auto rangeFunction = [&](IndexType chunkStart, IndexType chunkEnd)
+            {
+                T result = identity;
+                for (IndexType i = chunkStart; i < chunkEnd; ++i)
+                {
+                    result = reduce(result, function(i));
+                }
+                T& partialResult = partialResults.local();
+                partialResult = reduce(partialResult, result);
+            };
+        Internal::ParallelForRange(start, end, rangeFunction, jobContext, grainSize);
+        return partialResults.combine(reduce);
+    }
+
+    /**
+     * Inclusive scan, result[i] = identity op first[0] op ... op first[i], computed in parallel in two passes over
+     * blocks of the input. op must be associative. result may be the same as first. Iterators must be random access.
+     */
+    template<class InputIterator, class OutputIterator, class T, class BinaryOperation>
+    inline void parallel_scan(InputIterator first, InputIterator last, OutputIterator result, const T& identity, const BinaryOperation& op, JobContext* jobContext = nullptr)
+    {
+        typedef typename AZStd::iterator_traits<InputIterator>::difference_type difference_type;
+        difference_type count = last - first;
+        if (count <= 0)
+        {
+            return;
+        }
+        if (!jobContext)
+        {
+            jobContext = JobContext::GetParentContext();
+        }
+
+        //a few blocks per thread, so the passes balance well, but not so many the serial pass over the blocks shows up
+        difference_type numBlocks = static_cast<difference_type>((jobContext->GetJobManager().GetNumWorkerThreads() + 1) * 4);
+        const difference_type minBlockSize = 1024;
+        if (!jobContext->GetJobManager().IsAsynchronous() || count < minBlockSize * 2)
+        {
+            numBlocks = 1;
+        }
+        else if (count / numBlocks < minBlockSize)
+        {
+            numBlocks = count / minBlockSize;
+        }
+        const difference_type blockSize = (count + numBlocks - 1) / numBlocks;
+
+        //first pass, reduce each block
+        AZStd::vector<T> blockOffsets(static_cast<size_t>(numBlocks), identity);
+        if (numBlocks > 1)
+        {
+            parallel_for<difference_type>(0, numBlocks - 1, [&](difference_type block) //last block sum is not needed
+                {
+                    InputIterator it = first + block * blockSize;
+                    InputIterator end = it + blockSize;
+                    T sum = *it;
+                    for (++it; it != end; ++it)
+                    {
+                        sum = op(sum, *it);
+                    }
+                    blockOffsets[block + 1] = sum;
+                }, jobContext, 1);
+
+            for (difference_type block = 1; block < numBlocks; ++block)
+            {
+                blockOffsets[block] = op(blockOffsets[block - 1], blockOffsets[block]);
+            }
+        }
+
+        //second pass, scan each block starting from its offset
+        parallel_for<difference_type>(0, numBlocks, [&](difference_type block)
+            {
+                difference_type start = block * blockSize;
+                difference_type end = (start + blockSize < count) ? (start + blockSize) : count;
+                T sum = blockOffsets[block];
+                for (difference_type i = start; i < end; ++i)
+                {
+                    sum = op(sum, first[i]);
+                    result[i] = sum;
+                }
+            }, jobContext, 1);
+    }
+
+    /**
+     * Sorts [first, last) in parallel using a merge sort, the merges are done in place (see AZStd::merge_buffered) and
+     * are split into independent parallel merges when big. Like AZStd::sort the sort is not stable.
+     */
+    template<class RandomAccessIterator, class Compare>
+    inline void parallel_sort(RandomAccessIterator first, RandomAccessIterator last, const Compare& comp, JobContext* jobContext = nullptr)
+    {
+        typedef typename AZStd::iterator_traits<RandomAccessIterator>::difference_type difference_type;
+        difference_type count = last - first;
+        if (!jobContext)
+        {
+            jobContext = JobContext::GetParentContext();
+        }
+
+        //leaves are sorted with AZStd::sort, keep them big enough for that to be worth a job
+        const difference_type minGrainSize = 2048;
+        difference_type grainSize = count / static_cast<difference_type>((jobContext->GetJobManager().GetNumWorkerThreads() + 1) * 8);
+        if (grainSize < minGrainSize)
+        {
+            grainSize = minGrainSize;
+        }
+
+        if (count <= grainSize || !jobContext->GetJobManager().IsAsynchronous())
+        {
+            AZStd::sort(first, last, comp);
+            return;
+        }
+
+        Internal::StartAndWaitForContinuations(aznew Internal::ParallelSortJob<RandomAccessIterator, Compare>(first, last, grainSize, comp, jobContext));
+    }
+
+    template<class RandomAccessIterator>
+    inline void parallel_sort(RandomAccessIterator first, RandomAccessIterator last, JobContext* jobContext = nullptr)
+    {
+        parallel_sort(first, last, AZStd::less<typename AZStd::iterator_traits<RandomAccessIterator>::value_type>(), jobContext);
+    }
+}
+
+#endif
+#pragma once
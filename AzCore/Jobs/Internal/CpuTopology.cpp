@@ -0,0 +1,245 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZ_UNITY_BUILD
+
+#include <AzCore/Jobs/Internal/CpuTopology.h>
+
+#if defined(AZ_PLATFORM_LINUX)
+#   include <stdio.h>
+#   include <stdlib.h>
+#   include <string.h>
+#   include <unistd.h>
+#endif
+
+using namespace AZ;
+using namespace Internal;
+
+#if defined(AZ_PLATFORM_LINUX)
+namespace
+{
+    // Reads a small sysfs file into buffer, returns false if the file doesn't exist.
+    bool ReadSysFile(const char* path, char* buffer, size_t bufferSize)
+    {
+        FILE* file = fopen(path, "r");
+        if (!file)
+        {
+            return false;
+        }
+        size_t numRead = fread(buffer, 1, bufferSize - 1, file);
+        fclose(file);
+        buffer[numRead] = 0;
+        return numRead > 0;
+    }
+
+    int ReadSysInt(const char* path)
+    {
+        char buffer[32];
+        if (!ReadSysFile(path, buffer, AZ_ARRAY_SIZE(buffer)))
+        {
+            return -1;
+        }
+        return atoi(buffer);
+    }
+
+    // Calls cb for each cpu in a sysfs cpu list, e.g. "0-3,8,10-11"
+    template<class Callback>
+    void ForEachCpuInList(const char* list, Callback cb)
+    {
+        const char* str = list;
+        while (*str >= '0' && *str <= '9')
+        {
+            char* end;
+            int first = static_cast<int>(strtol(str, &end, 10));
+            int last = first;
+            if (*end == '-')
+            {
+                last = static_cast<int>(strtol(end + 1, &end, 10));
+            }
+            for (int cpu = first; cpu <= last; ++cpu)
+            {
+                cb(cpu);
+            }
+            str = (*end == ',') ? end + 1 : end;
+        }
+    }
+
+    int GetLowestCpuInList(const char* list)
+    {
+        int lowest = -1;
+        ForEachCpuInList(list, [&lowest](int cpu)
+            {
+                if (lowest == -1 || cpu < lowest)
+                {
+                    lowest = cpu;
+                }
+            });
+        return lowest;
+    }
+}
+#endif // AZ_PLATFORM_LINUX
+
+CpuTopology::CpuTopology()
+{
+}
+
+bool CpuTopology::Read()
+{
+    m_cpus.clear();
+#if defined(AZ_PLATFORM_LINUX)
+    long numCpus = sysconf(_SC_NPROCESSORS_CONF);
+    if (numCpus <= 0)
+    {
+        return false;
+    }
+
+    CpuInfo unknown = { -1, -1, -1, -1 };
+    m_cpus.resize(static_cast<size_t>(numCpus), unknown);
+
+    char path[256];
+    char buffer[1024];
+    for (int cpu = 0; cpu < static_cast<int>(numCpus); ++cpu)
+    {
+        CpuInfo& info = m_cpus[cpu];
+
+        azsnprintf(path, AZ_ARRAY_SIZE(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+        info.m_package = ReadSysInt(path);
+
+        // walk the cache levels, data/unified caches only
+        int llcLevel = 0;
+        for (int index = 0; ; ++index)
+        {
+            azsnprintf(path, AZ_ARRAY_SIZE(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/level", cpu, index);
+            int level = ReadSysInt(path);
+            if (level < 0)
+            {
+                break;
+            }
+            azsnprintf(path, AZ_ARRAY_SIZE(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/type", cpu, index);
+            if (ReadSysFile(path, buffer, AZ_ARRAY_SIZE(buffer)) && strncmp(buffer, "Instruction", 11) == 0)
+            {
+                continue;
+            }
+            azsnprintf(path, AZ_ARRAY_SIZE(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/shared_cpu_list", cpu, index);
+            if (!ReadSysFile(path, buffer, AZ_ARRAY_SIZE(buffer)))
+            {
+                continue;
+            }
+            int group = GetLowestCpuInList(buffer);
+            if (level == 2)
+            {
+                info.m_l2Group = group;
+            }
+            if (level >= llcLevel)
+            {
+                llcLevel = level;
+                info.m_llcGroup = group;
+            }
+        }
+    }
+
+    // NUMA nodes, the node directories are not necessarily contiguous, so try a reasonable range
+    for (int node = 0; node < 64; ++node)
+    {
+        azsnprintf(path, AZ_ARRAY_SIZE(path), "/sys/devices/system/node/node%d/cpulist", node);
+        if (!ReadSysFile(path, buffer, AZ_ARRAY_SIZE(buffer)))
+        {
+            continue;
+        }
+        AZStd::vector<CpuInfo>& cpus = m_cpus;
+        ForEachCpuInList(buffer, [&cpus, node](int cpu)
+            {
+                if (cpu < static_cast<int>(cpus.size()))
+                {
+                    cpus[cpu].m_numaNode = node;
+                }
+            });
+    }
+    return true;
+#else
+    return false;
+#endif // AZ_PLATFORM_LINUX
+}
+
+CpuTopology::Distance CpuTopology::GetDistance(int cpuA, int cpuB) const
+{
+    if (cpuA < 0 || cpuB < 0 || cpuA >= static_cast<int>(m_cpus.size()) || cpuB >= static_cast<int>(m_cpus.size()))
+    {
+        return DISTANCE_UNKNOWN;
+    }
+
+    const CpuInfo& a = m_cpus[cpuA];
+    const CpuInfo& b = m_cpus[cpuB];
+    if (a.m_l2Group != -1 && a.m_l2Group == b.m_l2Group)
+    {
+        return DISTANCE_SHARED_L2;
+    }
+    if (a.m_llcGroup != -1 && a.m_llcGroup == b.m_llcGroup)
+    {
+        return DISTANCE_SHARED_LLC;
+    }
+    if (a.m_numaNode != -1 && b.m_numaNode != -1)
+    {
+        return (a.m_numaNode == b.m_numaNode) ? DISTANCE_SAME_NODE : DISTANCE_REMOTE;
+    }
+    if (a.m_package != -1 && b.m_package != -1)
+    {
+        return (a.m_package == b.m_package) ? DISTANCE_SAME_NODE : DISTANCE_REMOTE;
+    }
+    return DISTANCE_UNKNOWN;
+}
+
+float CpuTopology::GetDistance(const AZStd::thread_cpu_mask& cpusA, const AZStd::thread_cpu_mask& cpusB) const
+{
+    AZStd::vector<int> listA;
+    AZStd::vector<int> listB;
+    for (size_t cpu = 0; cpu < cpusA.size(); ++cpu)
+    {
+        if (cpusA.test(cpu))
+        {
+            listA.push_back(static_cast<int>(cpu));
+        }
+        if (cpusB.test(cpu))
+        {
+            listB.push_back(static_cast<int>(cpu));
+        }
+    }
+    if (listA.empty() || listB.empty())
+    {
+        return static_cast<float>(DISTANCE_UNKNOWN);
+    }
+
+    unsigned int sum = 0;
+    for (size_t a = 0; a < listA.size(); ++a)
+    {
+        for (size_t b = 0; b < listB.size(); ++b)
+        {
+            sum += GetDistance(listA[a], listB[b]);
+        }
+    }
+    return static_cast<float>(sum) / static_cast<float>(listA.size() * listB.size());
+}
+
+AZStd::thread_cpu_mask CpuTopology::GetAffinityCpus(int cpuId, const AZStd::thread_cpu_mask& cpuMask)
+{
+    if (cpuMask.any())
+    {
+        return cpuMask;
+    }
+    AZStd::thread_cpu_mask cpus;
+    if (cpuId >= 0 && static_cast<size_t>(cpuId) < cpus.size())
+    {
+        cpus.set(cpuId);
+    }
+    return cpus;
+}
+
+#endif // #ifndef AZ_UNITY_BUILD
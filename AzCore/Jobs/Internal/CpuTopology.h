@@ -0,0 +1,73 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZCORE_JOBS_INTERNAL_CPUTOPOLOGY_H
+#define AZCORE_JOBS_INTERNAL_CPUTOPOLOGY_H 1
+
+#include <AzCore/base.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/parallel/thread.h>
+
+namespace AZ
+{
+    namespace Internal
+    {
+        /**
+         * Cache and socket layout of the logical cpus, used by the JobManager to prefer stealing from nearby threads.
+         * Only Linux reads the real topology (from /sys), on other platforms all cpus are reported at the same distance.
+         */
+        class CpuTopology
+        {
+        public:
+            enum Distance
+            {
+                DISTANCE_SHARED_L2 = 0,     ///< cpus share the L2 cache (usually hyper threads of the same core)
+                DISTANCE_SHARED_LLC,        ///< cpus share the last level cache
+                DISTANCE_SAME_NODE,         ///< cpus are on the same NUMA node (or socket if NUMA info is not available)
+                DISTANCE_REMOTE,            ///< cpus are on different NUMA nodes
+                DISTANCE_UNKNOWN,           ///< at least one of the cpus is unknown
+            };
+
+            CpuTopology();
+
+            /// Reads the topology from the OS, returns false if it's not available.
+            bool Read();
+
+            unsigned int GetNumCpus() const { return static_cast<unsigned int>(m_cpus.size()); }
+
+            Distance GetDistance(int cpuA, int cpuB) const;
+
+            /**
+             * Average distance between the cpus of two sets, e.g. two threads allowed to run anywhere on the same node
+             * are closer than two threads on different nodes even though their masks have no cpu in common.
+             * Returns DISTANCE_UNKNOWN if either set is empty.
+             */
+            float GetDistance(const AZStd::thread_cpu_mask& cpusA, const AZStd::thread_cpu_mask& cpusB) const;
+
+            /// Returns the cpus a thread may run on for an affinity, the mask if any bit is set, else cpuId. Empty if not pinned.
+            static AZStd::thread_cpu_mask GetAffinityCpus(int cpuId, const AZStd::thread_cpu_mask& cpuMask);
+
+        private:
+            struct CpuInfo
+            {
+                int m_l2Group;      ///< lowest cpu id sharing the L2 with this cpu
+                int m_llcGroup;     ///< lowest cpu id sharing the last level cache with this cpu
+                int m_package;
+                int m_numaNode;
+            };
+
+            AZStd::vector<CpuInfo> m_cpus;
+        };
+    }
+}
+
+#endif
+#pragma once
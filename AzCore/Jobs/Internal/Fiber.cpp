@@ -0,0 +1,176 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZ_UNITY_BUILD
+
+#include <AzCore/Jobs/Internal/Fiber.h>
+
+#if defined(AZ_JOBS_FIBER_ASM_X64) || defined(AZ_JOBS_FIBER_UCONTEXT)
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+
+using namespace AZ;
+using namespace Internal;
+
+#if defined(AZ_JOBS_FIBER_ASM_X64)
+// System V x86-64 context switch. The caller saved registers are already spilled by the compiler at the call site,
+// so only rbx, rbp, r12-r15, the SSE control word and the x87 control word are kept on the stack of the fiber we leave.
+extern "C" void AzJobsFiberSwitch(void** fromStackPointer, void* toStackPointer);
+extern "C" void AzJobsFiberTrampoline();
+
+asm (
+    ".text\n"
+    ".p2align 4\n"
+    ".globl AzJobsFiberSwitch\n"
+    ".hidden AzJobsFiberSwitch\n"
+    ".type AzJobsFiberSwitch, @function\n"
+    "AzJobsFiberSwitch:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".size AzJobsFiberSwitch, .-AzJobsFiberSwitch\n"
+    "\n"
+    // first switch to a fiber returns here, r12 holds the user data and r13 the entry function
+    ".p2align 4\n"
+    ".globl AzJobsFiberTrampoline\n"
+    ".hidden AzJobsFiberTrampoline\n"
+    ".type AzJobsFiberTrampoline, @function\n"
+    "AzJobsFiberTrampoline:\n"
+    "    movq %r12, %rdi\n"
+    "    callq *%r13\n"
+    "    ud2\n"
+    ".size AzJobsFiberTrampoline, .-AzJobsFiberTrampoline\n"
+    );
+#endif // AZ_JOBS_FIBER_ASM_X64
+
+Fiber::Fiber()
+    : m_stack(nullptr)
+    , m_stackSize(0)
+    , m_entry(nullptr)
+    , m_userData(nullptr)
+{
+#if defined(AZ_JOBS_FIBER_ASM_X64)
+    m_stackPointer = nullptr;
+#endif
+}
+
+Fiber::~Fiber()
+{
+#if defined(AZ_JOBS_FIBER_ASM_X64) || defined(AZ_JOBS_FIBER_UCONTEXT)
+    if (m_stack)
+    {
+        munmap(m_stack, m_stackSize);
+    }
+#endif
+}
+
+bool Fiber::IsSupported()
+{
+#if defined(AZ_JOBS_FIBER_ASM_X64) || defined(AZ_JOBS_FIBER_UCONTEXT)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Fiber::Create(size_t stackSize, EntryFunction entry, void* userData)
+{
+    AZ_Assert(!m_stack, "Fiber was already created");
+    m_entry = entry;
+    m_userData = userData;
+#if defined(AZ_JOBS_FIBER_ASM_X64) || defined(AZ_JOBS_FIBER_UCONTEXT)
+    //the pages are only committed when touched, the lowest one is a guard page to catch stack overflows
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    stackSize = ((stackSize + pageSize - 1) / pageSize + 1) * pageSize;
+    void* stack = mmap(nullptr, stackSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (stack == MAP_FAILED)
+    {
+        return false;
+    }
+    mprotect(stack, pageSize, PROT_NONE);
+    m_stack = stack;
+    m_stackSize = stackSize;
+    Reset();
+    return true;
+#else
+    (void)stackSize;
+    return false;
+#endif
+}
+
+void Fiber::Reset()
+{
+    AZ_Assert(m_stack, "Fiber has no stack, it can't be reset");
+#if defined(AZ_JOBS_FIBER_ASM_X64)
+    //initial frame popped by AzJobsFiberSwitch: control words, r15, r14, r13 (entry), r12 (user data), rbx, rbp and
+    //the return address. The trampoline then runs with a 16 byte aligned stack, as required at a call.
+    AZ::u64* top = reinterpret_cast<AZ::u64*>((reinterpret_cast<uintptr_t>(m_stack) + m_stackSize) & ~static_cast<uintptr_t>(15));
+    AZ::u64* frame = top - 2 - 8;
+    frame[0] = 0x037F00001F80ull; //mxcsr 0x1F80 (all exceptions masked), x87 control word 0x037F
+    frame[1] = 0;
+    frame[2] = 0;
+    frame[3] = reinterpret_cast<AZ::u64>(m_entry);
+    frame[4] = reinterpret_cast<AZ::u64>(m_userData);
+    frame[5] = 0;
+    frame[6] = 0;
+    frame[7] = reinterpret_cast<AZ::u64>(&AzJobsFiberTrampoline);
+    m_stackPointer = frame;
+#elif defined(AZ_JOBS_FIBER_UCONTEXT)
+    getcontext(&m_context);
+    m_context.uc_stack.ss_sp = m_stack;
+    m_context.uc_stack.ss_size = m_stackSize;
+    m_context.uc_link = nullptr;
+    uintptr_t self = reinterpret_cast<uintptr_t>(this);
+    makecontext(&m_context, reinterpret_cast<void(*)()>(&Fiber::UContextEntry), 2, static_cast<unsigned int>(static_cast<AZ::u64>(self) >> 32), static_cast<unsigned int>(self));
+#endif
+}
+
+#if defined(AZ_JOBS_FIBER_UCONTEXT)
+void Fiber::UContextEntry(unsigned int fiberHigh, unsigned int fiberLow)
+{
+    Fiber* fiber = reinterpret_cast<Fiber*>(static_cast<uintptr_t>((static_cast<AZ::u64>(fiberHigh) << 32) | fiberLow));
+    fiber->m_entry(fiber->m_userData);
+}
+#endif
+
+void Fiber::Switch(Fiber& from, Fiber& to)
+{
+#if defined(AZ_JOBS_FIBER_ASM_X64)
+    AzJobsFiberSwitch(&from.m_stackPointer, to.m_stackPointer);
+#elif defined(AZ_JOBS_FIBER_UCONTEXT)
+    swapcontext(&from.m_context, &to.m_context);
+#else
+    (void)from;
+    (void)to;
+    AZ_Assert(false, "Fibers are not supported on this platform");
+#endif
+}
+
+#endif // #ifndef AZ_UNITY_BUILD
@@ -0,0 +1,80 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZCORE_JOBS_INTERNAL_FIBER_H
+#define AZCORE_JOBS_INTERNAL_FIBER_H 1
+
+#include <AzCore/base.h>
+
+#if defined(AZ_PLATFORM_LINUX) || defined(AZ_PLATFORM_ANDROID)
+#   if defined(__x86_64__)
+#       define AZ_JOBS_FIBER_ASM_X64
+#   elif defined(AZ_PLATFORM_LINUX)
+#       define AZ_JOBS_FIBER_UCONTEXT
+#       include <ucontext.h>
+#   endif
+#endif
+
+namespace AZ
+{
+    namespace Internal
+    {
+        /**
+         * Minimal stackful coroutine used by the JobManager to suspend jobs without nesting on the worker stack.
+         * Context switches are hand written on Linux x86-64 (only callee saved registers are swapped), other Linux
+         * platforms use ucontext. Fibers are not supported on other platforms, see IsSupported.
+         *
+         * A default constructed fiber has no stack, it's used to save the context of a thread when switching away from
+         * the thread's own stack.
+         */
+        class Fiber
+        {
+        public:
+            typedef void (*EntryFunction)(void* userData);
+
+            Fiber();
+            ~Fiber();
+
+            /// Allocates the stack (with a guard page below it), the fiber will call entry(userData) when first switched to. The entry must never return.
+            bool Create(size_t stackSize, EntryFunction entry, void* userData);
+
+            /// Rewinds the fiber so it calls the entry function again next time it's switched to. Must not be called on the running fiber.
+            void Reset();
+
+            /// Saves the current context into from and continues running to.
+            static void Switch(Fiber& from, Fiber& to);
+
+            static bool IsSupported();
+
+        private:
+            //non-copyable
+            Fiber(const Fiber&);
+            Fiber& operator=(const Fiber&);
+
+#if defined(AZ_JOBS_FIBER_UCONTEXT)
+            static void UContextEntry(unsigned int fiberHigh, unsigned int fiberLow);
+#endif
+
+            void* m_stack;
+            size_t m_stackSize;
+            EntryFunction m_entry;
+            void* m_userData;
+#if defined(AZ_JOBS_FIBER_ASM_X64)
+            void* m_stackPointer;
+#elif defined(AZ_JOBS_FIBER_UCONTEXT)
+            ucontext_t m_context;
+#endif
+        };
+    }
+}
+
+#endif
+#pragma once
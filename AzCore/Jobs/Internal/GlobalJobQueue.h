@@ -0,0 +1,124 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZCORE_JOBS_INTERNAL_GLOBALJOBQUEUE_H
+#define AZCORE_JOBS_INTERNAL_GLOBALJOBQUEUE_H 1
+
+#include <AzCore/Memory/SystemAllocator.h>
+#include <AzCore/std/parallel/containers/lock_free_bounded_queue.h>
+#include <AzCore/std/parallel/spin_mutex.h>
+#include <AzCore/std/parallel/lock.h>
+#include <AzCore/std/containers/deque.h>
+
+namespace AZ
+{
+    class Job;
+
+    namespace Internal
+    {
+        /**
+         * Queue for the jobs added by non-worker threads. Jobs go to a lock-free bounded ring, so producers don't
+         * contend on a lock. If the ring is full jobs spill to an overflow queue protected by a lock, which is only
+         * checked by consumers when it's not empty. While it's not empty every other pop takes from the overflow first,
+         * so a ring kept full by many producers can't starve the spilled jobs. The order of jobs is not strictly FIFO
+         * once the ring overflows.
+         */
+        class GlobalJobQueue
+        {
+        public:
+            AZ_CLASS_ALLOCATOR(GlobalJobQueue, SystemAllocator, 0)
+
+            GlobalJobQueue(unsigned int capacity)
+                : m_ring(capacity)
+                , m_numOverflowJobs(0)
+                , m_numOverflowPops(0)
+            {
+            }
+
+            void Push(Job* job)
+            {
+                Push(&job, 1);
+            }
+
+            void Push(Job** jobs, size_t numJobs)
+            {
+                size_t numPushed = m_ring.push(jobs, numJobs);
+                if (numPushed < numJobs)
+                {
+                    AZStd::lock_guard<AZStd::spin_mutex> lock(m_overflowMutex);
+                    for (size_t i = numPushed; i < numJobs; ++i)
+                    {
+                        m_overflow.push_back(jobs[i]);
+                    }
+                    m_numOverflowJobs.store(static_cast<unsigned int>(m_overflow.size()), AZStd::memory_order_release);
+                }
+            }
+
+            bool Pop(Job** job)
+            {
+                return Pop(job, 1) == 1;
+            }
+
+            /// Pops up to maxJobs jobs, returns the number of jobs popped.
+            size_t Pop(Job** jobs, size_t maxJobs)
+            {
+                size_t numPopped = 0;
+                bool isOverflow = m_numOverflowJobs.load(AZStd::memory_order_acquire) != 0;
+                if (isOverflow && (m_numOverflowPops.fetch_add(1, AZStd::memory_order_relaxed) & 1))
+                {
+                    numPopped = PopOverflow(jobs, maxJobs);
+                }
+                if (numPopped == 0)
+                {
+                    numPopped = m_ring.pop(jobs, maxJobs);
+                }
+                if (numPopped == 0 && isOverflow)
+                {
+                    numPopped = PopOverflow(jobs, maxJobs);
+                }
+                return numPopped;
+            }
+
+            /// Only a hint when other threads are using the queue.
+            bool IsEmpty() const
+            {
+                return m_ring.empty() && m_numOverflowJobs.load(AZStd::memory_order_acquire) == 0;
+            }
+
+        private:
+            size_t PopOverflow(Job** jobs, size_t maxJobs)
+            {
+                size_t numPopped = 0;
+                AZStd::lock_guard<AZStd::spin_mutex> lock(m_overflowMutex);
+                while (numPopped < maxJobs && !m_overflow.empty())
+                {
+                    jobs[numPopped++] = m_overflow.front();
+                    m_overflow.pop_front();
+                }
+                m_numOverflowJobs.store(static_cast<unsigned int>(m_overflow.size()), AZStd::memory_order_release);
+                return numPopped;
+            }
+
+            //non-copyable
+            GlobalJobQueue(const GlobalJobQueue&);
+            GlobalJobQueue& operator=(const GlobalJobQueue&);
+
+            AZStd::lock_free_bounded_queue<Job*> m_ring;
+            AZStd::atomic<unsigned int> m_numOverflowJobs;
+            AZStd::atomic<unsigned int> m_numOverflowPops;  ///< Pops while the overflow is not empty, odd ones take from it first.
+            AZStd::spin_mutex m_overflowMutex;
+            AZStd::deque<Job*> m_overflow;
+        };
+    }
+}
+
+#endif
+#pragma once
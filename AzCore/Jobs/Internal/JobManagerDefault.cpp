@@ -28,12 +28,16 @@ using namespace AZ;
 using namespace Internal;
 
 JobManagerDefault::JobManagerDefault()
+    : m_jobQueue(JobManagerDesc().m_globalQueueCapacity)
+    , m_numWaitingThreads(0)
 {
     m_isKillingThreads = false;
     m_isAsynchronous = false;
 }
 
 JobManagerDefault::JobManagerDefault(const JobManagerDesc& desc)
+    : m_jobQueue(desc.m_globalQueueCapacity)
+    , m_numWaitingThreads(0)
 {
     m_isKillingThreads = false;
 
@@ -56,25 +60,36 @@ void JobManagerDefault::AddPendingJob(Job* job)
 {
     AZ_Assert(job->GetDependentCount() == 0, ("Job has a non-zero ready count, it should not be being added yet"));
 
+    m_jobQueue.Push(job);
+
     if (IsAsynchronous())
     {
-        //lock and push the job onto the queue
-        AZStd::lock_guard<AZStd::mutex> lock(m_queueMutex);
-        m_jobQueue.push(job);
-
         //wake up a worker thread to process the job
-        m_condVar.notify_one(); //notify can only be called while holding the mutex
+        WakeWaitingThreads(1);
     }
     else
     {
+        //no workers, so must process the jobs right now
+        ThreadInfo* info = GetCurrentThreadInfo();
+        if (!info->m_currentJob)  //unless we're already processing
         {
-            AZStd::lock_guard<AZStd::mutex> lock(m_queueMutex);
-            m_jobQueue.push(job);
+            ProcessJobsSynchronous(info, NULL, NULL);
         }
+    }
+}
 
-        //no workers, so must process the jobs right now
+void JobManagerDefault::AddPendingJobs(Job** jobs, size_t numJobs)
+{
+    m_jobQueue.Push(jobs, numJobs);
+
+    if (IsAsynchronous())
+    {
+        WakeWaitingThreads(numJobs);
+    }
+    else
+    {
         ThreadInfo* info = GetCurrentThreadInfo();
-        if (!info->m_currentJob)  //unless we're already processing
+        if (!info->m_currentJob)
         {
             ProcessJobsSynchronous(info, NULL, NULL);
         }
@@ -157,38 +172,36 @@ void JobManagerDefault::ProcessJobsInternal(ThreadInfo* info, Job* suspendedJob,
 
     while (true)
     {
+        if ((suspendedJob && (suspendedJob->GetDependentCount() == 0)) ||
+            (notifyFlag && notifyFlag->load(AZStd::memory_order_acquire)))
+        {
+            return;
+        }
+
         //pop a job from the queue, blocking until one is available
         Job* job;
+        if (!m_jobQueue.Pop(&job))
         {
             AZStd::unique_lock<AZStd::mutex> lock(m_queueMutex);
 
-            //we must check this before blocking, and while we have acquired the lock, to ensure we don't miss a
-            //notification
-            if ((suspendedJob && (suspendedJob->GetDependentCount() == 0)) ||
-                (notifyFlag && notifyFlag->load(AZStd::memory_order_acquire)))
+            //register as waiting before checking again, a job pushed after we checked the queue only signals the
+            //condition variable if the pusher can see us waiting. The ready checks are done while we have acquired the
+            //lock, to ensure we don't miss a notification.
+            m_numWaitingThreads.fetch_add(1, AZStd::memory_order_seq_cst);
+            AZStd::atomic_thread_fence(AZStd::memory_order_seq_cst);
+            bool isReady = (suspendedJob && (suspendedJob->GetDependentCount() == 0)) ||
+                (notifyFlag && notifyFlag->load(AZStd::memory_order_acquire));
+            if (!isReady && !m_isKillingThreads && m_jobQueue.IsEmpty())
             {
-                return;
+                m_condVar.wait(lock);
             }
+            m_numWaitingThreads.fetch_sub(1, AZStd::memory_order_relaxed);
 
-            while (m_jobQueue.empty())
+            if (m_isKillingThreads && m_jobQueue.IsEmpty())
             {
-                m_condVar.wait(lock);
-
-                //check if wakeup was due to suspended job being ready
-                if ((suspendedJob && (suspendedJob->GetDependentCount() == 0)) ||
-                    (notifyFlag && notifyFlag->load(AZStd::memory_order_acquire)))
-                {
-                    return;
-                }
-
-                if (m_isKillingThreads)
-                {
-                    return;
-                }
+                return;
             }
-
-            job = m_jobQueue.front();
-            m_jobQueue.pop();
+            continue;
         }
 
         info->m_currentJob = job;
@@ -201,11 +214,9 @@ void JobManagerDefault::ProcessJobsInternal(ThreadInfo* info, Job* suspendedJob,
 
 void JobManagerDefault::ProcessJobsSynchronous(ThreadInfo* info, Job* suspendedJob, AZStd::atomic<bool>* notifyFlag)
 {
-    while (!m_jobQueue.empty())
+    Job* job;
+    while (m_jobQueue.Pop(&job))
     {
-        Job* job = m_jobQueue.front();
-        m_jobQueue.pop();
-
         info->m_currentJob = job;
         Process(job);
         info->m_currentJob = NULL;
@@ -221,6 +232,29 @@ void JobManagerDefault::ProcessJobsSynchronous(ThreadInfo* info, Job* suspendedJ
     }
 }
 
+void JobManagerDefault::WakeWaitingThreads(size_t numJobs)
+{
+    //orders the push with the waiting count, pairs with the fence in ProcessJobsInternal
+    AZStd::atomic_thread_fence(AZStd::memory_order_seq_cst);
+    unsigned int numWaiting = m_numWaitingThreads.load(AZStd::memory_order_relaxed);
+    if (numWaiting > 0)
+    {
+        //wake at most one thread per job, notify can only be called while holding the mutex
+        AZStd::lock_guard<AZStd::mutex> lock(m_queueMutex);
+        if (numJobs >= numWaiting)
+        {
+            m_condVar.notify_all();
+        }
+        else
+        {
+            for (size_t i = 0; i < numJobs; ++i)
+            {
+                m_condVar.notify_one();
+            }
+        }
+    }
+}
+
 JobManagerDefault::ThreadInfo* JobManagerDefault::GetCurrentThreadInfo()
 {
     //we could use tls to speed this up, but it's not available on all platforms
@@ -251,6 +285,7 @@ void JobManagerDefault::AddThread(const JobManagerThreadDesc& desc)
     AZStd::thread_desc threadDesc;
     threadDesc.m_name = "AZ JobManager worker thread";
     threadDesc.m_cpuId = desc.m_cpuId;
+    threadDesc.m_cpuMask = desc.m_cpuMask;
     threadDesc.m_priority = desc.m_priority;
     if (desc.m_stackSize != 0)
     {
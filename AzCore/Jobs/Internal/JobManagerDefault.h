@@ -17,12 +17,14 @@
 #if defined(AZCORE_JOBS_IMPL_DEFAULT)
 
 #include <AzCore/Jobs/Internal/JobManagerBase.h>
+#include <AzCore/Jobs/Internal/GlobalJobQueue.h>
+#include <AzCore/Jobs/Internal/JobTrace.h>
 #include <AzCore/Jobs/JobManagerDesc.h>
 #include <AzCore/Memory/PoolAllocator.h>
 
+#include <AzCore/std/containers/vector.h>
 #include <AzCore/std/parallel/mutex.h>
 #include <AzCore/std/parallel/conditional_variable.h>
-#include <AzCore/std/containers/queue.h>
 #include <AzCore/std/parallel/atomic.h>
 #include <AzCore/std/parallel/thread.h>
 
@@ -33,7 +35,8 @@ namespace AZ
     namespace Internal
     {
         /**
-         * A reference implementation of a job manager, uses only locks and condition variables.
+         * A reference implementation of a job manager. Jobs are pushed to a lock-free queue shared by all threads,
+         * idle threads wait on a condition variable, which is only signaled when somebody is waiting.
          */
         class JobManagerDefault
             : public JobManagerBase
@@ -47,6 +50,8 @@ namespace AZ
 
             void AddPendingJob(Job* job);
 
+            void AddPendingJobs(Job** jobs, size_t numJobs);
+
             void SuspendJobUntilReady(Job* job);
 
             void NotifySuspendedJobReady(Job* job);
@@ -58,6 +63,10 @@ namespace AZ
 
             void CollectGarbage() { }
 
+            void SetTracingEnabled(bool) { }
+            bool IsTracingEnabled() const { return false; }
+            void WriteChromeTrace(AZStd::string& output) { JobTraceWriter(output, 0, 0).Finish(); }
+
             Job* GetCurrentJob();
 
             unsigned int GetNumWorkerThreads() const
@@ -65,12 +74,13 @@ namespace AZ
                 return static_cast<unsigned int>(m_threads.size());
             }
 
-        protected:
-            typedef AZStd::queue<Job*, AZStd::deque<Job*> > JobQueue;
+            bool IsLocalQueueEmpty() const { return m_jobQueue.IsEmpty(); } //all threads share one queue
 
-            JobQueue m_jobQueue;
-            AZStd::mutex m_queueMutex;
+        protected:
+            GlobalJobQueue m_jobQueue;
+            AZStd::mutex m_queueMutex; //only used to wait on the condition variable
             AZStd::condition_variable m_condVar;
+            AZStd::atomic<unsigned int> m_numWaitingThreads; //threads blocked on the condition variable, or about to be
 
             struct ThreadInfo
             {
@@ -86,6 +96,7 @@ namespace AZ
             void ProcessJobsAssist(ThreadInfo* info, Job* suspendedJob, AZStd::atomic<bool>* notifyFlag);
             void ProcessJobsInternal(ThreadInfo* info, Job* suspendedJob, AZStd::atomic<bool>* notifyFlag);
             void ProcessJobsSynchronous(ThreadInfo* info, Job* suspendedJob, AZStd::atomic<bool>* notifyFlag);
+            void WakeWaitingThreads(size_t numJobs);
             void AddThread(const JobManagerThreadDesc& desc);
             void KillThreads();
             ThreadInfo* GetCurrentThreadInfo();
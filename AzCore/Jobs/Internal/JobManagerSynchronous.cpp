@@ -44,6 +44,21 @@ void JobManagerSynchronous::AddPendingJob(Job* job)
     }
 }
 
+void JobManagerSynchronous::AddPendingJobs(Job** jobs, size_t numJobs)
+{
+    for (size_t i = 0; i < numJobs; ++i)
+    {
+        AZ_Assert(jobs[i]->GetDependentCount() == 0, ("Job has a non-zero ready count, it should not be being added yet"));
+        m_jobQueue.push(jobs[i]);
+    }
+
+    //no workers, so must process the jobs right now
+    if (!m_currentJob)  //unless we're already processing
+    {
+        ProcessJobs(NULL);
+    }
+}
+
 void JobManagerSynchronous::SuspendJobUntilReady(Job* job)
 {
     AZ_Assert(m_currentJob == job, ("Can't suspend a job which isn't currently running"));
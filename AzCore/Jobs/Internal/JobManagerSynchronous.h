@@ -16,6 +16,7 @@
 #if defined(AZCORE_JOBS_IMPL_SYNCHRONOUS)
 
 #include <AzCore/Jobs/Internal/JobManagerBase.h>
+#include <AzCore/Jobs/Internal/JobTrace.h>
 #include <AzCore/Jobs/JobManagerDesc.h>
 #include <AzCore/Memory/PoolAllocator.h>
 
@@ -43,6 +44,8 @@ namespace AZ
 
             void AddPendingJob(Job* job);
 
+            void AddPendingJobs(Job** jobs, size_t numJobs);
+
             void SuspendJobUntilReady(Job* job);
 
             void NotifySuspendedJobReady(Job* job);
@@ -54,10 +57,16 @@ namespace AZ
 
             void CollectGarbage() { }
 
+            void SetTracingEnabled(bool) { }
+            bool IsTracingEnabled() const { return false; }
+            void WriteChromeTrace(AZStd::string& output) { JobTraceWriter(output, 0, 0).Finish(); }
+
             Job* GetCurrentJob() { return m_currentJob; }
 
             unsigned int GetNumWorkerThreads() const { return 1; }
 
+            bool IsLocalQueueEmpty() const { return false; } //jobs run immediately, splitting work would only add overhead
+
         private:
             typedef AZStd::queue<Job*> JobQueue;
 
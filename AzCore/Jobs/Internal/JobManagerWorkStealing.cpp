@@ -17,9 +17,11 @@
 
 #include <AzCore/Jobs/Job.h>
 #include <AzCore/Jobs/Internal/JobNotify.h>
+#include <AzCore/Jobs/Internal/CpuTopology.h>
 
 #include <AzCore/std/parallel/thread.h>
 #include <AzCore/std/parallel/lock.h>
+#include <AzCore/std/parallel/exponential_backoff.h>
 #include <AzCore/std/functional.h>
 
 #ifdef JOBMANAGER_ENABLE_STATS
@@ -39,16 +41,43 @@ JobManagerWorkStealing::JobManagerWorkStealing(const JobManagerDesc& desc)
     m_isQuit = false;
 
     m_numAvailableWorkers = 0;
+    m_numSpinningWorkers = 0;
+
+    m_idleSpinCount = desc.m_idleSpinCount;
+    m_maxSpinningWorkers = desc.m_maxSpinningWorkers;
+    m_priorityStarvationLimit = desc.m_priorityStarvationLimit;
+
+    for (unsigned int priority = 0; priority < JOB_PRIORITY_COUNT; ++priority)
+    {
+        m_globalJobQueues[priority] = aznew GlobalJobQueue(desc.m_globalQueueCapacity);
+    }
 
     //need to set this first, before creating threads, which will check it
     m_isAsynchronous = (desc.m_workerThreads.size() > 0);
 
+    m_useFibers = desc.m_useFibers && m_isAsynchronous && Fiber::IsSupported();
+    m_fiberStackSize = desc.m_fiberStackSize;
+    m_freeFibers = nullptr;
+    for (unsigned int i = 0; i < NUM_SUSPENDED_BUCKETS; ++i)
+    {
+        m_suspendedFibers[i] = nullptr;
+    }
+    m_readyFibersHead = nullptr;
+    m_readyFibersTail = nullptr;
+
+    m_isTracing = false;
+    m_traceBufferSize = desc.m_traceBufferSize;
+    m_traceStartTime = 0;
+    m_traceStartTicks = 0;
+
     // Create all worker threads.
     for (unsigned int iThread = 0; iThread < desc.m_workerThreads.size(); ++iThread)
     {
         AddThread(desc.m_workerThreads[iThread]);
     }
 
+    InitVictims();
+
     //allow workers to begin processing after they have all been created, needed to wait since they may access each
     //others queues
     m_initSemaphore.release(static_cast<unsigned int>(desc.m_workerThreads.size()));
@@ -57,6 +86,11 @@ JobManagerWorkStealing::JobManagerWorkStealing(const JobManagerDesc& desc)
 JobManagerWorkStealing::~JobManagerWorkStealing()
 {
     KillThreads();
+
+    for (unsigned int priority = 0; priority < JOB_PRIORITY_COUNT; ++priority)
+    {
+        delete m_globalJobQueues[priority];
+    }
 }
 
 void JobManagerWorkStealing::AddPendingJob(Job* job)
@@ -67,7 +101,7 @@ void JobManagerWorkStealing::AddPendingJob(Job* job)
     if (info && info->m_isWorker)
     {
         //current thread is a worker, push to the local queue
-        info->m_pendingJobs.local_push_bottom(job);
+        info->m_pendingJobs[job->GetPriority()].local_push_bottom(job);
 #ifdef JOBMANAGER_ENABLE_STATS
         ++info->m_jobsForked;
 #endif
@@ -77,10 +111,7 @@ void JobManagerWorkStealing::AddPendingJob(Job* job)
     else
     {
         //current thread is not a worker thread, push to the global queue
-        {
-            AZStd::lock_guard<GlobalQueueMutexType> lock(m_globalJobQueueMutex);
-            m_globalJobQueue.push(job);
-        }
+        m_globalJobQueues[job->GetPriority()]->Push(job);
         if (IsAsynchronous())
         {
             ActivateWorker();
@@ -96,31 +127,113 @@ void JobManagerWorkStealing::AddPendingJob(Job* job)
     }
 }
 
+void JobManagerWorkStealing::AddPendingJobs(Job** jobs, size_t numJobs)
+{
+    ThreadInfo* info = m_currentThreadInfo;
+    bool isWorker = info && info->m_isWorker;
+
+    //push runs of jobs with the same priority at once, usually that's the whole batch
+    size_t runStart = 0;
+    while (runStart < numJobs)
+    {
+        JobPriority priority = jobs[runStart]->GetPriority();
+        size_t runEnd = runStart + 1;
+        while (runEnd < numJobs && jobs[runEnd]->GetPriority() == priority)
+        {
+            ++runEnd;
+        }
+        if (isWorker)
+        {
+            info->m_pendingJobs[priority].local_push_bottom(jobs + runStart, static_cast<unsigned int>(runEnd - runStart));
+        }
+        else
+        {
+            m_globalJobQueues[priority]->Push(jobs + runStart, runEnd - runStart);
+        }
+        runStart = runEnd;
+    }
+
+    if (isWorker)
+    {
+#ifdef JOBMANAGER_ENABLE_STATS
+        info->m_jobsForked += static_cast<unsigned int>(numJobs);
+#endif
+        ActivateWorkers(static_cast<unsigned int>(numJobs));
+    }
+    else if (IsAsynchronous())
+    {
+        ActivateWorkers(static_cast<unsigned int>(numJobs));
+    }
+    else if (!m_currentThreadInfo)
+    {
+        //no workers, so must process the jobs right now, unless we're already processing
+        ProcessJobsSynchronous(GetCurrentThreadInfo(), NULL, NULL);
+    }
+}
+
 void JobManagerWorkStealing::SuspendJobUntilReady(Job* job)
 {
     ThreadInfo* info = GetCurrentThreadInfo();
     AZ_Assert(info->m_currentJob == job, ("Can't suspend a job which isn't currently running"));
 
     info->m_currentJob = NULL; //clear current job
+    Trace(info, JOB_TRACE_SUSPEND, job);
 
-    if (IsAsynchronous())
+    //on a fiber we switch away until the job is ready, otherwise we process other jobs nested on this stack
+    bool isFiberSuspended = m_useFibers && info->m_currentFiber && SuspendFiber(info, job);
+    if (!isFiberSuspended)
     {
-        ProcessJobsAssist(info, job, NULL);
+        if (IsAsynchronous())
+        {
+            ProcessJobsAssist(info, job, NULL);
+        }
+        else
+        {
+            ProcessJobsSynchronous(info, job, NULL);
+        }
     }
-    else
+
+    if (m_useFibers)
     {
-        ProcessJobsSynchronous(info, job, NULL);
+        //we may have been resumed by another worker, even when waiting nested (a nested job can wait on a fiber)
+        info = GetWorkerThreadInfo();
     }
-
+    Trace(info, JOB_TRACE_RESUME, job);
     info->m_currentJob = job; //restore current job
 }
 
 void JobManagerWorkStealing::NotifySuspendedJobReady(Job* job)
 {
-    (void)job;
-    //Nothing to do here, a thread which has a suspended job waiting will not go to sleep, so we don't need to send
-    //any wake up events or anything. This means is possible for a thread to spin while waiting for a child to
-    //complete if there are no other jobs available, but this should be fairly rare.
+    //Without fibers there is nothing to do here, a thread which has a suspended job waiting will not go to sleep, so
+    //we don't need to send any wake up events or anything. This means is possible for a thread to spin while waiting
+    //for a child to complete if there are no other jobs available, but this should be fairly rare.
+    if (!m_useFibers)
+    {
+        return;
+    }
+
+    //find the fiber waiting for this job, it's not there if the job waited nested or on a non-worker
+    FiberInfo* fiber = nullptr;
+    {
+        AZStd::lock_guard<AZStd::spin_mutex> lock(m_fiberMutex);
+        FiberInfo** link = &m_suspendedFibers[(reinterpret_cast<size_t>(job) >> 4) % NUM_SUSPENDED_BUCKETS];
+        while (*link)
+        {
+            if ((*link)->m_suspendedJob == job)
+            {
+                fiber = *link;
+                *link = fiber->m_next;
+                break;
+            }
+            link = &(*link)->m_next;
+        }
+    }
+
+    //the suspending worker may still be on the fiber stack, the last one through the gate makes it ready
+    if (fiber && fiber->m_resumeGate.fetch_add(1, AZStd::memory_order_acq_rel) == 1)
+    {
+        PushReadyFiber(fiber);
+    }
 }
 
 void JobManagerWorkStealing::StartJobAndAssistUntilComplete(Job* job)
@@ -161,6 +274,9 @@ void JobManagerWorkStealing::ClearStats()
         info->m_jobsForked = 0;
         info->m_jobsDone = 0;
         info->m_jobsStolen = 0;
+        info->m_spins = 0;
+        info->m_spinHits = 0;
+        info->m_parks = 0;
         info->m_jobTime = 0;
         info->m_stealTime = 0;
     }
@@ -173,21 +289,51 @@ void JobManagerWorkStealing::PrintStats()
     char str[256];
     OutputDebugString("===================================================\n");
     OutputDebugString("Job System Stats:\n");
-    OutputDebugString("Thread   Global jobs    Forks/dependents   Jobs done   Jobs stolen    Job time (ms)  Steal time (ms)  Total time (ms)\n");
-    OutputDebugString("------   -------------  -----------------  ----------  ------------   -------------  ---------------  ---------------\n");
+    OutputDebugString("Thread   Global jobs    Forks/dependents   Jobs done   Jobs stolen    Spins (hits)     Parks     Job time (ms)  Steal time (ms)  Total time (ms)\n");
+    OutputDebugString("------   -------------  -----------------  ----------  ------------   ---------------  --------  -------------  ---------------  ---------------\n");
     for (unsigned int i = 0; i < m_threads.size(); ++i)
     {
         ThreadInfo* info = m_threads[i];
         double jobTime = 1000.0f * static_cast<double>(info->m_jobTime) / AZStd::GetTimeTicksPerSecond();
         double stealTime = 1000.0f * static_cast<double>(info->m_stealTime) / AZStd::GetTimeTicksPerSecond();
-        azsnprintf(str, AZ_ARRAY_SIZE(str),  " %d:        %5d          %5d           %5d         %5d            %3.2f           %3.2f         %3.2f\n",
-            i, info->m_globalJobs, info->m_jobsForked, info->m_jobsDone, info->m_jobsStolen, jobTime, stealTime, jobTime + stealTime);
+        azsnprintf(str, AZ_ARRAY_SIZE(str),  " %d:        %5d          %5d           %5d         %5d        %5d (%5d)     %5d        %3.2f           %3.2f         %3.2f\n",
+            i, info->m_globalJobs, info->m_jobsForked, info->m_jobsDone, info->m_jobsStolen, info->m_spins, info->m_spinHits, info->m_parks,
+            jobTime, stealTime, jobTime + stealTime);
         OutputDebugString(str);
         printf(str);
     }
 #endif
 }
 
+void JobManagerWorkStealing::SetTracingEnabled(bool isEnabled)
+{
+    if (isEnabled && !m_isTracing.load(AZStd::memory_order_acquire))
+    {
+        //a new capture, drop the events of the previous one
+        AZStd::lock_guard<AZStd::mutex> lock(m_threadsMutex);
+        for (unsigned int i = 0; i < m_threads.size(); ++i)
+        {
+            m_threads[i]->m_trace.Clear();
+        }
+        m_traceStartTime = GetJobTraceTime();
+        m_traceStartTicks = AZStd::GetTimeNowTicks();
+    }
+    m_isTracing.store(isEnabled, AZStd::memory_order_release);
+}
+
+void JobManagerWorkStealing::WriteChromeTrace(AZStd::string& output)
+{
+    JobTraceWriter writer(output, m_traceStartTime, m_traceStartTicks);
+    {
+        AZStd::lock_guard<AZStd::mutex> lock(m_threadsMutex);
+        for (unsigned int i = 0; i < m_threads.size(); ++i)
+        {
+            writer.WriteThread(i, m_threads[i]->m_isWorker, m_threads[i]->m_trace);
+        }
+    }
+    writer.Finish();
+}
+
 void JobManagerWorkStealing::CollectGarbage()
 {
     //spin until all worker threads are sleeping, that's the only safe time to collect the garbage
@@ -197,7 +343,10 @@ void JobManagerWorkStealing::CollectGarbage()
 
     for (unsigned int i = 0; i < m_workerThreads.size(); ++i)
     {
-        m_workerThreads[i]->m_pendingJobs.collect_garbage();
+        for (unsigned int priority = 0; priority < JOB_PRIORITY_COUNT; ++priority)
+        {
+            m_workerThreads[i]->m_pendingJobs[priority].collect_garbage();
+        }
     }
 }
 
@@ -209,7 +358,17 @@ void JobManagerWorkStealing::ProcessJobsWorker(ThreadInfo* info)
     //setup thread-local storage
     m_currentThreadInfo = info;
 
-    ProcessJobsInternal(info, NULL, NULL);
+    FiberInfo* fiber = m_useFibers ? AcquireFiber() : nullptr;
+    if (fiber)
+    {
+        //process the jobs on a pool fiber, the last fiber running on this thread switches back here when quitting
+        info->m_currentFiber = fiber;
+        Fiber::Switch(info->m_threadFiber, fiber->m_fiber);
+    }
+    else
+    {
+        ProcessJobsInternal(info, NULL, NULL);
+    }
 
     m_currentThreadInfo = NULL;
 }
@@ -221,15 +380,16 @@ void JobManagerWorkStealing::ProcessJobsAssist(ThreadInfo* info, Job* suspendedJ
 
     ProcessJobsInternal(info, suspendedJob, notifyFlag);
 
-    m_currentThreadInfo = oldInfo; //restore previous ThreadInfo, necessary as must be NULL when returning to user code
+    if (!info->m_isWorker)
+    {
+        m_currentThreadInfo = oldInfo; //restore previous ThreadInfo, necessary as must be NULL when returning to user code
+    }
 }
 
 void JobManagerWorkStealing::ProcessJobsInternal(ThreadInfo* info, Job* suspendedJob, AZStd::atomic<bool>* notifyFlag)
 {
     AZ_Assert(IsAsynchronous(), "ProcessJobs is only to be used when we have worker threads (can be called on non-workers too though)");
 
-    //get thread local job queue
-    WorkQueue* pendingJobs = info->m_isWorker ? &info->m_pendingJobs : NULL;
     unsigned int victim = 0;
 
     while (true)
@@ -241,27 +401,35 @@ void JobManagerWorkStealing::ProcessJobsInternal(ThreadInfo* info, Job* suspende
             return;
         }
 
+        //resuming a fiber comes first, it finishes work which is already in progress. This switches away for good, only
+        //the top level loop of a fiber can do it, not a nested one which has a suspended job on the stack.
+        if (HasReadyFibers() && info->m_currentFiber && !suspendedJob && !notifyFlag)
+        {
+            ResumeReadyFiber(info);
+        }
+
         //Try to get initial job.
         Job* job = NULL;
         {
-            //only sleep if this thread is a worker and does not have a suspended job
-            if (info->m_isWorker && !suspendedJob && m_globalJobQueue.empty())
+            //only idle if this thread is a worker and does not have a suspended job
+            if (info->m_isWorker && !suspendedJob && IsGlobalQueueEmpty() && !HasReadyFibers())
             {
                 if (m_isQuit)
                 {
                     return;
                 }
 
-                bool wasAvailable = info->m_isAvailable.exchange(true, AZStd::memory_order_acq_rel);
-                (void)wasAvailable;
-                AZ_Assert(!wasAvailable, "available flag should have been false as we are processing jobs!");
-
-                //going to sleep, increment the sleep counter. This is not synchronized properly, but it doesn't have to be
-                // since we are only using it as a guess to optimize some stuff
-                m_numAvailableWorkers.fetch_add(1, AZStd::memory_order_acq_rel);
-
-                //block, quit thread if we get a kill event
-                info->m_waitEvent.acquire();
+                //a fiber which just took over from a suspended one starts here, the children of the suspended job are
+                // still on our local queue and nobody else may be around to steal them
+                if (!PopLocalJob(info, &job))
+                {
+                    //spin for a while first, if nothing shows up go to sleep
+                    job = SpinForJob(info, victim);
+                }
+                if (!job && IsGlobalQueueEmpty() && !HasReadyFibers())
+                {
+                    ParkWorker(info);
+                }
 
                 if (m_isQuit)
                 {
@@ -270,32 +438,24 @@ void JobManagerWorkStealing::ProcessJobsInternal(ThreadInfo* info, Job* suspende
             }
 
             //check if suspended job is ready, before we try to get a new job
-            if ((suspendedJob && (suspendedJob->GetDependentCount() == 0)) ||
-                (notifyFlag && notifyFlag->load(AZStd::memory_order_acquire)))
+            if (!job && ((suspendedJob && (suspendedJob->GetDependentCount() == 0)) ||
+                (notifyFlag && notifyFlag->load(AZStd::memory_order_acquire))))
             {
                 return;
             }
 
+            if (!job && PopGlobalJob(info, &job))
             {
-                AZStd::lock_guard<GlobalQueueMutexType> lock(m_globalJobQueueMutex);
-                if (!m_globalJobQueue.empty())
-                {
-                    job = m_globalJobQueue.front();
-                    m_globalJobQueue.pop();
 #ifdef JOBMANAGER_ENABLE_STATS
-                    ++info->m_globalJobs;
+                ++info->m_globalJobs;
 #endif
-                }
             }
         }
 
         if (!job)
         {
             //nothing on the global queue, try to pop from the local queue
-            if (pendingJobs && !pendingJobs->local_pop_bottom(&job))
-            {
-                job = NULL;
-            }
+            PopLocalJob(info, &job);
         }
 
         bool isTerminated = false;
@@ -308,7 +468,14 @@ void JobManagerWorkStealing::ProcessJobsInternal(ThreadInfo* info, Job* suspende
             while (job)
             {
                 info->m_currentJob = job;
+                Trace(info, JOB_TRACE_BEGIN, job);
                 Process(job);
+                if (m_useFibers)
+                {
+                    //the job may have waited on a fiber and been resumed by another worker
+                    info = GetWorkerThreadInfo();
+                }
+                Trace(info, JOB_TRACE_END, job);
                 info->m_currentJob = NULL;
 
                 //...after calling Process we cannot use the job pointer again, the job has completed and may not exist anymore
@@ -322,16 +489,17 @@ void JobManagerWorkStealing::ProcessJobsInternal(ThreadInfo* info, Job* suspende
                     return;
                 }
 
+                if (HasReadyFibers() && info->m_currentFiber && !suspendedJob && !notifyFlag)
+                {
+                    ResumeReadyFiber(info);
+                }
+
                 //pop a new job from the local queue
-                if (pendingJobs && pendingJobs->local_pop_bottom(&job))
+                if (PopLocalJob(info, &job))
                 {
                     //not necessary, just an optimization - wakeup sleeping threads, there's work to be done
                     ActivateWorker();
                 }
-                else
-                {
-                    job = NULL;
-                }
             }
 
 #ifdef JOBMANAGER_ENABLE_STATS
@@ -351,33 +519,11 @@ void JobManagerWorkStealing::ProcessJobsInternal(ThreadInfo* info, Job* suspende
                     return;
                 }
 
-                //select a victim thread, using the same victim as the previous successful steal if possible
-                WorkQueue* victimQueue = &m_workerThreads[victim]->m_pendingJobs;
-
-                //attempt the steal
-                if (victimQueue->steal_top(&job))
+                if (StealJob(info, victim, &job))
                 {
                     //success, continue with the stolen job
-#ifdef JOBMANAGER_ENABLE_STATS
-                    ++info->m_jobsStolen;
-#endif
                     break;
                 }
-                else
-                {
-                    job = NULL;
-                }
-
-                //steal failed, choose a new victim for next time
-                ++victim;
-                if ((victim < m_workerThreads.size()) && (m_workerThreads[victim] == info))  //don't steal from ourselves
-                {
-                    ++victim;
-                }
-                if (victim >= m_workerThreads.size())
-                {
-                    victim = 0;
-                }
 
                 ++numStealAttempts;
                 if (numStealAttempts > maxStealAttempts)
@@ -385,8 +531,8 @@ void JobManagerWorkStealing::ProcessJobsInternal(ThreadInfo* info, Job* suspende
                     //Time to give up, it's likely all the local queues are empty. Note that this does not mean all the jobs
                     // are done, some jobs may be in progress, or we may have had terrible luck with our steals. There may be
                     // more jobs coming, another worker could create many new jobs right now. But the only way this thread
-                    // will get a new job is from the global queue or by a steal, so we're going to sleep until a new job is
-                    // queued.
+                    // will get a new job is from the global queue or by a steal, so we're going to spin for a bit and then
+                    // sleep until a new job is queued.
                     // The important thing to note is that all jobs will be processed, even if this thread goes to sleep while
                     // jobs are pending.
 
@@ -403,6 +549,256 @@ void JobManagerWorkStealing::ProcessJobsInternal(ThreadInfo* info, Job* suspende
     }
 }
 
+bool JobManagerWorkStealing::IsGlobalQueueEmpty() const
+{
+    for (unsigned int priority = 0; priority < JOB_PRIORITY_COUNT; ++priority)
+    {
+        if (!m_globalJobQueues[priority]->IsEmpty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool JobManagerWorkStealing::IsStealPossible(ThreadInfo* info) const
+{
+    for (size_t i = 0; i < info->m_victims.size(); ++i)
+    {
+        for (unsigned int priority = 0; priority < JOB_PRIORITY_COUNT; ++priority)
+        {
+            if (!info->m_victims[i]->m_pendingJobs[priority].empty())
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool JobManagerWorkStealing::IsLocalQueueEmpty() const
+{
+    ThreadInfo* info = m_currentThreadInfo;
+    if (info && info->m_isWorker)
+    {
+        for (unsigned int priority = 0; priority < JOB_PRIORITY_COUNT; ++priority)
+        {
+            if (!info->m_pendingJobs[priority].empty())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    //non-worker threads only take jobs from the global queue
+    return IsGlobalQueueEmpty();
+}
+
+bool JobManagerWorkStealing::IsLowPriorityFirst(ThreadInfo* info)
+{
+    //starvation protection, every so often pick the lowest priority job instead of the highest
+    if (m_priorityStarvationLimit == 0)
+    {
+        return false;
+    }
+    if (++info->m_numPicks < m_priorityStarvationLimit)
+    {
+        return false;
+    }
+    info->m_numPicks = 0;
+    return true;
+}
+
+bool JobManagerWorkStealing::PopGlobalJob(ThreadInfo* info, Job** job)
+{
+    bool isLowFirst = IsLowPriorityFirst(info);
+    for (unsigned int i = 0; i < JOB_PRIORITY_COUNT; ++i)
+    {
+        unsigned int priority = isLowFirst ? i : (JOB_PRIORITY_COUNT - 1 - i);
+        if (!info->m_isWorker)
+        {
+            //non-worker threads have no local queue to hold extra jobs
+            if (m_globalJobQueues[priority]->Pop(job))
+            {
+                return true;
+            }
+            continue;
+        }
+
+        //take a batch, we run the oldest job and move the others to our local queue so idle workers can steal them
+        Job* jobs[GLOBAL_POP_BATCH_SIZE];
+        size_t numJobs = m_globalJobQueues[priority]->Pop(jobs, GLOBAL_POP_BATCH_SIZE);
+        if (numJobs > 0)
+        {
+            for (size_t j = numJobs - 1; j > 0; --j)
+            {
+                info->m_pendingJobs[priority].local_push_bottom(jobs[j]);
+            }
+            if (numJobs > 1)
+            {
+                ActivateWorker();
+            }
+            *job = jobs[0];
+            return true;
+        }
+    }
+    *job = NULL;
+    return false;
+}
+
+bool JobManagerWorkStealing::PopGlobalJob(unsigned int priority, Job** job)
+{
+    return m_globalJobQueues[priority]->Pop(job);
+}
+
+bool JobManagerWorkStealing::PopLocalJob(ThreadInfo* info, Job** job)
+{
+    //take the best job from the local queue, unless a job with a higher priority is waiting on the global queue. The
+    //global queues of higher priorities are checked in the previous iterations, at the same priority our own (LIFO)
+    //jobs come first, as they are most likely to be in the cache. We peek at the global queue without the lock, it's
+    //only a hint.
+    bool isLowFirst = IsLowPriorityFirst(info);
+    for (unsigned int i = 0; i < JOB_PRIORITY_COUNT; ++i)
+    {
+        unsigned int priority = isLowFirst ? i : (JOB_PRIORITY_COUNT - 1 - i);
+        if (info->m_isWorker && info->m_pendingJobs[priority].local_pop_bottom(job))
+        {
+            return true;
+        }
+        if (!m_globalJobQueues[priority]->IsEmpty() && PopGlobalJob(priority, job))
+        {
+#ifdef JOBMANAGER_ENABLE_STATS
+            ++info->m_globalJobs;
+#endif
+            return true;
+        }
+    }
+    *job = NULL;
+    return false;
+}
+
+bool JobManagerWorkStealing::StealJob(ThreadInfo* info, unsigned int& victim, Job** job)
+{
+    if (info->m_victims.empty())
+    {
+        *job = NULL;
+        return false;
+    }
+
+    //select a victim thread, using the same victim as the previous successful steal if possible
+    ThreadInfo* victimInfo = info->m_victims[victim];
+
+    //attempt the steal, highest priority first
+    for (int priority = JOB_PRIORITY_COUNT - 1; priority >= 0; --priority)
+    {
+        if (victimInfo->m_pendingJobs[priority].steal_top(job))
+        {
+#ifdef JOBMANAGER_ENABLE_STATS
+            ++info->m_jobsStolen;
+#endif
+            Trace(info, JOB_TRACE_STEAL, *job, victimInfo->m_index);
+            return true;
+        }
+    }
+    *job = NULL;
+
+    //steal failed, choose a new victim for next time, the victims are sorted so we try the closest threads first
+    ++victim;
+    if (victim >= info->m_victims.size())
+    {
+        victim = 0;
+    }
+    return false;
+}
+
+Job* JobManagerWorkStealing::SpinForJob(ThreadInfo* info, unsigned int& victim)
+{
+    if (m_idleSpinCount == 0)
+    {
+        return NULL;
+    }
+
+    //claim a spot in the spin budget, there is no point in having all idle workers burn cpu
+    unsigned int numSpinning = m_numSpinningWorkers.load(AZStd::memory_order_acquire);
+    do
+    {
+        if (numSpinning >= m_maxSpinningWorkers)
+        {
+            return NULL;
+        }
+    } while (!m_numSpinningWorkers.compare_exchange_weak(numSpinning, numSpinning + 1, AZStd::memory_order_acq_rel, AZStd::memory_order_acquire));
+
+#ifdef JOBMANAGER_ENABLE_STATS
+    ++info->m_spins;
+#endif
+
+    Job* job = NULL;
+    bool isWorkFound = false;
+    AZStd::exponential_backoff backoff;
+    for (unsigned int i = 0; i < m_idleSpinCount && !m_isQuit; ++i)
+    {
+        if (!IsGlobalQueueEmpty() || HasReadyFibers() || StealJob(info, victim, &job))
+        {
+            isWorkFound = true;
+            break;
+        }
+        backoff.wait();
+    }
+
+    unsigned int oldNumSpinning = m_numSpinningWorkers.fetch_sub(1, AZStd::memory_order_acq_rel);
+    if (isWorkFound)
+    {
+#ifdef JOBMANAGER_ENABLE_STATS
+        ++info->m_spinHits;
+#endif
+        //while we were spinning other threads skipped waking up workers, if we were the last spinning thread hand the
+        //role over to a sleeping worker, there may be more jobs queued than we can handle
+        if (oldNumSpinning == 1)
+        {
+            ActivateWorker();
+        }
+    }
+    return job;
+}
+
+void JobManagerWorkStealing::ParkWorker(ThreadInfo* info)
+{
+    bool wasAvailable = info->m_isAvailable.exchange(true, AZStd::memory_order_acq_rel);
+    (void)wasAvailable;
+    AZ_Assert(!wasAvailable, "available flag should have been false as we are processing jobs!");
+
+    //going to sleep, increment the sleep counter so AddPendingJob knows there is somebody to wake up
+    m_numAvailableWorkers.fetch_add(1, AZStd::memory_order_seq_cst);
+
+    //a job may have been pushed after we checked the queues, but before the pusher could see us as available or saw
+    //us still counted as spinning. Check again after a full fence, which pairs with the fence in ActivateWorkers.
+    //That includes the victims' queues, a worker pushing there relies on us to steal. Ready fibers are queued under
+    //a lock, which orders us with the push.
+    AZStd::atomic_thread_fence(AZStd::memory_order_seq_cst);
+    bool isJobPending = !IsGlobalQueueEmpty() || IsStealPossible(info);
+    if (!isJobPending && m_useFibers)
+    {
+        AZStd::lock_guard<AZStd::spin_mutex> lock(m_readyFibersMutex);
+        isJobPending = HasReadyFibers();
+    }
+
+    if (isJobPending && info->m_isAvailable.exchange(false, AZStd::memory_order_acq_rel))
+    {
+        //nobody claimed us yet, withdraw and go process the job
+        m_numAvailableWorkers.fetch_sub(1, AZStd::memory_order_acq_rel);
+        return;
+    }
+
+#ifdef JOBMANAGER_ENABLE_STATS
+    ++info->m_parks;
+#endif
+
+    //block, quit thread if we get a kill event. If another thread already claimed us this returns right away.
+    Trace(info, JOB_TRACE_PARK, nullptr);
+    info->m_waitEvent.acquire();
+    Trace(info, JOB_TRACE_UNPARK, nullptr);
+}
+
 void JobManagerWorkStealing::ProcessJobsSynchronous(ThreadInfo* info, Job* suspendedJob, AZStd::atomic<bool>* notifyFlag)
 {
     AZ_Assert(!IsAsynchronous(), "ProcessJobsSynchronous should not be used when we have worker threads");
@@ -410,13 +806,13 @@ void JobManagerWorkStealing::ProcessJobsSynchronous(ThreadInfo* info, Job* suspe
     ThreadInfo* oldInfo = m_currentThreadInfo;
     m_currentThreadInfo = info;
 
-    while (!m_globalJobQueue.empty())
+    Job* job;
+    while (PopGlobalJob(info, &job))
     {
-        Job* job = m_globalJobQueue.front();
-        m_globalJobQueue.pop();
-
         info->m_currentJob = job;
+        Trace(info, JOB_TRACE_BEGIN, job);
         Process(job);
+        Trace(info, JOB_TRACE_END, job);
         info->m_currentJob = NULL;
 
         //...after calling Process we cannot use the job pointer again, the job has completed and may not exist anymore
@@ -461,15 +857,26 @@ JobManagerWorkStealing::ThreadInfo* JobManagerWorkStealing::GetCurrentThreadInfo
             info->m_isWorker = false;
             info->m_threadId = AZStd::this_thread::get_id();
             info->m_currentJob = nullptr;
+            info->m_numPicks = 0;
+            info->m_cpus.reset();
+            info->m_currentFiber = nullptr;
+            info->m_recycleFiber = nullptr;
+            info->m_suspendingFiber = nullptr;
+            info->m_victims = m_workerThreads;
+            info->m_trace.SetCapacity(m_traceBufferSize);
 
 #ifdef JOBMANAGER_ENABLE_STATS
             info->m_globalJobs = 0;
             info->m_jobsForked = 0;
             info->m_jobsDone = 0;
             info->m_jobsStolen = 0;
+            info->m_spins = 0;
+            info->m_spinHits = 0;
+            info->m_parks = 0;
             info->m_jobTime = 0;
             info->m_stealTime = 0;
 #endif
+            info->m_index = static_cast<unsigned int>(m_threads.size());
             m_threads.push_back(info);
         }
     }
@@ -483,11 +890,18 @@ void JobManagerWorkStealing::AddThread(const JobManagerThreadDesc& desc)
 
     info->m_isWorker = true;
     info->m_currentJob = nullptr;
+    info->m_numPicks = 0;
+    info->m_cpus = CpuTopology::GetAffinityCpus(desc.m_cpuId, desc.m_cpuMask);
+    info->m_currentFiber = nullptr;
+    info->m_recycleFiber = nullptr;
+    info->m_suspendingFiber = nullptr;
     info->m_isAvailable = false;
+    info->m_trace.SetCapacity(m_traceBufferSize);
 
     AZStd::thread_desc threadDesc;
     threadDesc.m_name = "AZ JobManager worker thread";
     threadDesc.m_cpuId = desc.m_cpuId;
+    threadDesc.m_cpuMask = desc.m_cpuMask;
     threadDesc.m_priority = desc.m_priority;
     if (desc.m_stackSize != 0)
     {
@@ -501,17 +915,58 @@ void JobManagerWorkStealing::AddThread(const JobManagerThreadDesc& desc)
     info->m_jobsForked = 0;
     info->m_jobsDone = 0;
     info->m_jobsStolen = 0;
+    info->m_spins = 0;
+    info->m_spinHits = 0;
+    info->m_parks = 0;
     info->m_jobTime = 0;
     info->m_stealTime = 0;
 #endif
 
     {
         AZStd::lock_guard<AZStd::mutex> lock(m_threadsMutex);
+        info->m_index = static_cast<unsigned int>(m_threads.size());
         m_threads.push_back(info);
         m_workerThreads.push_back(info);
     }
 }
 
+void JobManagerWorkStealing::InitVictims()
+{
+    bool isAnyPinned = false;
+    for (unsigned int i = 0; i < m_workerThreads.size(); ++i)
+    {
+        isAnyPinned |= m_workerThreads[i]->m_cpus.any();
+    }
+
+    CpuTopology topology;
+    if (isAnyPinned)
+    {
+        topology.Read();
+    }
+
+    const unsigned int numWorkers = static_cast<unsigned int>(m_workerThreads.size());
+    for (unsigned int i = 0; i < numWorkers; ++i)
+    {
+        ThreadInfo* info = m_workerThreads[i];
+
+        //start with the threads after us, so not all workers hammer the same victim first, then stable sort by distance
+        info->m_victims.clear();
+        AZStd::vector<float> distances;
+        for (unsigned int j = 1; j < numWorkers; ++j)
+        {
+            ThreadInfo* victim = m_workerThreads[(i + j) % numWorkers];
+            float distance = isAnyPinned ? topology.GetDistance(info->m_cpus, victim->m_cpus) : 0.0f;
+            size_t insertPos = 0;
+            while (insertPos < distances.size() && distances[insertPos] <= distance)
+            {
+                ++insertPos;
+            }
+            distances.insert(distances.begin() + insertPos, distance);
+            info->m_victims.insert(info->m_victims.begin() + insertPos, victim);
+        }
+    }
+}
+
 void JobManagerWorkStealing::KillThreads()
 {
     if (!m_threads.empty())
@@ -537,24 +992,204 @@ void JobManagerWorkStealing::KillThreads()
         m_threads.clear();
         m_workerThreads.clear();
     }
+
+    for (unsigned int i = 0; i < m_fibers.size(); ++i)
+    {
+        delete m_fibers[i];
+    }
+    m_fibers.clear();
+    m_freeFibers = nullptr;
+}
+
+//fibers move between threads, the thread local is read through a function the compiler can't inline, so an address
+//computed before a fiber switch is never reused after it
+#if defined(AZ_COMPILER_MSVC)
+__declspec(noinline)
+#else
+__attribute__((noinline))
+#endif
+JobManagerWorkStealing::ThreadInfo* JobManagerWorkStealing::GetWorkerThreadInfo()
+{
+    return m_currentThreadInfo;
+}
+
+void JobManagerWorkStealing::FiberMain(void* userData)
+{
+    JobManagerWorkStealing* manager = reinterpret_cast<JobManagerWorkStealing*>(userData);
+    ThreadInfo* info = GetWorkerThreadInfo();
+    manager->AfterFiberSwitch(info);
+
+    manager->ProcessJobsInternal(info, NULL, NULL);
+
+    //quitting, go back to the stack of the thread, this fiber is never resumed
+    info = GetWorkerThreadInfo();
+    FiberInfo* fiber = info->m_currentFiber;
+    info->m_currentFiber = nullptr;
+    Fiber::Switch(fiber->m_fiber, info->m_threadFiber);
+}
+
+JobManagerWorkStealing::FiberInfo* JobManagerWorkStealing::AcquireFiber()
+{
+    {
+        AZStd::lock_guard<AZStd::spin_mutex> lock(m_fiberMutex);
+        FiberInfo* fiber = m_freeFibers;
+        if (fiber)
+        {
+            m_freeFibers = fiber->m_next;
+            return fiber;
+        }
+    }
+
+    FiberInfo* fiber = aznew FiberInfo;
+    fiber->m_suspendedJob = nullptr;
+    fiber->m_resumeGate = 0;
+    fiber->m_next = nullptr;
+    if (!fiber->m_fiber.Create(m_fiberStackSize, &JobManagerWorkStealing::FiberMain, this))
+    {
+        delete fiber;
+        return nullptr;
+    }
+
+    AZStd::lock_guard<AZStd::spin_mutex> lock(m_fiberMutex);
+    m_fibers.push_back(fiber);
+    return fiber;
+}
+
+bool JobManagerWorkStealing::SuspendFiber(ThreadInfo* info, Job* job)
+{
+    FiberInfo* nextFiber = AcquireFiber();
+    if (!nextFiber)
+    {
+        return false; //out of fibers, wait nested
+    }
+
+    FiberInfo* fiber = info->m_currentFiber;
+    fiber->m_suspendedJob = job;
+    fiber->m_resumeGate.store(0, AZStd::memory_order_relaxed);
+    {
+        AZStd::lock_guard<AZStd::spin_mutex> lock(m_fiberMutex);
+        //the children may have completed since WaitForChildren checked, nobody will notify us in that case
+        if (job->GetDependentCount() == 0)
+        {
+            nextFiber->m_next = m_freeFibers;
+            m_freeFibers = nextFiber;
+            return true;
+        }
+        FiberInfo*& bucket = m_suspendedFibers[(reinterpret_cast<size_t>(job) >> 4) % NUM_SUSPENDED_BUCKETS];
+        fiber->m_next = bucket;
+        bucket = fiber;
+    }
+
+    //keep processing jobs on the next fiber, it publishes this one once we are off its stack
+    info->m_suspendingFiber = fiber;
+    info->m_currentFiber = nextFiber;
+    Fiber::Switch(fiber->m_fiber, nextFiber->m_fiber);
+
+    //resumed, possibly on another worker
+    AfterFiberSwitch(GetWorkerThreadInfo());
+    return true;
+}
+
+void JobManagerWorkStealing::ResumeReadyFiber(ThreadInfo* info)
+{
+    FiberInfo* readyFiber;
+    {
+        AZStd::lock_guard<AZStd::spin_mutex> lock(m_readyFibersMutex);
+        readyFiber = m_readyFibersHead.load(AZStd::memory_order_relaxed);
+        if (!readyFiber)
+        {
+            return;
+        }
+        m_readyFibersHead.store(readyFiber->m_next, AZStd::memory_order_relaxed);
+        if (!readyFiber->m_next)
+        {
+            m_readyFibersTail = nullptr;
+        }
+    }
+
+    //this fiber is only running the job loop, it's recycled by the ready fiber once we are off its stack
+    FiberInfo* fiber = info->m_currentFiber;
+    info->m_recycleFiber = fiber;
+    info->m_currentFiber = readyFiber;
+    Fiber::Switch(fiber->m_fiber, readyFiber->m_fiber);
+    AZ_Assert(false, "A recycled fiber has been resumed");
+}
+
+void JobManagerWorkStealing::AfterFiberSwitch(ThreadInfo* info)
+{
+    if (info->m_recycleFiber)
+    {
+        FiberInfo* fiber = info->m_recycleFiber;
+        info->m_recycleFiber = nullptr;
+        fiber->m_fiber.Reset();
+        AZStd::lock_guard<AZStd::spin_mutex> lock(m_fiberMutex);
+        fiber->m_next = m_freeFibers;
+        m_freeFibers = fiber;
+    }
+
+    if (info->m_suspendingFiber)
+    {
+        FiberInfo* fiber = info->m_suspendingFiber;
+        info->m_suspendingFiber = nullptr;
+        if (fiber->m_resumeGate.fetch_add(1, AZStd::memory_order_acq_rel) == 1)
+        {
+            //the children completed while we were switching
+            PushReadyFiber(fiber);
+        }
+    }
+}
+
+void JobManagerWorkStealing::PushReadyFiber(FiberInfo* fiber)
+{
+    fiber->m_next = nullptr;
+    {
+        AZStd::lock_guard<AZStd::spin_mutex> lock(m_readyFibersMutex);
+        if (m_readyFibersTail)
+        {
+            m_readyFibersTail->m_next = fiber;
+        }
+        else
+        {
+            m_readyFibersHead.store(fiber, AZStd::memory_order_release);
+        }
+        m_readyFibersTail = fiber;
+    }
+    ActivateWorker();
 }
 
 inline void JobManagerWorkStealing::ActivateWorker()
 {
-    // find an available worker thread (we do it brute force because the number of threads is small)
-    if (m_numAvailableWorkers.load(AZStd::memory_order_acquire) > 0)
+    ActivateWorkers(1);
+}
+
+inline void JobManagerWorkStealing::ActivateWorkers(unsigned int numJobs)
+{
+    //orders the push with the spinning and available worker counts, pairs with the fence in ParkWorker
+    AZStd::atomic_thread_fence(AZStd::memory_order_seq_cst);
+
+    // spinning workers will pick jobs up, no need to pay for a wake up, we only wake parked workers for the rest
+    unsigned int numSpinning = m_numSpinningWorkers.load(AZStd::memory_order_acquire);
+    if (numSpinning >= numJobs)
+    {
+        return;
+    }
+    unsigned int numToWake = numJobs - numSpinning;
+
+    // find available worker threads (we do it brute force because the number of threads is small)
+    for (size_t i = 0; i < m_workerThreads.size() && numToWake > 0; ++i)
     {
-        for (size_t i = 0; i < m_workerThreads.size(); ++i)
+        if (m_numAvailableWorkers.load(AZStd::memory_order_acquire) == 0)
         {
-            ThreadInfo* info = m_workerThreads[i];
-            if (info->m_isAvailable.exchange(false, AZStd::memory_order_acq_rel) == true)
-            {
-                // decrement number of available workers
-                m_numAvailableWorkers.fetch_sub(1, AZStd::memory_order_acq_rel);
-                // resume the thread execution
-                info->m_waitEvent.release();
-                break;
-            }
+            break;
+        }
+        ThreadInfo* info = m_workerThreads[i];
+        if (info->m_isAvailable.exchange(false, AZStd::memory_order_acq_rel) == true)
+        {
+            // decrement number of available workers
+            m_numAvailableWorkers.fetch_sub(1, AZStd::memory_order_acq_rel);
+            // resume the thread execution
+            info->m_waitEvent.release();
+            --numToWake;
         }
     }
 }
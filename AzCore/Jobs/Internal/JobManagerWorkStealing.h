@@ -18,9 +18,13 @@
 
 #include <AzCore/Jobs/Internal/JobManagerBase.h>
 #include <AzCore/Jobs/JobManagerDesc.h>
+#include <AzCore/Jobs/JobContext.h>
+#include <AzCore/Jobs/Internal/Fiber.h>
+#include <AzCore/Jobs/Internal/GlobalJobQueue.h>
+#include <AzCore/Jobs/Internal/JobTrace.h>
 #include <AzCore/Memory/PoolAllocator.h>
 
-#include <AzCore/std/containers/queue.h>
+#include <AzCore/std/containers/vector.h>
 #include <AzCore/std/parallel/containers/work_stealing_queue.h>
 #include <AzCore/std/parallel/spin_mutex.h>
 #include <AzCore/std/parallel/mutex.h>
@@ -36,11 +40,16 @@ namespace AZ
     {
         /**
          * Work stealing is in practice a very efficient way for processing fine grained jobs.
-         * IMPORTANT: Because we want to put worker threads to sleep we do have extra locks and condition
-         * variable in the code. In addition we are constantly kicking sleeping threads when we add jobs,
-         * this is NOT efficient. Once we have heavier job loads (in practice) try to optimize and remove
-         * those sticky points (if they are a problem). In addition we can think about writing a more advanced
-         * scheduler or use some off the shelf.
+         * Idle workers spin for a while (see JobManagerDesc::m_idleSpinCount) before they park on their wait event,
+         * the number of spinning workers is limited by JobManagerDesc::m_maxSpinningWorkers. Adding a job only wakes
+         * a parked worker when nobody is spinning, so fine grained fork/join work doesn't pay for a wake up per job.
+         * Each job priority has its own global queue and its own local queue per worker, workers always drain (and steal)
+         * the highest priority first. The global queues are lock-free, a worker takes a few jobs at once from them and
+         * moves the extra ones to its local queue, where idle workers can steal them.
+         * When worker threads have an affinity, each worker steals from the closest workers first (shared L2, then
+         * shared last level cache, then the same NUMA node) before crossing to another node.
+         * In fiber mode (JobManagerDesc::m_useFibers) a worker whose job waits for children switches to a pooled fiber
+         * instead of nesting, the waiting fiber is queued as ready once the children are complete and any worker resumes it.
          */
         class JobManagerWorkStealing
             : public JobManagerBase
@@ -53,6 +62,8 @@ namespace AZ
 
             void AddPendingJob(Job* job);
 
+            void AddPendingJobs(Job** jobs, size_t numJobs);
+
             void SuspendJobUntilReady(Job* job);
 
             void NotifySuspendedJobReady(Job* job);
@@ -72,31 +83,62 @@ namespace AZ
 
             unsigned int GetNumWorkerThreads() const    { return static_cast<unsigned int>(m_threads.size()); }
 
+            bool IsLocalQueueEmpty() const;
+
+            void SetTracingEnabled(bool isEnabled);
+            bool IsTracingEnabled() const { return m_isTracing.load(AZStd::memory_order_relaxed); }
+            void WriteChromeTrace(AZStd::string& output);
+
         private:
 
             void ActivateWorker();
+            void ActivateWorkers(unsigned int numJobs);
 
             typedef AZStd::work_stealing_queue<Job*> WorkQueue;
 
+            struct FiberInfo
+            {
+                AZ_CLASS_ALLOCATOR(FiberInfo, SystemAllocator, 0)
+
+                Fiber m_fiber;
+                Job* m_suspendedJob; //job waiting for its children on this fiber
+                AZStd::atomic<unsigned int> m_resumeGate; //the fiber is ready when both the suspend and the notify side passed the gate
+                FiberInfo* m_next; //link in the free list, the suspended buckets or the ready list
+            };
+
             struct ThreadInfo
             {
-                AZ_CLASS_ALLOCATOR(ThreadInfo, ThreadPoolAllocator, 0)
+                AZ_CLASS_ALLOCATOR(ThreadInfo, SystemAllocator, 0) //not pooled, it holds a fiber context which can be large
 
                 AZStd::thread::id m_threadId;
                 bool m_isWorker;
+                unsigned int m_index; //index in m_threads
                 Job* m_currentJob; //job which is currently processing on this thread
+                unsigned int m_numPicks; //number of jobs picked by priority, used for starvation protection
+                JobTraceBuffer m_trace; //only written by this thread
+
+                // fiber mode only, valid on workers
+                Fiber m_threadFiber; //context of the thread's own stack, we switch back to it when quitting
+                FiberInfo* m_currentFiber; //fiber running on this thread
+                FiberInfo* m_recycleFiber; //fiber we just left for good, freed once we are off its stack
+                FiberInfo* m_suspendingFiber; //fiber we just left with a waiting job, published once we are off its stack
 
                 // valid only on workers (TODO: Use some lazy initialization as we don't need that data for non worker threads)
                 AZStd::thread m_thread;
+                AZStd::thread_cpu_mask m_cpus; //cpus from the thread affinity, empty if the thread is not pinned
+                AZStd::vector<ThreadInfo*> m_victims; //threads to steal from, ordered by distance
                 AZStd::atomic_bool m_isAvailable;
                 AZStd::binary_semaphore m_waitEvent;
-                WorkQueue m_pendingJobs;
+                WorkQueue m_pendingJobs[JOB_PRIORITY_COUNT];
 
 #ifdef JOBMANAGER_ENABLE_STATS
                 unsigned int m_globalJobs;
                 unsigned int m_jobsForked;
                 unsigned int m_jobsDone;
                 unsigned int m_jobsStolen;
+                unsigned int m_spins;       //number of times we started spinning while idle
+                unsigned int m_spinHits;    //number of spins which found a job before the spin budget expired
+                unsigned int m_parks;       //number of times we went to sleep on the wait event
                 u64 m_jobTime;
                 u64 m_stealTime;
 #endif //
@@ -106,9 +148,36 @@ namespace AZ
             void ProcessJobsAssist(ThreadInfo* info, Job* suspendedJob, AZStd::atomic<bool>* notifyFlag);
             void ProcessJobsSynchronous(ThreadInfo* info, Job* suspendedJob, AZStd::atomic<bool>* notifyFlag);
             void ProcessJobsInternal(ThreadInfo* info, Job* suspendedJob, AZStd::atomic<bool>* notifyFlag);
+            bool PopGlobalJob(ThreadInfo* info, Job** job);
+            bool PopGlobalJob(unsigned int priority, Job** job);
+            bool PopLocalJob(ThreadInfo* info, Job** job);
+            bool IsGlobalQueueEmpty() const;
+            bool IsStealPossible(ThreadInfo* info) const;
+            bool IsLowPriorityFirst(ThreadInfo* info);
+            bool StealJob(ThreadInfo* info, unsigned int& victim, Job** job);
+            Job* SpinForJob(ThreadInfo* info, unsigned int& victim);
+            void ParkWorker(ThreadInfo* info);
             void AddThread(const JobManagerThreadDesc& desc);
+            void InitVictims();
             void KillThreads();
             ThreadInfo* GetCurrentThreadInfo();
+            static ThreadInfo* GetWorkerThreadInfo();
+
+            AZ_FORCE_INLINE void Trace(ThreadInfo* info, JobTraceEventType type, const Job* job, AZ::u32 data = 0)
+            {
+                if (m_isTracing.load(AZStd::memory_order_relaxed))
+                {
+                    info->m_trace.Record(type, job, data);
+                }
+            }
+
+            static void FiberMain(void* userData);
+            FiberInfo* AcquireFiber();
+            bool SuspendFiber(ThreadInfo* info, Job* job);
+            void ResumeReadyFiber(ThreadInfo* info);
+            void AfterFiberSwitch(ThreadInfo* info);
+            void PushReadyFiber(FiberInfo* fiber);
+            bool HasReadyFibers() const { return m_readyFibersHead.load(AZStd::memory_order_acquire) != nullptr; }
 
             bool m_isAsynchronous;
 
@@ -120,15 +189,33 @@ namespace AZ
 
             ThreadList m_workerThreads; //no mutex required for this list, it's only assigned during startup
 
-            typedef AZStd::queue<Job*, AZStd::deque<Job*> > GlobalJobQueue;
-
-            typedef AZStd::spin_mutex GlobalQueueMutexType;
+            enum { GLOBAL_POP_BATCH_SIZE = 8 }; //max number of jobs a worker takes from a global queue at once
 
-            GlobalJobQueue              m_globalJobQueue;
-            GlobalQueueMutexType        m_globalJobQueueMutex;
+            GlobalJobQueue*             m_globalJobQueues[JOB_PRIORITY_COUNT];
 
             volatile bool               m_isQuit;
             AZStd::atomic<unsigned int> m_numAvailableWorkers;
+            AZStd::atomic<unsigned int> m_numSpinningWorkers;
+
+            unsigned int                m_idleSpinCount;
+            unsigned int                m_maxSpinningWorkers;
+            unsigned int                m_priorityStarvationLimit;
+
+            bool                        m_useFibers;
+            unsigned int                m_fiberStackSize;
+            AZStd::vector<FiberInfo*>   m_fibers; //all fibers, for cleanup
+            FiberInfo*                  m_freeFibers;
+            enum { NUM_SUSPENDED_BUCKETS = 64 };
+            FiberInfo*                  m_suspendedFibers[NUM_SUSPENDED_BUCKETS]; //fibers with a waiting job, hashed by job
+            AZStd::spin_mutex           m_fiberMutex; //protects the fiber list, the free list and the suspended buckets
+            AZStd::spin_mutex           m_readyFibersMutex;
+            AZStd::atomic<FiberInfo*>   m_readyFibersHead; //fibers ready to resume, written under m_readyFibersMutex, HasReadyFibers peeks without it
+            FiberInfo*                  m_readyFibersTail;
+
+            AZStd::atomic_bool          m_isTracing;
+            unsigned int                m_traceBufferSize;
+            AZ::u64                     m_traceStartTime; //GetJobTraceTime and system ticks when tracing was enabled
+            AZStd::sys_time_t           m_traceStartTicks;
 
             //thread-local pointer to the info for this thread. This is set for worker threads all the time,
             //and user threads only while they are processing jobs
@@ -0,0 +1,191 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZ_UNITY_BUILD
+
+#include <AzCore/Jobs/Internal/JobTrace.h>
+#include <AzCore/Memory/SystemAllocator.h>
+#include <AzCore/std/containers/vector.h>
+
+using namespace AZ;
+using namespace Internal;
+
+//=========================================================================
+// JobTraceBuffer
+//=========================================================================
+JobTraceBuffer::JobTraceBuffer()
+    : m_events(nullptr)
+    , m_mask(0)
+    , m_writePos(0)
+    , m_clearPos(0)
+{
+}
+
+JobTraceBuffer::~JobTraceBuffer()
+{
+    JobTraceEvent* events = m_events.load(AZStd::memory_order_acquire);
+    if (events)
+    {
+        azfree(events, SystemAllocator);
+    }
+}
+
+void JobTraceBuffer::SetCapacity(unsigned int capacity)
+{
+    AZ_Assert(!m_events.load(AZStd::memory_order_acquire), "The trace buffer capacity can't change once events are recorded");
+    unsigned int powerOf2 = 1;
+    while (powerOf2 < capacity)
+    {
+        powerOf2 <<= 1;
+    }
+    m_mask = powerOf2 - 1;
+}
+
+JobTraceEvent* JobTraceBuffer::Allocate()
+{
+    JobTraceEvent* events = reinterpret_cast<JobTraceEvent*>(azmalloc(sizeof(JobTraceEvent) * (m_mask + 1), AZStd::alignment_of<JobTraceEvent>::value, SystemAllocator, "AZ::JobTraceBuffer"));
+    m_events.store(events, AZStd::memory_order_release);
+    return events;
+}
+
+void JobTraceBuffer::Clear()
+{
+    m_clearPos.store(m_writePos.load(AZStd::memory_order_acquire), AZStd::memory_order_release);
+}
+
+unsigned int JobTraceBuffer::Read(JobTraceEvent* events, unsigned int maxEvents) const
+{
+    const JobTraceEvent* buffer = m_events.load(AZStd::memory_order_acquire);
+    if (!buffer)
+    {
+        return 0;
+    }
+
+    AZ::u64 capacity = m_mask + 1;
+    AZ::u64 end = m_writePos.load(AZStd::memory_order_acquire);
+    AZ::u64 begin = AZStd::GetMax(m_clearPos.load(AZStd::memory_order_acquire), end > capacity ? end - capacity : 0);
+    if (end - begin > maxEvents)
+    {
+        begin = end - maxEvents;
+    }
+    for (AZ::u64 pos = begin; pos < end; ++pos)
+    {
+        events[pos - begin] = buffer[pos & m_mask];
+    }
+
+    //the owner may have wrapped around while we were copying, the event at position p is overwritten as soon as the
+    //owner starts recording position p + capacity, so only the events after that are intact
+    AZStd::atomic_thread_fence(AZStd::memory_order_acquire);
+    AZ::u64 newEnd = m_writePos.load(AZStd::memory_order_relaxed);
+    AZ::u64 firstIntact = newEnd + 1 > capacity ? newEnd + 1 - capacity : 0;
+    unsigned int numEvents = static_cast<unsigned int>(end - begin);
+    if (firstIntact > begin)
+    {
+        unsigned int numTorn = static_cast<unsigned int>(AZStd::GetMin(firstIntact - begin, end - begin));
+        for (unsigned int i = numTorn; i < numEvents; ++i)
+        {
+            events[i - numTorn] = events[i];
+        }
+        numEvents -= numTorn;
+    }
+    return numEvents;
+}
+
+//=========================================================================
+// JobTraceWriter
+//=========================================================================
+JobTraceWriter::JobTraceWriter(AZStd::string& output, AZ::u64 startTime, AZStd::sys_time_t startTicks)
+    : m_output(output)
+    , m_startTime(startTime)
+    , m_isFirstEvent(true)
+{
+#if defined(AZ_JOBS_TRACE_TSC)
+    //measure the TSC frequency over the whole capture, it's invariant on all the CPUs we care about
+    AZ::u64 time = GetJobTraceTime();
+    AZStd::sys_time_t ticks = AZStd::GetTimeNowTicks();
+    double seconds = static_cast<double>(ticks - startTicks) / static_cast<double>(AZStd::GetTimeTicksPerSecond());
+    m_microSecondsPerTick = (time > startTime && seconds > 0.0) ? seconds * 1000000.0 / static_cast<double>(time - startTime) : 0.0;
+#else
+    (void)startTicks;
+    m_microSecondsPerTick = 1000000.0 / static_cast<double>(AZStd::GetTimeTicksPerSecond());
+#endif
+    m_output += "{\"traceEvents\":[\n";
+}
+
+void JobTraceWriter::WriteThread(unsigned int threadIndex, bool isWorker, const JobTraceBuffer& buffer)
+{
+    char args[64];
+    azsnprintf(args, AZ_ARRAY_SIZE(args), "{\"name\":\"%s %u\"}", isWorker ? "Worker" : "Thread", threadIndex);
+    WriteEvent("thread_name", 'M', threadIndex, m_startTime, args);
+
+    AZStd::vector<JobTraceEvent> events(buffer.GetCapacity());
+    unsigned int numEvents = buffer.Read(events.data(), static_cast<unsigned int>(events.size()));
+
+    //the oldest events may have been overwritten, so slices which started before the first event we have are skipped
+    unsigned int depth = 0;
+    for (unsigned int i = 0; i < numEvents; ++i)
+    {
+        const JobTraceEvent& e = events[i];
+        if (e.m_time < m_startTime)
+        {
+            continue;
+        }
+        switch (e.m_type)
+        {
+        case JOB_TRACE_BEGIN:
+        case JOB_TRACE_RESUME:
+            azsnprintf(args, AZ_ARRAY_SIZE(args), "{\"job\":\"%p\"}", e.m_job);
+            WriteEvent(e.m_type == JOB_TRACE_BEGIN ? "Job" : "Job (resumed)", 'B', threadIndex, e.m_time, args);
+            ++depth;
+            break;
+        case JOB_TRACE_PARK:
+            WriteEvent("Parked", 'B', threadIndex, e.m_time, nullptr);
+            ++depth;
+            break;
+        case JOB_TRACE_END:
+        case JOB_TRACE_SUSPEND:
+        case JOB_TRACE_UNPARK:
+            if (depth)
+            {
+                WriteEvent(nullptr, 'E', threadIndex, e.m_time, nullptr);
+                --depth;
+            }
+            break;
+        case JOB_TRACE_STEAL:
+            azsnprintf(args, AZ_ARRAY_SIZE(args), "{\"job\":\"%p\",\"victim\":%u}", e.m_job, e.m_data);
+            WriteEvent("Steal", 'i', threadIndex, e.m_time, args);
+            break;
+        }
+    }
+}
+
+void JobTraceWriter::Finish()
+{
+    m_output += "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+void JobTraceWriter::WriteEvent(const char* name, char phase, unsigned int threadIndex, AZ::u64 time, const char* args)
+{
+    char str[256];
+    double timeStamp = static_cast<double>(time - m_startTime) * m_microSecondsPerTick;
+    int length = azsnprintf(str, AZ_ARRAY_SIZE(str), "%s{\"ph\":\"%c\",\"pid\":0,\"tid\":%u,\"ts\":%.3f%s%s%s%s%s%s}",
+        m_isFirstEvent ? "" : ",\n", phase, threadIndex, timeStamp,
+        name ? ",\"name\":\"" : "", name ? name : "", name ? "\"" : "",
+        phase == 'i' ? ",\"s\":\"t\"" : "",
+        args ? ",\"args\":" : "", args ? args : "");
+    if (length > 0)
+    {
+        m_output.append(str, AZStd::GetMin(static_cast<size_t>(length), AZ_ARRAY_SIZE(str) - 1));
+    }
+    m_isFirstEvent = false;
+}
+
+#endif // #ifndef AZ_UNITY_BUILD
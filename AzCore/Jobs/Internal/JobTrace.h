@@ -0,0 +1,148 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZCORE_JOBS_INTERNAL_JOBTRACE_H
+#define AZCORE_JOBS_INTERNAL_JOBTRACE_H 1
+
+#include <AzCore/base.h>
+#include <AzCore/std/parallel/atomic.h>
+#include <AzCore/std/string/string.h>
+#include <AzCore/std/time.h>
+
+#if defined(AZ_COMPILER_MSVC) && (defined(_M_X64) || defined(_M_IX86))
+#   include <intrin.h>
+#   define AZ_JOBS_TRACE_TSC
+#elif (defined(AZ_COMPILER_GCC) || defined(AZ_COMPILER_CLANG)) && (defined(__x86_64__) || defined(__i386__))
+#   include <x86intrin.h>
+#   define AZ_JOBS_TRACE_TSC
+#endif
+
+namespace AZ
+{
+    class Job;
+
+    namespace Internal
+    {
+        enum JobTraceEventType
+        {
+            JOB_TRACE_BEGIN,    ///< job starts processing
+            JOB_TRACE_END,      ///< job is done processing
+            JOB_TRACE_SUSPEND,  ///< job waits for its children, the thread moves on to other jobs
+            JOB_TRACE_RESUME,   ///< job continues after waiting, possibly on another thread
+            JOB_TRACE_STEAL,    ///< job was stolen, data is the index of the victim thread
+            JOB_TRACE_PARK,     ///< worker goes to sleep
+            JOB_TRACE_UNPARK,   ///< worker woke up
+        };
+
+        struct JobTraceEvent
+        {
+            AZ::u64 m_time;
+            const Job* m_job;
+            AZ::u32 m_type;
+            AZ::u32 m_data;
+        };
+
+        /// Timestamp of trace events, the TSC where available (a few cycles to read), the system ticks otherwise.
+        AZ_FORCE_INLINE AZ::u64 GetJobTraceTime()
+        {
+#if defined(AZ_JOBS_TRACE_TSC)
+            return __rdtsc();
+#else
+            return static_cast<AZ::u64>(AZStd::GetTimeNowTicks());
+#endif
+        }
+
+        /**
+         * Ring buffer of trace events for a single thread. Only the owning thread records events, it never waits: once
+         * the buffer is full the oldest events are overwritten. Other threads can read the buffer at any time, events
+         * which are overwritten while they are read are detected and dropped. The events are allocated on the first
+         * record, so threads which never trace don't pay for the memory.
+         */
+        class JobTraceBuffer
+        {
+        public:
+            JobTraceBuffer();
+            ~JobTraceBuffer();
+
+            /// Sets the number of events kept, rounded up to a power of 2. Must be called before the first record.
+            void SetCapacity(unsigned int capacity);
+
+            AZ_FORCE_INLINE void Record(JobTraceEventType type, const Job* job, AZ::u32 data = 0)
+            {
+                JobTraceEvent* events = m_events.load(AZStd::memory_order_relaxed);
+                if (!events)
+                {
+                    events = Allocate();
+                }
+                AZ::u64 pos = m_writePos.load(AZStd::memory_order_relaxed);
+                JobTraceEvent& e = events[pos & m_mask];
+                e.m_time = GetJobTraceTime();
+                e.m_job = job;
+                e.m_type = type;
+                e.m_data = data;
+                m_writePos.store(pos + 1, AZStd::memory_order_release);
+            }
+
+            /// Drops all the events recorded so far, can be called from any thread.
+            void Clear();
+
+            /// Copies the events still in the buffer into events (oldest first), returns the number of events copied.
+            unsigned int Read(JobTraceEvent* events, unsigned int maxEvents) const;
+
+            unsigned int GetCapacity() const { return m_mask + 1; }
+
+        private:
+            //non-copyable
+            JobTraceBuffer(const JobTraceBuffer&);
+            JobTraceBuffer& operator=(const JobTraceBuffer&);
+
+            JobTraceEvent* Allocate();
+
+            AZStd::atomic<JobTraceEvent*> m_events;
+            unsigned int m_mask;
+            AZStd::atomic<AZ::u64> m_writePos; //number of events ever recorded, only written by the owning thread
+            AZStd::atomic<AZ::u64> m_clearPos; //events before this position were cleared
+        };
+
+        /**
+         * Writes trace events in the Chrome trace event JSON format, which can be loaded by chrome://tracing and
+         * ui.perfetto.dev. Each thread is a track, jobs are duration slices (split when the job is suspended), parking
+         * is a slice too and steals are instant events. Timestamps are converted to microseconds since the start
+         * time, the TSC frequency is measured between the start time and the construction of the writer.
+         */
+        class JobTraceWriter
+        {
+        public:
+            /// startTime/startTicks are a GetJobTraceTime/AZStd::GetTimeNowTicks pair sampled when tracing was enabled.
+            JobTraceWriter(AZStd::string& output, AZ::u64 startTime, AZStd::sys_time_t startTicks);
+
+            void WriteThread(unsigned int threadIndex, bool isWorker, const JobTraceBuffer& buffer);
+
+            /// Closes the JSON document, must be called once all the threads are written.
+            void Finish();
+
+        private:
+            //non-copyable
+            JobTraceWriter(const JobTraceWriter&);
+            JobTraceWriter& operator=(const JobTraceWriter&);
+
+            void WriteEvent(const char* name, char phase, unsigned int threadIndex, AZ::u64 time, const char* args);
+
+            AZStd::string& m_output;
+            AZ::u64 m_startTime;
+            double m_microSecondsPerTick;
+            bool m_isFirstEvent;
+        };
+    }
+}
+
+#endif
+#pragma once
@@ -30,6 +30,7 @@ namespace AZ
     {
         class JobManagerBase;
     }
+    class JobGraph;
 
     /**
      * Job class, representing a small unit of processing which can be parallelized with other jobs. This is the generic
@@ -70,6 +71,14 @@ namespace AZ
          */
         void Start();
 
+        /**
+         * Starts a batch of jobs, same as calling Start on each of them, but the jobs which are ready to run are queued
+         * together: they are published to the queue at once, and at most one worker is woken up per job. This is much
+         * cheaper than starting the jobs one by one when fanning out many small jobs. All the jobs must belong to the
+         * same JobManager. Auto-delete jobs should not be accessed after calling this function, the array can be reused.
+         */
+        static void StartJobs(Job** jobs, size_t numJobs);
+
         /**
          * Resets a non-auto-deleting job so it can be used again. If the dependent is not cleared, then it
          * should be already in the reset state, in order to increment the dependent count.
@@ -113,6 +122,11 @@ namespace AZ
          */
         void StartAsChild(Job* childJob);
 
+        /**
+         * Batch version of StartAsChild, see StartJobs.
+         */
+        void StartAsChildren(Job** childJobs, size_t numChildJobs);
+
         /**
          * Suspends processing of this job until all children are complete. The thread currently running the job will
          * resume running other jobs until the children are complete.
@@ -149,6 +163,14 @@ namespace AZ
          */
         JobContext* GetContext() const;
 
+        /**
+         * Sets the priority of this job, overriding the default priority from the context. Can only be called before
+         * the job is started.
+         */
+        void SetPriority(JobPriority priority);
+
+        JobPriority GetPriority() const;
+
         /**
          * Gets the dependent job, the dependent job will not start until this job has completed.
          */
@@ -182,7 +204,17 @@ namespace AZ
         void SetDependentCountAndFlags(unsigned int countAndFlags);
         unsigned int GetDependentCountAndFlags() const;
 
+        /**
+         * Same as DecrementDependentCount, except when the job becomes ready: instead of queueing the job this returns
+         * true, the caller must then queue it with QueueJobs (so several ready jobs can be queued together).
+         */
+        bool DecrementDependentCountDeferred();
+
+        /// Queues jobs which are ready to run, all the jobs must belong to the same JobManager.
+        static void QueueJobs(Job** readyJobs, size_t numJobs);
+
         friend class Internal::JobManagerBase;
+        friend class JobGraph; //re-arms its compiled jobs directly
 
     private:
         //non-copyable
@@ -195,6 +227,10 @@ namespace AZ
             FLAG_AUTO_DELETE = (1 << 31),
             FLAG_CHILD_JOBS  = (1 << 30),
 
+            //2 bits for priority
+            FLAG_PRIORITY_SHIFT = 24,
+            FLAG_PRIORITY_MASK = (0x3 << FLAG_PRIORITY_SHIFT),
+
             //24 bits for count
             FLAG_DEPENDENTCOUNT_MASK = 0x00ffffff
         };
@@ -239,6 +275,7 @@ namespace AZ
         {
             countAndFlags |= (unsigned int)FLAG_AUTO_DELETE;
         }
+        countAndFlags |= ((unsigned int)m_context->GetPriority() << FLAG_PRIORITY_SHIFT) & FLAG_PRIORITY_MASK;
         SetDependentCountAndFlags(countAndFlags);
         StoreDependent(NULL);
 
@@ -344,6 +381,18 @@ namespace AZ
         childJob->Start();
     }
 
+    inline void Job::StartAsChildren(Job** childJobs, size_t numChildJobs)
+    {
+#ifdef AZ_DEBUG_JOB_STATE
+        AZ_Assert(m_state == STATE_PROCESSING, "Child jobs can only be added while we are processing");
+#endif
+        for (size_t i = 0; i < numChildJobs; ++i)
+        {
+            childJobs[i]->SetDependentChild(this);
+        }
+        StartJobs(childJobs, numChildJobs);
+    }
+
     AZ_FORCE_INLINE void Job::WaitForChildren()
     {
 #ifdef AZ_DEBUG_JOB_STATE
@@ -403,6 +452,22 @@ namespace AZ
         return m_context;
     }
 
+    inline void Job::SetPriority(JobPriority priority)
+    {
+#ifdef AZ_DEBUG_JOB_STATE
+        AZ_Assert(m_state == STATE_SETUP, "Priority can only be set before the job is started");
+#endif
+        AZ_Assert(priority >= 0 && priority < JOB_PRIORITY_COUNT, "Invalid job priority %d", priority);
+        unsigned int countAndFlags = GetDependentCountAndFlags();
+        countAndFlags = (countAndFlags & ~(unsigned int)FLAG_PRIORITY_MASK) | (((unsigned int)priority << FLAG_PRIORITY_SHIFT) & FLAG_PRIORITY_MASK);
+        SetDependentCountAndFlags(countAndFlags);
+    }
+
+    AZ_FORCE_INLINE JobPriority Job::GetPriority() const
+    {
+        return static_cast<JobPriority>((GetDependentCountAndFlags() & FLAG_PRIORITY_MASK) >> FLAG_PRIORITY_SHIFT);
+    }
+
     AZ_FORCE_INLINE unsigned int Job::GetDependentCount()
     {
         return (GetDependentCountAndFlags() & FLAG_DEPENDENTCOUNT_MASK);
@@ -467,6 +532,81 @@ namespace AZ
         }
     }
 
+    inline bool Job::DecrementDependentCountDeferred()
+    {
+#ifdef AZ_DEBUG_JOB_STATE
+        AZ_Assert((m_state == STATE_SETUP) || (m_state == STATE_STARTED)
+            || (m_state == STATE_PROCESSING) || (m_state == STATE_SUSPENDED), //child jobs
+            "Job dependent count should not be decremented after job is already pending");
+#endif
+        AZ_Assert(GetDependentCount() > 0, ("Job dependent count is already zero"));
+#ifdef AZCORE_JOBS_IMPL_SYNCHRONOUS
+        unsigned int countAndFlags = m_dependentCountAndFlags--;
+#else
+        unsigned int countAndFlags = m_dependentCountAndFlags.fetch_sub(1, AZStd::memory_order_acq_rel);
+#endif
+        unsigned int count = countAndFlags & FLAG_DEPENDENTCOUNT_MASK;
+        if (count == 1)
+        {
+            if (countAndFlags & FLAG_CHILD_JOBS)
+            {
+                m_context->GetJobManager().NotifySuspendedJobReady(this);
+            }
+            else
+            {
+#ifdef AZ_DEBUG_JOB_STATE
+                AZ_Assert(m_state == STATE_STARTED, "Job has not been started but the dependent count is zero, must be a dependency error");
+                SetState(STATE_PENDING);
+#endif
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline void Job::QueueJobs(Job** readyJobs, size_t numJobs)
+    {
+        if (numJobs)
+        {
+            readyJobs[0]->m_context->GetJobManager().AddPendingJobs(readyJobs, numJobs);
+        }
+    }
+
+    inline void Job::StartJobs(Job** jobs, size_t numJobs)
+    {
+        if (numJobs == 0)
+        {
+            return;
+        }
+
+        //jobs are queued in chunks, so we don't need to allocate. The first job may be complete once the first chunk is
+        //queued, so we don't touch it anymore.
+        const size_t maxReadyJobs = 64;
+        Job* readyJobs[maxReadyJobs];
+        size_t numReadyJobs = 0;
+        JobManager* jobManager = &jobs[0]->m_context->GetJobManager();
+        (void)jobManager;
+        for (size_t i = 0; i < numJobs; ++i)
+        {
+            Job* job = jobs[i];
+            AZ_Assert(&job->m_context->GetJobManager() == jobManager, "All the jobs in a batch must belong to the same JobManager");
+#ifdef AZ_DEBUG_JOB_STATE
+            AZ_Assert(job->m_state == STATE_SETUP, ("Jobs must be in the setup state before they can be started"));
+            job->SetState(STATE_STARTED);
+#endif
+            if (job->DecrementDependentCountDeferred())
+            {
+                readyJobs[numReadyJobs++] = job;
+                if (numReadyJobs == maxReadyJobs)
+                {
+                    QueueJobs(readyJobs, numReadyJobs);
+                    numReadyJobs = 0;
+                }
+            }
+        }
+        QueueJobs(readyJobs, numReadyJobs);
+    }
+
 #ifdef AZ_DEBUG_JOB_STATE
     AZ_FORCE_INLINE void Job::SetState(int state)
     {
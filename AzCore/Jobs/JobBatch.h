@@ -0,0 +1,72 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZCORE_JOBS_JOBBATCH_H
+#define AZCORE_JOBS_JOBBATCH_H 1
+
+#include <AzCore/Jobs/Job.h>
+
+namespace AZ
+{
+    /**
+     * Collects jobs to start them together with Job::StartJobs, so fanning out many jobs only publishes to the queue
+     * and wakes up workers once per batch instead of once per job. The batch is started automatically when it's full.
+     * This is a stack object, it must be started (or be empty) when destroyed.
+     */
+    class JobBatch
+    {
+    public:
+        enum
+        {
+            MAX_JOBS = 64
+        };
+
+        JobBatch()
+            : m_numJobs(0)
+        {
+        }
+
+        ~JobBatch()
+        {
+            AZ_Assert(m_numJobs == 0, "JobBatch destroyed with jobs which were never started, call Start first");
+        }
+
+        /// Adds a job to the batch, it must belong to the same JobManager as the other jobs in the batch.
+        void Add(Job* job)
+        {
+            m_jobs[m_numJobs++] = job;
+            if (m_numJobs == MAX_JOBS)
+            {
+                Start();
+            }
+        }
+
+        /// Starts all the jobs in the batch, the batch is empty afterwards and can be reused.
+        void Start()
+        {
+            Job::StartJobs(m_jobs, m_numJobs);
+            m_numJobs = 0;
+        }
+
+        unsigned int GetNumJobs() const { return m_numJobs; }
+
+    private:
+        //non-copyable
+        JobBatch(const JobBatch&);
+        JobBatch& operator=(const JobBatch&);
+
+        Job* m_jobs[MAX_JOBS];
+        unsigned int m_numJobs;
+    };
+}
+
+#endif
+#pragma once
@@ -18,6 +18,20 @@ namespace AZ
 {
     class JobManager;
 
+    /**
+     * Job priority levels. Workers always pick the highest priority job available (from the global queue, their own
+     * queue and when stealing), with some starvation protection for lower priorities, see JobManagerDesc::m_priorityStarvationLimit.
+     */
+    enum JobPriority
+    {
+        JOB_PRIORITY_LOW = 0,
+        JOB_PRIORITY_NORMAL,
+        JOB_PRIORITY_HIGH,
+        JOB_PRIORITY_CRITICAL,
+
+        JOB_PRIORITY_COUNT
+    };
+
     /**
      * A job context stores information about the execution environment of jobs, a single context should be shared
      * between many jobs.
@@ -29,15 +43,18 @@ namespace AZ
 
         JobContext(JobManager& jobManager)
             : m_jobManager(jobManager)
-            , m_cancelGroup(NULL) { }
+            , m_cancelGroup(NULL)
+            , m_priority(JOB_PRIORITY_NORMAL) { }
 
         JobContext(JobManager& jobManager, JobCancelGroup& cancelGroup)
             : m_jobManager(jobManager)
-            , m_cancelGroup(&cancelGroup) { }
+            , m_cancelGroup(&cancelGroup)
+            , m_priority(JOB_PRIORITY_NORMAL) { }
 
         JobContext(const JobContext& rhs)
             : m_jobManager(rhs.m_jobManager)
-            , m_cancelGroup(rhs.m_cancelGroup) { }
+            , m_cancelGroup(rhs.m_cancelGroup)
+            , m_priority(rhs.m_priority) { }
 
         JobContext& operator=(const JobContext&) = delete;
 
@@ -50,6 +67,14 @@ namespace AZ
 
         JobCancelGroup* GetCancelGroup() const { return m_cancelGroup; }
 
+        /**
+         * Default priority for jobs created with this context, individual jobs can override it with Job::SetPriority.
+         * Call this only before jobs using this context have been created, it is not threadsafe.
+         */
+        void SetPriority(JobPriority priority) { m_priority = priority; }
+
+        JobPriority GetPriority() const { return m_priority; }
+
         /**
          * Sets the global job context, this is what will be used when creating a top-level job without specifying
          * the context explicitly.
@@ -68,6 +93,7 @@ namespace AZ
 
         JobManager& m_jobManager;
         JobCancelGroup* m_cancelGroup;
+        JobPriority m_priority;
     };
 }
 
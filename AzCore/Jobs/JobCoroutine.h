@@ -0,0 +1,401 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZCORE_JOBS_JOBCOROUTINE_H
+#define AZCORE_JOBS_JOBCOROUTINE_H 1
+
+#include <AzCore/Jobs/Job.h>
+#include <AzCore/Jobs/JobEmpty.h>
+#include <AzCore/Jobs/JobCancelGroup.h>
+#include <AzCore/Memory/PoolAllocator.h>
+#include <AzCore/Memory/SystemAllocator.h>
+
+//coroutines need compiler support (C++20), the header compiles to nothing otherwise
+#if defined(__cpp_impl_coroutine)
+#   define AZ_JOBS_COROUTINES 1
+#   include <coroutine>
+#endif
+
+#if defined(AZ_JOBS_COROUTINES)
+
+namespace AZ
+{
+    namespace Internal
+    {
+        /**
+         * Resumes a coroutine when processed. Each JobTask frame embeds one, it's re-armed every time the coroutine
+         * suspends, so awaiting does not allocate.
+         */
+        class CoroutineResumeJob
+            : public Job
+        {
+        public:
+            CoroutineResumeJob(JobContext* context)
+                : Job(false, context)
+            {
+            }
+
+            void Schedule()
+            {
+                Reset(true);
+                Start();
+            }
+
+            std::coroutine_handle<> m_coroutine;
+
+        protected:
+            void Process() override
+            {
+                //the coroutine may complete and free this job, don't touch any member after resuming
+                m_coroutine.resume();
+            }
+        };
+    }
+
+    /**
+     * Coroutine running on the JobManager workers, declare a function returning a JobTask and use co_await in it
+     * to suspend until jobs are complete:
+     *
+     *  JobTask LoadLevel(const char* name)
+     *  {
+     *      co_await *aznew JobFunction<...>(..., true); //starts the job, resumes when it's complete
+     *      Job* jobs[] = { ... };
+     *      co_await AwaitJobs(jobs, AZ_ARRAY_SIZE(jobs)); //starts all jobs, resumes when they are all complete
+     *      co_await LoadTextures(name); //runs another JobTask, resumes when it's complete
+     *      if (co_await cancelGroup) //checks a cancel group without suspending
+     *      {
+     *          co_return;
+     *      }
+     *  }
+     *
+     * A coroutine does not run until its task is started (with Start or StartAndWaitForCompletion) or awaited, it
+     * always runs in a job and resumes in a job, on any worker. Awaited jobs must not be started by the caller, and
+     * can be auto-delete. Awaiting never blocks the worker, and does not allocate: the coroutine frame (allocated from
+     * the ThreadPoolAllocator when it's small enough, otherwise from the SystemAllocator) holds the job used to resume.
+     *
+     * The coroutine body runs with a copy of the task context without the cancel group, so a cancelled task still
+     * resumes and completes. Check the cancel group with co_await, or pass the task context explicitly to jobs
+     * which should be cancelled.
+     */
+    class JobTask
+    {
+    public:
+        class promise_type
+        {
+        public:
+            promise_type()
+                : m_resumeContext(*JobContext::GetParentContext())
+                , m_cancelGroup(m_resumeContext.GetCancelGroup())
+                , m_resumeJob(&m_resumeContext)
+                , m_dependent(nullptr)
+                , m_isDetached(false)
+            {
+                m_resumeContext.SetCancelGroup(nullptr);
+                m_resumeJob.m_coroutine = std::coroutine_handle<promise_type>::from_promise(*this);
+            }
+
+            static void* operator new(size_t byteSize)
+            {
+                if (AZ::SizeAlignUp(byteSize, AZCORE_GLOBAL_NEW_ALIGNMENT) <= AllocatorInstance<ThreadPoolAllocator>::Get().GetMaxAllocationSize())
+                {
+                    return AllocatorInstance<ThreadPoolAllocator>::Get().Allocate(byteSize, AZCORE_GLOBAL_NEW_ALIGNMENT, 0, "JobTask", __FILE__, __LINE__);
+                }
+                return AllocatorInstance<SystemAllocator>::Get().Allocate(byteSize, AZCORE_GLOBAL_NEW_ALIGNMENT, 0, "JobTask", __FILE__, __LINE__);
+            }
+
+            static void operator delete(void* address, size_t byteSize)
+            {
+                if (AZ::SizeAlignUp(byteSize, AZCORE_GLOBAL_NEW_ALIGNMENT) <= AllocatorInstance<ThreadPoolAllocator>::Get().GetMaxAllocationSize())
+                {
+                    AllocatorInstance<ThreadPoolAllocator>::Get().DeAllocate(address, byteSize);
+                }
+                else
+                {
+                    AllocatorInstance<SystemAllocator>::Get().DeAllocate(address, byteSize);
+                }
+            }
+
+            JobTask get_return_object()
+            {
+                return JobTask(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept { return std::suspend_always(); }
+
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept { return false; }
+                void await_suspend(std::coroutine_handle<promise_type> coroutine) noexcept
+                {
+                    //the frame can be destroyed by the awaiting task as soon as it's notified
+                    promise_type& promise = coroutine.promise();
+                    Job* dependent = promise.m_dependent;
+                    if (promise.m_isDetached)
+                    {
+                        coroutine.destroy();
+                    }
+                    if (dependent)
+                    {
+                        dependent->DecrementDependentCount();
+                    }
+                }
+                void await_resume() noexcept {}
+            };
+
+            FinalAwaiter final_suspend() noexcept { return FinalAwaiter(); }
+
+            void return_void() {}
+
+            void unhandled_exception()
+            {
+                AZ_Assert(false, "Exceptions must not escape from a JobTask");
+            }
+
+            /// Context used for the coroutine jobs, see JobTask::SetContext.
+            void SetContext(JobContext& context)
+            {
+                m_resumeContext.~JobContext();
+                new(&m_resumeContext) JobContext(context);
+                m_cancelGroup = context.GetCancelGroup();
+                m_resumeContext.SetCancelGroup(nullptr);
+                m_resumeJob.SetPriority(context.GetPriority());
+            }
+
+            JobContext m_resumeContext; ///< Copy of the task context without the cancel group
+            JobCancelGroup* m_cancelGroup;
+            Internal::CoroutineResumeJob m_resumeJob;
+            Job* m_dependent; ///< Notified when the coroutine completes
+            bool m_isDetached; ///< Frame is destroyed when the coroutine completes
+        };
+
+        typedef std::coroutine_handle<promise_type> Handle;
+
+        JobTask()
+        {
+        }
+
+        JobTask(JobTask&& rhs)
+            : m_coroutine(rhs.m_coroutine)
+        {
+            rhs.m_coroutine = nullptr;
+        }
+
+        JobTask& operator=(JobTask&& rhs)
+        {
+            if (this != &rhs)
+            {
+                Destroy();
+                m_coroutine = rhs.m_coroutine;
+                rhs.m_coroutine = nullptr;
+            }
+            return *this;
+        }
+
+        /// The task must not be running, a started task must be waited for.
+        ~JobTask()
+        {
+            Destroy();
+        }
+
+        bool IsValid() const { return static_cast<bool>(m_coroutine); }
+
+        /**
+         * Sets the context used by the coroutine jobs, the context of the job creating the task is used by default.
+         * Must be called before the task is started.
+         */
+        void SetContext(JobContext& context)
+        {
+            AZ_Assert(m_coroutine, "Invalid task");
+            m_coroutine.promise().SetContext(context);
+        }
+
+        /// Cancel group of the task context, if any.
+        JobCancelGroup* GetCancelGroup() const
+        {
+            AZ_Assert(m_coroutine, "Invalid task");
+            return m_coroutine.promise().m_cancelGroup;
+        }
+
+        /// Starts the coroutine, which will free itself when complete. The task is invalid afterwards.
+        void Start()
+        {
+            AZ_Assert(m_coroutine, "Invalid task");
+            promise_type& promise = m_coroutine.promise();
+            promise.m_isDetached = true;
+            m_coroutine = nullptr;
+            promise.m_resumeJob.Schedule();
+        }
+
+        /**
+         * Starts the coroutine and blocks until it's complete. If called from a job, the job waits for the coroutine
+         * as a child, see Job::StartAndWaitForCompletion.
+         */
+        void StartAndWaitForCompletion()
+        {
+            AZ_Assert(m_coroutine, "Invalid task");
+            promise_type& promise = m_coroutine.promise();
+            JobEmpty completion(false, &promise.m_resumeContext);
+            completion.IncrementDependentCount();
+            promise.m_dependent = &completion;
+            promise.m_resumeJob.Schedule();
+            completion.StartAndWaitForCompletion();
+        }
+
+        /// Awaiting a task from another coroutine runs it, and resumes the awaiting coroutine when it's complete.
+        struct Awaiter
+        {
+            bool await_ready() { return false; }
+            void await_suspend(Handle awaiting)
+            {
+                Internal::CoroutineResumeJob* resumeJob = &awaiting.promise().m_resumeJob;
+                promise_type& promise = m_coroutine.promise();
+                resumeJob->Reset(true);
+                resumeJob->IncrementDependentCount();
+                promise.m_dependent = resumeJob;
+                resumeJob->Start();
+                promise.m_resumeJob.Schedule();
+            }
+            void await_resume() {}
+
+            Handle m_coroutine;
+        };
+
+        Awaiter operator co_await() &
+        {
+            AZ_Assert(m_coroutine, "Invalid task");
+            return Awaiter{ m_coroutine };
+        }
+
+        Awaiter operator co_await() &&
+        {
+            AZ_Assert(m_coroutine, "Invalid task");
+            return Awaiter{ m_coroutine };
+        }
+
+    private:
+        explicit JobTask(Handle coroutine)
+            : m_coroutine(coroutine)
+        {
+        }
+
+        //non-copyable
+        JobTask(const JobTask&) = delete;
+        JobTask& operator=(const JobTask&) = delete;
+
+        void Destroy()
+        {
+            if (m_coroutine)
+            {
+                m_coroutine.destroy();
+                m_coroutine = nullptr;
+            }
+        }
+
+        Handle m_coroutine;
+    };
+
+    namespace Internal
+    {
+        /// Starts a job, the awaiting coroutine resumes when it's complete.
+        struct JobAwaiter
+        {
+            bool await_ready() { return false; }
+            void await_suspend(JobTask::Handle awaiting)
+            {
+                //the awaiter lives in the coroutine frame, which may resume on another worker as soon as the job is started
+                CoroutineResumeJob* resumeJob = &awaiting.promise().m_resumeJob;
+                Job* job = m_job;
+                resumeJob->Reset(true);
+                job->SetDependent(resumeJob);
+                resumeJob->Start();
+                job->Start();
+            }
+            void await_resume() {}
+
+            Job* m_job;
+        };
+
+        /// Starts a batch of jobs, the awaiting coroutine resumes when they are all complete.
+        struct JobBatchAwaiter
+        {
+            bool await_ready() { return m_numJobs == 0; }
+            void await_suspend(JobTask::Handle awaiting)
+            {
+                CoroutineResumeJob* resumeJob = &awaiting.promise().m_resumeJob;
+                Job** jobs = m_jobs;
+                size_t numJobs = m_numJobs;
+                resumeJob->Reset(true);
+                for (size_t i = 0; i < numJobs; ++i)
+                {
+                    jobs[i]->SetDependent(resumeJob);
+                }
+                resumeJob->Start();
+                for (size_t i = 0; i < numJobs; ++i)
+                {
+                    jobs[i]->Start();
+                }
+            }
+            void await_resume() {}
+
+            Job** m_jobs;
+            size_t m_numJobs;
+        };
+
+        /// Reschedules the awaiting coroutine as a new job.
+        struct JobYieldAwaiter
+        {
+            bool await_ready() { return false; }
+            void await_suspend(JobTask::Handle awaiting)
+            {
+                awaiting.promise().m_resumeJob.Schedule();
+            }
+            void await_resume() {}
+        };
+
+        struct JobCancelGroupAwaiter
+        {
+            bool await_ready() { return true; }
+            void await_suspend(JobTask::Handle) {}
+            bool await_resume() { return m_cancelGroup->IsCancelled(); }
+
+            JobCancelGroup* m_cancelGroup;
+        };
+    }
+
+    /// co_await job starts the job (which must not be started yet), and resumes when it's complete.
+    inline Internal::JobAwaiter operator co_await(Job& job)
+    {
+        return Internal::JobAwaiter{ &job };
+    }
+
+    /// co_await AwaitJobs(jobs, numJobs) starts all the jobs (which must not be started yet), and resumes when they are all complete.
+    inline Internal::JobBatchAwaiter AwaitJobs(Job** jobs, size_t numJobs)
+    {
+        return Internal::JobBatchAwaiter{ jobs, numJobs };
+    }
+
+    /// co_await JobYield() lets other jobs run, the coroutine resumes in a new job.
+    inline Internal::JobYieldAwaiter JobYield()
+    {
+        return Internal::JobYieldAwaiter();
+    }
+
+    /// co_await cancelGroup returns true if the group is cancelled, it does not suspend.
+    inline Internal::JobCancelGroupAwaiter operator co_await(JobCancelGroup& cancelGroup)
+    {
+        return Internal::JobCancelGroupAwaiter{ &cancelGroup };
+    }
+}
+
+#endif // AZ_JOBS_COROUTINES
+
+#endif
+#pragma once
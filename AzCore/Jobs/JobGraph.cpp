@@ -0,0 +1,425 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZ_UNITY_BUILD
+
+#include <AzCore/Jobs/JobGraph.h>
+#include <AzCore/std/algorithm.h>
+#include <AzCore/std/sort.h>
+
+using namespace AZ;
+
+/**
+ * Compiled graph node. Node jobs are never deleted by the job manager, they are re-armed by JobGraph::Run, and release
+ * their successors directly once processed. The graph completion job is their regular dependent.
+ */
+class JobGraph::NodeJob
+    : public Job
+{
+public:
+    NodeJob(JobGraph* graph, const NodeFunction* function, const AZ::u32* successors, AZ::u32 numSuccessors, AZ::u32 numPredecessors)
+        : Job(false, &graph->m_context)
+        , m_graph(graph)
+        , m_function(function)
+        , m_successors(successors)
+        , m_numSuccessors(numSuccessors)
+        , m_numPredecessors(numPredecessors)
+        , m_priority(JOB_PRIORITY_NORMAL)
+        , m_isCritical(false)
+        , m_startTime(0)
+        , m_endTime(0)
+    {
+    }
+
+    JobGraph* m_graph;
+    const NodeFunction* m_function;
+    const AZ::u32* m_successors;
+    AZ::u32 m_numSuccessors;
+    AZ::u32 m_numPredecessors;
+    JobPriority m_priority;
+    bool m_isCritical;
+    AZStd::sys_time_t m_startTime;
+    AZStd::sys_time_t m_endTime;
+
+protected:
+    virtual void Process()
+    {
+        m_startTime = AZStd::GetTimeNowTicks();
+        JobCancelGroup* cancelGroup = m_graph->m_cancelGroup;
+        if (!cancelGroup || !cancelGroup->IsCancelled())
+        {
+            (*m_function)();
+        }
+        m_endTime = AZStd::GetTimeNowTicks();
+
+        //successors which become ready are queued together
+        const AZ::u32 maxReadyJobs = 32;
+        Job* readyJobs[maxReadyJobs];
+        AZ::u32 numReadyJobs = 0;
+        NodeJob* jobs = m_graph->m_jobs;
+        for (AZ::u32 i = 0; i < m_numSuccessors; ++i)
+        {
+            NodeJob& successor = jobs[m_successors[i]];
+            if (successor.DecrementDependentCountDeferred())
+            {
+                readyJobs[numReadyJobs++] = &successor;
+                if (numReadyJobs == maxReadyJobs)
+                {
+                    QueueJobs(readyJobs, numReadyJobs);
+                    numReadyJobs = 0;
+                }
+            }
+        }
+        QueueJobs(readyJobs, numReadyJobs);
+    }
+};
+
+//=========================================================================
+// JobGraph
+//=========================================================================
+JobGraph::JobGraph(JobContext* context)
+    : m_context(context ? *context : *JobContext::GetParentContext())
+    , m_isCompiled(false)
+    , m_jobs(nullptr)
+    , m_numJobs(0)
+    , m_completion(false, &m_context)
+    , m_runStartTime(0)
+    , m_runEndTime(0)
+{
+    m_cancelGroup = m_context.GetCancelGroup();
+    m_context.SetCancelGroup(nullptr);
+}
+
+//=========================================================================
+// ~JobGraph
+//=========================================================================
+JobGraph::~JobGraph()
+{
+    DestroyJobs();
+}
+
+//=========================================================================
+// AddNode
+//=========================================================================
+JobGraph::NodeId JobGraph::AddNode(const NodeFunction& function, const char* name, float cost)
+{
+    m_isCompiled = false;
+    m_nodes.push_back();
+    Node& node = m_nodes.back();
+    node.m_function = function;
+    node.m_name = name;
+    node.m_cost = cost;
+    return static_cast<NodeId>(m_nodes.size() - 1);
+}
+
+//=========================================================================
+// AddEdge
+//=========================================================================
+void JobGraph::AddEdge(NodeId from, NodeId to)
+{
+    AZ_Assert(from < m_nodes.size() && to < m_nodes.size(), "Invalid JobGraph node id");
+    AZ_Assert(from != to, "JobGraph node can't depend on itself");
+    m_isCompiled = false;
+    Edge edge;
+    edge.m_from = from;
+    edge.m_to = to;
+    m_edges.push_back(edge);
+}
+
+//=========================================================================
+// Clear
+//=========================================================================
+void JobGraph::Clear()
+{
+    DestroyJobs();
+    m_nodes.clear();
+    m_edges.clear();
+}
+
+//=========================================================================
+// DestroyJobs
+//=========================================================================
+void JobGraph::DestroyJobs()
+{
+    if (m_jobs)
+    {
+        for (AZ::u32 i = 0; i < m_numJobs; ++i)
+        {
+            m_jobs[i].~NodeJob();
+        }
+        azfree(m_jobs, SystemAllocator);
+        m_jobs = nullptr;
+    }
+    m_numJobs = 0;
+    m_isCompiled = false;
+}
+
+//=========================================================================
+// Compile
+//=========================================================================
+void JobGraph::Compile()
+{
+    DestroyJobs();
+
+    AZ::u32 numNodes = static_cast<AZ::u32>(m_nodes.size());
+    AZ::u32 numEdges = static_cast<AZ::u32>(m_edges.size());
+
+    //successors in node id order
+    AZStd::vector<AZ::u32> numPredecessors(numNodes, 0);
+    AZStd::vector<AZ::u32> successorOffsets(numNodes + 1, 0);
+    for (AZ::u32 i = 0; i < numEdges; ++i)
+    {
+        ++successorOffsets[m_edges[i].m_from + 1];
+        ++numPredecessors[m_edges[i].m_to];
+    }
+    for (AZ::u32 i = 0; i < numNodes; ++i)
+    {
+        successorOffsets[i + 1] += successorOffsets[i];
+    }
+    AZStd::vector<AZ::u32> nodeSuccessors(numEdges);
+    {
+        AZStd::vector<AZ::u32> cursor(successorOffsets.begin(), successorOffsets.end() - 1);
+        for (AZ::u32 i = 0; i < numEdges; ++i)
+        {
+            nodeSuccessors[cursor[m_edges[i].m_from]++] = m_edges[i].m_to;
+        }
+    }
+
+    //topological order
+    AZStd::vector<AZ::u32> order;
+    order.reserve(numNodes);
+    AZStd::vector<AZ::u32> remaining(numPredecessors);
+    for (AZ::u32 i = 0; i < numNodes; ++i)
+    {
+        if (remaining[i] == 0)
+        {
+            order.push_back(i);
+        }
+    }
+    for (AZ::u32 i = 0; i < order.size(); ++i)
+    {
+        AZ::u32 node = order[i];
+        for (AZ::u32 j = successorOffsets[node]; j < successorOffsets[node + 1]; ++j)
+        {
+            if (--remaining[nodeSuccessors[j]] == 0)
+            {
+                order.push_back(nodeSuccessors[j]);
+            }
+        }
+    }
+    if (order.size() != numNodes)
+    {
+        AZ_Error("JobGraph", false, "JobGraph has a cycle, it can't be compiled");
+        return;
+    }
+
+    //flatten in topological order
+    m_nodeToJob.resize(numNodes);
+    for (AZ::u32 i = 0; i < numNodes; ++i)
+    {
+        m_nodeToJob[order[i]] = i;
+    }
+    m_successors.resize(numEdges);
+    m_costs.resize(numNodes);
+    m_earliestStart.resize(numNodes);
+    m_longestChain.resize(numNodes);
+    m_roots.clear();
+
+    if (numNodes)
+    {
+        m_jobs = reinterpret_cast<NodeJob*>(azmalloc(sizeof(NodeJob) * numNodes, AZStd::alignment_of<NodeJob>::value, SystemAllocator, "AZ::JobGraph"));
+    }
+    AZ::u32 numSuccessors = 0;
+    for (AZ::u32 i = 0; i < numNodes; ++i)
+    {
+        AZ::u32 node = order[i];
+        AZ::u32 firstSuccessor = numSuccessors;
+        for (AZ::u32 j = successorOffsets[node]; j < successorOffsets[node + 1]; ++j)
+        {
+            m_successors[numSuccessors++] = m_nodeToJob[nodeSuccessors[j]];
+        }
+        new(&m_jobs[i]) NodeJob(this, &m_nodes[node].m_function, m_successors.data() + firstSuccessor, numSuccessors - firstSuccessor, numPredecessors[node]);
+        m_costs[i] = m_nodes[node].m_cost;
+        if (numPredecessors[node] == 0)
+        {
+            m_roots.push_back(i);
+        }
+    }
+    m_numJobs = numNodes;
+
+    ComputeCriticalPath();
+    m_isCompiled = true;
+}
+
+//=========================================================================
+// ComputeCriticalPath
+//=========================================================================
+void JobGraph::ComputeCriticalPath()
+{
+    //longest chain starting at each node, jobs are in topological order so successors come later
+    float criticalLength = 0.0f;
+    for (AZ::u32 i = m_numJobs; i-- > 0; )
+    {
+        const NodeJob& job = m_jobs[i];
+        float chain = 0.0f;
+        for (AZ::u32 j = 0; j < job.m_numSuccessors; ++j)
+        {
+            chain = AZStd::GetMax(chain, m_longestChain[job.m_successors[j]]);
+        }
+        m_longestChain[i] = m_costs[i] + chain;
+        criticalLength = AZStd::GetMax(criticalLength, m_longestChain[i]);
+    }
+
+    //earliest start of each node, given infinite threads
+    for (AZ::u32 i = 0; i < m_numJobs; ++i)
+    {
+        m_earliestStart[i] = 0.0f;
+    }
+    for (AZ::u32 i = 0; i < m_numJobs; ++i)
+    {
+        const NodeJob& job = m_jobs[i];
+        float end = m_earliestStart[i] + m_costs[i];
+        for (AZ::u32 j = 0; j < job.m_numSuccessors; ++j)
+        {
+            float& successorStart = m_earliestStart[job.m_successors[j]];
+            successorStart = AZStd::GetMax(successorStart, end);
+        }
+    }
+
+    //nodes without slack are on the critical path, they get a priority boost
+    JobPriority priority = m_context.GetPriority();
+    JobPriority criticalPriority = (priority + 1 < JOB_PRIORITY_COUNT) ? static_cast<JobPriority>(priority + 1) : priority;
+    float criticalThreshold = criticalLength * 0.999f;
+    for (AZ::u32 i = 0; i < m_numJobs; ++i)
+    {
+        NodeJob& job = m_jobs[i];
+        job.m_isCritical = (m_earliestStart[i] + m_longestChain[i]) >= criticalThreshold;
+        job.m_priority = job.m_isCritical ? criticalPriority : priority;
+    }
+
+    AZStd::vector<float>& longestChain = m_longestChain;
+    AZStd::sort(m_roots.begin(), m_roots.end(), [&longestChain](AZ::u32 lhs, AZ::u32 rhs) { return longestChain[lhs] > longestChain[rhs]; });
+    m_rootJobs.resize(m_roots.size());
+    for (AZ::u32 i = 0; i < m_roots.size(); ++i)
+    {
+        m_rootJobs[i] = &m_jobs[m_roots[i]];
+    }
+}
+
+//=========================================================================
+// UpdateCriticalPath
+//=========================================================================
+void JobGraph::UpdateCriticalPath()
+{
+    if (!m_isCompiled)
+    {
+        return;
+    }
+    const float ticksToMicroSeconds = 1000000.0f / static_cast<float>(AZStd::GetTimeTicksPerSecond());
+    for (AZ::u32 i = 0; i < m_numJobs; ++i)
+    {
+        m_costs[i] = static_cast<float>(m_jobs[i].m_endTime - m_jobs[i].m_startTime) * ticksToMicroSeconds;
+    }
+    ComputeCriticalPath();
+}
+
+//=========================================================================
+// ArmJob
+//=========================================================================
+void JobGraph::ArmJob(Job* job, unsigned int count, JobPriority priority, Job* dependent)
+{
+    //plain stores, the jobs are not running and are published to the workers when the roots are started
+    unsigned int countAndFlags = count | (((unsigned int)priority << Job::FLAG_PRIORITY_SHIFT) & Job::FLAG_PRIORITY_MASK);
+    job->SetDependentCountAndFlags(countAndFlags);
+    job->StoreDependent(dependent);
+#ifdef AZ_DEBUG_JOB_STATE
+    job->SetState(Job::STATE_SETUP);
+#endif
+}
+
+//=========================================================================
+// Run
+//=========================================================================
+void JobGraph::Run()
+{
+    if (!m_isCompiled)
+    {
+        Compile();
+        if (!m_isCompiled)
+        {
+            return;
+        }
+    }
+    if (m_numJobs == 0)
+    {
+        return;
+    }
+
+    //the completion waits for its own start and all the nodes
+    ArmJob(&m_completion, m_numJobs + 1, m_context.GetPriority(), nullptr);
+
+    //nodes with predecessors are armed as already started, they are queued by the last predecessor to complete
+    for (AZ::u32 i = 0; i < m_numJobs; ++i)
+    {
+        NodeJob& job = m_jobs[i];
+        if (job.m_numPredecessors)
+        {
+            ArmJob(&job, job.m_numPredecessors, job.m_priority, &m_completion);
+#ifdef AZ_DEBUG_JOB_STATE
+            job.SetState(Job::STATE_STARTED);
+#endif
+        }
+        else
+        {
+            ArmJob(&job, 1, job.m_priority, &m_completion);
+        }
+    }
+
+    m_runStartTime = AZStd::GetTimeNowTicks();
+    Job::StartJobs(m_rootJobs.data(), m_rootJobs.size());
+    m_completion.StartAndWaitForCompletion();
+    m_runEndTime = AZStd::GetTimeNowTicks();
+}
+
+//=========================================================================
+// GetNodeTimings
+//=========================================================================
+void JobGraph::GetNodeTimings(AZStd::vector<NodeTiming>& timings) const
+{
+    timings.clear();
+    if (!m_isCompiled)
+    {
+        return;
+    }
+    const float ticksToMicroSeconds = 1000000.0f / static_cast<float>(AZStd::GetTimeTicksPerSecond());
+    timings.reserve(m_numJobs);
+    for (NodeId node = 0; node < m_numJobs; ++node)
+    {
+        const NodeJob& job = m_jobs[m_nodeToJob[node]];
+        NodeTiming timing;
+        timing.m_node = node;
+        timing.m_name = m_nodes[node].m_name;
+        timing.m_startTime = static_cast<float>(job.m_startTime - m_runStartTime) * ticksToMicroSeconds;
+        timing.m_duration = static_cast<float>(job.m_endTime - job.m_startTime) * ticksToMicroSeconds;
+        timing.m_isCritical = job.m_isCritical;
+        timings.push_back(timing);
+    }
+}
+
+//=========================================================================
+// GetLastRunDuration
+//=========================================================================
+float JobGraph::GetLastRunDuration() const
+{
+    return static_cast<float>(m_runEndTime - m_runStartTime) * 1000000.0f / static_cast<float>(AZStd::GetTimeTicksPerSecond());
+}
+
+#endif // #ifndef AZ_UNITY_BUILD
@@ -0,0 +1,151 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZCORE_JOBS_JOBGRAPH_H
+#define AZCORE_JOBS_JOBGRAPH_H 1
+
+#include <AzCore/Jobs/Job.h>
+#include <AzCore/Jobs/JobEmpty.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/functional.h>
+#include <AzCore/std/time.h>
+
+namespace AZ
+{
+    /**
+     * A reusable graph of jobs. Nodes and edges are declared once, then compiled into a flat array of jobs (in
+     * topological order) and a flat successor list. Each Run resets the compiled jobs in place, so running the graph
+     * does not allocate and costs a single store per node to re-arm it, instead of creating and wiring every job again.
+     *
+     * Nodes can have any number of predecessors and successors. A node starts when all its predecessors are complete,
+     * Run blocks until all nodes are complete (if called from a job, the job waits for the graph as a child).
+     *
+     * Scheduling hints: each node has a cost (estimated, or the measured duration of the last run after calling
+     * UpdateCriticalPath). Nodes on the critical path (the longest chain by cost) run one priority level above the
+     * graph context priority, and root nodes are started longest chain first.
+     *
+     * Cancellation: the graph context cancel group is checked before each node function is called, cancelled nodes
+     * are skipped but still release their successors. Nodes run with a copy of the graph context which has no cancel
+     * group, pass the graph context explicitly to jobs created from node functions if they need to be cancelled too.
+     */
+    class JobGraph
+    {
+    public:
+        AZ_CLASS_ALLOCATOR(JobGraph, SystemAllocator, 0)
+
+        typedef AZ::u32 NodeId;
+        typedef AZStd::function<void()> NodeFunction;
+
+        /// Timing of a node in the last run, times are in microseconds since the start of the run.
+        struct NodeTiming
+        {
+            NodeId m_node;
+            const char* m_name;
+            float m_startTime;
+            float m_duration;
+            bool m_isCritical; ///< Node was on the critical path when the run started
+        };
+
+        /**
+         * If a JobContext is not specified, the context is picked like for a regular job, see Job::Job.
+         */
+        JobGraph(JobContext* context = nullptr);
+
+        ~JobGraph();
+
+        /**
+         * Adds a node, which will call function when run. cost is an estimate of the node duration, only the ratio
+         * to other node costs matters. The name is stored by pointer, used for timing exports.
+         */
+        NodeId AddNode(const NodeFunction& function, const char* name = nullptr, float cost = 1.0f);
+
+        /// Node 'to' will not start until node 'from' is complete.
+        void AddEdge(NodeId from, NodeId to);
+
+        /// Removes all nodes and edges.
+        void Clear();
+
+        AZ::u32 GetNumNodes() const { return static_cast<AZ::u32>(m_nodes.size()); }
+
+        /**
+         * Compiles the graph, this is where all the allocation happens. Called by Run if the graph was modified since
+         * the last compile. The graph must be acyclic.
+         */
+        void Compile();
+
+        bool IsCompiled() const { return m_isCompiled; }
+
+        /// Runs all the nodes and blocks until they are complete. Must not be called while the graph is running.
+        void Run();
+
+        /**
+         * Uses the measured node durations of the last run as costs, and updates the critical path hints for the next
+         * runs. Does not allocate, can be called every frame or only once in a while.
+         */
+        void UpdateCriticalPath();
+
+        /// Exports the node timings of the last run.
+        void GetNodeTimings(AZStd::vector<NodeTiming>& timings) const;
+
+        /// Duration of the last run in microseconds.
+        float GetLastRunDuration() const;
+
+    private:
+        //non-copyable
+        JobGraph(const JobGraph&);
+        JobGraph& operator=(const JobGraph&);
+
+        class NodeJob;
+        friend class NodeJob;
+
+        struct Node
+        {
+            NodeFunction m_function;
+            const char* m_name;
+            float m_cost;
+        };
+
+        struct Edge
+        {
+            NodeId m_from;
+            NodeId m_to;
+        };
+
+        void DestroyJobs();
+        void ComputeCriticalPath();
+        void ArmJob(Job* job, unsigned int count, JobPriority priority, Job* dependent);
+
+        JobContext m_context; ///< Copy of the graph context without the cancel group, used by the node jobs
+        JobCancelGroup* m_cancelGroup;
+
+        AZStd::vector<Node> m_nodes;
+        AZStd::vector<Edge> m_edges;
+
+        //compiled graph, indexed in topological order
+        bool m_isCompiled;
+        NodeJob* m_jobs;
+        AZ::u32 m_numJobs;
+        AZStd::vector<AZ::u32> m_successors; ///< Successors of all nodes, each node has a range in this array
+        AZStd::vector<AZ::u32> m_roots; ///< Nodes without predecessors, sorted by longest chain first
+        AZStd::vector<Job*> m_rootJobs; ///< Jobs of the root nodes, in the same order, started as a batch
+        AZStd::vector<float> m_costs;
+        AZStd::vector<float> m_earliestStart;
+        AZStd::vector<float> m_longestChain; ///< Cost of the longest chain starting at each node, including the node
+        AZStd::vector<AZ::u32> m_nodeToJob;
+
+        JobEmpty m_completion;
+        AZStd::sys_time_t m_runStartTime;
+        AZStd::sys_time_t m_runEndTime;
+    };
+}
+
+#endif
+#pragma once
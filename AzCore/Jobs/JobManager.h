@@ -86,6 +86,28 @@ namespace AZ
         /// Returns number of active worker threads.
         unsigned int GetNumWorkerThreads() const    { return m_impl.GetNumWorkerThreads(); }
 
+        /**
+         * Returns true if there are no queued jobs which the current thread would pick next. This is only a hint, it's
+         * used by the parallel algorithms to split work when other threads are likely to be idle (lazy binary splitting).
+         */
+        bool IsLocalQueueEmpty() const { return m_impl.IsLocalQueueEmpty(); }
+
+        /**
+         * Job tracing, for a timeline of the job system. While enabled each thread records when jobs begin, end, are
+         * suspended and resumed, when it steals a job and when it parks, with TSC timestamps, to its own ring buffer (no
+         * locks, see JobManagerDesc::m_traceBufferSize). Enabling starts a new capture. While disabled the cost is a
+         * branch per event. Only the work stealing implementation records events.
+         */
+        void SetTracingEnabled(bool isEnabled) { m_impl.SetTracingEnabled(isEnabled); }
+        bool IsTracingEnabled() const { return m_impl.IsTracingEnabled(); }
+
+        /**
+         * Appends the events of the last capture to output in the Chrome trace event JSON format, which loads in
+         * chrome://tracing and in the Perfetto UI. Tracing can still be enabled, but events recorded meanwhile may be
+         * missing.
+         */
+        void WriteChromeTrace(AZStd::string& output) { m_impl.WriteChromeTrace(output); }
+
     private:
         //non-copyable
         JobManager(const JobManager& manager);
@@ -95,6 +117,7 @@ namespace AZ
         friend class Job;
         friend class Internal::JobNotify;
         AZ_FORCE_INLINE void AddPendingJob(Job* job) { m_impl.AddPendingJob(job); }
+        AZ_FORCE_INLINE void AddPendingJobs(Job** jobs, size_t numJobs) { m_impl.AddPendingJobs(jobs, numJobs); }
 
         //called internally by Job class to suspend itself until child jobs are complete
         AZ_FORCE_INLINE void SuspendJobUntilReady(Job* job) { m_impl.SuspendJobUntilReady(job); }
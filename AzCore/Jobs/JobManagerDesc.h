@@ -14,6 +14,7 @@
 
 #include <AzCore/base.h>
 #include <AzCore/std/containers/fixed_vector.h>
+#include <AzCore/std/parallel/thread.h>
 
 namespace AZ
 {
@@ -29,6 +30,12 @@ namespace AZ
          */
         int     m_cpuId;
 
+        /**
+         *  Affinity mask, bit N allows the thread to run on core N, see \ref AZStd::thread_desc::m_cpuMask.
+         *  When any bit is set it is used instead of m_cpuId. Default is empty.
+         */
+        AZStd::thread_cpu_mask m_cpuMask;
+
         /**
          *  Windows: One of the following values:
          *      THREAD_PRIORITY_IDLE
@@ -60,9 +67,60 @@ namespace AZ
      */
     struct JobManagerDesc
     {
-        JobManagerDesc() {}
+        JobManagerDesc()
+            : m_idleSpinCount(64)
+            , m_maxSpinningWorkers(2)
+            , m_priorityStarvationLimit(32)
+            , m_useFibers(false)
+            , m_fiberStackSize(128 * 1024)
+            , m_globalQueueCapacity(4096)
+            , m_traceBufferSize(16 * 1024)
+        {}
 
         AZStd::fixed_vector<JobManagerThreadDesc, 64> m_workerThreads; ///< List of worker threads to create
+
+        /**
+         * Idle policy for worker threads. A worker which runs out of jobs spins (polling the global queue and stealing)
+         * for up to m_idleSpinCount iterations before it parks on its wait event. While at least one worker is spinning,
+         * adding a job will not wake a parked worker, the spinning one will pick it up instead.
+         * Set m_idleSpinCount to 0 to park immediately. Only used by the work stealing implementation.
+         */
+        unsigned int m_idleSpinCount;
+        unsigned int m_maxSpinningWorkers; ///< Wake budget, max number of workers allowed to spin at the same time, 0 disables spinning.
+
+        /**
+         * Starvation protection for job priorities. Every m_priorityStarvationLimit picks a worker takes the lowest
+         * priority job available instead of the highest, so low priority jobs still make progress under a constant
+         * stream of high priority work. 0 disables the protection. Only used by the work stealing implementation.
+         */
+        unsigned int m_priorityStarvationLimit;
+
+        /**
+         * Fiber mode. When a job waits for its children on a worker thread (Job::WaitForChildren, or
+         * Job::StartAndWaitForCompletion from a job) the worker switches to another fiber and keeps processing jobs, the
+         * waiting job is resumed on a fiber switch, by any worker, once its children are complete. Without fibers the
+         * worker processes other jobs nested on top of the waiting job, which grows the stack with the depth of the
+         * fork/join tree and can not resume the waiting job until the nested jobs return.
+         * Fibers are pooled, a pool fiber is only created when no free one is available. Non-worker threads (assisting
+         * with StartAndAssistUntilComplete) always wait nested. Ignored on platforms without fiber support (only
+         * Linux for now), and by the non work stealing implementations.
+         */
+        bool m_useFibers;
+        unsigned int m_fiberStackSize; ///< Stack size of each fiber, default is 128KB.
+
+        /**
+         * Capacity of the lock-free ring used to queue jobs added by non-worker threads (rounded up to a power of 2).
+         * Jobs still get queued when the ring is full, but through a lock. The work stealing implementation has one
+         * ring per job priority.
+         */
+        unsigned int m_globalQueueCapacity;
+
+        /**
+         * Number of events each thread keeps while tracing is enabled (see JobManager::SetTracingEnabled), rounded up
+         * to a power of 2. Older events are overwritten. The buffer (24 bytes per event) is allocated the first time a
+         * thread records an event. Only used by the work stealing implementation.
+         */
+        unsigned int m_traceBufferSize;
     };
 }
 
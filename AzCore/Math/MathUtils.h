@@ -22,6 +22,10 @@
 #include <AzCore/std/typetraits/conditional.h>
 #include <AzCore/std/typetraits/is_integral.h>
 
+#if defined(AZ_COMPILER_MSVC)
+#   include <intrin.h>
+#endif
+
 namespace AZ
 {
     /**
@@ -150,6 +154,49 @@ namespace AZ
     {
         return std::isnormal(x);
     }
+
+    //! Returns the index of the lowest set bit, bits must not be 0.
+    AZ_MATH_FORCE_INLINE unsigned int CountTrailingZeros(AZ::u64 bits)
+    {
+#if defined(AZ_COMPILER_MSVC)
+        unsigned long index;
+#   if defined(AZ_OS64)
+        _BitScanForward64(&index, bits);
+#   else
+        if (!_BitScanForward(&index, static_cast<unsigned long>(bits)))
+        {
+            _BitScanForward(&index, static_cast<unsigned long>(bits >> 32));
+            index += 32;
+        }
+#   endif
+        return index;
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+
+    //! Returns the index of the highest set bit (floor(log2(value))), value must not be 0.
+    AZ_MATH_FORCE_INLINE unsigned int FloorLog2(AZ::u64 value)
+    {
+#if defined(AZ_COMPILER_MSVC)
+        unsigned long index;
+#   if defined(AZ_OS64)
+        _BitScanReverse64(&index, value);
+#   else
+        if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32)))
+        {
+            index += 32;
+        }
+        else
+        {
+            _BitScanReverse(&index, static_cast<unsigned long>(value));
+        }
+#   endif
+        return index;
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
 }
 
 
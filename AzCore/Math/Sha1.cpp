@@ -0,0 +1,540 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+// Modifications copyright Amazon.com, Inc. or its affiliates.   
+
+// Copyright 2007 Andy Tompkins.
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef AZ_UNITY_BUILD
+
+#include <AzCore/Math/Sha1.h>
+#include <AzCore/Math/MathUtils.h>
+
+#include <string.h>
+
+#if defined(AZ_PLATFORM_WINDOWS) || defined(AZ_PLATFORM_XBONE) || defined(AZ_PLATFORM_PS4) || defined(AZ_PLATFORM_LINUX) || defined(AZ_PLATFORM_APPLE_OSX) // ACCEPTED_USE
+#   define AZ_SHA1_SIMD
+#   include <emmintrin.h>
+#   include <immintrin.h>
+#   if defined(AZ_COMPILER_MSVC)
+#       include <intrin.h>
+#       define AZ_SHA1_TARGET(features)
+#       define AZ_SHA1_FLATTEN
+#   else
+#       include <cpuid.h>
+#       define AZ_SHA1_TARGET(features) __attribute__((target(features)))
+#       define AZ_SHA1_FLATTEN __attribute__((flatten))
+#   endif
+#   if defined(__GNUC__)
+// the generic lane functions pass LanesAvx2 vectors by value, but they only run inlined in AVX2 code
+#       pragma GCC diagnostic ignored "-Wpsabi"
+#   endif
+#   define AZ_SHA1_AVX2
+#endif
+
+namespace AZ
+{
+    namespace
+    {
+        const AZ::u32 s_initialState[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+
+        AZ_FORCE_INLINE AZ::u32 LoadBigEndian(const unsigned char* bytes)
+        {
+            return (AZ::u32(bytes[0]) << 24) | (AZ::u32(bytes[1]) << 16) | (AZ::u32(bytes[2]) << 8) | AZ::u32(bytes[3]);
+        }
+
+        /**
+         * Writes the final block(s) of a messageSize bytes message that ends with tailSize (< 64) bytes at tail to padded:
+         * the tail, a 1 bit, zeros and the message length in bits as a 64-bit big endian integer. Returns the number of blocks.
+         */
+        size_t PadMessage(const unsigned char* tail, size_t tailSize, AZ::u64 messageSize, unsigned char (&padded)[128])
+        {
+            size_t numBlocks = tailSize < 56 ? 1 : 2;
+            if (tailSize)
+            {
+                memcpy(padded, tail, tailSize);
+            }
+            padded[tailSize] = 0x80;
+            memset(padded + tailSize + 1, 0, numBlocks * 64 - 8 - tailSize - 1);
+            AZ::u64 bitCount = messageSize * 8;
+            for (size_t i = 0; i < 8; ++i)
+            {
+                padded[numBlocks * 64 - 1 - i] = static_cast<unsigned char>(bitCount >> (i * 8));
+            }
+            return numBlocks;
+        }
+
+        //////////////////////////////////////////////////////////////////////////
+        // Lanes, the sha1 rounds run on Lanes::Width messages at once.
+
+        struct LanesScalar
+        {
+            typedef AZ::u32 Vector;
+            static const unsigned int Width = 1;
+
+            static AZ_FORCE_INLINE Vector Gather(const unsigned char* const* blocks, size_t word)   { return LoadBigEndian(blocks[0] + word * 4); }
+            static AZ_FORCE_INLINE Vector Load(const AZ::u32* values)            { return *values; }
+            static AZ_FORCE_INLINE void Store(AZ::u32* values, Vector v)         { *values = v; }
+            static AZ_FORCE_INLINE Vector Set1(AZ::u32 value)                    { return value; }
+            static AZ_FORCE_INLINE Vector Add(Vector a, Vector b)                { return a + b; }
+            static AZ_FORCE_INLINE Vector Xor(Vector a, Vector b)                { return a ^ b; }
+            static AZ_FORCE_INLINE Vector And(Vector a, Vector b)                { return a & b; }
+            static AZ_FORCE_INLINE Vector Or(Vector a, Vector b)                 { return a | b; }
+            static AZ_FORCE_INLINE Vector AndNot(Vector a, Vector b)             { return ~a & b; }
+            template<int N>
+            static AZ_FORCE_INLINE Vector Rotate(Vector a)                       { return (a << N) | (a >> (32 - N)); }
+        };
+
+#if defined(AZ_SHA1_SIMD)
+        struct LanesSse2
+        {
+            typedef __m128i Vector;
+            static const unsigned int Width = 4;
+
+            static AZ_FORCE_INLINE Vector Gather(const unsigned char* const* blocks, size_t word)
+            {
+                return _mm_set_epi32(LoadBigEndian(blocks[3] + word * 4), LoadBigEndian(blocks[2] + word * 4), LoadBigEndian(blocks[1] + word * 4), LoadBigEndian(blocks[0] + word * 4));
+            }
+            static AZ_FORCE_INLINE Vector Load(const AZ::u32* values)            { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values)); }
+            static AZ_FORCE_INLINE void Store(AZ::u32* values, Vector v)         { _mm_storeu_si128(reinterpret_cast<__m128i*>(values), v); }
+            static AZ_FORCE_INLINE Vector Set1(AZ::u32 value)                    { return _mm_set1_epi32(static_cast<int>(value)); }
+            static AZ_FORCE_INLINE Vector Add(Vector a, Vector b)                { return _mm_add_epi32(a, b); }
+            static AZ_FORCE_INLINE Vector Xor(Vector a, Vector b)                { return _mm_xor_si128(a, b); }
+            static AZ_FORCE_INLINE Vector And(Vector a, Vector b)                { return _mm_and_si128(a, b); }
+            static AZ_FORCE_INLINE Vector Or(Vector a, Vector b)                 { return _mm_or_si128(a, b); }
+            static AZ_FORCE_INLINE Vector AndNot(Vector a, Vector b)             { return _mm_andnot_si128(a, b); }
+            template<int N>
+            static AZ_FORCE_INLINE Vector Rotate(Vector a)                       { return _mm_or_si128(_mm_slli_epi32(a, N), _mm_srli_epi32(a, 32 - N)); }
+        };
+#endif // AZ_SHA1_SIMD
+
+#if defined(AZ_SHA1_AVX2)
+        /**
+         * GCC and clang only allow AVX2 intrinsics in code compiled for AVX2, so the members can't be force inlined in
+         * the generic lane functions. They are only used through ComputeDigestsAvx2, which is compiled for AVX2 and
+         * inlines everything it calls.
+         */
+        struct LanesAvx2
+        {
+            typedef __m256i Vector;
+            static const unsigned int Width = 8;
+
+            static AZ_SHA1_TARGET("avx2") inline Vector Gather(const unsigned char* const* blocks, size_t word)
+            {
+                return _mm256_set_epi32(LoadBigEndian(blocks[7] + word * 4), LoadBigEndian(blocks[6] + word * 4), LoadBigEndian(blocks[5] + word * 4), LoadBigEndian(blocks[4] + word * 4),
+                    LoadBigEndian(blocks[3] + word * 4), LoadBigEndian(blocks[2] + word * 4), LoadBigEndian(blocks[1] + word * 4), LoadBigEndian(blocks[0] + word * 4));
+            }
+            static AZ_SHA1_TARGET("avx2") inline Vector Load(const AZ::u32* values)            { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values)); }
+            static AZ_SHA1_TARGET("avx2") inline void Store(AZ::u32* values, Vector v)         { _mm256_storeu_si256(reinterpret_cast<__m256i*>(values), v); }
+            static AZ_SHA1_TARGET("avx2") inline Vector Set1(AZ::u32 value)                    { return _mm256_set1_epi32(static_cast<int>(value)); }
+            static AZ_SHA1_TARGET("avx2") inline Vector Add(Vector a, Vector b)                { return _mm256_add_epi32(a, b); }
+            static AZ_SHA1_TARGET("avx2") inline Vector Xor(Vector a, Vector b)                { return _mm256_xor_si256(a, b); }
+            static AZ_SHA1_TARGET("avx2") inline Vector And(Vector a, Vector b)                { return _mm256_and_si256(a, b); }
+            static AZ_SHA1_TARGET("avx2") inline Vector Or(Vector a, Vector b)                 { return _mm256_or_si256(a, b); }
+            static AZ_SHA1_TARGET("avx2") inline Vector AndNot(Vector a, Vector b)             { return _mm256_andnot_si256(a, b); }
+            template<int N>
+            static AZ_SHA1_TARGET("avx2") inline Vector Rotate(Vector a)                       { return _mm256_or_si256(_mm256_slli_epi32(a, N), _mm256_srli_epi32(a, 32 - N)); }
+        };
+#endif // AZ_SHA1_AVX2
+
+        /**
+         * Processes one block per lane. state holds 5 x Width words, the a, b, c, d and e of every lane.
+         * The rounds are the scalar sha1 rounds, with a 16 word circular message schedule.
+         */
+        template<class Lanes>
+        AZ_FORCE_INLINE void ProcessBlockLanes(AZ::u32* state, const unsigned char* const* blocks)
+        {
+            typedef typename Lanes::Vector Vector;
+            const unsigned int Width = Lanes::Width;
+
+            Vector w[16];
+            for (size_t i = 0; i < 16; ++i)
+            {
+                w[i] = Lanes::Gather(blocks, i);
+            }
+
+            Vector a = Lanes::Load(state + 0 * Width);
+            Vector b = Lanes::Load(state + 1 * Width);
+            Vector c = Lanes::Load(state + 2 * Width);
+            Vector d = Lanes::Load(state + 3 * Width);
+            Vector e = Lanes::Load(state + 4 * Width);
+
+#define AZ_SHA1_ROUND(f, k)                                                                                                                 \
+    if (i >= 16)                                                                                                                            \
+    {                                                                                                                                       \
+        w[i & 15] = Lanes::template Rotate<1>(Lanes::Xor(Lanes::Xor(w[(i - 3) & 15], w[(i - 8) & 15]), Lanes::Xor(w[(i - 14) & 15], w[i & 15]))); \
+    }                                                                                                                                       \
+    Vector temp = Lanes::Add(Lanes::Add(Lanes::template Rotate<5>(a), f), Lanes::Add(Lanes::Add(e, k), w[i & 15]));                        \
+    e = d;                                                                                                                                  \
+    d = c;                                                                                                                                  \
+    c = Lanes::template Rotate<30>(b);                                                                                                      \
+    b = a;                                                                                                                                  \
+    a = temp;
+
+            const Vector k0 = Lanes::Set1(0x5A827999);
+            for (size_t i = 0; i < 20; ++i)
+            {
+                AZ_SHA1_ROUND(Lanes::Or(Lanes::And(b, c), Lanes::AndNot(b, d)), k0);
+            }
+            const Vector k1 = Lanes::Set1(0x6ED9EBA1);
+            for (size_t i = 20; i < 40; ++i)
+            {
+                AZ_SHA1_ROUND(Lanes::Xor(Lanes::Xor(b, c), d), k1);
+            }
+            const Vector k2 = Lanes::Set1(0x8F1BBCDC);
+            for (size_t i = 40; i < 60; ++i)
+            {
+                AZ_SHA1_ROUND(Lanes::Or(Lanes::And(b, c), Lanes::And(d, Lanes::Or(b, c))), k2);
+            }
+            const Vector k3 = Lanes::Set1(0xCA62C1D6);
+            for (size_t i = 60; i < 80; ++i)
+            {
+                AZ_SHA1_ROUND(Lanes::Xor(Lanes::Xor(b, c), d), k3);
+            }
+#undef AZ_SHA1_ROUND
+
+            Lanes::Store(state + 0 * Width, Lanes::Add(Lanes::Load(state + 0 * Width), a));
+            Lanes::Store(state + 1 * Width, Lanes::Add(Lanes::Load(state + 1 * Width), b));
+            Lanes::Store(state + 2 * Width, Lanes::Add(Lanes::Load(state + 2 * Width), c));
+            Lanes::Store(state + 3 * Width, Lanes::Add(Lanes::Load(state + 3 * Width), d));
+            Lanes::Store(state + 4 * Width, Lanes::Add(Lanes::Load(state + 4 * Width), e));
+        }
+
+        void ProcessBlocksScalar(AZ::u32* state, const unsigned char* blocks, size_t numBlocks)
+        {
+            for (; numBlocks; --numBlocks, blocks += 64)
+            {
+                ProcessBlockLanes<LanesScalar>(state, &blocks);
+            }
+        }
+
+        /// A message being hashed in one of the lanes of ComputeDigestsLanes.
+        struct MessageLane
+        {
+            const unsigned char*    m_data;
+            size_t                  m_numDataBlocks;    ///< Number of blocks read directly from the message.
+            size_t                  m_numBlocks;        ///< Number of blocks including the padded ones.
+            size_t                  m_block;
+            size_t                  m_message;          ///< Index of the message, count when the lane is idle.
+            unsigned char           m_padded[128];
+
+            const unsigned char* GetBlock() const
+            {
+                return m_block < m_numDataBlocks ? m_data + m_block * 64 : m_padded + (m_block - m_numDataBlocks) * 64;
+            }
+        };
+
+        /// Starts the next message in lane laneIndex, returns false and leaves the lane idle when there are no more messages.
+        bool StartMessage(MessageLane& lane, AZ::u32* state, unsigned int laneIndex, unsigned int width,
+            const void* const* messages, const size_t* messageSizes, size_t count, size_t& nextMessage)
+        {
+            if (nextMessage == count)
+            {
+                lane.m_message = count;
+                return false;
+            }
+            lane.m_message = nextMessage++;
+            lane.m_data = static_cast<const unsigned char*>(messages[lane.m_message]);
+            size_t size = messageSizes[lane.m_message];
+            lane.m_numDataBlocks = size / 64;
+            lane.m_numBlocks = lane.m_numDataBlocks + PadMessage(lane.m_data + lane.m_numDataBlocks * 64, size % 64, size, lane.m_padded);
+            lane.m_block = 0;
+            for (unsigned int i = 0; i < 5; ++i)
+            {
+                state[i * width + laneIndex] = s_initialState[i];
+            }
+            return true;
+        }
+
+        /// Hashes the messages in Lanes::Width lanes, a lane picks up the next message as soon as it is done with the previous one.
+        template<class Lanes>
+        void ComputeDigestsLanes(const void* const* messages, const size_t* messageSizes, size_t count, AZ::u32 (*digests)[5])
+        {
+            const unsigned int Width = Lanes::Width;
+
+            AZ::u32 state[5 * Width];
+            MessageLane lanes[Width];
+            const unsigned char* blocks[Width];
+            const unsigned char idleBlock[64] = { 0 };
+            size_t nextMessage = 0;
+            unsigned int numActive = 0;
+
+            for (unsigned int lane = 0; lane < Width; ++lane)
+            {
+                numActive += StartMessage(lanes[lane], state, lane, Width, messages, messageSizes, count, nextMessage) ? 1 : 0;
+            }
+
+            while (numActive)
+            {
+                for (unsigned int lane = 0; lane < Width; ++lane)
+                {
+                    blocks[lane] = lanes[lane].m_message < count ? lanes[lane].GetBlock() : idleBlock;
+                }
+
+                ProcessBlockLanes<Lanes>(state, blocks);
+
+                for (unsigned int lane = 0; lane < Width; ++lane)
+                {
+                    MessageLane& current = lanes[lane];
+                    if (current.m_message < count && ++current.m_block == current.m_numBlocks)
+                    {
+                        for (unsigned int i = 0; i < 5; ++i)
+                        {
+                            digests[current.m_message][i] = state[i * Width + lane];
+                        }
+                        if (!StartMessage(current, state, lane, Width, messages, messageSizes, count, nextMessage))
+                        {
+                            --numActive;
+                        }
+                    }
+                }
+            }
+        }
+
+#if defined(AZ_SHA1_SIMD)
+        //////////////////////////////////////////////////////////////////////////
+        // SHA-NI
+
+        void CpuId(unsigned int leaf, AZ::u32 (&registers)[4])
+        {
+#   if defined(AZ_COMPILER_MSVC)
+            int info[4];
+            __cpuidex(info, static_cast<int>(leaf), 0);
+            for (int i = 0; i < 4; ++i)
+            {
+                registers[i] = static_cast<AZ::u32>(info[i]);
+            }
+#   else
+            __cpuid_count(leaf, 0, registers[0], registers[1], registers[2], registers[3]);
+#   endif
+        }
+
+        bool IsShaNiSupported()
+        {
+            AZ::u32 registers[4];
+            CpuId(0, registers);
+            if (registers[0] < 7)
+            {
+                return false;
+            }
+            CpuId(1, registers);
+            bool hasSse41 = (registers[2] & (1 << 19)) != 0;
+            bool hasSsse3 = (registers[2] & (1 << 9)) != 0;
+            CpuId(7, registers);
+            return hasSse41 && hasSsse3 && (registers[1] & (1 << 29)) != 0;
+        }
+
+        /// Zero initialized before the dynamic initialization, so hashes computed during static init take the portable path.
+        const bool s_isShaNiSupported = IsShaNiSupported();
+
+        /// Four rounds of the SHA-NI block loop (Intel's "New Instructions Supporting the Secure Hash Algorithm"),
+        /// msg holds the last 16 message words and the schedule is computed 4 rounds ahead.
+        template<int I>
+        AZ_SHA1_TARGET("ssse3,sse4.1,sha") AZ_FORCE_INLINE void ShaNiRounds(__m128i& abcd, __m128i& e0, __m128i& e1, __m128i (&msg)[4])
+        {
+            __m128i& e = (I & 1) ? e1 : e0;
+            __m128i& eNext = (I & 1) ? e0 : e1;
+            const __m128i m = msg[I % 4];
+            e = (I == 0) ? _mm_add_epi32(e, m) : _mm_sha1nexte_epu32(e, m);
+            eNext = abcd;
+            if (I >= 3 && I <= 18)
+            {
+                msg[(I + 1) % 4] = _mm_sha1msg2_epu32(msg[(I + 1) % 4], m);
+            }
+            abcd = _mm_sha1rnds4_epu32(abcd, e, I / 5);
+            if (I >= 1 && I <= 16)
+            {
+                msg[(I + 3) % 4] = _mm_sha1msg1_epu32(msg[(I + 3) % 4], m);
+            }
+            if (I >= 2 && I <= 17)
+            {
+                msg[(I + 2) % 4] = _mm_xor_si128(msg[(I + 2) % 4], m);
+            }
+        }
+
+        AZ_SHA1_TARGET("ssse3,sse4.1,sha") void ProcessBlocksShaNi(AZ::u32* state, const unsigned char* blocks, size_t numBlocks)
+        {
+            const __m128i byteSwap = _mm_set_epi64x(0x0001020304050607ll, 0x08090a0b0c0d0e0fll);
+            __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1B);
+            __m128i e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+            __m128i e1;
+            __m128i msg[4];
+
+            for (; numBlocks; --numBlocks, blocks += 64)
+            {
+                __m128i abcdSave = abcd;
+                __m128i e0Save = e0;
+                for (int i = 0; i < 4; ++i)
+                {
+                    msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + i * 16)), byteSwap);
+                }
+
+                ShaNiRounds<0>(abcd, e0, e1, msg);  ShaNiRounds<1>(abcd, e0, e1, msg);  ShaNiRounds<2>(abcd, e0, e1, msg);  ShaNiRounds<3>(abcd, e0, e1, msg);
+                ShaNiRounds<4>(abcd, e0, e1, msg);  ShaNiRounds<5>(abcd, e0, e1, msg);  ShaNiRounds<6>(abcd, e0, e1, msg);  ShaNiRounds<7>(abcd, e0, e1, msg);
+                ShaNiRounds<8>(abcd, e0, e1, msg);  ShaNiRounds<9>(abcd, e0, e1, msg);  ShaNiRounds<10>(abcd, e0, e1, msg); ShaNiRounds<11>(abcd, e0, e1, msg);
+                ShaNiRounds<12>(abcd, e0, e1, msg); ShaNiRounds<13>(abcd, e0, e1, msg); ShaNiRounds<14>(abcd, e0, e1, msg); ShaNiRounds<15>(abcd, e0, e1, msg);
+                ShaNiRounds<16>(abcd, e0, e1, msg); ShaNiRounds<17>(abcd, e0, e1, msg); ShaNiRounds<18>(abcd, e0, e1, msg); ShaNiRounds<19>(abcd, e0, e1, msg);
+
+                e0 = _mm_sha1nexte_epu32(e0, e0Save);
+                abcd = _mm_add_epi32(abcd, abcdSave);
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+            state[4] = static_cast<AZ::u32>(_mm_extract_epi32(e0, 3));
+        }
+
+#   if defined(AZ_SHA1_AVX2)
+        bool IsAvx2Supported()
+        {
+            AZ::u32 registers[4];
+            CpuId(0, registers);
+            if (registers[0] < 7)
+            {
+                return false;
+            }
+            CpuId(1, registers);
+            const AZ::u32 osXSaveAndAvx = (1 << 27) | (1 << 28);
+            if ((registers[2] & osXSaveAndAvx) != osXSaveAndAvx)
+            {
+                return false;
+            }
+            // the OS must save the ymm registers
+#       if defined(AZ_COMPILER_MSVC)
+            AZ::u64 xcr0 = _xgetbv(0);
+#       else
+            AZ::u32 xcr0Low, xcr0High;
+            __asm__ ("xgetbv" : "=a" (xcr0Low), "=d" (xcr0High) : "c" (0));
+            AZ::u64 xcr0 = (AZ::u64(xcr0High) << 32) | xcr0Low;
+#       endif
+            if ((xcr0 & 6) != 6)
+            {
+                return false;
+            }
+            CpuId(7, registers);
+            return (registers[1] & (1 << 5)) != 0;
+        }
+
+        const bool s_isAvx2Supported = IsAvx2Supported();
+
+        AZ_SHA1_TARGET("avx2") AZ_SHA1_FLATTEN void ComputeDigestsAvx2(const void* const* messages, const size_t* messageSizes, size_t count, AZ::u32 (*digests)[5])
+        {
+            ComputeDigestsLanes<LanesAvx2>(messages, messageSizes, count, digests);
+            _mm256_zeroupper();
+        }
+#   endif // AZ_SHA1_AVX2
+#endif // AZ_SHA1_SIMD
+    }
+
+    //=========================================================================
+    // ProcessBlocks
+    //=========================================================================
+    void Sha1::ProcessBlocks(AZ::u32* state, unsigned char const* blocks, size_t numBlocks)
+    {
+#if defined(AZ_SHA1_SIMD)
+        if (s_isShaNiSupported)
+        {
+            ProcessBlocksShaNi(state, blocks, numBlocks);
+            return;
+        }
+#endif
+        ProcessBlocksScalar(state, blocks, numBlocks);
+    }
+
+    //=========================================================================
+    // ProcessBytes
+    //=========================================================================
+    void Sha1::ProcessBytes(void const* buffer, size_t byteCount)
+    {
+        unsigned char const* bytes = static_cast<unsigned char const*>(buffer);
+        m_byteCount += byteCount;
+        if (m_blockByteIndex)
+        {
+            size_t numBytes = AZ::GetMin(64 - m_blockByteIndex, byteCount);
+            memcpy(m_block + m_blockByteIndex, bytes, numBytes);
+            m_blockByteIndex += numBytes;
+            bytes += numBytes;
+            byteCount -= numBytes;
+            if (m_blockByteIndex < 64)
+            {
+                return;
+            }
+            ProcessBlocks(m_h, m_block, 1);
+            m_blockByteIndex = 0;
+        }
+
+        size_t numBlocks = byteCount / 64;
+        if (numBlocks)
+        {
+            ProcessBlocks(m_h, bytes, numBlocks);
+            bytes += numBlocks * 64;
+            byteCount -= numBlocks * 64;
+        }
+        if (byteCount)
+        {
+            memcpy(m_block, bytes, byteCount);
+            m_blockByteIndex = byteCount;
+        }
+    }
+
+    //=========================================================================
+    // GetDigest
+    //=========================================================================
+    void Sha1::GetDigest(DigestType digest)
+    {
+        unsigned char padded[128];
+        size_t numBlocks = PadMessage(m_block, m_blockByteIndex, m_byteCount, padded);
+        ProcessBlocks(m_h, padded, numBlocks);
+
+        for (int i = 0; i < 5; ++i)
+        {
+            digest[i] = m_h[i];
+        }
+    }
+
+    //=========================================================================
+    // ComputeDigests
+    //=========================================================================
+    void Sha1::ComputeDigests(void const* const* messages, const size_t* messageSizes, size_t count, AZ::u32 (*digests)[5])
+    {
+#if defined(AZ_SHA1_SIMD)
+#   if defined(AZ_SHA1_AVX2)
+        // 8 lanes beat SHA-NI, which hashes one message at a time with a long dependency chain
+        if (s_isAvx2Supported)
+        {
+            ComputeDigestsAvx2(messages, messageSizes, count, digests);
+            return;
+        }
+#   endif
+        if (s_isShaNiSupported)
+        {
+            for (size_t message = 0; message < count; ++message)
+            {
+                const unsigned char* data = static_cast<const unsigned char*>(messages[message]);
+                size_t numDataBlocks = messageSizes[message] / 64;
+                unsigned char padded[128];
+                size_t numPaddedBlocks = PadMessage(data + numDataBlocks * 64, messageSizes[message] % 64, messageSizes[message], padded);
+                memcpy(digests[message], s_initialState, sizeof(s_initialState));
+                ProcessBlocksShaNi(digests[message], data, numDataBlocks);
+                ProcessBlocksShaNi(digests[message], padded, numPaddedBlocks);
+            }
+            return;
+        }
+        ComputeDigestsLanes<LanesSse2>(messages, messageSizes, count, digests);
+#else
+        ComputeDigestsLanes<LanesScalar>(messages, messageSizes, count, digests);
+#endif
+    }
+} // namespace AZ
+
+#endif // #ifndef AZ_UNITY_BUILD
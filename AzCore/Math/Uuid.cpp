@@ -23,6 +23,32 @@
 
 namespace AZ
 {
+    namespace
+    {
+        /// Name based uuid (VAR_RFC_4122, VER_NAME_SHA1) from the sha1 digest of the name.
+        Uuid CreateFromSha1Digest(const AZ::u32 (&digest)[5])
+        {
+            Uuid id;
+            for (int i = 0; i < 4; ++i)
+            {
+                id.data[i * 4 + 0] = ((digest[i] >> 24) & 0xff);
+                id.data[i * 4 + 1] = ((digest[i] >> 16) & 0xff);
+                id.data[i * 4 + 2] = ((digest[i] >> 8) & 0xff);
+                id.data[i * 4 + 3] = ((digest[i] >> 0) & 0xff);
+            }
+
+            // variant VAR_RFC_4122
+            id.data[8] &= 0xBF;
+            id.data[8] |= 0x80;
+
+            // version VER_NAME_SHA1
+            id.data[6] &= 0x5F;
+            id.data[6] |= 0x50;
+
+            return id;
+        }
+    }
+
     //=========================================================================
     // CreateNull
     // [4/10/2012]
@@ -228,26 +254,37 @@ namespace AZ
             AZ::u32 digest[5];
             sha.GetDigest(digest);
 
-            Uuid id;
-            for (int i = 0; i < 4; ++i)
+            return CreateFromSha1Digest(digest);
+        }
+        return Uuid::CreateNull();
+    }
+
+    //=========================================================================
+    // CreateNames
+    //=========================================================================
+    void Uuid::CreateNames(const char* const* names, size_t numNames, Uuid* uuids)
+    {
+        const size_t batchSize = 64;
+        const void* messages[batchSize];
+        size_t messageSizes[batchSize];
+        AZ::u32 digests[batchSize][5];
+
+        for (size_t first = 0; first < numNames; first += batchSize)
+        {
+            size_t count = AZStd::GetMin(batchSize, numNames - first);
+            for (size_t i = 0; i < count; ++i)
             {
-                id.data[i * 4 + 0] = ((digest[i] >> 24) & 0xff);
-                id.data[i * 4 + 1] = ((digest[i] >> 16) & 0xff);
-                id.data[i * 4 + 2] = ((digest[i] >> 8) & 0xff);
-                id.data[i * 4 + 3] = ((digest[i] >> 0) & 0xff);
+                messages[i] = names[first + i];
+                messageSizes[i] = names[first + i] ? strlen(names[first + i]) : 0;
             }
 
-            // variant VAR_RFC_4122
-            id.data[8] &= 0xBF;
-            id.data[8] |= 0x80;
-
-            // version VER_NAME_SHA1
-            id.data[6] &= 0x5F;
-            id.data[6] |= 0x50;
+            Sha1::ComputeDigests(messages, messageSizes, count, digests);
 
-            return id;
+            for (size_t i = 0; i < count; ++i)
+            {
+                uuids[first + i] = messageSizes[i] ? CreateFromSha1Digest(digests[i]) : CreateNull();
+            }
         }
-        return Uuid::CreateNull();
     }
 
     //=========================================================================
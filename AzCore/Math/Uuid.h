@@ -68,6 +68,8 @@ namespace AZ
         static Uuid CreateName(const char* name);
         /// Create a UUID based on a byte stream (sha1)
         static Uuid CreateData(const void* data, size_t dataSize);
+        /// Create UUIDs based on string names (sha1), uuids[i] = CreateName(names[i]), but several names are hashed in parallel.
+        static void CreateNames(const char* const* names, size_t numNames, Uuid* uuids);
 
         bool    IsNull() const;
         Variant GetVariant() const;
@@ -141,16 +143,9 @@ namespace AZ
 
         size_t GetHash() const
         {
-            // Returning first few bytes as a size_t. This is faster than
-            // hashing every byte and the chance of collision is still very low.
-            union
-            {
-                const size_t* hash;
-                const unsigned char* data;
-            } convert;
-
-            convert.data = data;
-            return *convert.hash;
+            // Hash all 16 bytes, not every id is a random version 4 one. Ids built from
+            // counters or written by hand as constants can differ in a few bytes only.
+            return AZStd::hash_bytes(data, sizeof(data));
         }
 
         // or _m128i and VMX ???
@@ -0,0 +1,525 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZ_UNITY_BUILD
+
+#include <AzCore/Memory/AllocationSampler.h>
+#include <AzCore/Memory/OSAllocator.h>
+#include <AzCore/std/parallel/lock.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#if defined(AZ_PLATFORM_WINDOWS)
+#   include <AzCore/PlatformIncl.h>
+#elif defined(AZ_PLATFORM_LINUX) || defined(AZ_PLATFORM_APPLE)
+#   include <execinfo.h>
+#   define AZ_ALLOCATION_SAMPLER_BACKTRACE
+#endif
+
+namespace AZ
+{
+    namespace Debug
+    {
+        struct AllocationSampler::StackEntry
+        {
+            StackEntry*     m_next;
+            size_t          m_hash;
+            size_t          m_inUseCount;
+            size_t          m_inUseBytes;
+            size_t          m_allocCount;
+            size_t          m_allocBytes;
+            unsigned int    m_depth;
+            void*           m_frames[1];
+        };
+
+        struct AllocationSampler::Sample
+        {
+            Sample*         m_next;
+            void*           m_address;
+            size_t          m_size;
+            StackEntry*     m_stack;
+        };
+
+        AZ_THREAD_LOCAL s64 AllocationSampler::s_bytesUntilSample[AllocationSampler::MaxNumSamplers];
+
+        namespace
+        {
+            AZ_THREAD_LOCAL u32 s_initializedSlots;     ///< Samplers for which this thread picked the first sample distance.
+            AZ_THREAD_LOCAL u64 s_randomState;
+            AZStd::atomic<u32>  s_usedSlots(0);
+
+            AZ_FORCE_INLINE size_t SampleBucket(void* address, unsigned int numBuckets)
+            {
+                u64 key = static_cast<u64>(reinterpret_cast<size_t>(address) >> 4) * 0x9E3779B97F4A7C15ull;
+                return static_cast<size_t>(key >> 40) & (numBuckets - 1);
+            }
+
+            /// Text we write in one go, we don't use our allocators so we don't sample ourselves.
+            struct ProfileText
+            {
+                ProfileText()
+                    : m_data(nullptr)
+                    , m_size(0)
+                    , m_capacity(0)
+                {}
+                ~ProfileText()
+                {
+                    if (m_data)
+                    {
+                        AZ_OS_FREE(m_data);
+                    }
+                }
+
+                bool Append(const char* text, size_t size)
+                {
+                    if (m_size + size > m_capacity)
+                    {
+                        size_t capacity = m_capacity ? m_capacity * 2 : 64 * 1024;
+                        while (capacity < m_size + size)
+                        {
+                            capacity *= 2;
+                        }
+                        char* data = reinterpret_cast<char*>(AZ_OS_MALLOC(capacity, 16));
+                        if (data == nullptr)
+                        {
+                            return false;
+                        }
+                        if (m_data)
+                        {
+                            memcpy(data, m_data, m_size);
+                            AZ_OS_FREE(m_data);
+                        }
+                        m_data = data;
+                        m_capacity = capacity;
+                    }
+                    memcpy(m_data + m_size, text, size);
+                    m_size += size;
+                    return true;
+                }
+
+                char*   m_data;
+                size_t  m_size;
+                size_t  m_capacity;
+            };
+        }
+    }
+}
+
+using namespace AZ;
+using namespace AZ::Debug;
+
+//=========================================================================
+// AllocationSampler
+//=========================================================================
+AllocationSampler::AllocationSampler()
+    : m_allocator(nullptr)
+    , m_sampleInterval(0)
+    , m_stackRecordLevels(0)
+    , m_slot(MaxNumSamplers)
+    , m_numLiveSamples(0)
+    , m_stackBuckets(nullptr)
+    , m_sampleBuckets(nullptr)
+{
+    for (unsigned int i = 0; i < FilterSize; ++i)
+    {
+        m_filter[i].store(0, AZStd::memory_order_relaxed);
+    }
+}
+
+//=========================================================================
+// ~AllocationSampler
+//=========================================================================
+AllocationSampler::~AllocationSampler()
+{
+    Stop();
+    Reset();
+    if (m_stackBuckets)
+    {
+        AZ_OS_FREE(m_stackBuckets);
+    }
+    if (m_sampleBuckets)
+    {
+        AZ_OS_FREE(m_sampleBuckets);
+    }
+}
+
+//=========================================================================
+// Start
+//=========================================================================
+bool
+AllocationSampler::Start(IAllocator& allocator, const Descriptor& desc)
+{
+    AZ_Assert(m_allocator == nullptr, "Sampler is already started!");
+    AZ_Assert(desc.m_sampleInterval > 0, "Sample interval must be > 0!");
+    if (m_allocator || allocator.m_sampler)
+    {
+        return false;
+    }
+
+    if (m_stackBuckets == nullptr)
+    {
+        m_stackBuckets = reinterpret_cast<StackEntry**>(AZ_OS_MALLOC(sizeof(StackEntry*) * NumStackBuckets, sizeof(StackEntry*)));
+        if (m_stackBuckets == nullptr)
+        {
+            return false;
+        }
+        memset(m_stackBuckets, 0, sizeof(StackEntry*) * NumStackBuckets);
+    }
+    if (m_sampleBuckets == nullptr)
+    {
+        m_sampleBuckets = reinterpret_cast<Sample**>(AZ_OS_MALLOC(sizeof(Sample*) * NumSampleBuckets, sizeof(Sample*)));
+        if (m_sampleBuckets == nullptr)
+        {
+            return false;
+        }
+        memset(m_sampleBuckets, 0, sizeof(Sample*) * NumSampleBuckets);
+    }
+    // samples of a previous run are stale, we didn't see their frees
+    Reset();
+
+    // grab a thread local counter
+    u32 usedSlots = s_usedSlots.load(AZStd::memory_order_relaxed);
+    unsigned int slot;
+    do
+    {
+        for (slot = 0; slot < MaxNumSamplers && (usedSlots & (1 << slot)); ++slot)
+        {
+        }
+        if (slot == MaxNumSamplers)
+        {
+            AZ_Assert(false, "Too many allocation samplers (max %d) are running!", MaxNumSamplers);
+            return false;
+        }
+    } while (!s_usedSlots.compare_exchange_weak(usedSlots, usedSlots | (1 << slot)));
+
+    m_slot = slot;
+    m_sampleInterval = desc.m_sampleInterval;
+    m_stackRecordLevels = desc.m_stackRecordLevels < MaxStackRecordLevels ? desc.m_stackRecordLevels : MaxStackRecordLevels;
+    m_allocator = &allocator;
+    allocator.m_sampler = this;
+    return true;
+}
+
+//=========================================================================
+// Stop
+//=========================================================================
+void
+AllocationSampler::Stop()
+{
+    if (m_allocator)
+    {
+        m_allocator->m_sampler = nullptr;
+        m_allocator = nullptr;
+        s_usedSlots.fetch_and(~(1u << m_slot));
+    }
+}
+
+//=========================================================================
+// Reset
+//=========================================================================
+void
+AllocationSampler::Reset()
+{
+    if (m_stackBuckets == nullptr || m_sampleBuckets == nullptr)
+    {
+        return;
+    }
+    AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+    for (unsigned int i = 0; i < NumSampleBuckets; ++i)
+    {
+        while (Sample* sample = m_sampleBuckets[i])
+        {
+            m_sampleBuckets[i] = sample->m_next;
+            AZ_OS_FREE(sample);
+        }
+    }
+    for (unsigned int i = 0; i < NumStackBuckets; ++i)
+    {
+        while (StackEntry* stack = m_stackBuckets[i])
+        {
+            m_stackBuckets[i] = stack->m_next;
+            AZ_OS_FREE(stack);
+        }
+    }
+    for (unsigned int i = 0; i < FilterSize; ++i)
+    {
+        m_filter[i].store(0, AZStd::memory_order_relaxed);
+    }
+    m_numLiveSamples = 0;
+}
+
+//=========================================================================
+// NextSampleDistance
+//=========================================================================
+s64
+AllocationSampler::NextSampleDistance()
+{
+    u64 state = s_randomState;
+    if (state == 0)
+    {
+        state = static_cast<u64>(reinterpret_cast<size_t>(&s_randomState)) * 0x9E3779B97F4A7C15ull + 1;
+    }
+    // xorshift64*
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    s_randomState = state;
+    // uniform in (0,1], then exponential with mean m_sampleInterval
+    double uniform = static_cast<double>(((state * 0x2545F4914F6CDD1Dull) >> 11) + 1) * (1.0 / 9007199254740992.0);
+    return static_cast<s64>(-log(uniform) * static_cast<double>(m_sampleInterval)) + 1;
+}
+
+//=========================================================================
+// RecordSample
+//=========================================================================
+void
+AllocationSampler::RecordSample(void* address, size_t byteSize, unsigned int suppressStackRecord)
+{
+    u32 slotBit = 1 << m_slot;
+    if ((s_initializedSlots & slotBit) == 0)
+    {
+        // first allocation on this thread, just pick where the first sample is
+        s_initializedSlots |= slotBit;
+        s_bytesUntilSample[m_slot] = NextSampleDistance();
+        return;
+    }
+    s_bytesUntilSample[m_slot] = NextSampleDistance();
+    if (address == nullptr)
+    {
+        return;
+    }
+
+    void* frames[MaxStackRecordLevels];
+    unsigned int depth = 0;
+    unsigned int skip = suppressStackRecord + 1; // skip RecordSample too
+#if defined(AZ_ALLOCATION_SAMPLER_BACKTRACE)
+    void* callStack[MaxStackRecordLevels + 16];
+    int maxFrames = static_cast<int>(m_stackRecordLevels + skip);
+    if (maxFrames > static_cast<int>(AZ_ARRAY_SIZE(callStack)))
+    {
+        maxFrames = static_cast<int>(AZ_ARRAY_SIZE(callStack));
+    }
+    int numFrames = backtrace(callStack, maxFrames);
+    for (int i = static_cast<int>(skip); i < numFrames; ++i)
+    {
+        frames[depth++] = callStack[i];
+    }
+#elif defined(AZ_PLATFORM_WINDOWS)
+    depth = RtlCaptureStackBackTrace(skip, m_stackRecordLevels, frames, nullptr);
+#else
+    (void)skip;
+#endif
+
+    size_t hash = depth;
+    for (unsigned int i = 0; i < depth; ++i)
+    {
+        hash = (hash ^ reinterpret_cast<size_t>(frames[i])) * static_cast<size_t>(0x100000001B3ull);
+    }
+
+    AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+    StackEntry** stackBucket = &m_stackBuckets[(hash ^ (hash >> 17)) & (NumStackBuckets - 1)];
+    StackEntry* stack = *stackBucket;
+    for (; stack; stack = stack->m_next)
+    {
+        if (stack->m_hash == hash && stack->m_depth == depth && memcmp(stack->m_frames, frames, depth * sizeof(void*)) == 0)
+        {
+            break;
+        }
+    }
+    if (stack == nullptr)
+    {
+        stack = reinterpret_cast<StackEntry*>(AZ_OS_MALLOC(sizeof(StackEntry) + depth * sizeof(void*), AZStd::alignment_of<StackEntry>::value));
+        if (stack == nullptr)
+        {
+            return;
+        }
+        stack->m_hash = hash;
+        stack->m_inUseCount = 0;
+        stack->m_inUseBytes = 0;
+        stack->m_allocCount = 0;
+        stack->m_allocBytes = 0;
+        stack->m_depth = depth;
+        memcpy(stack->m_frames, frames, depth * sizeof(void*));
+        stack->m_next = *stackBucket;
+        *stackBucket = stack;
+    }
+
+    Sample* sample = reinterpret_cast<Sample*>(AZ_OS_MALLOC(sizeof(Sample), AZStd::alignment_of<Sample>::value));
+    if (sample == nullptr)
+    {
+        return;
+    }
+    sample->m_address = address;
+    sample->m_size = byteSize;
+    sample->m_stack = stack;
+    Sample** sampleBucket = &m_sampleBuckets[SampleBucket(address, NumSampleBuckets)];
+    sample->m_next = *sampleBucket;
+    *sampleBucket = sample;
+    m_filter[FilterIndex(address)].fetch_add(1, AZStd::memory_order_relaxed);
+    ++m_numLiveSamples;
+
+    stack->m_inUseCount++;
+    stack->m_inUseBytes += byteSize;
+    stack->m_allocCount++;
+    stack->m_allocBytes += byteSize;
+}
+
+//=========================================================================
+// RemoveSample
+//=========================================================================
+void
+AllocationSampler::RemoveSample(void* address)
+{
+    AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+    Sample** prev = &m_sampleBuckets[SampleBucket(address, NumSampleBuckets)];
+    for (Sample* sample = *prev; sample; prev = &sample->m_next, sample = sample->m_next)
+    {
+        if (sample->m_address == address)
+        {
+            *prev = sample->m_next;
+            m_filter[FilterIndex(address)].fetch_sub(1, AZStd::memory_order_relaxed);
+            --m_numLiveSamples;
+            sample->m_stack->m_inUseCount--;
+            sample->m_stack->m_inUseBytes -= sample->m_size;
+            AZ_OS_FREE(sample);
+            return;
+        }
+    }
+    // not sampled, the filter slot is used by another live sample
+}
+
+//=========================================================================
+// EstimatedInUseBytes
+//=========================================================================
+size_t
+AllocationSampler::EstimatedInUseBytes()
+{
+    if (m_stackBuckets == nullptr)
+    {
+        return 0;
+    }
+    AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+    double inUseBytes = 0.0;
+    for (unsigned int i = 0; i < NumStackBuckets; ++i)
+    {
+        for (StackEntry* stack = m_stackBuckets[i]; stack; stack = stack->m_next)
+        {
+            if (stack->m_inUseCount)
+            {
+                // an allocation of size S is sampled with probability 1 - e^(-S/interval), we use the average size like pprof
+                double averageSize = static_cast<double>(stack->m_inUseBytes) / static_cast<double>(stack->m_inUseCount);
+                inUseBytes += static_cast<double>(stack->m_inUseBytes) / (1.0 - exp(-averageSize / static_cast<double>(m_sampleInterval)));
+            }
+        }
+    }
+    return static_cast<size_t>(inUseBytes);
+}
+
+//=========================================================================
+// WriteHeapProfile
+//=========================================================================
+bool
+AllocationSampler::WriteHeapProfile(const AZStd::function<void(const char* data, size_t size)>& write)
+{
+    if (m_stackBuckets == nullptr)
+    {
+        return false;
+    }
+
+    // format everything under the lock and write after, so the writer can allocate (and be sampled)
+    ProfileText text;
+    char line[64 + MaxStackRecordLevels * 20];
+    {
+        AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+        unsigned long long inUseCount = 0, inUseBytes = 0, allocCount = 0, allocBytes = 0;
+        for (unsigned int i = 0; i < NumStackBuckets; ++i)
+        {
+            for (StackEntry* stack = m_stackBuckets[i]; stack; stack = stack->m_next)
+            {
+                inUseCount += stack->m_inUseCount;
+                inUseBytes += stack->m_inUseBytes;
+                allocCount += stack->m_allocCount;
+                allocBytes += stack->m_allocBytes;
+            }
+        }
+
+        int size = azsnprintf(line, sizeof(line), "heap profile: %6llu: %8llu [%6llu: %8llu] @ heap_v2/%llu\n",
+                inUseCount, inUseBytes, allocCount, allocBytes, static_cast<unsigned long long>(m_sampleInterval));
+        if (!text.Append(line, size))
+        {
+            return false;
+        }
+
+        for (unsigned int i = 0; i < NumStackBuckets; ++i)
+        {
+            for (StackEntry* stack = m_stackBuckets[i]; stack; stack = stack->m_next)
+            {
+                size = azsnprintf(line, sizeof(line), "%6llu: %8llu [%6llu: %8llu] @",
+                        static_cast<unsigned long long>(stack->m_inUseCount), static_cast<unsigned long long>(stack->m_inUseBytes),
+                        static_cast<unsigned long long>(stack->m_allocCount), static_cast<unsigned long long>(stack->m_allocBytes));
+                for (unsigned int frame = 0; frame < stack->m_depth; ++frame)
+                {
+                    size += azsnprintf(line + size, sizeof(line) - size, " 0x%llx", static_cast<unsigned long long>(reinterpret_cast<size_t>(stack->m_frames[frame])));
+                }
+                line[size++] = '\n';
+                if (!text.Append(line, size))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+#if defined(AZ_PLATFORM_LINUX)
+    // pprof needs the mappings to symbolize the addresses
+    static const char mappedLibraries[] = "\nMAPPED_LIBRARIES:\n";
+    text.Append(mappedLibraries, sizeof(mappedLibraries) - 1);
+    if (FILE* maps = fopen("/proc/self/maps", "r"))
+    {
+        size_t numRead;
+        while ((numRead = fread(line, 1, sizeof(line), maps)) > 0)
+        {
+            text.Append(line, numRead);
+        }
+        fclose(maps);
+    }
+#endif
+
+    write(text.m_data, text.m_size);
+    return true;
+}
+
+//=========================================================================
+// WriteHeapProfile
+//=========================================================================
+bool
+AllocationSampler::WriteHeapProfile(const char* fileName)
+{
+    FILE* file;
+#if defined(AZ_COMPILER_MSVC)
+    if (fopen_s(&file, fileName, "wb") != 0)
+    {
+        file = nullptr;
+    }
+#else
+    file = fopen(fileName, "wb");
+#endif
+    if (file == nullptr)
+    {
+        return false;
+    }
+    bool isWritten = WriteHeapProfile([file](const char* data, size_t size) { fwrite(data, 1, size, file); });
+    fclose(file);
+    return isWritten;
+}
+
+#endif // #ifndef AZ_UNITY_BUILD
@@ -0,0 +1,146 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZCORE_ALLOCATION_SAMPLER_H
+#define AZCORE_ALLOCATION_SAMPLER_H 1
+
+#include <AzCore/Memory/AllocatorBase.h>
+#include <AzCore/std/parallel/mutex.h>
+#include <AzCore/std/parallel/atomic.h>
+#include <AzCore/std/functional.h>
+
+namespace AZ
+{
+    namespace Debug
+    {
+        /**
+         * Allocation sampling profiler.
+         * Full allocation records are too expensive for production, instead the sampler records the stack of an
+         * allocation every m_sampleInterval bytes on average. The distance between samples is drawn from an exponential
+         * distribution (Poisson process over the allocated bytes), the same way the tcmalloc heap profiler does it, so
+         * the samples can be scaled back to an unbiased estimate of the real heap.
+         * When no sample is due an allocation costs one thread local decrement, a free costs one lookup in a small
+         * counting filter.
+         *
+         * Usage:
+         * \code
+         * Debug::AllocationSampler sampler;
+         * sampler.Start(AllocatorInstance<SystemAllocator>::Get());
+         * ...
+         * sampler.WriteHeapProfile("server.heap");   // pprof --text server_binary server.heap
+         * sampler.Stop();
+         * \endcode
+         *
+         * Allocators which support sampling call \ref OnAllocation and \ref OnDeAllocation when IAllocator::GetSampler
+         * is set (SystemAllocator and the pool allocators).
+         * IMPORTANT: Start/Stop don't synchronize with allocations in flight. Destroy the sampler only when the allocator
+         * is idle (or destroyed).
+         */
+        class AllocationSampler
+        {
+        public:
+            struct Descriptor
+            {
+                Descriptor()
+                    : m_sampleInterval(512 * 1024)
+                    , m_stackRecordLevels(32)
+                {}
+
+                size_t          m_sampleInterval;       ///< Average number of allocated bytes between samples.
+                unsigned char   m_stackRecordLevels;    ///< How many stack levels to record for each sample (up to MaxStackRecordLevels).
+            };
+
+            static const unsigned int MaxStackRecordLevels = 64;
+            /// Number of samplers which can run at the same time (we keep a thread local counter for each).
+            static const unsigned int MaxNumSamplers = 8;
+
+            AllocationSampler();
+            ~AllocationSampler();
+
+            /// Starts sampling the allocator. Returns false if it's already sampled or we run out of sampler slots.
+            bool            Start(IAllocator& allocator, const Descriptor& desc = Descriptor());
+            /// Stops sampling, the recorded samples are kept until Reset or destruction so we can still write them.
+            void            Stop();
+            /// Removes all samples.
+            void            Reset();
+
+            bool            IsStarted() const   { return m_allocator != nullptr; }
+
+            /// Called by the allocator after each allocation, suppressStackRecord is the number of allocator frames to skip.
+            AZ_FORCE_INLINE void OnAllocation(void* address, size_t byteSize, unsigned int suppressStackRecord = 0)
+            {
+                s64& bytesUntilSample = s_bytesUntilSample[m_slot];
+                bytesUntilSample -= static_cast<s64>(byteSize);
+                if (bytesUntilSample < 0)
+                {
+                    RecordSample(address, byteSize, suppressStackRecord);
+                }
+            }
+
+            /// Called by the allocator before each free.
+            AZ_FORCE_INLINE void OnDeAllocation(void* address)
+            {
+                if (m_filter[FilterIndex(address)].load(AZStd::memory_order_relaxed) != 0)
+                {
+                    RemoveSample(address);
+                }
+            }
+
+            /**
+             * Writes a heap profile in the pprof legacy text format (heap_v2), with in use and total sampled
+             * allocations for each stack. On Linux the process memory map is added so pprof can symbolize.
+             */
+            bool            WriteHeapProfile(const AZStd::function<void(const char* data, size_t size)>& write);
+            bool            WriteHeapProfile(const char* fileName);
+
+            /// Number of sampled allocations which are still alive.
+            size_t          NumLiveSamples() const  { return m_numLiveSamples; }
+            /// Estimated bytes in use, the sampled sizes scaled by the inverse of their sample probability.
+            size_t          EstimatedInUseBytes();
+
+        protected:
+            AllocationSampler(const AllocationSampler&);
+            AllocationSampler& operator=(const AllocationSampler&);
+
+            struct StackEntry;
+            struct Sample;
+
+            static const unsigned int FilterSize = 4096;
+            static const unsigned int NumSampleBuckets = 4096;
+            static const unsigned int NumStackBuckets = 16384;
+
+            static AZ_FORCE_INLINE unsigned int FilterIndex(void* address)
+            {
+                size_t key = reinterpret_cast<size_t>(address) >> 4;
+                return static_cast<unsigned int>((key ^ (key >> 12)) & (FilterSize - 1));
+            }
+
+            void            RecordSample(void* address, size_t byteSize, unsigned int suppressStackRecord);
+            void            RemoveSample(void* address);
+            s64             NextSampleDistance();
+
+            IAllocator*                 m_allocator;
+            size_t                      m_sampleInterval;
+            unsigned int                m_stackRecordLevels;
+            unsigned int                m_slot;
+            size_t                      m_numLiveSamples;
+            StackEntry**                m_stackBuckets;
+            Sample**                    m_sampleBuckets;
+            AZStd::mutex                m_mutex;
+            AZStd::atomic<u32>          m_filter[FilterSize];   ///< Number of live samples for each address hash, so most frees don't need the lock.
+
+            static AZ_THREAD_LOCAL s64  s_bytesUntilSample[MaxNumSamplers];
+        };
+    }
+}
+
+#endif // AZCORE_ALLOCATION_SAMPLER_H
+#pragma once
@@ -22,6 +22,7 @@ using namespace AZ;
 //=========================================================================
 IAllocator::IAllocator()
     : m_records(NULL)
+    , m_sampler(NULL)
     , m_isReady(false)
 {
 }
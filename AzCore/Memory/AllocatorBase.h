@@ -15,12 +15,14 @@
 #include <AzCore/base.h>
 #include <AzCore/std/base.h>
 #include <AzCore/std/typetraits/integral_constant.h>
+#include <AzCore/Memory/AllocatorStatistics.h>
 
 namespace AZ
 {
     namespace Debug
     {
         class AllocationRecords;
+        class AllocationSampler;
         class MemoryDriller;
     }
     /**
@@ -64,6 +66,8 @@ namespace AZ
          * that will be reported.
          */
         virtual size_type               GetUnAllocatedMemory(bool isPrint = false) const { (void)isPrint; return 0; }
+        /// Returns how many times a thread had to wait for a lock inside the allocator. 0 if the allocator has no locks or doesn't count them.
+        virtual size_type               GetLockContentionCount() const { return 0; }
         /// Returns a pointer to a sub-allocator or NULL.
         virtual IAllocatorAllocate*     GetSubAllocator() = 0;
     };
@@ -75,6 +79,7 @@ namespace AZ
         : public IAllocatorAllocate
     {
         friend class Debug::MemoryDriller;
+        friend class Debug::AllocationSampler;
     public:
         // @{ IAlloctor will be registered in the AllocatorManager on construction and removed on destruction.
         IAllocator();
@@ -90,6 +95,13 @@ namespace AZ
         /// Returns a pointer to the allocation records. They might be available or not depending on the build type. \ref Debug::AllocationRecords
         Debug::AllocationRecords*   GetRecords()    { return m_records; }
 
+        /// Returns the allocation sampler if sampling is running for this allocator. \ref Debug::AllocationSampler
+        Debug::AllocationSampler*   GetSampler()    { return m_sampler; }
+
+        /// Returns the allocation counters, maintained by the allocators which support them (SystemAllocator, the pool allocators and BestFitExternalMapAllocator).
+        const AllocatorStatistics&  GetStatistics() const   { return m_statistics; }
+        AllocatorStatistics&        GetStatistics()         { return m_statistics; }
+
         bool                        IsReady() const { return m_isReady; }
 
     protected:
@@ -102,6 +114,8 @@ namespace AZ
         bool OnOutOfMemory(size_type byteSize, size_type alignment, int flags, const char* name, const char* fileName, int lineNum);
 
         Debug::AllocationRecords*   m_records;      ///< Cached pointer to allocation records. Works together with the MemoryDriller.
+        Debug::AllocationSampler*   m_sampler;      ///< Sampler set by Debug::AllocationSampler::Start, the allocator reports allocations to it when set.
+        AllocatorStatistics         m_statistics;   ///< Allocation counters, \ref AllocatorManager::GetStats
 
     private:
 
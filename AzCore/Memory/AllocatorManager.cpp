@@ -97,6 +97,46 @@ AllocatorManager::GarbageCollect()
     }
 }
 
+//=========================================================================
+// GetStats
+//=========================================================================
+AZStd::vector<AllocatorManager::AllocatorStats>
+AllocatorManager::GetStats()
+{
+    AZStd::vector<AllocatorStats> stats;
+    stats.reserve(m_numAllocators);
+
+    AZStd::lock_guard<AZStd::mutex> lock(m_allocatorListMutex);
+    for (int i = 0; i < m_numAllocators; ++i)
+    {
+        IAllocator* allocator = m_allocators[i];
+        AllocatorStats allocatorStats;
+        allocatorStats.m_allocator = allocator;
+        allocatorStats.m_name = allocator->GetName();
+        allocatorStats.m_allocatedBytes = allocator->NumAllocatedBytes();
+        allocatorStats.m_capacity = allocator->Capacity();
+        allocatorStats.m_unAllocatedBytes = allocator->GetUnAllocatedMemory();
+        size_t heldBytes = allocatorStats.m_allocatedBytes + allocatorStats.m_unAllocatedBytes;
+        allocatorStats.m_fragmentation = heldBytes ? static_cast<float>(allocatorStats.m_unAllocatedBytes) / static_cast<float>(heldBytes) : 0.0f;
+        allocatorStats.m_lockContentions = allocator->GetLockContentionCount();
+
+        AllocatorStatistics& statistics = allocator->GetStatistics();
+        statistics.UpdatePeak(allocatorStats.m_allocatedBytes);
+        AllocatorStatistics::Snapshot snapshot;
+        statistics.GetSnapshot(snapshot);
+        allocatorStats.m_peakAllocatedBytes = snapshot.m_peakAllocatedBytes;
+        allocatorStats.m_numAllocations = snapshot.m_numAllocations;
+        allocatorStats.m_numFrees = snapshot.m_numFrees;
+        allocatorStats.m_requestedBytes = snapshot.m_requestedBytes;
+        for (unsigned int bucket = 0; bucket < AllocatorStatistics::NumSizeBuckets; ++bucket)
+        {
+            allocatorStats.m_sizeHistogram[bucket] = snapshot.m_sizeHistogram[bucket];
+        }
+        stats.push_back(allocatorStats);
+    }
+    return stats;
+}
+
 //=========================================================================
 // AddOutOfMemoryListener
 // [12/2/2010]
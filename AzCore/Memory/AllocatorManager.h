@@ -15,6 +15,8 @@
 #include <AzCore/base.h>
 #include <AzCore/std/algorithm.h>
 #include <AzCore/std/parallel/mutex.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/Memory/AllocatorStatistics.h>
 
 #include <AzCore/std/functional.h> // for callbacks
 
@@ -56,6 +58,25 @@ namespace AZ
         /// Especially for great code and engines...
         void    SetAllocatorLeaking(bool allowLeaking)  { m_isAllocatorLeaking = allowLeaking; }
 
+        /// Snapshot of an allocator usage and counters, \ref AllocatorStatistics.
+        struct AllocatorStats
+        {
+            IAllocator*     m_allocator;
+            const char*     m_name;
+            size_t          m_allocatedBytes;       ///< IAllocatorAllocate::NumAllocatedBytes
+            size_t          m_peakAllocatedBytes;   ///< Highest sampled m_allocatedBytes
+            size_t          m_capacity;             ///< IAllocatorAllocate::Capacity
+            size_t          m_unAllocatedBytes;     ///< IAllocatorAllocate::GetUnAllocatedMemory
+            float           m_fragmentation;        ///< Part of the memory the allocator holds which is free (unallocated / (allocated + unallocated))
+            u64             m_numAllocations;
+            u64             m_numFrees;
+            u64             m_requestedBytes;       ///< Sum of all requested allocation sizes
+            u64             m_lockContentions;      ///< Number of times a thread waited for an allocator lock
+            u64             m_sizeHistogram[AllocatorStatistics::NumSizeBuckets];   ///< Number of allocations in each power of 2 size bucket, \ref AllocatorStatistics::GetSizeBucket
+        };
+        /// Returns the stats of all registered allocators.
+        AZStd::vector<AllocatorStats> GetStats();
+
         //////////////////////////////////////////////////////////////////////////
         // Debug support
         static const int MaxNumMemoryBreaks = 5;
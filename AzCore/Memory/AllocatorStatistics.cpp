@@ -0,0 +1,100 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZ_UNITY_BUILD
+
+#include <AzCore/Memory/AllocatorStatistics.h>
+
+using namespace AZ;
+
+AZ_THREAD_LOCAL unsigned int AllocatorStatistics::s_shardIndex = 0;
+
+//=========================================================================
+// AllocatorStatistics
+//=========================================================================
+AllocatorStatistics::AllocatorStatistics()
+{
+    Reset();
+}
+
+//=========================================================================
+// AssignShard
+//=========================================================================
+unsigned int
+AllocatorStatistics::AssignShard()
+{
+    // spread the threads over the shards, it's shared by all allocators
+    static AZStd::atomic<unsigned int> s_nextShard(0);
+    s_shardIndex = s_nextShard.fetch_add(1, AZStd::memory_order_relaxed) % NumShards + 1;
+    return s_shardIndex;
+}
+
+//=========================================================================
+// UpdatePeak
+//=========================================================================
+void
+AllocatorStatistics::UpdatePeak(size_t allocatedBytes)
+{
+    size_t peak = m_peakAllocatedBytes.load(AZStd::memory_order_relaxed);
+    while (allocatedBytes > peak && !m_peakAllocatedBytes.compare_exchange_weak(peak, allocatedBytes, AZStd::memory_order_relaxed))
+    {
+    }
+}
+
+//=========================================================================
+// GetSnapshot
+//=========================================================================
+void
+AllocatorStatistics::GetSnapshot(Snapshot& snapshot) const
+{
+    snapshot.m_numAllocations = 0;
+    snapshot.m_numFrees = 0;
+    snapshot.m_requestedBytes = 0;
+    for (unsigned int bucket = 0; bucket < NumSizeBuckets; ++bucket)
+    {
+        snapshot.m_sizeHistogram[bucket] = 0;
+    }
+
+    for (unsigned int i = 0; i < NumShards; ++i)
+    {
+        const Shard& shard = m_shards[i];
+        snapshot.m_numFrees += shard.m_numFrees.load(AZStd::memory_order_relaxed);
+        snapshot.m_requestedBytes += shard.m_requestedBytes.load(AZStd::memory_order_relaxed);
+        for (unsigned int bucket = 0; bucket < NumSizeBuckets; ++bucket)
+        {
+            u64 numAllocations = shard.m_sizeHistogram[bucket].load(AZStd::memory_order_relaxed);
+            snapshot.m_sizeHistogram[bucket] += numAllocations;
+            snapshot.m_numAllocations += numAllocations;
+        }
+    }
+    snapshot.m_peakAllocatedBytes = m_peakAllocatedBytes.load(AZStd::memory_order_relaxed);
+}
+
+//=========================================================================
+// Reset
+//=========================================================================
+void
+AllocatorStatistics::Reset()
+{
+    for (unsigned int i = 0; i < NumShards; ++i)
+    {
+        Shard& shard = m_shards[i];
+        shard.m_numFrees.store(0, AZStd::memory_order_relaxed);
+        shard.m_requestedBytes.store(0, AZStd::memory_order_relaxed);
+        for (unsigned int bucket = 0; bucket < NumSizeBuckets; ++bucket)
+        {
+            shard.m_sizeHistogram[bucket].store(0, AZStd::memory_order_relaxed);
+        }
+    }
+    m_peakAllocatedBytes.store(0, AZStd::memory_order_relaxed);
+}
+
+#endif // #ifndef AZ_UNITY_BUILD
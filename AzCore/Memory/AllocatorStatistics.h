@@ -0,0 +1,159 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZCORE_ALLOCATOR_STATISTICS_H
+#define AZCORE_ALLOCATOR_STATISTICS_H 1
+
+#include <AzCore/base.h>
+#include <AzCore/std/parallel/atomic.h>
+#include <AzCore/Math/MathUtils.h>
+
+namespace AZ
+{
+    /**
+     * Allocation counters of an allocator, cheap enough to be always on.
+     * The counters are split in shards, each thread picks a shard once and updates it with a relaxed fetch_add, so
+     * threads don't fight for the same cache line. More than NumShards threads share shards, their increments are
+     * still exact but contend a little. The shards are summed without a lock, so a snapshot taken while other threads
+     * allocate can be slightly inconsistent. The number of allocations is the sum of the size histogram, so an
+     * allocation only touches two counters. The peak usage is sampled every time the requested bytes of a shard cross a PeakSampleBytes boundary
+     * (and on every snapshot), so short spikes of small allocations can be missed.
+     */
+    class AllocatorStatistics
+    {
+    public:
+        static const unsigned int NumShards = 8;
+        static const unsigned int NumSizeBuckets = 20;          ///< Power of 2 size buckets, [0,16), [16,32) ... [4MB, ...)
+        static const unsigned int PeakSampleBytes = 64 * 1024;  ///< Must be a power of 2.
+
+        struct Snapshot
+        {
+            u64     m_numAllocations;
+            u64     m_numFrees;
+            u64     m_requestedBytes;                   ///< Sum of all requested allocation sizes.
+            size_t  m_peakAllocatedBytes;
+            u64     m_sizeHistogram[NumSizeBuckets];    ///< Number of allocations in each size bucket.
+        };
+
+        AllocatorStatistics();
+
+        /// Returns true when the allocator should report its allocated bytes with UpdatePeak.
+        AZ_FORCE_INLINE bool OnAllocation(size_t byteSize)
+        {
+            Shard& shard = m_shards[GetShardIndex()];
+            u64 requestedBytes = Increment(shard.m_requestedBytes, byteSize);
+            Increment(shard.m_sizeHistogram[GetSizeBucket(byteSize)], 1);
+            return ((requestedBytes - byteSize) ^ requestedBytes) >= PeakSampleBytes;
+        }
+
+        AZ_FORCE_INLINE void OnDeAllocation()
+        {
+            Increment(m_shards[GetShardIndex()].m_numFrees, 1);
+        }
+
+        /// Counts count allocations of byteSize at once, for bulk allocations. Same return value as OnAllocation.
+        AZ_FORCE_INLINE bool OnAllocations(size_t byteSize, size_t count)
+        {
+            Shard& shard = m_shards[GetShardIndex()];
+            u64 totalBytes = u64(byteSize) * count;
+            u64 requestedBytes = Increment(shard.m_requestedBytes, totalBytes);
+            Increment(shard.m_sizeHistogram[GetSizeBucket(byteSize)], count);
+            return ((requestedBytes - totalBytes) ^ requestedBytes) >= PeakSampleBytes;
+        }
+
+        AZ_FORCE_INLINE void OnDeAllocations(size_t count)
+        {
+            Increment(m_shards[GetShardIndex()].m_numFrees, count);
+        }
+
+        void UpdatePeak(size_t allocatedBytes);
+
+        /// Sums all shards, the counters of the different shards are not read atomically.
+        void GetSnapshot(Snapshot& snapshot) const;
+        /// Resets all counters and the peak.
+        void Reset();
+
+        static AZ_FORCE_INLINE unsigned int GetSizeBucket(size_t byteSize)
+        {
+            if (byteSize < 16)
+            {
+                return 0;
+            }
+            unsigned int bucket = FloorLog2(byteSize) - 3;
+            return bucket < NumSizeBuckets ? bucket : NumSizeBuckets - 1;
+        }
+
+    private:
+        AllocatorStatistics(const AllocatorStatistics&);
+        AllocatorStatistics& operator=(const AllocatorStatistics&);
+
+        struct Shard
+        {
+            AZ_ALIGN(AZStd::atomic<u64> m_numFrees, 64);         ///< Alignment keeps each shard on its own cache lines.
+            AZStd::atomic<u64>  m_requestedBytes;
+            AZStd::atomic<u64>  m_sizeHistogram[NumSizeBuckets];   ///< Number of allocations in each size bucket.
+        };
+
+        /// Returns the new counter value. More threads than shards can share a shard, so we need an atomic add, but
+        /// with a shard per few threads it's mostly uncontended.
+        static AZ_FORCE_INLINE u64 Increment(AZStd::atomic<u64>& counter, u64 value)
+        {
+            return counter.fetch_add(value, AZStd::memory_order_relaxed) + value;
+        }
+
+        static AZ_FORCE_INLINE unsigned int GetShardIndex()
+        {
+            unsigned int index = s_shardIndex;
+            if (index == 0)
+            {
+                index = AssignShard();
+            }
+            return index - 1;
+        }
+        static unsigned int AssignShard();
+
+        Shard                   m_shards[NumShards];
+        AZStd::atomic<size_t>   m_peakAllocatedBytes;
+
+        static AZ_THREAD_LOCAL unsigned int s_shardIndex;  ///< Shard index + 1 of the current thread, 0 if not assigned yet.
+    };
+
+    /**
+     * Lock guard for the allocators internal locks, counts how many times we had to wait for the lock.
+     */
+    template<class Mutex>
+    class ContentionLockGuard
+    {
+    public:
+        ContentionLockGuard(Mutex& mutex, AZStd::atomic<size_t>& contentionCount)
+            : m_mutex(mutex)
+        {
+            if (!m_mutex.try_lock())
+            {
+                contentionCount.fetch_add(1, AZStd::memory_order_relaxed);
+                m_mutex.lock();
+            }
+        }
+        ~ContentionLockGuard()
+        {
+            m_mutex.unlock();
+        }
+
+    private:
+        ContentionLockGuard(const ContentionLockGuard&);
+        ContentionLockGuard& operator=(const ContentionLockGuard&);
+
+        Mutex& m_mutex;
+    };
+}
+
+#endif // AZCORE_ALLOCATOR_STATISTICS_H
+#pragma once
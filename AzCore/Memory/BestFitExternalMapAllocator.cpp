@@ -111,6 +111,10 @@ BestFitExternalMapAllocator::Allocate(size_type byteSize, size_type alignment, i
     }
 
     AZ_Assert(address != 0, "BestFitExternalMapAllocator: Failed to allocate %d bytes aligned on %d (flags: 0x%08x) %s : %s (%d)!", byteSize, alignment, flags, name ? name : "(no name)", fileName ? fileName : "(no file name)", lineNum);
+    if (address && m_statistics.OnAllocation(byteSize))
+    {
+        m_statistics.UpdatePeak(m_schema->NumAllocatedBytes());
+    }
 #ifdef AZCORE_ENABLE_MEMORY_TRACKING
     if (m_records)
     {
@@ -143,6 +147,10 @@ BestFitExternalMapAllocator::DeAllocate(pointer_type ptr, size_type byteSize, si
 #endif
     (void)byteSize;
     (void)alignment;
+    if (ptr)
+    {
+        m_statistics.OnDeAllocation();
+    }
     m_schema->DeAllocate(ptr);
 }
 
@@ -14,6 +14,9 @@
 #include <AzCore/Memory/BestFitExternalMapSchema.h>
 #include <AzCore/Memory/SystemAllocator.h>
 
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/sort.h>
+
 using namespace AZ;
 
 //=========================================================================
@@ -49,7 +52,7 @@ BestFitExternalMapSchema::Allocate(size_type byteSize, size_type alignment, int
     AZ_Assert(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be >0 and power of 2!");
     for (int i = 0; i < 2; ++i) // max 2 attempts to allocate
     {
-        FreeMapType::iterator iter = m_freeChunksMap.find(byteSize);
+        FreeMapType::iterator iter = m_freeChunksMap.lower_bound(byteSize); // smallest chunk that can fit
         size_t  blockSize = 0;
         char*   blockAddress = NULL;
         size_t  preAllocBlockSize = 0;
@@ -148,56 +151,38 @@ BestFitExternalMapSchema::GetMaxAllocationSize() const
 void
 BestFitExternalMapSchema::GarbageCollect()
 {
-    for (FreeMapType::iterator curBlock = m_freeChunksMap.begin(); curBlock != m_freeChunksMap.end(); )
+    if (m_freeChunksMap.size() < 2)
+    {
+        return;
+    }
+
+    // sort the free chunks by address and merge the neighbours
+    typedef AZStd::vector<AZStd::pair<char*, size_t>, AZStdIAllocator> ChunkArrayType;
+    ChunkArrayType chunks(AZStdIAllocator(m_desc.m_mapAllocator));
+    chunks.reserve(m_freeChunksMap.size());
+    for (FreeMapType::iterator iter = m_freeChunksMap.begin(); iter != m_freeChunksMap.end(); ++iter)
+    {
+        chunks.push_back(AZStd::make_pair(iter->second, iter->first));
+    }
+    AZStd::sort(chunks.begin(), chunks.end(), [](const AZStd::pair<char*, size_t>& lhs, const AZStd::pair<char*, size_t>& rhs) { return lhs.first < rhs.first; });
+
+    m_freeChunksMap.clear();
+    char* blockAddress = chunks[0].first;
+    size_t blockSize = chunks[0].second;
+    for (size_t i = 1; i < chunks.size(); ++i)
     {
-        char* curStart = curBlock->second;
-        char* curEnd = curStart + curBlock->first;
-        bool isMerge = false;
-        for (FreeMapType::iterator nextBlock = curBlock++; nextBlock != m_freeChunksMap.end(); )
+        if (blockAddress + blockSize == chunks[i].first)
         {
-            char* nextStart = nextBlock->second;
-            char* nextEnd = nextStart + nextBlock->first;
-            if (curStart == nextEnd)
-            {
-                // merge
-                size_t newBlockSize = curBlock->first + nextBlock->first;
-                char* newBlockAddress = nextStart;
-                m_freeChunksMap.erase(nextBlock);
-                FreeMapType::iterator toErase = curBlock;
-                ++curBlock;
-                m_freeChunksMap.erase(toErase);
-                FreeMapType::iterator newBlock = m_freeChunksMap.insert(AZStd::make_pair(newBlockSize, newBlockAddress)).first;
-                if (curBlock != m_freeChunksMap.end() && newBlockSize < curBlock->first)  // if the newBlock in before the next in the list, update next in the list to current
-                {
-                    curBlock = newBlock;
-                }
-                isMerge = true;
-                break;
-            }
-            else if (curEnd == nextStart)
-            {
-                // merge
-                size_t newBlockSize = curBlock->first + nextBlock->first;
-                char* newBlockAddress = curStart;
-                m_freeChunksMap.erase(nextBlock);
-                FreeMapType::iterator toErase = curBlock;
-                ++curBlock;
-                m_freeChunksMap.erase(toErase);
-                FreeMapType::iterator newBlock = m_freeChunksMap.insert(AZStd::make_pair(newBlockSize, newBlockAddress)).first;
-                if (curBlock != m_freeChunksMap.end() && newBlockSize < curBlock->first)  // if the newBlock in before the next in the list, update next in the list to current
-                {
-                    curBlock = newBlock;
-                }
-                isMerge = true;
-                break;
-            }
-            ++nextBlock;
+            blockSize += chunks[i].second;
         }
-        if (!isMerge)
+        else
         {
-            ++curBlock;
+            m_freeChunksMap.insert(AZStd::make_pair(blockSize, blockAddress));
+            blockAddress = chunks[i].first;
+            blockSize = chunks[i].second;
         }
     }
+    m_freeChunksMap.insert(AZStd::make_pair(blockSize, blockAddress));
 }
 
 #endif // #ifndef AZ_UNITY_BUILD
\ No newline at end of file
@@ -0,0 +1,359 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZ_UNITY_BUILD
+
+#include <AzCore/Memory/CompactingHandleSchema.h>
+#include <AzCore/Memory/SystemAllocator.h>
+#include <AzCore/std/time.h>
+
+#include <string.h>
+
+using namespace AZ;
+
+namespace
+{
+    const AZ::u32 InvalidSlot = 0xffffffff;
+}
+
+//=========================================================================
+// CompactingHandleSchema
+//=========================================================================
+CompactingHandleSchema::CompactingHandleSchema(const Descriptor& desc)
+    : m_desc(desc)
+    , m_used(0)
+    , m_relocatedBytes(0)
+    , m_defragCursor(reinterpret_cast<char*>(desc.m_memoryBlock))
+    , m_firstFreeSlot(InvalidSlot)
+    , m_freeChunksByAddress(FreeAddressMapType::key_compare(), AZStdIAllocator(desc.m_mapAllocator != NULL ? desc.m_mapAllocator : &AllocatorInstance<SystemAllocator>::Get()))
+    , m_freeChunksBySize(FreeSizeMapType::key_compare(), AZStdIAllocator(desc.m_mapAllocator != NULL ? desc.m_mapAllocator : &AllocatorInstance<SystemAllocator>::Get()))
+    , m_allocChunksMap(AllocMapType::key_compare(), AZStdIAllocator(desc.m_mapAllocator != NULL ? desc.m_mapAllocator : &AllocatorInstance<SystemAllocator>::Get()))
+    , m_slots(AZStdIAllocator(desc.m_mapAllocator != NULL ? desc.m_mapAllocator : &AllocatorInstance<SystemAllocator>::Get()))
+{
+    if (m_desc.m_mapAllocator == NULL)
+    {
+        m_desc.m_mapAllocator = &AllocatorInstance<SystemAllocator>::Get(); // used as our sub allocator
+    }
+    AZ_Assert(m_desc.m_memoryBlockByteSize > 0, "You must provide memory block size!");
+    AZ_Assert(m_desc.m_memoryBlock != NULL, "You must provide memory block allocated as you with!");
+    AddFreeChunk(reinterpret_cast<char*>(m_desc.m_memoryBlock), m_desc.m_memoryBlockByteSize);
+}
+
+//=========================================================================
+// ~CompactingHandleSchema
+//=========================================================================
+CompactingHandleSchema::~CompactingHandleSchema()
+{
+    AZ_Assert(m_allocChunksMap.empty(), "We still have %d allocations (%d bytes) in the compacting handle schema!", (int)m_allocChunksMap.size(), (int)m_used);
+}
+
+//=========================================================================
+// Allocate
+//=========================================================================
+CompactingHandleSchema::Handle
+CompactingHandleSchema::Allocate(size_type byteSize, size_type alignment, RelocateCallback callback, void* userData)
+{
+    AZ_Assert(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be >0 and power of 2!");
+    if (byteSize == 0)
+    {
+        return InvalidHandle;
+    }
+
+    // best fit, the smallest chunk that can hold the aligned block
+    char* address = NULL;
+    FreeSizeMapType::iterator bySizeIter = m_freeChunksBySize.lower_bound(byteSize);
+    for (; bySizeIter != m_freeChunksBySize.end(); ++bySizeIter)
+    {
+        address = PointerAlignUp(bySizeIter->second, alignment);
+        if (static_cast<size_type>(address - bySizeIter->second) + byteSize <= bySizeIter->first)
+        {
+            break;
+        }
+    }
+    if (bySizeIter == m_freeChunksBySize.end())
+    {
+        return InvalidHandle;
+    }
+
+    // split the chunk, the parts are next to allocated blocks (or the block ends) so there is nothing to merge
+    char* chunkAddress = bySizeIter->second;
+    size_type chunkSize = bySizeIter->first;
+    RemoveFreeChunk(m_freeChunksByAddress.find(chunkAddress));
+    size_type preAllocBlockSize = address - chunkAddress;
+    if (preAllocBlockSize)
+    {
+        m_freeChunksByAddress.insert(AZStd::make_pair(chunkAddress, preAllocBlockSize));
+        m_freeChunksBySize.insert(AZStd::make_pair(preAllocBlockSize, chunkAddress));
+    }
+    size_type postAllocBlockSize = chunkSize - preAllocBlockSize - byteSize;
+    if (postAllocBlockSize)
+    {
+        m_freeChunksByAddress.insert(AZStd::make_pair(address + byteSize, postAllocBlockSize));
+        m_freeChunksBySize.insert(AZStd::make_pair(postAllocBlockSize, address + byteSize));
+    }
+
+    AZ::u32 slotIndex = m_firstFreeSlot;
+    if (slotIndex != InvalidSlot)
+    {
+        m_firstFreeSlot = m_slots[slotIndex].m_nextFree;
+    }
+    else
+    {
+        slotIndex = static_cast<AZ::u32>(m_slots.size());
+        m_slots.push_back();
+        m_slots.back().m_generation = 1;
+    }
+    Slot& slot = m_slots[slotIndex];
+    slot.m_address = address;
+    slot.m_byteSize = byteSize;
+    slot.m_callback = callback;
+    slot.m_userData = userData;
+    slot.m_alignment = static_cast<AZ::u32>(alignment);
+    slot.m_pinCount = 0;
+    slot.m_nextFree = InvalidSlot;
+
+    m_allocChunksMap.insert(AZStd::make_pair(address, slotIndex));
+    m_used += byteSize;
+    return (static_cast<Handle>(slot.m_generation) << 32) | slotIndex;
+}
+
+//=========================================================================
+// DeAllocate
+//=========================================================================
+void
+CompactingHandleSchema::DeAllocate(Handle handle)
+{
+    if (handle == InvalidHandle)
+    {
+        return;
+    }
+    Slot* slot = GetSlot(handle);
+    AZ_Assert(slot, "Invalid handle 0x%llx, it was already freed or it's not from this schema!", handle);
+    if (slot == NULL)
+    {
+        return;
+    }
+    AZ_Assert(slot->m_pinCount == 0, "Freeing pinned block 0x%llx!", handle);
+
+    m_allocChunksMap.erase(slot->m_address);
+    m_used -= slot->m_byteSize;
+    AddFreeChunk(slot->m_address, slot->m_byteSize);
+
+    slot->m_address = NULL;
+    slot->m_callback = NULL;
+    slot->m_userData = NULL;
+    if (++slot->m_generation == 0)
+    {
+        slot->m_generation = 1; // generation 0 is used by InvalidHandle
+    }
+    AZ::u32 slotIndex = static_cast<AZ::u32>(handle);
+    slot->m_nextFree = m_firstFreeSlot;
+    m_firstFreeSlot = slotIndex;
+}
+
+//=========================================================================
+// GetAddress
+//=========================================================================
+CompactingHandleSchema::pointer_type
+CompactingHandleSchema::GetAddress(Handle handle) const
+{
+    Slot* slot = GetSlot(handle);
+    return slot ? slot->m_address : NULL;
+}
+
+//=========================================================================
+// AllocationSize
+//=========================================================================
+CompactingHandleSchema::size_type
+CompactingHandleSchema::AllocationSize(Handle handle) const
+{
+    Slot* slot = GetSlot(handle);
+    return slot ? slot->m_byteSize : 0;
+}
+
+//=========================================================================
+// IsValid
+//=========================================================================
+bool
+CompactingHandleSchema::IsValid(Handle handle) const
+{
+    return GetSlot(handle) != NULL;
+}
+
+//=========================================================================
+// Pin
+//=========================================================================
+CompactingHandleSchema::pointer_type
+CompactingHandleSchema::Pin(Handle handle)
+{
+    Slot* slot = GetSlot(handle);
+    AZ_Assert(slot, "Invalid handle 0x%llx!", handle);
+    if (slot == NULL)
+    {
+        return NULL;
+    }
+    ++slot->m_pinCount;
+    return slot->m_address;
+}
+
+//=========================================================================
+// Unpin
+//=========================================================================
+void
+CompactingHandleSchema::Unpin(Handle handle)
+{
+    Slot* slot = GetSlot(handle);
+    AZ_Assert(slot, "Invalid handle 0x%llx!", handle);
+    AZ_Assert(slot == NULL || slot->m_pinCount > 0, "Handle 0x%llx is not pinned!", handle);
+    if (slot && slot->m_pinCount > 0)
+    {
+        --slot->m_pinCount;
+    }
+}
+
+//=========================================================================
+// Defragment
+//=========================================================================
+bool
+CompactingHandleSchema::Defragment(unsigned int budgetMicroseconds)
+{
+    AZStd::sys_time_t startTime = AZStd::GetTimeNowMicroSecond();
+    bool isMoved = false;
+    for (;; )
+    {
+        // Free chunks are merged, so the next free chunk is followed by an allocated block or the end of the memory block.
+        FreeAddressMapType::iterator freeChunk = m_freeChunksByAddress.lower_bound(m_defragCursor);
+        AllocMapType::iterator block = freeChunk != m_freeChunksByAddress.end() ? m_allocChunksMap.find(freeChunk->first + freeChunk->second) : m_allocChunksMap.end();
+        if (block == m_allocChunksMap.end())
+        {
+            // nothing left to move in this pass
+            m_defragCursor = reinterpret_cast<char*>(m_desc.m_memoryBlock);
+            return true;
+        }
+
+        Slot& slot = m_slots[block->second];
+        char* freeAddress = freeChunk->first;
+        char* oldAddress = block->first;
+        char* newAddress = PointerAlignUp(freeAddress, slot.m_alignment);
+        if (slot.m_pinCount > 0 || newAddress == oldAddress)
+        {
+            m_defragCursor = oldAddress + slot.m_byteSize;
+            continue;
+        }
+
+        if (isMoved && static_cast<unsigned int>(AZStd::GetTimeNowMicroSecond() - startTime) >= budgetMicroseconds)
+        {
+            return false;
+        }
+
+        // slide the block down, the gap moves after it and merges with the following free chunk
+        memmove(newAddress, oldAddress, slot.m_byteSize);
+        RemoveFreeChunk(freeChunk);
+        m_allocChunksMap.erase(block);
+        m_allocChunksMap.insert(AZStd::make_pair(newAddress, static_cast<AZ::u32>(&slot - m_slots.data())));
+        if (newAddress != freeAddress)
+        {
+            m_freeChunksByAddress.insert(AZStd::make_pair(freeAddress, static_cast<size_type>(newAddress - freeAddress)));
+            m_freeChunksBySize.insert(AZStd::make_pair(static_cast<size_type>(newAddress - freeAddress), freeAddress));
+        }
+        AddFreeChunk(newAddress + slot.m_byteSize, oldAddress - newAddress);
+        slot.m_address = newAddress;
+        m_relocatedBytes += slot.m_byteSize;
+        m_defragCursor = newAddress + slot.m_byteSize;
+        isMoved = true;
+
+        if (slot.m_callback)
+        {
+            Handle handle = (static_cast<Handle>(slot.m_generation) << 32) | static_cast<AZ::u32>(&slot - m_slots.data());
+            slot.m_callback(handle, newAddress, oldAddress, slot.m_byteSize, slot.m_userData);
+        }
+    }
+}
+
+//=========================================================================
+// GetMaxAllocationSize
+//=========================================================================
+CompactingHandleSchema::size_type
+CompactingHandleSchema::GetMaxAllocationSize() const
+{
+    if (!m_freeChunksBySize.empty())
+    {
+        return m_freeChunksBySize.rbegin()->first;
+    }
+    return 0;
+}
+
+//=========================================================================
+// GetSlot
+//=========================================================================
+CompactingHandleSchema::Slot*
+CompactingHandleSchema::GetSlot(Handle handle) const
+{
+    AZ::u32 slotIndex = static_cast<AZ::u32>(handle);
+    AZ::u32 generation = static_cast<AZ::u32>(handle >> 32);
+    if (slotIndex >= m_slots.size())
+    {
+        return NULL;
+    }
+    Slot* slot = const_cast<Slot*>(&m_slots[slotIndex]);
+    if (slot->m_generation != generation || slot->m_address == NULL)
+    {
+        return NULL;
+    }
+    return slot;
+}
+
+//=========================================================================
+// AddFreeChunk
+//=========================================================================
+void
+CompactingHandleSchema::AddFreeChunk(char* address, size_type byteSize)
+{
+    FreeAddressMapType::iterator next = m_freeChunksByAddress.lower_bound(address);
+    if (next != m_freeChunksByAddress.begin())
+    {
+        FreeAddressMapType::iterator prev = next;
+        --prev;
+        if (prev->first + prev->second == address)
+        {
+            address = prev->first;
+            byteSize += prev->second;
+            RemoveFreeChunk(prev);
+        }
+    }
+    if (next != m_freeChunksByAddress.end() && address + byteSize == next->first)
+    {
+        byteSize += next->second;
+        RemoveFreeChunk(next);
+    }
+    m_freeChunksByAddress.insert(AZStd::make_pair(address, byteSize));
+    m_freeChunksBySize.insert(AZStd::make_pair(byteSize, address));
+}
+
+//=========================================================================
+// RemoveFreeChunk
+//=========================================================================
+void
+CompactingHandleSchema::RemoveFreeChunk(FreeAddressMapType::iterator chunk)
+{
+    AZStd::pair<FreeSizeMapType::iterator, FreeSizeMapType::iterator> range = m_freeChunksBySize.equal_range(chunk->second);
+    for (FreeSizeMapType::iterator iter = range.first; iter != range.second; ++iter)
+    {
+        if (iter->second == chunk->first)
+        {
+            m_freeChunksBySize.erase(iter);
+            break;
+        }
+    }
+    m_freeChunksByAddress.erase(chunk);
+}
+
+#endif // #ifndef AZ_UNITY_BUILD
@@ -0,0 +1,132 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZCORE_COMPACTING_HANDLE_SCHEMA_H
+#define AZCORE_COMPACTING_HANDLE_SCHEMA_H 1
+
+#include <AzCore/Memory/Memory.h>
+
+#include <AzCore/std/containers/map.h>
+#include <AzCore/std/containers/vector.h>
+
+namespace AZ
+{
+    /**
+     * Relocatable best fit allocation scheme using external maps, for long lived data in a fixed memory block.
+     * Same as the BestFitExternalMapSchema the tracking info is stored outside the memory block (so it can be
+     * uncached), but allocations are referenced by handles instead of pointers. This allows Defragment to slide live
+     * blocks towards the start of the memory block, a little bit every call, so fragmentation doesn't accumulate
+     * over time.
+     * Pointers returned by GetAddress are only valid until the next Defragment call, use Pin/Unpin when you need to
+     * keep a pointer for longer, pinned blocks are never moved.
+     * \note This schema is NOT thread safe.
+     */
+    class CompactingHandleSchema
+    {
+    public:
+        typedef void*       pointer_type;
+        typedef size_t      size_type;
+        typedef ptrdiff_t   difference_type;
+        typedef AZ::u64     Handle;     ///< Slot index in the low 32 bits, generation in the high 32 bits.
+
+        static const Handle InvalidHandle = 0;
+
+        /**
+         * Called after a block was moved by Defragment, the data is already copied to the newAddress.
+         * Use it to patch pointers into the block or inner pointers the block itself holds.
+         */
+        typedef void (*RelocateCallback)(Handle handle, void* newAddress, void* oldAddress, size_type byteSize, void* userData);
+
+        struct Descriptor
+        {
+            Descriptor()
+                : m_memoryBlock(NULL)
+                , m_memoryBlockByteSize(0)
+                , m_mapAllocator(NULL)
+            {}
+
+            static const int        m_memoryBlockAlignment = 16;
+            void*                   m_memoryBlock;              ///< Pointer to memory to allocate from. Can be uncached.
+            size_type               m_memoryBlockByteSize;      ///< Sizes if the memory block.
+            IAllocatorAllocate*     m_mapAllocator;             ///< Allocator for the handle table and chunk maps. If null the SystemAllocator will be used.
+        };
+
+        CompactingHandleSchema(const Descriptor& desc);
+        ~CompactingHandleSchema();
+
+        /// Returns InvalidHandle if there is no free chunk big enough, calling Defragment might help.
+        Handle          Allocate(size_type byteSize, size_type alignment, RelocateCallback callback = NULL, void* userData = NULL);
+        void            DeAllocate(Handle handle);
+
+        /// Returns the current address of the block, valid until the next Defragment call. NULL for invalid handles.
+        pointer_type    GetAddress(Handle handle) const;
+        size_type       AllocationSize(Handle handle) const;
+        bool            IsValid(Handle handle) const;
+
+        /// Prevents Defragment from moving the block and returns its address. Pins are counted.
+        pointer_type    Pin(Handle handle);
+        void            Unpin(Handle handle);
+
+        /**
+         * Moves live blocks towards the start of the memory block until the budget runs out. At least one block is moved
+         * per call (when possible), so the budget can be exceeded by the time it takes to copy one block.
+         * \returns true when a full pass over the memory block is complete, the next call will start a new pass.
+         */
+        bool            Defragment(unsigned int budgetMicroseconds);
+
+        AZ_FORCE_INLINE size_type           NumAllocatedBytes() const               { return m_used; }
+        AZ_FORCE_INLINE size_type           Capacity() const                        { return m_desc.m_memoryBlockByteSize; }
+        /// Size of the biggest free chunk, in a fully compacted block this is Capacity() - NumAllocatedBytes() (minus pinned holes).
+        size_type                           GetMaxAllocationSize() const;
+        /// Number of bytes moved by Defragment since the schema was created.
+        AZ_FORCE_INLINE size_type           NumRelocatedBytes() const               { return m_relocatedBytes; }
+        AZ_FORCE_INLINE IAllocatorAllocate* GetSubAllocator() const                 { return m_desc.m_mapAllocator; }
+
+    private:
+        CompactingHandleSchema(const CompactingHandleSchema&);
+        CompactingHandleSchema& operator=(const CompactingHandleSchema&);
+
+        struct Slot
+        {
+            char*               m_address;          ///< NULL when the slot is free.
+            size_type           m_byteSize;
+            RelocateCallback    m_callback;
+            void*               m_userData;
+            AZ::u32             m_alignment;
+            AZ::u32             m_generation;
+            AZ::u32             m_pinCount;
+            AZ::u32             m_nextFree;         ///< Next free slot index, when the slot is free.
+        };
+
+        typedef AZStd::map<char*, size_type, AZStd::less<char*>, AZStdIAllocator> FreeAddressMapType;
+        typedef AZStd::multimap<size_type, char*, AZStd::less<size_type>, AZStdIAllocator> FreeSizeMapType;
+        typedef AZStd::map<char*, AZ::u32, AZStd::less<char*>, AZStdIAllocator> AllocMapType;
+        typedef AZStd::vector<Slot, AZStdIAllocator> SlotArrayType;
+
+        Slot*       GetSlot(Handle handle) const;
+        /// Adds a free chunk and merges it with its neighbours.
+        void        AddFreeChunk(char* address, size_type byteSize);
+        void        RemoveFreeChunk(FreeAddressMapType::iterator chunk);
+
+        Descriptor          m_desc;
+        size_type           m_used;                 ///< Number of bytes in use.
+        size_type           m_relocatedBytes;
+        char*               m_defragCursor;         ///< Where the current Defragment pass continues.
+        AZ::u32             m_firstFreeSlot;
+        FreeAddressMapType  m_freeChunksByAddress;  ///< Free chunks are always merged, so two free chunks are never adjacent.
+        FreeSizeMapType     m_freeChunksBySize;
+        AllocMapType        m_allocChunksMap;       ///< Allocated chunks sorted by address, maps to slot index.
+        SlotArrayType       m_slots;
+    };
+}
+
+#endif // AZCORE_COMPACTING_HANDLE_SCHEMA_H
+#pragma once
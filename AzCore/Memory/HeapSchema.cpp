@@ -243,6 +243,62 @@ HeapSchema::DeAllocate(pointer_type ptr, size_type byteSize, size_type alignment
 #   endif
 }
 
+//=========================================================================
+// ReAllocate
+//=========================================================================
+HeapSchema::pointer_type
+HeapSchema::ReAllocate(pointer_type ptr, size_type newSize, size_type newAlignment)
+{
+    if (ptr == 0)
+    {
+        return Allocate(newSize, newAlignment, 0);
+    }
+    if (newSize == 0)
+    {
+        DeAllocate(ptr);
+        return 0;
+    }
+
+    size_type oldChunkSize = ChunckSize(ptr);
+    if (newAlignment <= 1 || ((size_t)ptr & (newAlignment - 1)) == 0)
+    {
+        // grow (or shrink) in place when the next chunk is free
+        if (AZDLMalloc::mspace_az_resize(ptr, newSize) >= newSize)
+        {
+            m_used = m_used - oldChunkSize + ChunckSize(ptr);
+            return ptr;
+        }
+    }
+
+    // move to a new chunk in the same memory space
+    pointer_type newPtr = AZDLMalloc::mspace_memalign(get_mstate_for(mem2chunk(ptr)), newAlignment, newSize);
+    if (newPtr == 0)
+    {
+        return 0;
+    }
+    m_used += ChunckSize(newPtr);
+    size_type oldSize = AZDLMalloc::dlmalloc_usable_size(ptr);
+    memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+    DeAllocate(ptr);
+    return newPtr;
+}
+
+//=========================================================================
+// Resize
+//=========================================================================
+HeapSchema::size_type
+HeapSchema::Resize(pointer_type ptr, size_type newSize)
+{
+    if (ptr == 0)
+    {
+        return 0;
+    }
+    size_type oldChunkSize = ChunckSize(ptr);
+    size_type size = AZDLMalloc::mspace_az_resize(ptr, newSize);
+    m_used = m_used - oldChunkSize + ChunckSize(ptr);
+    return size;
+}
+
 //=========================================================================
 // AllocationSize
 // [11/22/2010]
@@ -54,8 +54,9 @@ namespace AZ
 
         virtual pointer_type    Allocate(size_type byteSize, size_type alignment, int flags, const char* name = 0, const char* fileName = 0, int lineNum = 0, unsigned int suppressStackRecord = 0);
         virtual void            DeAllocate(pointer_type ptr, size_type byteSize = 0, size_type alignment = 0);
-        virtual pointer_type    ReAllocate(pointer_type ptr, size_type newSize, size_type newAlignment) { (void)ptr; (void)newSize; (void)newAlignment; return NULL; }
-        virtual size_type       Resize(pointer_type ptr, size_type newSize)                  { (void)ptr; (void)newSize; return 0; }
+        virtual pointer_type    ReAllocate(pointer_type ptr, size_type newSize, size_type newAlignment);
+        /// Resizes the memory block in place (if the neighbouring memory is free) and returns the new size.
+        virtual size_type       Resize(pointer_type ptr, size_type newSize);
         virtual size_type       AllocationSize(pointer_type ptr);
 
         virtual size_type       NumAllocatedBytes() const               { return m_used; }
@@ -23,9 +23,11 @@
 #endif
 
 #include <AzCore/Memory/OSAllocator.h>
+#include <AzCore/Memory/AllocatorStatistics.h>
 
 #include <AzCore/std/parallel/mutex.h>
 #include <AzCore/std/parallel/lock.h>
+#include <AzCore/std/parallel/atomic.h>
 #include <AzCore/std/algorithm.h>
 #include <AzCore/std/containers/intrusive_set.h>
 
@@ -52,6 +54,13 @@ namespace AZ {
 
 #ifdef MULTITHREADED
 #   define  SPIN_COUNT 4000
+#   ifdef AZ_THREAD_LOCAL
+#       define THREAD_CACHE // thread caches are available (still opt-in, see HphaSchema::Descriptor::m_isThreadCache)
+#       if defined(AZ_PLATFORM_LINUX) || defined(AZ_PLATFORM_ANDROID) || defined(AZ_PLATFORM_APPLE)
+#           include <pthread.h>
+#           define THREAD_CACHE_EXIT_HOOK // caches are returned when their thread exits, otherwise only when the heap is destroyed
+#       endif
+#   endif
 #endif
 
     //////////////////////////////////////////////////////////////////////////
@@ -486,7 +495,7 @@ namespace AZ {
                     // and that will indicate that more secure measures are needed
 #ifdef DEBUG_PTR_IN_BUCKET_CHECK
 #ifdef MULTITHREADED
-                    AZStd::lock_guard<AZStd::mutex> lock(mBuckets[bi].get_lock());
+                    ContentionLockGuard<AZStd::mutex> lock(mBuckets[bi].get_lock(), mLockContention);
 #endif
                     const page* pe = mBuckets[bi].page_list_end();
                     const page* pb = mBuckets[bi].page_list_begin();
@@ -552,14 +561,112 @@ namespace AZ {
         size_t tree_get_max_allocation() const;
         size_t tree_get_unused_memory(bool isPrint) const;
         void tree_purge();
+        void tree_decommit();
 
         bucket mBuckets[NUM_BUCKETS];
+
+        // the thread cache is a front-end for the buckets (in the spirit of tcmalloc), each thread keeps a magazine (a
+        // free list) per bucket. Small allocations and frees only touch the magazine of the calling thread, a bucket
+        // lock is taken only to move half a magazine at once between the magazine and the bucket. Elements are not
+        // owned by a thread, a free always goes to the magazine of the freeing thread.
+#ifdef THREAD_CACHE
+        static const unsigned THREAD_CACHE_MAGAZINE_BYTES = 16 * 1024;  // max bytes kept per magazine
+        static const unsigned THREAD_CACHE_MIN_MAGAZINE = 16;           // min/max number of elements per magazine
+        static const unsigned THREAD_CACHE_MAX_MAGAZINE = 256;
+        static const unsigned THREAD_CACHE_TRIM_PERIOD = 64 * 1024;     // number of operations between trims of idle elements
+        static const unsigned THREAD_CACHE_SLOTS = 4;                   // max number of heaps with thread caches at the same time
+
+        struct magazine
+        {
+            free_link*      mHead;
+            unsigned short  mCount;
+            unsigned short  mLowWater;  // lowest count since the last trim, that many elements were not used
+            unsigned short  mCapacity;
+        };
+        struct thread_cache
+        {
+            magazine        mMagazines[NUM_BUCKETS];
+            unsigned        mNumOps;
+            unsigned        mFlushEpoch;
+            HpAllocator*    mHeap;
+            thread_cache*   mNext;      // all the caches of the heap, protected by mThreadCacheMutex
+        };
+        struct thread_cache_slot
+        {
+            size_t          mHeapId;    // heap ids are never reused, so a slot left by a destroyed heap never matches
+            thread_cache*   mCache;
+        };
+        static AZ_THREAD_LOCAL thread_cache_slot sThreadCacheSlots[THREAD_CACHE_SLOTS];
+        static AZStd::atomic<size_t> sThreadCacheHeaps[THREAD_CACHE_SLOTS];  // id of the heap using each slot
+        static AZStd::atomic<size_t> sNextHeapId;
+
+        inline thread_cache* get_thread_cache()
+        {
+            if (mThreadCacheSlot >= THREAD_CACHE_SLOTS)
+            {
+                return nullptr;
+            }
+            thread_cache_slot& slot = sThreadCacheSlots[mThreadCacheSlot];
+            return slot.mHeapId == mHeapId ? slot.mCache : thread_cache_create(slot);
+        }
+        inline void thread_cache_tick(thread_cache* tc)
+        {
+            if (++tc->mNumOps >= THREAD_CACHE_TRIM_PERIOD || tc->mFlushEpoch != mThreadCacheFlushEpoch.load(AZStd::memory_order_relaxed))
+            {
+                thread_cache_maintain(tc);
+            }
+        }
+        thread_cache* thread_cache_create(thread_cache_slot& slot);
+        void* thread_cache_alloc(thread_cache* tc, unsigned bi);
+        void thread_cache_free(thread_cache* tc, void* ptr, unsigned bi);
+        bool thread_cache_refill(magazine& m, unsigned bi);
+        void thread_cache_release(magazine& m, unsigned bi, unsigned count);
+        void thread_cache_maintain(thread_cache* tc);
+        void thread_cache_flush(thread_cache* tc);
+        void thread_cache_purge();
+        void thread_cache_remove(thread_cache* tc);
+        void thread_cache_destroy();
+#ifdef THREAD_CACHE_EXIT_HOOK
+        static void thread_cache_exit(void*);
+#endif
+
+        size_t mHeapId;
+        unsigned mThreadCacheSlot;  // THREAD_CACHE_SLOTS if this heap doesn't use thread caches
+        AZStd::atomic<unsigned> mThreadCacheFlushEpoch; // incremented to make all threads flush their cache
+        thread_cache* mThreadCaches;
+        AZStd::mutex mThreadCacheMutex;
+#endif // THREAD_CACHE
+
+        inline void* bucket_alloc_cached(unsigned bi)
+        {
+#ifdef THREAD_CACHE
+            if (thread_cache* tc = get_thread_cache())
+            {
+                return thread_cache_alloc(tc, bi);
+            }
+#endif
+            return bucket_alloc_direct(bi);
+        }
+        inline void bucket_free_cached(void* ptr, unsigned bi)
+        {
+#ifdef THREAD_CACHE
+            if (thread_cache* tc = get_thread_cache())
+            {
+                // if this asserts, the free size doesn't match the allocated size
+                HPPA_ASSERT(bi == ptr_get_page(ptr)->bucket_index());
+                return thread_cache_free(tc, ptr, bi);
+            }
+#endif
+            bucket_free_direct(ptr, bi);
+        }
+
         block_header* mMRFreeBlock; // most recent block, used by the tree HpAllocator
         free_node_tree mFreeTree;
         small_free_node_list mSmallFreeList;
 #ifdef MULTITHREADED
         // TODO rbbaklov: switched to recursive_mutex from mutex for Linux support.
         mutable AZStd::recursive_mutex mTreeMutex;
+        mutable AZStd::atomic<size_t> mLockContention; // times we had to wait for one of the locks
 #endif
 
         enum debug_source
@@ -667,7 +774,7 @@ namespace AZ {
         size_t mTotalAllocatedSizeBuckets;
         size_t mTotalAllocatedSizeTree;
     public:
-        HpAllocator(void* memoryBlock, size_t memoryBlockSize, size_t pageSize, size_t poolPageSize, bool isPoolAllocations);
+        HpAllocator(void* memoryBlock, size_t memoryBlockSize, size_t pageSize, size_t poolPageSize, bool isPoolAllocations, bool isThreadCache, OSPageSize hugePageSize, size_t decommitMinSize);
         ~HpAllocator();
         // allocate memory using DEFAULT_ALIGNMENT
         // size == 0 returns NULL
@@ -680,7 +787,7 @@ namespace AZ {
             if (m_isPoolAllocations && is_small_allocation(size))
             {
                 size = clamp_small_allocation(size);
-                void* ptr = bucket_alloc_direct(bucket_spacing_function(size + MEMORY_GUARD_SIZE));
+                void* ptr = bucket_alloc_cached(bucket_spacing_function(size + MEMORY_GUARD_SIZE));
                 return debug_add(ptr, size, DEBUG_SOURCE_BUCKETS);
             }
             else
@@ -706,7 +813,7 @@ namespace AZ {
             if (m_isPoolAllocations && is_small_allocation(size) && alignment <= MAX_SMALL_ALLOCATION)
             {
                 size = clamp_small_allocation(size);
-                void* ptr = bucket_alloc_direct(bucket_spacing_function(AZ::SizeAlignUp(size + MEMORY_GUARD_SIZE, alignment)));
+                void* ptr = bucket_alloc_cached(bucket_spacing_function(AZ::SizeAlignUp(size + MEMORY_GUARD_SIZE, alignment)));
                 return debug_add(ptr, size, DEBUG_SOURCE_BUCKETS);
             }
             else
@@ -914,7 +1021,7 @@ namespace AZ {
             debug_remove(ptr);
             if (ptr_in_bucket(ptr))
             {
-                return bucket_free(ptr);
+                return bucket_free_cached(ptr, ptr_get_page(ptr)->bucket_index());
             }
             tree_free(ptr);
         }
@@ -930,7 +1037,7 @@ namespace AZ {
             {
                 // if this asserts probably the original alloc used alignment
                 HPPA_ASSERT(ptr_in_bucket(ptr));
-                return bucket_free_direct(ptr, bucket_spacing_function(origSize + MEMORY_GUARD_SIZE));
+                return bucket_free_cached(ptr, bucket_spacing_function(origSize + MEMORY_GUARD_SIZE));
             }
             tree_free(ptr);
         }
@@ -945,7 +1052,7 @@ namespace AZ {
             if (m_isPoolAllocations && is_small_allocation(origSize) && oldAlignment <= MAX_SMALL_ALLOCATION)
             {
                 HPPA_ASSERT(ptr_in_bucket(ptr));
-                return bucket_free_direct(ptr, bucket_spacing_function(AZ::SizeAlignUp(origSize + MEMORY_GUARD_SIZE, oldAlignment)));
+                return bucket_free_cached(ptr, bucket_spacing_function(AZ::SizeAlignUp(origSize + MEMORY_GUARD_SIZE, oldAlignment)));
             }
             tree_free(ptr);
         }
@@ -955,8 +1062,11 @@ namespace AZ {
         // in all cases memory is never automatically returned to the OS
         void purge()
         {
+#ifdef THREAD_CACHE
+            thread_cache_purge();
+#endif
+            bucket_purge(); // first, empty pages might go back to the tree
             tree_purge();
-            bucket_purge();
             debug_purge();
         }
 #ifdef DEBUG_ALLOCATOR
@@ -979,15 +1089,26 @@ namespace AZ {
         size_t  AllocationSize(void* ptr);
         size_t  GetMaxAllocationSize() const;
         size_t  GetUnAllocatedMemory(bool isPrint) const;
+        // return the number of times a thread waited for one of our locks
+        size_t  lock_contention() const
+        {
+#ifdef MULTITHREADED
+            return mLockContention.load(AZStd::memory_order_relaxed);
+#else
+            return 0;
+#endif
+        }
 
         void*   SystemAlloc(size_t size, size_t align);
-        void    SystemFree(void* ptr);
+        void    SystemFree(void* ptr, size_t size);
 
         void*        m_fixedBlock;
         size_t       m_fixedBlockSize;
         const size_t m_treePageSize;
         const size_t m_poolPageSize;
         bool         m_isPoolAllocations;
+        OSPageSize m_hugePageSize;   // if not default the OS memory is mapped with huge pages and the pools allocate their pages from the tree
+        size_t       m_decommitMinSize;
     };
     //////////////////////////////////////////////////////////////////////////
 
@@ -1034,17 +1155,23 @@ namespace AZ {
 
 
     //////////////////////////////////////////////////////////////////////////
-    HpAllocator::HpAllocator(void* memoryBlock, size_t memoryBlockSize, size_t pageSize, size_t poolPageSize, bool isPoolAllocations)
+    HpAllocator::HpAllocator(void* memoryBlock, size_t memoryBlockSize, size_t pageSize, size_t poolPageSize, bool isPoolAllocations, bool isThreadCache, OSPageSize hugePageSize, size_t decommitMinSize)
         : mMRFreeBlock(0)
 #if defined(AZ_PLATFORM_X360) || defined(AZ_PLATFORM_WINDOWS) || defined(AZ_PLATFORM_XBONE) || defined(AZ_PLATFORM_PS4) // ACCEPTED_USE
         // we will use the os for direct allocations if memoryBlock == NULL
-        , m_treePageSize(memoryBlock != NULL ? pageSize : OS_VIRTUAL_PAGE_SIZE)
+        , m_treePageSize(memoryBlock != NULL ? pageSize : AZStd::GetMax<size_t>(OS_VIRTUAL_PAGE_SIZE, OSAllocator::GetPageSize(hugePageSize)))
         , m_poolPageSize(memoryBlock != NULL ? poolPageSize : OS_VIRTUAL_PAGE_SIZE)
 #else
-        , m_treePageSize(pageSize)
+        // with huge pages we map at least a page at a time
+        , m_treePageSize(memoryBlock != NULL ? pageSize : AZStd::GetMax<size_t>(pageSize, OSAllocator::GetPageSize(hugePageSize)))
         , m_poolPageSize(poolPageSize)
 #endif
+        , m_hugePageSize(hugePageSize)
+        , m_decommitMinSize(decommitMinSize)
     {
+#ifdef MULTITHREADED
+        mLockContention.store(0, AZStd::memory_order_relaxed);
+#endif
 #ifdef DEBUG_ALLOCATOR
         mTotalRequestedSizeBuckets = 0;
         mTotalRequestedSizeTree = 0;
@@ -1061,6 +1188,25 @@ namespace AZ {
             tree_attach(bl);
         }
 
+#ifdef THREAD_CACHE
+        // claim a thread cache slot, if they are all used by other heaps we just go without a cache
+        mHeapId = sNextHeapId.fetch_add(1, AZStd::memory_order_relaxed);
+        mThreadCacheSlot = THREAD_CACHE_SLOTS;
+        mThreadCacheFlushEpoch = 0;
+        mThreadCaches = nullptr;
+        for (unsigned i = 0; isThreadCache && m_isPoolAllocations && i < THREAD_CACHE_SLOTS; ++i)
+        {
+            size_t freeSlot = 0;
+            if (sThreadCacheHeaps[i].compare_exchange_strong(freeSlot, mHeapId, AZStd::memory_order_acq_rel))
+            {
+                mThreadCacheSlot = i;
+                break;
+            }
+        }
+#else
+        (void)isThreadCache;
+#endif
+
 #if defined(AZ_PLATFORM_WINDOWS) || defined(AZ_PLATFORM_X360) || defined(AZ_PLATFORM_XBONE) // ACCEPTED_USE
 #   if  defined(MULTITHREADED)
         // For some platforms we can use an actual spin lock, test and profile. We don't expect much contention there
@@ -1071,6 +1217,9 @@ namespace AZ {
 
     HpAllocator::~HpAllocator()
     {
+#ifdef THREAD_CACHE
+        thread_cache_destroy();
+#endif
         purge();
         // print any remaining allocated blocks
 
@@ -1176,7 +1325,7 @@ namespace AZ {
     void* HpAllocator::bucket_system_alloc()
     {
         void* ptr;
-        if (m_fixedBlock)
+        if (m_fixedBlock || m_hugePageSize != OS_PAGE_SIZE_DEFAULT)
         {
             ptr = tree_alloc_bucket_page();
             // mTotalAllocatedSizeBuckets memory is part of the tree allocations
@@ -1193,14 +1342,14 @@ namespace AZ {
     void HpAllocator::bucket_system_free(void* ptr)
     {
         HPPA_ASSERT(ptr);
-        if (m_fixedBlock)
+        if (m_fixedBlock || m_hugePageSize != OS_PAGE_SIZE_DEFAULT)
         {
             tree_free_bucket_page(ptr);
             // mTotalAllocatedSizeBuckets memory is part of the tree allocations
         }
         else
         {
-            SystemFree(ptr);
+            SystemFree(ptr, m_poolPageSize);
             mTotalAllocatedSizeBuckets -= m_poolPageSize;
         }
     }
@@ -1222,7 +1371,7 @@ namespace AZ {
         unsigned bi = bucket_spacing_function(size);
         HPPA_ASSERT(bi < NUM_BUCKETS);
 #ifdef MULTITHREADED
-        AZStd::lock_guard<AZStd::mutex> lock(mBuckets[bi].get_lock());
+        ContentionLockGuard<AZStd::mutex> lock(mBuckets[bi].get_lock(), mLockContention);
 #endif
         // get the page info and check if there's any available elements
         page* p = mBuckets[bi].get_free_page();
@@ -1245,7 +1394,7 @@ namespace AZ {
     {
         HPPA_ASSERT(bi < NUM_BUCKETS);
 #ifdef MULTITHREADED
-        AZStd::lock_guard<AZStd::mutex> lock(mBuckets[bi].get_lock());
+        ContentionLockGuard<AZStd::mutex> lock(mBuckets[bi].get_lock(), mLockContention);
 #endif
         page* p = mBuckets[bi].get_free_page();
         if (!p)
@@ -1265,9 +1414,8 @@ namespace AZ {
     {
         page* p = ptr_get_page(ptr);
         size_t elemSize = p->elem_size();
-        //if we do this and we use the bucket_free with size hint we will crash, as the hit will not be the real index/bucket size
-        //if (size <= elemSize)
-        if (size == elemSize)
+        // stay in place as long as the size maps to the same bucket, so a free with the new size as a hint finds the right bucket
+        if (bucket_spacing_function(size) == p->bucket_index())
         {
             return ptr;
         }
@@ -1285,9 +1433,7 @@ namespace AZ {
     {
         page* p = ptr_get_page(ptr);
         size_t elemSize = p->elem_size();
-        //if we do this and we use the bucket_free with size hint we will crash, as the hit will not be the real index/bucket size
-        //if (size <= elemSize && (elemSize&(alignment-1))==0)
-        if (size == elemSize && (elemSize & (alignment - 1)) == 0)
+        if (bucket_spacing_function(AZ::SizeAlignUp(size, alignment)) == p->bucket_index() && (elemSize & (alignment - 1)) == 0)
         {
             return ptr;
         }
@@ -1307,7 +1453,7 @@ namespace AZ {
         unsigned bi = p->bucket_index();
         HPPA_ASSERT(bi < NUM_BUCKETS);
 #ifdef MULTITHREADED
-        AZStd::lock_guard<AZStd::mutex> lock(mBuckets[bi].get_lock());
+        ContentionLockGuard<AZStd::mutex> lock(mBuckets[bi].get_lock(), mLockContention);
 #endif
         mBuckets[bi].free(p, ptr);
     }
@@ -1320,7 +1466,7 @@ namespace AZ {
         // most likely a class needs a base virtual destructor
         HPPA_ASSERT(bi == p->bucket_index());
 #ifdef MULTITHREADED
-        AZStd::lock_guard<AZStd::mutex> lock(mBuckets[bi].get_lock());
+        ContentionLockGuard<AZStd::mutex> lock(mBuckets[bi].get_lock(), mLockContention);
 #endif
         mBuckets[bi].free(p, ptr);
     }
@@ -1331,7 +1477,7 @@ namespace AZ {
         unsigned bi = p->bucket_index();
         HPPA_ASSERT(bi < NUM_BUCKETS);
 #ifdef MULTITHREADED
-        AZStd::lock_guard<AZStd::mutex> lock(mBuckets[bi].get_lock());
+        ContentionLockGuard<AZStd::mutex> lock(mBuckets[bi].get_lock(), mLockContention);
 #endif
         return p->elem_size() - MEMORY_GUARD_SIZE;
     }
@@ -1341,7 +1487,7 @@ namespace AZ {
         for (int i = (int)NUM_BUCKETS - 1; i > 0; i--)
         {
 #ifdef MULTITHREADED
-            AZStd::lock_guard<AZStd::mutex> lock(mBuckets[i].get_lock());
+            ContentionLockGuard<AZStd::mutex> lock(mBuckets[i].get_lock(), mLockContention);
 #endif
             const page* p = mBuckets[i].get_free_page();
             if (p)
@@ -1360,7 +1506,7 @@ namespace AZ {
         for (int i = (int)NUM_BUCKETS - 1; i > 0; i--)
         {
 #ifdef MULTITHREADED
-            AZStd::lock_guard<AZStd::mutex> lock(mBuckets[i].get_lock());
+            ContentionLockGuard<AZStd::mutex> lock(mBuckets[i].get_lock(), mLockContention);
 #endif
             const page* pageEnd = mBuckets[i].page_list_end();
             for (const page* p = mBuckets[i].page_list_begin(); p != pageEnd; )
@@ -1388,7 +1534,7 @@ namespace AZ {
         for (unsigned i = 0; i < NUM_BUCKETS; i++)
         {
 #ifdef MULTITHREADED
-            AZStd::lock_guard<AZStd::mutex> lock(mBuckets[i].get_lock());
+            ContentionLockGuard<AZStd::mutex> lock(mBuckets[i].get_lock(), mLockContention);
 #endif
             page* pageEnd = mBuckets[i].page_list_end();
             for (page* p = mBuckets[i].page_list_begin(); p != pageEnd; )
@@ -1411,6 +1557,237 @@ namespace AZ {
         }
     }
 
+#ifdef THREAD_CACHE
+    AZ_THREAD_LOCAL HpAllocator::thread_cache_slot HpAllocator::sThreadCacheSlots[HpAllocator::THREAD_CACHE_SLOTS];
+    AZStd::atomic<size_t> HpAllocator::sThreadCacheHeaps[HpAllocator::THREAD_CACHE_SLOTS];
+    AZStd::atomic<size_t> HpAllocator::sNextHeapId(1);
+
+    HpAllocator::thread_cache* HpAllocator::thread_cache_create(thread_cache_slot& slot)
+    {
+        // first small allocation of this thread from this heap, the cache itself lives in the tree
+        thread_cache* tc = (thread_cache*)tree_alloc(sizeof(thread_cache));
+        if (!tc)
+        {
+            return nullptr;
+        }
+        for (unsigned bi = 0; bi < NUM_BUCKETS; ++bi)
+        {
+            magazine& m = tc->mMagazines[bi];
+            m.mHead = nullptr;
+            m.mCount = 0;
+            m.mLowWater = 0;
+            size_t capacity = THREAD_CACHE_MAGAZINE_BYTES / bucket_spacing_function_inverse(bi);
+            if (capacity < THREAD_CACHE_MIN_MAGAZINE)
+            {
+                capacity = THREAD_CACHE_MIN_MAGAZINE;
+            }
+            else if (capacity > THREAD_CACHE_MAX_MAGAZINE)
+            {
+                capacity = THREAD_CACHE_MAX_MAGAZINE;
+            }
+            m.mCapacity = (unsigned short)capacity;
+        }
+        tc->mNumOps = 0;
+        tc->mFlushEpoch = mThreadCacheFlushEpoch.load(AZStd::memory_order_relaxed);
+        tc->mHeap = this;
+#ifdef THREAD_CACHE_EXIT_HOOK
+        // the key destructor only runs for threads which set a value
+        static pthread_key_t exitKey = []() { pthread_key_t key; pthread_key_create(&key, &HpAllocator::thread_cache_exit); return key; }();
+        pthread_setspecific(exitKey, this);
+#endif
+        {
+            ContentionLockGuard<AZStd::mutex> lock(mThreadCacheMutex, mLockContention);
+            tc->mNext = mThreadCaches;
+            mThreadCaches = tc;
+        }
+        slot.mHeapId = mHeapId;
+        slot.mCache = tc;
+        return tc;
+    }
+
+    void* HpAllocator::thread_cache_alloc(thread_cache* tc, unsigned bi)
+    {
+        HPPA_ASSERT(bi < NUM_BUCKETS);
+        thread_cache_tick(tc);
+        magazine& m = tc->mMagazines[bi];
+        if (!m.mHead && !thread_cache_refill(m, bi))
+        {
+            return nullptr;
+        }
+        free_link* free = m.mHead;
+        m.mHead = free->mNext;
+        m.mCount--;
+        if (m.mCount < m.mLowWater)
+        {
+            m.mLowWater = m.mCount;
+        }
+        return free;
+    }
+
+    void HpAllocator::thread_cache_free(thread_cache* tc, void* ptr, unsigned bi)
+    {
+        HPPA_ASSERT(bi < NUM_BUCKETS);
+        thread_cache_tick(tc);
+        magazine& m = tc->mMagazines[bi];
+        free_link* lnk = (free_link*)ptr;
+        lnk->mNext = m.mHead;
+        m.mHead = lnk;
+        if (++m.mCount >= m.mCapacity)
+        {
+            thread_cache_release(m, bi, m.mCapacity / 2);
+        }
+    }
+
+    bool HpAllocator::thread_cache_refill(magazine& m, unsigned bi)
+    {
+        // take half a magazine with a single lock
+        unsigned count = m.mCapacity / 2;
+        ContentionLockGuard<AZStd::mutex> lock(mBuckets[bi].get_lock(), mLockContention);
+        for (unsigned i = 0; i < count; ++i)
+        {
+            page* p = mBuckets[bi].get_free_page();
+            if (!p)
+            {
+                p = bucket_grow(bucket_spacing_function_inverse(bi), mBuckets[bi].marker());
+                if (!p)
+                {
+                    break;
+                }
+                mBuckets[bi].add_free_page(p);
+            }
+            free_link* lnk = (free_link*)mBuckets[bi].alloc(p);
+            lnk->mNext = m.mHead;
+            m.mHead = lnk;
+            m.mCount++;
+        }
+        return m.mHead != nullptr;
+    }
+
+    void HpAllocator::thread_cache_release(magazine& m, unsigned bi, unsigned count)
+    {
+        HPPA_ASSERT(count <= m.mCount);
+        ContentionLockGuard<AZStd::mutex> lock(mBuckets[bi].get_lock(), mLockContention);
+        for (unsigned i = 0; i < count; ++i)
+        {
+            free_link* lnk = m.mHead;
+            m.mHead = lnk->mNext;
+            mBuckets[bi].free(ptr_get_page(lnk), lnk);
+        }
+        m.mCount = (unsigned short)(m.mCount - count);
+        m.mLowWater = AZStd::GetMin(m.mLowWater, m.mCount);
+    }
+
+    void HpAllocator::thread_cache_maintain(thread_cache* tc)
+    {
+        unsigned epoch = mThreadCacheFlushEpoch.load(AZStd::memory_order_relaxed);
+        if (tc->mFlushEpoch != epoch)
+        {
+            // GarbageCollect was called, give everything back
+            tc->mFlushEpoch = epoch;
+            thread_cache_flush(tc);
+        }
+        else
+        {
+            // elements which were not used during the whole period are idle, give half of them back
+            for (unsigned bi = 0; bi < NUM_BUCKETS; ++bi)
+            {
+                magazine& m = tc->mMagazines[bi];
+                if (m.mLowWater)
+                {
+                    thread_cache_release(m, bi, (m.mLowWater + 1) / 2);
+                }
+                m.mLowWater = m.mCount;
+            }
+        }
+        tc->mNumOps = 0;
+    }
+
+    void HpAllocator::thread_cache_flush(thread_cache* tc)
+    {
+        for (unsigned bi = 0; bi < NUM_BUCKETS; ++bi)
+        {
+            magazine& m = tc->mMagazines[bi];
+            if (m.mCount)
+            {
+                thread_cache_release(m, bi, m.mCount);
+            }
+            m.mLowWater = 0;
+        }
+    }
+
+    void HpAllocator::thread_cache_purge()
+    {
+        if (mThreadCacheSlot >= THREAD_CACHE_SLOTS)
+        {
+            return;
+        }
+        // other threads flush their cache on their next allocation or free, we can't touch their magazines
+        mThreadCacheFlushEpoch.fetch_add(1, AZStd::memory_order_relaxed);
+        thread_cache_slot& slot = sThreadCacheSlots[mThreadCacheSlot];
+        if (slot.mHeapId == mHeapId)
+        {
+            slot.mCache->mFlushEpoch = mThreadCacheFlushEpoch.load(AZStd::memory_order_relaxed);
+            thread_cache_flush(slot.mCache);
+        }
+    }
+
+    void HpAllocator::thread_cache_remove(thread_cache* tc)
+    {
+        // the heap may be destroyed while the thread exits, thread_cache_destroy frees all the caches it finds in the
+        // list under the same lock, so only free the cache if it's still linked
+        ContentionLockGuard<AZStd::mutex> lock(mThreadCacheMutex, mLockContention);
+        thread_cache** link = &mThreadCaches;
+        while (*link && *link != tc)
+        {
+            link = &(*link)->mNext;
+        }
+        if (!*link)
+        {
+            return;
+        }
+        *link = tc->mNext;
+        thread_cache_flush(tc);
+        tree_free(tc);
+    }
+
+#ifdef THREAD_CACHE_EXIT_HOOK
+    void HpAllocator::thread_cache_exit(void*)
+    {
+        // a heap which is already destroyed gave its slot up, the cache was freed with the heap
+        for (unsigned i = 0; i < THREAD_CACHE_SLOTS; ++i)
+        {
+            thread_cache_slot& slot = sThreadCacheSlots[i];
+            if (slot.mCache && sThreadCacheHeaps[i].load(AZStd::memory_order_acquire) == slot.mHeapId)
+            {
+                slot.mCache->mHeap->thread_cache_remove(slot.mCache);
+            }
+            slot.mHeapId = 0;
+            slot.mCache = nullptr;
+        }
+    }
+#endif
+
+    void HpAllocator::thread_cache_destroy()
+    {
+        if (mThreadCacheSlot >= THREAD_CACHE_SLOTS)
+        {
+            return;
+        }
+        // nobody is allowed to use the heap anymore, so we can flush the caches of all threads. Exiting threads still
+        // remove their cache, give the slot up first so they stop finding us and take the lock they remove it under.
+        ContentionLockGuard<AZStd::mutex> lock(mThreadCacheMutex, mLockContention);
+        sThreadCacheHeaps[mThreadCacheSlot].store(0, AZStd::memory_order_release);
+        while (mThreadCaches)
+        {
+            thread_cache* tc = mThreadCaches;
+            mThreadCaches = tc->mNext;
+            thread_cache_flush(tc);
+            tree_free(tc);
+        }
+        mThreadCacheSlot = THREAD_CACHE_SLOTS;
+    }
+#endif // THREAD_CACHE
+
     void HpAllocator::split_block(block_header* bl, size_t size)
     {
         HPPA_ASSERT(size + sizeof(block_header) + sizeof(free_node) <= bl->size());
@@ -1474,7 +1851,7 @@ namespace AZ {
         {
             return; // no need to free the fixed block
         }
-        SystemFree(ptr);
+        SystemFree(ptr, size);
     }
 
     HpAllocator::block_header* HpAllocator::tree_add_block(void* mem, size_t size)
@@ -1654,7 +2031,7 @@ namespace AZ {
     void* HpAllocator::tree_alloc(size_t size)
     {
 #ifdef MULTITHREADED
-        AZStd::lock_guard<AZStd::recursive_mutex> lock(mTreeMutex);
+        ContentionLockGuard<AZStd::recursive_mutex> lock(mTreeMutex, mLockContention);
 #endif
         // modify the size to make sure we can fit the block header and free node
         if (size < sizeof(free_node))
@@ -1688,7 +2065,7 @@ namespace AZ {
     void* HpAllocator::tree_alloc_aligned(size_t size, size_t alignment)
     {
 #ifdef MULTITHREADED
-        AZStd::lock_guard<AZStd::recursive_mutex> lock(mTreeMutex);
+        ContentionLockGuard<AZStd::recursive_mutex> lock(mTreeMutex, mLockContention);
 #endif
         if (size < sizeof(free_node))
         {
@@ -1731,7 +2108,7 @@ namespace AZ {
     void* HpAllocator::tree_alloc_bucket_page()
     {
 #ifdef MULTITHREADED
-        AZStd::lock_guard<AZStd::recursive_mutex> lock(mTreeMutex);
+        ContentionLockGuard<AZStd::recursive_mutex> lock(mTreeMutex, mLockContention);
 #endif
         // We are allocating pool pages m_poolPageSize aligned at m_poolPageSize
         // what is special is that we are keeping the block_header at the beginning of the
@@ -1774,7 +2151,7 @@ namespace AZ {
     void* HpAllocator::tree_realloc(void* ptr, size_t size)
     {
 #ifdef MULTITHREADED
-        AZStd::lock_guard<AZStd::recursive_mutex> lock(mTreeMutex);
+        ContentionLockGuard<AZStd::recursive_mutex> lock(mTreeMutex, mLockContention);
 #endif
         if (size < sizeof(free_node))
         {
@@ -1859,7 +2236,7 @@ namespace AZ {
     {
         HPPA_ASSERT(((size_t)ptr & (alignment - 1)) == 0);
 #ifdef MULTITHREADED
-        AZStd::lock_guard<AZStd::recursive_mutex> lock(mTreeMutex);
+        ContentionLockGuard<AZStd::recursive_mutex> lock(mTreeMutex, mLockContention);
 #endif
         if (size < sizeof(free_node))
         {
@@ -1949,7 +2326,7 @@ namespace AZ {
     size_t HpAllocator::tree_resize(void* ptr, size_t size)
     {
 #ifdef MULTITHREADED
-        AZStd::lock_guard<AZStd::recursive_mutex> lock(mTreeMutex);
+        ContentionLockGuard<AZStd::recursive_mutex> lock(mTreeMutex, mLockContention);
 #endif
         if (size < sizeof(free_node))
         {
@@ -1992,7 +2369,7 @@ namespace AZ {
     void HpAllocator::tree_free(void* ptr)
     {
 #ifdef MULTITHREADED
-        AZStd::lock_guard<AZStd::recursive_mutex> lock(mTreeMutex);
+        ContentionLockGuard<AZStd::recursive_mutex> lock(mTreeMutex, mLockContention);
 #endif
         block_header* bl = ptr_get_block_header(ptr);
         mTotalAllocatedSizeTree -= bl->size() + sizeof(block_header);
@@ -2004,7 +2381,7 @@ namespace AZ {
     void HpAllocator::tree_free_bucket_page(void* ptr)
     {
 #ifdef MULTITHREADED
-        AZStd::lock_guard<AZStd::recursive_mutex> lock(mTreeMutex);
+        ContentionLockGuard<AZStd::recursive_mutex> lock(mTreeMutex, mLockContention);
 #endif
         HPPA_ASSERT(AZ::PointerAlignDown(ptr, m_poolPageSize) == ptr);
         block_header* bl = (block_header*)ptr;
@@ -2119,7 +2496,7 @@ namespace AZ {
     size_t HpAllocator::tree_ptr_size(void* ptr) const
     {
 #ifdef MULTITHREADED
-        AZStd::lock_guard<AZStd::recursive_mutex> lock(mTreeMutex);
+        ContentionLockGuard<AZStd::recursive_mutex> lock(mTreeMutex, mLockContention);
 #endif
         block_header* bl = ptr_get_block_header(ptr);
         if (bl->used()) // add a magic number to avoid better bad pointer data.
@@ -2153,13 +2530,15 @@ namespace AZ {
 
     void HpAllocator::tree_purge()
     {
+#ifdef MULTITHREADED
+        ContentionLockGuard<AZStd::recursive_mutex> lock(mTreeMutex, mLockContention);
+#endif
         if (m_fixedBlock)
         {
+            tree_attach(NULL);
+            tree_decommit();
             return;
         }
-#ifdef MULTITHREADED
-        AZStd::lock_guard<AZStd::recursive_mutex> lock(mTreeMutex);
-#endif
         // purge MR block
         tree_attach(NULL);
         size_t pageSize = m_treePageSize - sizeof(free_node);
@@ -2176,6 +2555,29 @@ namespace AZ {
             tree_purge_block(cur);
         }
         tree_attach(NULL);
+        tree_decommit();
+    }
+
+    void HpAllocator::tree_decommit()
+    {
+        if (m_decommitMinSize == 0)
+        {
+            return;
+        }
+        // return the pages of the big free blocks to the OS, keeping the block header and tree node
+        // the pages are still mapped and are just refilled when we allocate them again
+        const size_t pageSize = OSAllocator::GetPageSize(m_hugePageSize);
+        free_node_tree::iterator end = mFreeTree.end();
+        for (free_node_tree::iterator node = mFreeTree.lower_bound(m_decommitMinSize); node != end; ++node)
+        {
+            block_header* bl = node->get_block();
+            char* start = AZ::PointerAlignUp((char*)bl->mem() + sizeof(free_node), pageSize);
+            char* stop = AZ::PointerAlignDown((char*)bl->next(), pageSize);
+            if (start < stop)
+            {
+                OSAllocator::DecommitPages(start, stop - start);
+            }
+        }
     }
 
     //=========================================================================
@@ -2227,6 +2629,10 @@ namespace AZ {
     void*
     HpAllocator::SystemAlloc(size_t size, size_t align)
     {
+        if (m_hugePageSize != OS_PAGE_SIZE_DEFAULT)
+        {
+            return OSAllocator::ReservePages(size, align, m_hugePageSize);
+        }
 #if defined(AZ_PLATFORM_X360) || defined(AZ_PLATFORM_WINDOWS) || defined(AZ_PLATFORM_XBONE) // ACCEPTED_USE
         (void)align;
         AZ_Assert(size / OS_VIRTUAL_PAGE_SIZE * OS_VIRTUAL_PAGE_SIZE == size, "Invalid allocation/page size %d should be %d!", size, OS_VIRTUAL_PAGE_SIZE);
@@ -2242,8 +2648,14 @@ namespace AZ {
     // [2/22/2011]
     //=========================================================================
     void
-    HpAllocator::SystemFree(void* ptr)
+    HpAllocator::SystemFree(void* ptr, size_t size)
     {
+        if (m_hugePageSize != OS_PAGE_SIZE_DEFAULT)
+        {
+            OSAllocator::ReleasePages(ptr, size);
+            return;
+        }
+        (void)size;
 #if defined(AZ_PLATFORM_X360) || defined(AZ_PLATFORM_WINDOWS) || defined(AZ_PLATFORM_XBONE) // ACCEPTED_USE
         BOOL ret = VirtualFree(ptr, 0, MEM_RELEASE);
         (void)ret;
@@ -2584,8 +2996,14 @@ namespace AZ {
             AZ_Assert((m_desc.m_memoryBlockByteSize & (m_desc.m_pageSize - 1)) == 0, "Memory block size %d MUST be multiples of the of the page size %d!", m_desc.m_memoryBlockByteSize, m_desc.m_pageSize);
             if (m_desc.m_memoryBlock == NULL)
             {
-                AZ_Assert(m_desc.m_subAllocator != NULL, "Sub allocator must point to a valid allocator if m_memoryBlock is NOT allocated (NULL)!");
-                m_desc.m_memoryBlock = m_desc.m_subAllocator->Allocate(m_desc.m_memoryBlockByteSize, m_desc.m_memoryBlockAlignment, 0, "HphaSchema", __FILE__, __LINE__, 1);
+                if (m_desc.m_subAllocator != NULL)
+                {
+                    m_desc.m_memoryBlock = m_desc.m_subAllocator->Allocate(m_desc.m_memoryBlockByteSize, m_desc.m_memoryBlockAlignment, 0, "HphaSchema", __FILE__, __LINE__, 1);
+                }
+                else
+                {
+                    m_desc.m_memoryBlock = OSAllocator::ReservePages(m_desc.m_memoryBlockByteSize, m_desc.m_memoryBlockAlignment, m_desc.m_hugePageSize);
+                }
                 AZ_Assert(m_desc.m_memoryBlock != NULL, "Faled to allocate %d bytes!", m_desc.m_memoryBlockByteSize);
                 m_ownMemoryBlock = true;
             }
@@ -2599,7 +3017,7 @@ namespace AZ {
         }
 
         AZ_Assert(sizeof(HpAllocator) <= sizeof(m_hpAllocatorBuffer), "Increase the m_hpAllocatorBuffer, we need %d bytes but we have %d bytes!", sizeof(HpAllocator), sizeof(m_hpAllocatorBuffer));
-        m_allocator = new (m_hpAllocatorBuffer) HpAllocator(m_desc.m_memoryBlock, m_desc.m_memoryBlockByteSize, m_desc.m_pageSize, m_desc.m_poolPageSize, m_desc.m_isPoolAllocations);
+        m_allocator = new (m_hpAllocatorBuffer) HpAllocator(m_desc.m_memoryBlock, m_desc.m_memoryBlockByteSize, m_desc.m_pageSize, m_desc.m_poolPageSize, m_desc.m_isPoolAllocations, m_desc.m_isThreadCache, m_desc.m_hugePageSize, m_desc.m_decommitMinSize);
     }
 
     //=========================================================================
@@ -2613,7 +3031,14 @@ namespace AZ {
 
         if (m_ownMemoryBlock)
         {
-            m_desc.m_subAllocator->DeAllocate(m_desc.m_memoryBlock, m_desc.m_memoryBlockByteSize, m_desc.m_memoryBlockAlignment);
+            if (m_desc.m_subAllocator != NULL)
+            {
+                m_desc.m_subAllocator->DeAllocate(m_desc.m_memoryBlock, m_desc.m_memoryBlockByteSize, m_desc.m_memoryBlockAlignment);
+            }
+            else
+            {
+                OSAllocator::ReleasePages(m_desc.m_memoryBlock, m_desc.m_memoryBlockByteSize);
+            }
             m_desc.m_memoryBlock = NULL;
         }
     }
@@ -2731,6 +3156,15 @@ namespace AZ {
         return m_allocator->GetUnAllocatedMemory(isPrint);
     }
 
+    //=========================================================================
+    // GetLockContentionCount
+    //=========================================================================
+    HphaSchema::size_type
+    HphaSchema::GetLockContentionCount() const
+    {
+        return m_allocator->lock_contention();
+    }
+
     //=========================================================================
     // GarbageCollect
     // [2/22/2011]
@@ -13,6 +13,7 @@
 #define AZ_HPHA_ALLOCATION_SCHEME_ALLOCATOR_H
 
 #include <AzCore/Memory/Memory.h>
+#include <AzCore/Memory/OSPageSize.h>
 
 namespace AZ
 {
@@ -40,18 +41,34 @@ namespace AZ
 #endif
                 , m_poolPageSize(4*1024)
                 , m_isPoolAllocations(true)
+                , m_isThreadCache(false)
                 , m_memoryBlockByteSize(0)
                 , m_memoryBlock(0)
                 , m_subAllocator(nullptr)
+                , m_hugePageSize(OS_PAGE_SIZE_DEFAULT)
+                , m_decommitMinSize(0)
             {}
 
             static const int        m_memoryBlockAlignment = 64*1024;
             unsigned int            m_pageSize;                             ///< Page allocation size must be 1024 bytes aligned.
             unsigned int            m_poolPageSize : 31;                    ///< Page size used to small memory allocations. Must be less or equal to m_pageSize and a multiple of it.
             unsigned int            m_isPoolAllocations : 1;                ///< True to allow allocations from pools, otherwise false.
+            /**
+             * True to put a per thread cache in front of the pools, small allocations and frees then don't take a lock
+             * (only every half magazine). Each thread keeps up to 16KB per pool bucket, idle elements are returned
+             * periodically and GarbageCollect makes every thread return its cache on its next allocation or free.
+             * Only up to 4 heaps can use thread caches at the same time, and only on platforms with thread local storage.
+             */
+            bool                    m_isThreadCache;
             size_t                  m_memoryBlockByteSize;                  ///< Memory block size, if 0 we use the OS memory allocation functions.
             void*                   m_memoryBlock;                          ///< Can be NULL if so the we will allocate memory from the subAllocator if m_memoryBlocksByteSize is != 0.
-            IAllocatorAllocate*     m_subAllocator;                         ///< Allocator that m_memoryBlocks memory was allocated from or should be allocated (if NULL).
+            IAllocatorAllocate*     m_subAllocator;                         ///< Allocator that m_memoryBlocks memory was allocated from or should be allocated (if NULL we map it from the OS).
+            /**
+             * Page size to map the OS memory with (and m_memoryBlock when we map it). With huge pages the heap grows by at
+             * least one huge page and the pools take their pages from it, falling back to smaller pages if the OS can't provide them.
+             */
+            OSPageSize              m_hugePageSize;
+            size_t                  m_decommitMinSize;                      ///< GarbageCollect returns the physical pages of free blocks at least this big to the OS (the range stays mapped), 0 to disable.
         };
 
 
@@ -69,6 +86,7 @@ namespace AZ
         virtual size_type       Capacity() const                            { return m_capacity; }
         virtual size_type       GetMaxAllocationSize() const;
         virtual size_type       GetUnAllocatedMemory(bool isPrint = false) const;
+        virtual size_type       GetLockContentionCount() const;
         virtual IAllocatorAllocate* GetSubAllocator()                       { return m_desc.m_subAllocator; }
 
         /// Return unused memory to the OS (if we don't use fixed block). Don't call this unless you really need free memory, it is slow.
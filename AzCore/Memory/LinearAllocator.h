@@ -0,0 +1,260 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZCORE_LINEAR_ALLOCATOR_H
+#define AZCORE_LINEAR_ALLOCATOR_H
+
+#include <AzCore/Memory/SystemAllocator.h>
+#include <AzCore/Memory/LinearSchema.h>
+
+namespace AZ
+{
+    namespace Internal
+    {
+        /*!
+        * Template you can use to create your own linear allocators, as you can't inherit from LinearAllocator.
+        * This is the case because we use tread local storage and we need separate "static" instance for each allocator.
+        * Allocations are not tracked by the memory driller as they are never freed individually.
+        */
+        template<class Schema>
+        class LinearAllocatorHelper
+            : public IAllocator
+        {
+        public:
+            typedef typename Schema::Descriptor Descriptor;
+            typedef typename Schema::Marker Marker;
+
+            bool Create(const Descriptor& desc)
+            {
+                AZ_Assert(IsReady() == false, "Allocator was already created!");
+                if (IsReady())
+                {
+                    return false;
+                }
+
+                if (m_schema.Create(desc))
+                {
+                    OnCreated();
+                }
+                return IsReady();
+            }
+
+            void Destroy()
+            {
+                OnDestroy();
+                m_schema.Destroy();
+            }
+
+            /// Returns the current position of the calling thread, see \ref LinearSchema::GetMarker.
+            Marker GetMarker()
+            {
+                return m_schema.GetMarker();
+            }
+
+            /// Releases everything the calling thread allocated after the marker was taken.
+            void Rewind(const Marker& marker)
+            {
+                m_schema.Rewind(marker);
+            }
+
+            /// Rewinds all threads, no other thread may use the allocator while we reset.
+            void Reset()
+            {
+                m_schema.Reset();
+            }
+
+            //////////////////////////////////////////////////////////////////////////
+            // IAllocator
+            pointer_type Allocate(size_type byteSize, size_type alignment, int flags = 0, const char* name = 0, const char* fileName = 0, int lineNum = 0, unsigned int suppressStackRecord = 0) override
+            {
+                (void)suppressStackRecord;
+                pointer_type address = m_schema.Allocate(byteSize, alignment, flags);
+                if (address == nullptr)
+                {
+                    OnOutOfMemory(byteSize, alignment, flags, name, fileName, lineNum);
+                }
+                return address;
+            }
+
+            void DeAllocate(pointer_type ptr, size_type byteSize = 0, size_type alignment = 0) override
+            {
+                (void)byteSize;
+                (void)alignment;
+                m_schema.DeAllocate(ptr);
+            }
+
+            pointer_type ReAllocate(pointer_type ptr, size_type newSize, size_type newAlignment) override
+            {
+                if (ptr == nullptr)
+                {
+                    return Allocate(newSize, newAlignment);
+                }
+                // only the last allocation can change in place
+                if (m_schema.Resize(ptr, newSize) == newSize && (newAlignment <= 1 || (reinterpret_cast<size_t>(ptr) & (newAlignment - 1)) == 0))
+                {
+                    return ptr;
+                }
+                // the size of other blocks is unknown, copy up to the end of their used chunk space.
+                // The old block is not freed, it stays until the thread rewinds or the allocator resets.
+                size_type copySize = m_schema.AllocationSizeBound(ptr);
+                if (copySize == 0)
+                {
+                    // not from this thread's chunks, we can't tell how much to copy
+                    return nullptr;
+                }
+                pointer_type newPtr = Allocate(newSize, newAlignment);
+                if (newPtr)
+                {
+                    memcpy(newPtr, ptr, AZ::GetMin(copySize, newSize));
+                }
+                return newPtr;
+            }
+
+            size_type Resize(pointer_type ptr, size_type newSize) override
+            {
+                return m_schema.Resize(ptr, newSize);
+            }
+
+            size_type AllocationSize(pointer_type ptr) override
+            {
+                return m_schema.AllocationSize(ptr);
+            }
+
+            size_type NumAllocatedBytes() const override
+            {
+                return m_schema.NumAllocatedBytes();
+            }
+
+            size_type Capacity() const override
+            {
+                return AZ_CORE_MAX_ALLOCATOR_SIZE; // chunks are allocated on demand
+            }
+
+            size_type GetMaxAllocationSize() const override
+            {
+                return AZ_CORE_MAX_ALLOCATOR_SIZE;
+            }
+
+            size_type GetUnAllocatedMemory(bool isPrint = false) const override
+            {
+                (void)isPrint;
+                return m_schema.NumChunkBytes() - m_schema.NumAllocatedBytes();
+            }
+
+            void GarbageCollect() override
+            {
+                m_schema.GarbageCollect();
+            }
+
+            IAllocatorAllocate* GetSubAllocator() override
+            {
+                return m_schema.GetPageAllocator();
+            }
+            //////////////////////////////////////////////////////////////////////////
+
+        protected:
+            LinearAllocatorHelper& operator=(const LinearAllocatorHelper&);
+            Schema m_schema;
+        };
+    }
+
+    template<class Allocator>
+    using LinearAllocatorBase = Internal::LinearAllocatorHelper<LinearSchemaHelper<Allocator> >;
+
+    /*!
+     * Linear allocator for transient data. Every thread bumps through its own chunks,
+     * nothing is freed until you rewind to a marker (\ref LinearAllocatorScope) or Reset.
+     * If you want to create your own linear heap, inherit from LinearAllocatorBase,
+     * as we need unique static variable for allocator type.
+     */
+    class LinearAllocator final
+        : public LinearAllocatorBase<LinearAllocator>
+    {
+    public:
+        AZ_CLASS_ALLOCATOR(LinearAllocator, SystemAllocator, 0)
+        AZ_TYPE_INFO(LinearAllocator, "{C3C1A3D6-0E0C-4B4D-9F6A-5D57C1A8E2B4}")
+
+        //////////////////////////////////////////////////////////////////////////
+        // IAllocator
+        const char* GetName() const override
+        {
+            return "LinearAllocator";
+        }
+
+        const char* GetDescription() const override
+        {
+            return "Linear allocator for transient data, memory is freed by rewinding";
+        }
+        //////////////////////////////////////////////////////////////////////////
+    };
+
+    /*!
+     * Frame allocator, a linear allocator which is Reset once per frame (from a sync point,
+     * when no other thread allocates). Anything allocated from it is valid until the end of the frame.
+     */
+    class FrameAllocator final
+        : public LinearAllocatorBase<FrameAllocator>
+    {
+    public:
+        AZ_CLASS_ALLOCATOR(FrameAllocator, SystemAllocator, 0)
+        AZ_TYPE_INFO(FrameAllocator, "{7E2B9F0A-6C41-4E0B-A3D8-2F95B6C0D71E}")
+
+        //////////////////////////////////////////////////////////////////////////
+        // IAllocator
+        const char* GetName() const override
+        {
+            return "FrameAllocator";
+        }
+
+        const char* GetDescription() const override
+        {
+            return "Per frame transient data, released all at once every frame";
+        }
+        //////////////////////////////////////////////////////////////////////////
+    };
+
+    /**
+     * Takes a marker of the calling thread on construction and rewinds to it on destruction,
+     * so everything allocated from the Allocator in the scope is released at once.
+     * \code
+     * {
+     *     LinearAllocatorScope<LinearAllocator> scope;
+     *     AZStd::vector<int, LinearStdAllocator> values;
+     *     ...
+     * } // values memory is released here (the container must not outlive the scope)
+     * \endcode
+     */
+    template<class Allocator>
+    class LinearAllocatorScope
+    {
+    public:
+        LinearAllocatorScope()
+            : m_marker(AllocatorInstance<Allocator>::Get().GetMarker())
+        {}
+
+        ~LinearAllocatorScope()
+        {
+            AllocatorInstance<Allocator>::Get().Rewind(m_marker);
+        }
+
+    private:
+        LinearAllocatorScope(const LinearAllocatorScope&);
+        LinearAllocatorScope& operator=(const LinearAllocatorScope&);
+
+        typename Allocator::Marker m_marker;
+    };
+
+    typedef AZStdAlloc<LinearAllocator> LinearStdAllocator;
+    typedef AZStdAlloc<FrameAllocator>  FrameStdAllocator;
+}
+
+#endif // AZCORE_LINEAR_ALLOCATOR_H
+#pragma once
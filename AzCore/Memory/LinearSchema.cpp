@@ -0,0 +1,441 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZ_UNITY_BUILD
+
+#include <AzCore/Memory/LinearSchema.h>
+#include <AzCore/Memory/OSAllocator.h>
+#include <AzCore/std/parallel/lock.h>
+
+namespace AZ
+{
+    /**
+     * Chunk header, the chunk memory follows it.
+     */
+    struct LinearChunk
+    {
+        LinearChunk*    m_next;     ///< Next chunk of the thread, chunks after the current one are spares.
+        size_t          m_size;     ///< Chunk size in bytes including the header.
+
+        static const size_t HeaderSize = 16;
+
+        char*   Data()  { return reinterpret_cast<char*>(this) + HeaderSize; }
+        char*   End()   { return reinterpret_cast<char*>(this) + m_size; }
+    };
+    static_assert(sizeof(LinearChunk) <= LinearChunk::HeaderSize, "Chunk header doesn't fit!");
+
+    /**
+     * Per thread bump state.
+     */
+    struct LinearThreadData
+    {
+        LinearChunk*        m_firstChunk;
+        LinearChunk*        m_chunk;                ///< Chunk we allocate from, null until the first allocation.
+        char*               m_position;
+        char*               m_end;
+        char*               m_lastAllocation;       ///< The only block we can resize.
+        size_t              m_numAllocatedBytes;    ///< Bytes used, including alignment and the abandoned chunk tails.
+        size_t              m_numChunkBytes;
+        LinearThreadData*   m_next;
+
+        void SetChunk(LinearChunk* chunk, char* position)
+        {
+            m_chunk = chunk;
+            m_position = position;
+            m_end = chunk ? chunk->End() : nullptr;
+            m_lastAllocation = nullptr;
+        }
+    };
+}
+
+using namespace AZ;
+
+// malloc compatible alignment when none is requested
+static const size_t LinearDefaultAlignment = 16;
+
+//=========================================================================
+// LinearSchema
+//=========================================================================
+LinearSchema::LinearSchema(GetLinearThreadData getThreadData, SetLinearThreadData setThreadData)
+    : m_threadDataGetter(getThreadData)
+    , m_threadDataSetter(setThreadData)
+    , m_pageAllocator(nullptr)
+    , m_chunkSize(0)
+    , m_threads(nullptr)
+{
+}
+
+//=========================================================================
+// ~LinearSchema
+//=========================================================================
+LinearSchema::~LinearSchema()
+{
+    AZ_Assert(m_threads == nullptr, "You did not destroy the linear schema!");
+}
+
+//=========================================================================
+// Create
+//=========================================================================
+bool
+LinearSchema::Create(const Descriptor& desc)
+{
+    AZ_Assert(desc.m_chunkSize > LinearChunk::HeaderSize, "Chunk size is too small!");
+    m_chunkSize = desc.m_chunkSize;
+    m_pageAllocator = desc.m_pageAllocator;
+    if (m_pageAllocator == nullptr)
+    {
+        if (!AllocatorInstance<OSAllocator>::IsReady())
+        {
+            AllocatorInstance<OSAllocator>::Create();  // debug allocator is such that there is no much point to free it
+        }
+        m_pageAllocator = &AllocatorInstance<OSAllocator>::Get();
+    }
+    return true;
+}
+
+//=========================================================================
+// Destroy
+//=========================================================================
+bool
+LinearSchema::Destroy()
+{
+    // IMPORTANT: We assume/rely that all threads (except the calling one) are or will
+    // destroyed before you create another instance of the linear allocation.
+    // This should generally be ok since the all allocators are singletons.
+    AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+    while (m_threads)
+    {
+        LinearThreadData* threadData = m_threads;
+        m_threads = threadData->m_next;
+        while (threadData->m_firstChunk)
+        {
+            LinearChunk* chunk = threadData->m_firstChunk;
+            threadData->m_firstChunk = chunk->m_next;
+            m_pageAllocator->DeAllocate(chunk, chunk->m_size, LinearDefaultAlignment);
+        }
+        m_pageAllocator->DeAllocate(threadData, sizeof(LinearThreadData), AZStd::alignment_of<LinearThreadData>::value);
+    }
+    m_threadDataSetter(nullptr);
+    return true;
+}
+
+//=========================================================================
+// AcquireThreadData
+//=========================================================================
+LinearThreadData*
+LinearSchema::AcquireThreadData()
+{
+#ifdef AZ_THREAD_LOCAL
+    LinearThreadData* threadData = m_threadDataGetter();
+    if (threadData)
+    {
+        return threadData;
+    }
+#else
+    // all threads share one data, the caller holds the lock
+    if (m_threads)
+    {
+        return m_threads;
+    }
+    LinearThreadData* threadData;
+#endif
+
+    threadData = reinterpret_cast<LinearThreadData*>(m_pageAllocator->Allocate(sizeof(LinearThreadData), AZStd::alignment_of<LinearThreadData>::value, 0, "AZSystem::LinearSchema::ThreadData", __FILE__, __LINE__));
+    if (threadData == nullptr)
+    {
+        return nullptr;
+    }
+    threadData->m_firstChunk = nullptr;
+    threadData->SetChunk(nullptr, nullptr);
+    threadData->m_numAllocatedBytes = 0;
+    threadData->m_numChunkBytes = 0;
+
+#ifdef AZ_THREAD_LOCAL
+    m_threadDataSetter(threadData);
+    AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+#endif
+    threadData->m_next = m_threads;
+    m_threads = threadData;
+    return threadData;
+}
+
+//=========================================================================
+// Allocate
+//=========================================================================
+LinearSchema::pointer_type
+LinearSchema::Allocate(size_type byteSize, size_type alignment, int flags)
+{
+    (void)flags;
+#ifndef AZ_THREAD_LOCAL
+    AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+#endif
+    LinearThreadData* threadData = AcquireThreadData();
+    if (threadData == nullptr)
+    {
+        return nullptr;
+    }
+    if (alignment == 0)
+    {
+        alignment = LinearDefaultAlignment;
+    }
+
+    char* address = reinterpret_cast<char*>(AZ_SIZE_ALIGN_UP(reinterpret_cast<size_t>(threadData->m_position), alignment));
+    if (address > threadData->m_end || byteSize > static_cast<size_type>(threadData->m_end - address))
+    {
+        address = AllocateFromNewChunk(threadData, byteSize, alignment);
+        if (address == nullptr)
+        {
+            return nullptr;
+        }
+    }
+
+    threadData->m_numAllocatedBytes += (address + byteSize) - threadData->m_position;
+    threadData->m_position = address + byteSize;
+    threadData->m_lastAllocation = address;
+    return address;
+}
+
+//=========================================================================
+// AllocateFromNewChunk
+//=========================================================================
+char*
+LinearSchema::AllocateFromNewChunk(LinearThreadData* threadData, size_type byteSize, size_type alignment)
+{
+    size_t neededSize = LinearChunk::HeaderSize + byteSize + alignment - 1;
+    LinearChunk* chunk = threadData->m_chunk ? threadData->m_chunk->m_next : threadData->m_firstChunk;
+    if (chunk == nullptr || chunk->m_size < neededSize)
+    {
+        // insert a new chunk after the current one, a spare which is too small stays for later
+        size_t chunkSize = neededSize > m_chunkSize ? neededSize : m_chunkSize;
+        chunk = reinterpret_cast<LinearChunk*>(m_pageAllocator->Allocate(chunkSize, LinearDefaultAlignment, 0, "AZSystem::LinearSchema::Chunk", __FILE__, __LINE__));
+        if (chunk == nullptr)
+        {
+            return nullptr;
+        }
+        chunk->m_size = chunkSize;
+        if (threadData->m_chunk)
+        {
+            chunk->m_next = threadData->m_chunk->m_next;
+            threadData->m_chunk->m_next = chunk;
+        }
+        else
+        {
+            chunk->m_next = threadData->m_firstChunk;
+            threadData->m_firstChunk = chunk;
+        }
+        threadData->m_numChunkBytes += chunkSize;
+    }
+
+    // the tail of the current chunk is lost until we rewind
+    threadData->m_numAllocatedBytes += threadData->m_end - threadData->m_position;
+    threadData->SetChunk(chunk, chunk->Data());
+    return reinterpret_cast<char*>(AZ_SIZE_ALIGN_UP(reinterpret_cast<size_t>(threadData->m_position), alignment));
+}
+
+//=========================================================================
+// DeAllocate
+//=========================================================================
+void
+LinearSchema::DeAllocate(pointer_type ptr)
+{
+    (void)ptr;
+}
+
+//=========================================================================
+// Resize
+//=========================================================================
+LinearSchema::size_type
+LinearSchema::Resize(pointer_type ptr, size_type newSize)
+{
+#ifndef AZ_THREAD_LOCAL
+    AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+#endif
+    LinearThreadData* threadData = AcquireThreadData();
+    char* address = reinterpret_cast<char*>(ptr);
+    if (threadData == nullptr || address == nullptr || address != threadData->m_lastAllocation)
+    {
+        return 0;
+    }
+    if (newSize > static_cast<size_type>(threadData->m_end - address))
+    {
+        return threadData->m_position - address;
+    }
+    threadData->m_numAllocatedBytes = threadData->m_numAllocatedBytes - (threadData->m_position - address) + newSize;
+    threadData->m_position = address + newSize;
+    return newSize;
+}
+
+//=========================================================================
+// AllocationSize
+//=========================================================================
+LinearSchema::size_type
+LinearSchema::AllocationSize(pointer_type ptr)
+{
+#ifndef AZ_THREAD_LOCAL
+    AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+#endif
+    LinearThreadData* threadData = AcquireThreadData();
+    char* address = reinterpret_cast<char*>(ptr);
+    if (threadData == nullptr || address == nullptr || address != threadData->m_lastAllocation)
+    {
+        return 0;
+    }
+    return threadData->m_position - address;
+}
+
+//=========================================================================
+// AllocationSizeBound
+//=========================================================================
+LinearSchema::size_type
+LinearSchema::AllocationSizeBound(pointer_type ptr)
+{
+#ifndef AZ_THREAD_LOCAL
+    AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+#endif
+    LinearThreadData* threadData = AcquireThreadData();
+    char* address = reinterpret_cast<char*>(ptr);
+    if (threadData == nullptr || address == nullptr)
+    {
+        return 0;
+    }
+    // chunks after the current one are spares, no live block is in them
+    for (LinearChunk* chunk = threadData->m_firstChunk; chunk; chunk = chunk->m_next)
+    {
+        if (chunk == threadData->m_chunk)
+        {
+            return (address >= chunk->Data() && address < threadData->m_position) ? threadData->m_position - address : 0;
+        }
+        if (address >= chunk->Data() && address < chunk->End())
+        {
+            return chunk->End() - address;
+        }
+    }
+    return 0;
+}
+
+//=========================================================================
+// GarbageCollect
+//=========================================================================
+void
+LinearSchema::GarbageCollect()
+{
+#ifdef AZ_THREAD_LOCAL
+    LinearThreadData* threadData = m_threadDataGetter();
+    if (threadData == nullptr)
+    {
+        return;
+    }
+#else
+    AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+    LinearThreadData* threadData = m_threads;
+    if (threadData == nullptr)
+    {
+        return;
+    }
+#endif
+    LinearChunk** link = threadData->m_chunk ? &threadData->m_chunk->m_next : &threadData->m_firstChunk;
+    while (*link)
+    {
+        LinearChunk* chunk = *link;
+        *link = chunk->m_next;
+        threadData->m_numChunkBytes -= chunk->m_size;
+        m_pageAllocator->DeAllocate(chunk, chunk->m_size, LinearDefaultAlignment);
+    }
+}
+
+//=========================================================================
+// GetMarker
+//=========================================================================
+LinearSchema::Marker
+LinearSchema::GetMarker()
+{
+#ifndef AZ_THREAD_LOCAL
+    AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+#endif
+    LinearThreadData* threadData = AcquireThreadData();
+    Marker marker;
+    if (threadData == nullptr)
+    {
+        return marker;
+    }
+    marker.m_threadData = threadData;
+    marker.m_chunk = threadData->m_chunk;
+    marker.m_position = threadData->m_position;
+    marker.m_numAllocatedBytes = threadData->m_numAllocatedBytes;
+    return marker;
+}
+
+//=========================================================================
+// Rewind
+//=========================================================================
+void
+LinearSchema::Rewind(const Marker& marker)
+{
+#ifndef AZ_THREAD_LOCAL
+    AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+#endif
+    LinearThreadData* threadData = AcquireThreadData();
+    if (threadData == nullptr)
+    {
+        return;
+    }
+    AZ_Assert(marker.m_threadData == threadData, "Marker was taken on a different thread, markers must be rewound on the thread which created them!");
+    AZ_Assert(marker.m_numAllocatedBytes <= threadData->m_numAllocatedBytes, "Markers must be rewound in LIFO order!");
+    threadData->SetChunk(reinterpret_cast<LinearChunk*>(marker.m_chunk), marker.m_position);
+    threadData->m_numAllocatedBytes = marker.m_numAllocatedBytes;
+}
+
+//=========================================================================
+// Reset
+//=========================================================================
+void
+LinearSchema::Reset()
+{
+    AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+    for (LinearThreadData* threadData = m_threads; threadData; threadData = threadData->m_next)
+    {
+        LinearChunk* chunk = threadData->m_firstChunk;
+        threadData->SetChunk(chunk, chunk ? chunk->Data() : nullptr);
+        threadData->m_numAllocatedBytes = 0;
+    }
+}
+
+//=========================================================================
+// NumAllocatedBytes
+//=========================================================================
+LinearSchema::size_type
+LinearSchema::NumAllocatedBytes() const
+{
+    size_type bytesAllocated = 0;
+    AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+    for (LinearThreadData* threadData = m_threads; threadData; threadData = threadData->m_next)
+    {
+        bytesAllocated += threadData->m_numAllocatedBytes;
+    }
+    return bytesAllocated;
+}
+
+//=========================================================================
+// NumChunkBytes
+//=========================================================================
+LinearSchema::size_type
+LinearSchema::NumChunkBytes() const
+{
+    size_type chunkBytes = 0;
+    AZStd::lock_guard<AZStd::mutex> lock(m_mutex);
+    for (LinearThreadData* threadData = m_threads; threadData; threadData = threadData->m_next)
+    {
+        chunkBytes += threadData->m_numChunkBytes;
+    }
+    return chunkBytes;
+}
+
+#endif // #ifndef AZ_UNITY_BUILD
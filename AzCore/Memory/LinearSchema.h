@@ -0,0 +1,167 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZCORE_LINEAR_SCHEMA_H
+#define AZCORE_LINEAR_SCHEMA_H 1
+
+#include <AzCore/Memory/AllocatorBase.h>
+#include <AzCore/std/parallel/mutex.h>
+
+namespace AZ
+{
+    struct LinearThreadData;
+
+    /**
+     * Linear (bump) allocation schema.
+     * Each thread carves its allocations sequentially out of its own chunks, so allocating never
+     * takes a lock and freeing an individual block is a no-op. Memory is reclaimed all at once,
+     * either by rewinding the calling thread to a \ref Marker or by resetting every thread with \ref Reset.
+     * Chunks are kept for reuse after a rewind, GarbageCollect returns the spare ones to the page allocator.
+     * Use it for data that lives for a frame/request, so large amounts of transient data cost no individual frees.
+     */
+    class LinearSchema
+    {
+    public:
+        typedef void*       pointer_type;
+        typedef size_t      size_type;
+        typedef ptrdiff_t   difference_type;
+
+        // Functions for getting an instance of a LinearThreadData when using thread local storage
+        typedef LinearThreadData* (* GetLinearThreadData)();
+        typedef void(* SetLinearThreadData)(LinearThreadData*);
+
+        struct Descriptor
+        {
+            Descriptor()
+                : m_chunkSize(256 * 1024)
+                , m_pageAllocator(nullptr)
+            {}
+            size_t              m_chunkSize;        ///< Size of the chunks the threads allocate from. Bigger allocations get a chunk of their own.
+            IAllocatorAllocate* m_pageAllocator;    ///< If you provide this interface we will use it for chunk allocations, otherwise OSAllocator will be used.
+        };
+
+        /**
+         * Position in the calling thread's chunks. Everything allocated after the marker was taken is
+         * released by \ref Rewind. Markers must be rewound on the thread which created them, in LIFO order.
+         */
+        struct Marker
+        {
+            Marker()
+                : m_threadData(nullptr)
+                , m_chunk(nullptr)
+                , m_position(nullptr)
+                , m_numAllocatedBytes(0)
+            {}
+            LinearThreadData*   m_threadData;
+            void*               m_chunk;
+            char*               m_position;
+            size_t              m_numAllocatedBytes;
+        };
+
+        LinearSchema(GetLinearThreadData getThreadData, SetLinearThreadData setThreadData);
+        ~LinearSchema();
+
+        bool Create(const Descriptor& desc);
+        bool Destroy();
+
+        pointer_type    Allocate(size_type byteSize, size_type alignment, int flags = 0);
+        /// Individual blocks are not freed, the memory is reclaimed by \ref Rewind or \ref Reset.
+        void            DeAllocate(pointer_type ptr);
+        /// Only the last allocation of the calling thread can be resized (in place), returns 0 for all other blocks.
+        size_type       Resize(pointer_type ptr, size_type newSize);
+        /// Only the size of the last allocation of the calling thread is known, returns 0 for all other blocks.
+        size_type       AllocationSize(pointer_type ptr);
+        /**
+         * Upper bound of the size of any live block of the calling thread: the bytes from ptr to the end of the used
+         * part of the chunk that holds it. Returns 0 if ptr is not in the calling thread's chunks.
+         */
+        size_type       AllocationSizeBound(pointer_type ptr);
+        /// Return the calling thread's unused chunks to the page allocator.
+        void            GarbageCollect();
+
+        /// Returns the current position of the calling thread.
+        Marker          GetMarker();
+        /// Releases everything the calling thread allocated after the marker was taken.
+        void            Rewind(const Marker& marker);
+        /**
+         * Rewinds all threads to the start of their chunks.
+         * IMPORTANT: No other thread may use the allocator while we reset, call it from a sync point (e.g. the end of a frame).
+         */
+        void            Reset();
+
+        size_type       NumAllocatedBytes() const;
+        /// Returns the bytes of all chunks the threads own.
+        size_type       NumChunkBytes() const;
+        IAllocatorAllocate* GetPageAllocator()  { return m_pageAllocator; }
+
+    protected:
+        LinearSchema(const LinearSchema&);
+        LinearSchema& operator=(const LinearSchema&);
+
+        LinearThreadData*   AcquireThreadData();
+        char*               AllocateFromNewChunk(LinearThreadData* threadData, size_type byteSize, size_type alignment);
+
+        GetLinearThreadData m_threadDataGetter;
+        SetLinearThreadData m_threadDataSetter;
+        IAllocatorAllocate* m_pageAllocator;
+        size_t              m_chunkSize;
+        LinearThreadData*   m_threads;          ///< All thread data, protected by m_mutex.
+        mutable AZStd::mutex m_mutex;
+    };
+
+    /**
+     * Helper class to allow multiple instances of LinearSchema that can
+     * operate independent from each other. Your linear allocator should inherit from that class.
+     */
+    template<class Allocator>
+    class LinearSchemaHelper
+        : public LinearSchema
+    {
+    public:
+        LinearSchemaHelper()
+            : LinearSchema(&GetLinearThreadData, &SetLinearThreadData)
+        {}
+
+    protected:
+
+#ifdef AZ_THREAD_LOCAL
+        static LinearThreadData* GetLinearThreadData()
+        {
+            return m_threadData;
+        }
+
+        static void SetLinearThreadData(LinearThreadData* data)
+        {
+            m_threadData = data;
+        }
+
+        static AZ_THREAD_LOCAL LinearThreadData*  m_threadData;
+#else
+        static LinearThreadData* GetLinearThreadData()
+        {
+            return nullptr;
+        }
+
+        static void SetLinearThreadData(LinearThreadData* data)
+        {
+            (void)data;
+        }
+#endif // AZ_THREAD_LOCAL
+    };
+
+#ifdef AZ_THREAD_LOCAL
+    template<class Allocator>
+    AZ_THREAD_LOCAL LinearThreadData* LinearSchemaHelper<Allocator>::m_threadData = 0;
+#endif // AZ_THREAD_LOCAL
+}
+
+#endif // AZCORE_LINEAR_SCHEMA_H
+#pragma once
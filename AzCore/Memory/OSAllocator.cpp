@@ -11,6 +11,7 @@
 */
 #ifndef AZ_UNITY_BUILD
 
+#include <AzCore/PlatformIncl.h>
 #include <AzCore/Memory/OSAllocator.h>
 
 #if defined(AZ_PLATFORM_LINUX)
@@ -19,6 +20,11 @@
     #include <malloc/malloc.h>
 #endif
 
+#if defined(AZ_PLATFORM_LINUX) || defined(AZ_PLATFORM_ANDROID) || defined(AZ_PLATFORM_APPLE)
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
 using namespace AZ;
 
 //=========================================================================
@@ -115,4 +121,257 @@ OSAllocator::DeAllocate(pointer_type ptr, size_type byteSize, size_type alignmen
     m_numAllocatedBytes -= byteSize;
 }
 
+namespace
+{
+#if defined(AZ_PLATFORM_WINDOWS) || defined(AZ_PLATFORM_XBONE) // ACCEPTED_USE
+    void* MapHugePages(size_t byteSize, OSPageSize pageSize)
+    {
+        // 1GB pages need VirtualAlloc2, we only support the large page size
+        size_t largePageSize = GetLargePageMinimum();
+        if (largePageSize == 0 || OSAllocator::GetPageSize(pageSize) != largePageSize || byteSize % largePageSize)
+        {
+            return nullptr;
+        }
+        // fails without SeLockMemoryPrivilege
+        return VirtualAlloc(NULL, byteSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    }
+
+    void* MapPages(size_t byteSize, size_t alignment, bool isTransparentHugePages)
+    {
+        (void)isTransparentHugePages;
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        if (alignment <= systemInfo.dwAllocationGranularity)
+        {
+            return VirtualAlloc(NULL, byteSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        }
+        // find an aligned range and map it, retry if another thread got it first
+        for (;; )
+        {
+            char* probe = reinterpret_cast<char*>(VirtualAlloc(NULL, byteSize + alignment, MEM_RESERVE, PAGE_NOACCESS));
+            if (probe == nullptr)
+            {
+                return nullptr;
+            }
+            VirtualFree(probe, 0, MEM_RELEASE);
+            if (void* address = VirtualAlloc(AZ::PointerAlignUp(probe, alignment), byteSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE))
+            {
+                return address;
+            }
+        }
+    }
+
+    void UnmapPages(void* address, size_t byteSize)
+    {
+        (void)byteSize;
+        BOOL ret = VirtualFree(address, 0, MEM_RELEASE);
+        (void)ret;
+        AZ_Assert(ret, "Failed to free memory!");
+    }
+
+    void DiscardPages(void* address, size_t byteSize, bool isLazy)
+    {
+        (void)isLazy;
+        // the pages are dropped from the working set, we don't decommit so the range stays usable
+        VirtualAlloc(address, byteSize, MEM_RESET, PAGE_READWRITE);
+    }
+
+    size_t GetOSPageSize()
+    {
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        return systemInfo.dwPageSize;
+    }
+#elif defined(AZ_PLATFORM_LINUX) || defined(AZ_PLATFORM_ANDROID) || defined(AZ_PLATFORM_APPLE)
+    void* MapHugePages(size_t byteSize, OSPageSize pageSize)
+    {
+#   if defined(MAP_HUGETLB)
+        if (byteSize % OSAllocator::GetPageSize(pageSize))
+        {
+            return nullptr;
+        }
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#       if defined(MAP_HUGE_SHIFT)
+        flags |= (pageSize == OS_PAGE_SIZE_1GB ? 30 : 21) << MAP_HUGE_SHIFT;
+#       endif
+        // fails unless the huge pages are reserved (/proc/sys/vm/nr_hugepages), the mapping is page size aligned
+        void* address = mmap(nullptr, byteSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+        return address != MAP_FAILED ? address : nullptr;
+#   else
+        (void)byteSize;
+        (void)pageSize;
+        return nullptr;
+#   endif
+    }
+
+    void* MapPages(size_t byteSize, size_t alignment, bool isTransparentHugePages)
+    {
+        const size_t hugePageSize = OSAllocator::GetPageSize(OS_PAGE_SIZE_2MB);
+        if (isTransparentHugePages && byteSize >= hugePageSize && alignment < hugePageSize)
+        {
+            alignment = hugePageSize; // only aligned 2MB ranges can be backed by a huge page
+        }
+        // map more and trim the ends to get the alignment
+        size_t pageSize = OSAllocator::GetPageSize();
+        size_t mapSize = byteSize + (alignment > pageSize ? alignment - pageSize : 0);
+        char* mapped = reinterpret_cast<char*>(mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (mapped == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        char* address = AZ::PointerAlignUp(mapped, alignment);
+        if (address != mapped)
+        {
+            munmap(mapped, address - mapped);
+        }
+        if (address + byteSize != mapped + mapSize)
+        {
+            munmap(address + byteSize, (mapped + mapSize) - (address + byteSize));
+        }
+#   if defined(MADV_HUGEPAGE)
+        if (isTransparentHugePages)
+        {
+            madvise(address, byteSize, MADV_HUGEPAGE);
+        }
+#   endif
+        return address;
+    }
+
+    void UnmapPages(void* address, size_t byteSize)
+    {
+        int ret = munmap(address, byteSize);
+        (void)ret;
+        AZ_Assert(ret == 0, "Failed to free memory!");
+    }
+
+    void DiscardPages(void* address, size_t byteSize, bool isLazy)
+    {
+#   if defined(AZ_PLATFORM_APPLE)
+        (void)isLazy;
+        madvise(address, byteSize, MADV_FREE); // MADV_DONTNEED doesn't release the memory on Darwin
+#   else
+#       if defined(MADV_FREE)
+        // MADV_FREE is not supported by older kernels, fall back to MADV_DONTNEED
+        if (isLazy && madvise(address, byteSize, MADV_FREE) == 0)
+        {
+            return;
+        }
+#       else
+        (void)isLazy;
+#       endif
+        madvise(address, byteSize, MADV_DONTNEED);
+#   endif
+    }
+
+    size_t GetOSPageSize()
+    {
+        return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+#else
+    void* MapHugePages(size_t byteSize, OSPageSize pageSize)
+    {
+        (void)byteSize;
+        (void)pageSize;
+        return nullptr;
+    }
+
+    void* MapPages(size_t byteSize, size_t alignment, bool isTransparentHugePages)
+    {
+        (void)isTransparentHugePages;
+        return AZ_OS_MALLOC(byteSize, alignment);
+    }
+
+    void UnmapPages(void* address, size_t byteSize)
+    {
+        (void)byteSize;
+        AZ_OS_FREE(address);
+    }
+
+    void DiscardPages(void* address, size_t byteSize, bool isLazy)
+    {
+        (void)address;
+        (void)byteSize;
+        (void)isLazy;
+    }
+
+    size_t GetOSPageSize()
+    {
+        return 4 * 1024;
+    }
+#endif
+}
+
+//=========================================================================
+// ReservePages
+//=========================================================================
+void*
+OSAllocator::ReservePages(size_t byteSize, size_t alignment, OSPageSize pageSize, OSPageSize* usedPageSize)
+{
+    for (int hugePageSize = pageSize; hugePageSize != OS_PAGE_SIZE_DEFAULT; --hugePageSize)
+    {
+        // huge pages are only aligned to their size
+        if (alignment > GetPageSize(static_cast<OSPageSize>(hugePageSize)))
+        {
+            continue;
+        }
+        if (void* address = MapHugePages(byteSize, static_cast<OSPageSize>(hugePageSize)))
+        {
+            if (usedPageSize)
+            {
+                *usedPageSize = static_cast<OSPageSize>(hugePageSize);
+            }
+            return address;
+        }
+    }
+
+    if (usedPageSize)
+    {
+        *usedPageSize = OS_PAGE_SIZE_DEFAULT;
+    }
+    return MapPages(AZ::SizeAlignUp(byteSize, GetPageSize()), alignment, pageSize != OS_PAGE_SIZE_DEFAULT);
+}
+
+//=========================================================================
+// ReleasePages
+//=========================================================================
+void
+OSAllocator::ReleasePages(void* address, size_t byteSize)
+{
+    UnmapPages(address, AZ::SizeAlignUp(byteSize, GetPageSize()));
+}
+
+//=========================================================================
+// DecommitPages
+//=========================================================================
+void
+OSAllocator::DecommitPages(void* address, size_t byteSize, bool isLazy)
+{
+    size_t pageSize = GetPageSize();
+    char* start = AZ::PointerAlignUp(reinterpret_cast<char*>(address), pageSize);
+    char* end = AZ::PointerAlignDown(reinterpret_cast<char*>(address) + byteSize, pageSize);
+    if (start < end)
+    {
+        DiscardPages(start, end - start, isLazy);
+    }
+}
+
+//=========================================================================
+// GetPageSize
+//=========================================================================
+size_t
+OSAllocator::GetPageSize(OSPageSize pageSize)
+{
+    switch (pageSize)
+    {
+    case OS_PAGE_SIZE_2MB:
+        return 2 * 1024 * 1024;
+    case OS_PAGE_SIZE_1GB:
+        return 1024 * 1024 * 1024;
+    default:
+        break;
+    }
+    static const size_t osPageSize = GetOSPageSize();
+    return osPageSize;
+}
+
 #endif // #ifndef AZ_UNITY_BUILD
\ No newline at end of file
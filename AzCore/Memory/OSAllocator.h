@@ -13,6 +13,7 @@
 #define AZCORE_OS_ALLOCATOR_H
 
 #include <AzCore/Memory/Memory.h>
+#include <AzCore/Memory/OSPageSize.h>
 #include <AzCore/std/allocator.h>
 
 #if defined(AZ_PLATFORM_LINUX)
@@ -50,6 +51,23 @@ namespace AZ
 
         void Destroy();
 
+        /**
+         * Maps byteSize bytes of committed memory directly from the OS, aligned to alignment (and to the page size).
+         * If pages of pageSize are not available (not reserved by the OS, missing privileges, byteSize is not a multiple of
+         * the page size) we fall back to the next smaller size. With default pages we still ask for transparent huge pages
+         * when huge pages were requested. usedPageSize returns what we got, free the memory with \ref ReleasePages.
+         */
+        static void*    ReservePages(size_t byteSize, size_t alignment, OSPageSize pageSize = OS_PAGE_SIZE_DEFAULT, OSPageSize* usedPageSize = nullptr);
+        static void     ReleasePages(void* address, size_t byteSize);
+        /**
+         * Returns the physical memory of the pages in the range to the OS, the range stays mapped and usable but its content is lost.
+         * By default the memory is released immediately (MADV_DONTNEED), lazy release lets the OS reclaim it only when it needs
+         * memory (MADV_FREE) which is cheaper if the range is reused soon. Partial pages at the range ends are not touched.
+         */
+        static void     DecommitPages(void* address, size_t byteSize, bool isLazy = false);
+        /// Returns the size of a page in bytes.
+        static size_t   GetPageSize(OSPageSize pageSize = OS_PAGE_SIZE_DEFAULT);
+
         //////////////////////////////////////////////////////////////////////////
         // IAllocator
         virtual const char*     GetName() const                 { return "OSAllocator"; }
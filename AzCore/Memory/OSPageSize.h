@@ -0,0 +1,28 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZCORE_OS_PAGE_SIZE_H
+#define AZCORE_OS_PAGE_SIZE_H
+
+namespace AZ
+{
+    /// Page sizes for \ref OSAllocator::ReservePages. Huge pages cut the TLB misses on large heaps.
+    /// Kept out of OSAllocator.h so the schema descriptors can use it without pulling in the OS headers.
+    enum OSPageSize
+    {
+        OS_PAGE_SIZE_DEFAULT,   ///< OS page size (usually 4KB)
+        OS_PAGE_SIZE_2MB,       ///< 2MB huge/large pages
+        OS_PAGE_SIZE_1GB,       ///< 1GB huge pages
+    };
+}
+
+#endif // AZCORE_OS_PAGE_SIZE_H
+#pragma once
@@ -14,6 +14,8 @@
 
 #include <AzCore/Memory/SystemAllocator.h>
 #include <AzCore/Memory/PoolSchema.h>
+#include <AzCore/Memory/SlabSchema.h>
+#include <AzCore/Memory/AllocationSampler.h>
 
 namespace AZ
 {
@@ -30,6 +32,10 @@ namespace AZ
             : public IAllocator
         {
         public:
+            PoolAllocatorHelper()
+                : m_maxAllocationSize(0)
+            {}
+
             struct Descriptor
                 : public Schema::Descriptor
             {
@@ -70,6 +76,7 @@ namespace AZ
                 {
                     desc.m_maxAllocationSize = desc.m_minAllocationSize;
                 }
+                m_maxAllocationSize = desc.m_maxAllocationSize;
 
 #ifdef AZCORE_ENABLE_MEMORY_TRACKING
                 if (desc.m_allocationRecords && desc.m_isMemoryGuards)
@@ -131,8 +138,15 @@ namespace AZ
                 (void)name;
                 (void)fileName;
                 (void)lineNum;
-                (void)suppressStackRecord;
 #endif
+                if (m_statistics.OnAllocation(byteSize))
+                {
+                    m_statistics.UpdatePeak(m_schema.NumAllocatedBytes());
+                }
+                if (m_sampler)
+                {
+                    m_sampler->OnAllocation(address, byteSize, suppressStackRecord + 1);
+                }
                 return address;
             }
 
@@ -150,24 +164,48 @@ namespace AZ
 #endif
                 (void)byteSize;
                 (void)alignment;
+                if (ptr)
+                {
+                    m_statistics.OnDeAllocation();
+                    if (m_sampler)
+                    {
+                        m_sampler->OnDeAllocation(ptr);
+                    }
+                }
                 m_schema.DeAllocate(ptr);
             }
 
             pointer_type ReAllocate(pointer_type ptr, size_type newSize, size_type newAlignment) override
             {
-                (void)ptr;
-                (void)newSize;
-                (void)newAlignment;
-                AZ_Assert(false, "Not supported!");
-                return nullptr;
+                if (ptr == nullptr)
+                {
+                    return Allocate(newSize, newAlignment);
+                }
+                if (newSize == 0)
+                {
+                    DeAllocate(ptr);
+                    return nullptr;
+                }
+                // stay in the node when the new size still fits
+                size_type nodeSize = m_schema.AllocationSize(ptr);
+                if (newSize <= nodeSize && (newAlignment <= 1 || (reinterpret_cast<size_t>(ptr) & (newAlignment - 1)) == 0))
+                {
+                    return ptr;
+                }
+                pointer_type newPtr = Allocate(newSize, newAlignment);
+                if (newPtr)
+                {
+                    memcpy(newPtr, ptr, AZ::GetMin(nodeSize, newSize));
+                    DeAllocate(ptr);
+                }
+                return newPtr;
             }
 
             size_type Resize(pointer_type ptr, size_type newSize) override
             {
-                (void)ptr;
                 (void)newSize;
-                // \todo return the node size
-                return 0;
+                // nodes can't grow or shrink, but the whole node is usable
+                return ptr ? m_schema.AllocationSize(ptr) : 0;
             }
 
             size_type AllocationSize(pointer_type ptr) override
@@ -193,6 +231,11 @@ namespace AZ
                 return m_schema.Capacity();
             }
 
+            size_type GetMaxAllocationSize() const override
+            {
+                return m_maxAllocationSize;
+            }
+
             void GarbageCollect() override
             {
                 m_schema.GarbageCollect();
@@ -207,6 +250,7 @@ namespace AZ
         protected:
             PoolAllocatorHelper& operator=(const PoolAllocatorHelper&);
             Schema m_schema;
+            size_type m_maxAllocationSize; ///< Biggest allocation the pools can serve, not including memory guards
         };
     }
 
@@ -236,6 +280,94 @@ namespace AZ
         }
     };
 
+    /*!
+     * Slab allocator
+     * Small object allocator with geometric size classes, it wastes less memory than the PoolAllocator for
+     * mixed sizes and supports bigger allocations (up to a quarter of the slab size). It also allows to allocate
+     * and free many objects at once.
+     * Slab Allocator is NOT thread safe, do the sync yourself.
+     */
+    class SlabAllocator
+        : public Internal::PoolAllocatorHelper<SlabSchema>
+    {
+    public:
+        AZ_CLASS_ALLOCATOR(SlabAllocator, SystemAllocator, 0)
+        AZ_TYPE_INFO(SlabAllocator, "{6A5E1C2B-0F37-4E8D-9B14-2C8D7F5A3E61}")
+
+        /// Allocates count blocks of byteSize into ptrs, returns the number of blocks allocated. The blocks are counted
+        /// in the statistics, with allocation records or a sampler this falls back to allocating one block at a time.
+        size_type AllocateBulk(size_type byteSize, size_type alignment, pointer_type* ptrs, size_type count)
+        {
+            if (IsTrackingAllocations() || m_sampler)
+            {
+                size_type numAllocated = 0;
+                for (; numAllocated < count; ++numAllocated)
+                {
+                    ptrs[numAllocated] = Allocate(byteSize, alignment, 0, "AZSystem::SlabAllocator::AllocateBulk", __FILE__, __LINE__, 1);
+                    if (ptrs[numAllocated] == nullptr)
+                    {
+                        break;
+                    }
+                }
+                return numAllocated;
+            }
+            size_type numAllocated = m_schema.AllocateBulk(byteSize, alignment, ptrs, count);
+            if (numAllocated && m_statistics.OnAllocations(byteSize, numAllocated))
+            {
+                m_statistics.UpdatePeak(m_schema.NumAllocatedBytes());
+            }
+            return numAllocated;
+        }
+
+        /// Frees count blocks from ptrs.
+        void DeAllocateBulk(pointer_type* ptrs, size_type count)
+        {
+            if (IsTrackingAllocations() || m_sampler)
+            {
+                for (size_type i = 0; i < count; ++i)
+                {
+                    DeAllocate(ptrs[i]);
+                }
+                return;
+            }
+            size_type numFreed = 0;
+            for (size_type i = 0; i < count; ++i)
+            {
+                numFreed += ptrs[i] != nullptr;
+            }
+            if (numFreed)
+            {
+                m_statistics.OnDeAllocations(numFreed);
+            }
+            m_schema.DeAllocateBulk(ptrs, count);
+        }
+
+        //////////////////////////////////////////////////////////////////////////
+        // IAllocator
+        const char* GetName() const override
+        {
+            return "SlabAllocator";
+        }
+        const char* GetDescription() const override
+        {
+            return "Slab allocator for small objects with geometric size classes";
+        }
+        //////////////////////////////////////////////////////////////////////////
+
+    protected:
+        /// Allocations must go one by one through Allocate/DeAllocate when they are recorded or sampled.
+        bool IsTrackingAllocations() const
+        {
+#ifdef AZCORE_ENABLE_MEMORY_TRACKING
+            if (m_records)
+            {
+                return true;
+            }
+#endif // AZCORE_ENABLE_MEMORY_TRACKING
+            return m_sampler != nullptr;
+        }
+    };
+
     template<class Allocator>
     using ThreadPoolBase = Internal::PoolAllocatorHelper<ThreadPoolSchemaHelper<Allocator> >;
 
@@ -261,6 +393,11 @@ namespace AZ
         {
             return "Generic thread safe pool allocator for small objects";
         }
+
+        size_type GetLockContentionCount() const override
+        {
+            return m_schema.GetLockContentionCount();
+        }
         //////////////////////////////////////////////////////////////////////////
     };
 }
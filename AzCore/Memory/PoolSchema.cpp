@@ -13,6 +13,7 @@
 
 #include <AzCore/PlatformIncl.h>
 #include <AzCore/Memory/PoolSchema.h>
+#include <AzCore/Memory/AllocatorStatistics.h>
 
 #include <AzCore/std/containers/vector.h>
 #include <AzCore/std/containers/intrusive_slist.h>
@@ -20,11 +21,17 @@
 #include <AzCore/std/parallel/mutex.h>
 #include <AzCore/std/parallel/lock.h>
 #include <AzCore/std/parallel/thread.h>
+#include <AzCore/std/parallel/atomic.h>
 
 #include <AzCore/Math/MathUtils.h>
 
 #ifdef AZ_THREAD_LOCAL
 #   include <AzCore/std/parallel/containers/lock_free_intrusive_stamped_stack.h>
+#   if defined(AZ_PLATFORM_LINUX) || defined(AZ_PLATFORM_ANDROID) || defined(AZ_PLATFORM_APPLE)
+#       include <AzCore/std/parallel/spin_mutex.h>
+#       include <pthread.h>
+#       define AZ_THREADPOOL_EXIT_HOOK // pending remote frees are sent when their thread exits, otherwise only on GarbageCollect
+#   endif
 #endif
 
 namespace AZ
@@ -194,9 +201,11 @@ namespace AZ
             struct FakeNode
                 : public AZStd::intrusive_slist_node<FakeNode>
             {};
-            // Fake Lock Free node used when we delete an element from another thread.
-            struct FakeNodeLF
-                : public AZStd::lock_free_intrusive_stack_node<FakeNodeLF>{};
+            // Fake node used to chain the elements freed from another thread.
+            struct RemoteFreeNode
+            {
+                RemoteFreeNode* m_next;
+            };
 
             void SetupFreeList(size_t elementSize, size_t pageDataBlockSize);
 
@@ -230,6 +239,10 @@ namespace AZ
         ThreadPoolSchema::pointer_type  Allocate(ThreadPoolSchema::size_type byteSize, ThreadPoolSchema::size_type alignment, int flags = 0);
         void                            DeAllocate(ThreadPoolSchema::pointer_type ptr);
         ThreadPoolSchema::size_type     AllocationSize(ThreadPoolSchema::pointer_type ptr);
+#   ifdef AZ_THREAD_LOCAL
+        /// Returns the calling thread data, creates it if needed.
+        ThreadPoolData*                 GetThreadData();
+#   endif
         /// Return unused memory to the OS. Don't call this too often because you will force unnecessary allocations.
         void            GarbageCollect();
         //////////////////////////////////////////////////////////////////////////
@@ -331,11 +344,20 @@ namespace AZ
         size_t                      m_minAllocationSize;
         size_t                      m_maxAllocationSize;
         bool                        m_isDynamic;
+    #       ifdef AZ_THREADPOOL_EXIT_HOOK
+        /// Thread exit hook, sends the remote frees the thread still holds to their owners.
+        static void                 ThreadExit(void* schema);
+        pthread_key_t               m_exitKey;          ///< Its destructor is the exit hook, the value is the schema.
+        ThreadPoolSchemaImpl*       m_nextLive;
+        static AZStd::spin_mutex    s_liveMutex;        ///< Protects the live list, exit hooks only touch live schemas.
+        static ThreadPoolSchemaImpl* s_liveSchemas;
+    #       endif
     #   else
         PoolSchemaImpl              m_allocator;
     #   endif
         // TODO rbbaklov Changed to recursive_mutex from mutex for Linux support.
         AZStd::recursive_mutex      m_mutex;
+        AZStd::atomic<size_t>       m_lockContention;   ///< Number of times we had to wait for m_mutex.
     };
 
 #ifdef AZ_THREAD_LOCAL
@@ -347,14 +369,40 @@ namespace AZ
         ~ThreadPoolData();
 
         typedef PoolAllocation<ThreadPoolSchemaImpl>  AllocatorType;
+        typedef ThreadPoolSchemaImpl::Page::RemoteFreeNode RemoteFreeNode;
+
         /**
-        * Stack with freed elements from other threads. We don't need stamped stack since the ABA problem can not
-        * happen here. We push from many threads and pop from only one (we don't push from it).
-        */
-        typedef AZStd::lock_free_intrusive_stack<ThreadPoolSchemaImpl::Page::FakeNodeLF, AZStd::lock_free_intrusive_stack_base_hook<ThreadPoolSchemaImpl::Page::FakeNodeLF> > FreedElementsStack;
+         * Elements we freed which belong to another thread (owner) pages. They are chained locally and sent to the
+         * owner in one go, so we touch the owner cache line once per batch instead of once per element.
+         */
+        struct RemoteFreeBatch
+        {
+            ThreadPoolData* m_owner;
+            RemoteFreeNode* m_first;
+            RemoteFreeNode* m_last;
+            unsigned int    m_numElements;
+        };
+
+        static const unsigned int NumRemoteFreeBatches = 8;     ///< Number of owners we batch for at the same time.
+        static const unsigned int RemoteFreeBatchSize = 32;     ///< Number of elements we send to the owner at once.
+
+        /// Adds an element of the owner pages to the outgoing batches.
+        void PushRemoteFree(ThreadPoolData* owner, void* ptr);
+        /// Sends a batch to the owner inbox.
+        static void FlushRemoteFrees(RemoteFreeBatch& batch);
+        /// Sends all outgoing batches.
+        void FlushAllRemoteFrees();
+        /// Frees all elements other threads sent to our inbox. Must be called from the owner thread.
+        void ReclaimRemoteFrees();
 
         AllocatorType           m_allocator;
-        FreedElementsStack      m_freedElements;
+        RemoteFreeBatch         m_remoteFreeBatches[NumRemoteFreeBatches];
+        unsigned int            m_nextRemoteFreeBatch;  ///< Batch we flush when we need a new owner and all are in use.
+        /**
+        * Inbox with freed elements from other threads, on its own cache line. We don't need a stamped stack since
+        * the ABA problem can not happen here. Many threads push chains and the owner takes them all at once.
+        */
+        AZ_ALIGN(AZStd::atomic<RemoteFreeNode*> m_remoteFreed, 64);
     };
 #endif
 }
@@ -1019,7 +1067,7 @@ ThreadPoolSchema::NumAllocatedBytes() const
 {
     size_type bytesAllocated = 0;
     {
-        AZStd::lock_guard<AZStd::recursive_mutex> lock(m_impl->m_mutex);
+        ContentionLockGuard<AZStd::recursive_mutex> lock(m_impl->m_mutex, m_impl->m_lockContention);
 #ifdef AZ_THREAD_LOCAL
         for (size_t i = 0; i < m_impl->m_threads.size(); ++i)
         {
@@ -1046,6 +1094,15 @@ ThreadPoolSchema::Capacity() const
 #endif
 }
 
+//=========================================================================
+// GetLockContentionCount
+//=========================================================================
+ThreadPoolSchema::size_type
+ThreadPoolSchema::GetLockContentionCount() const
+{
+    return m_impl->m_lockContention.load(AZStd::memory_order_relaxed);
+}
+
 //=========================================================================
 // GetPageAllocator
 // [11/17/2010]
@@ -1079,6 +1136,7 @@ ThreadPoolSchemaImpl::ThreadPoolSchemaImpl(const ThreadPoolSchema::Descriptor& d
 #else
     : m_allocator(desc)
 #endif
+    , m_lockContention(0)
 {
 #   if defined(AZ_PLATFORM_WINDOWS) || defined(AZ_PLATFORM_X360) || defined(AZ_PLATFORM_XBONE) // ACCEPTED_USE
     // In memory allocation case (usually tools) we might have high contention,
@@ -1105,6 +1163,14 @@ ThreadPoolSchemaImpl::ThreadPoolSchemaImpl(const ThreadPoolSchema::Descriptor& d
             memBlock += m_pageSize;
         }
     }
+#   ifdef AZ_THREADPOOL_EXIT_HOOK
+    pthread_key_create(&m_exitKey, &ThreadPoolSchemaImpl::ThreadExit);
+    {
+        AZStd::lock_guard<AZStd::spin_mutex> lock(s_liveMutex);
+        m_nextLive = s_liveSchemas;
+        s_liveSchemas = this;
+    }
+#   endif
 #endif // AZ_THREAD_LOCAL
 }
 
@@ -1115,14 +1181,36 @@ ThreadPoolSchemaImpl::ThreadPoolSchemaImpl(const ThreadPoolSchema::Descriptor& d
 ThreadPoolSchemaImpl::~ThreadPoolSchemaImpl()
 {
 #ifdef AZ_THREAD_LOCAL
+#   ifdef AZ_THREADPOOL_EXIT_HOOK
+    {
+        // threads exiting from now on don't call the hook, the ones exiting right now check the live list
+        AZStd::lock_guard<AZStd::spin_mutex> lock(s_liveMutex);
+        ThreadPoolSchemaImpl** link = &s_liveSchemas;
+        while (*link != this)
+        {
+            link = &(*link)->m_nextLive;
+        }
+        *link = m_nextLive;
+        pthread_key_delete(m_exitKey);
+    }
+#   endif
     // clean up all the thread data.
     // IMPORTANT: We assume/rely that all threads (except the calling one) are or will
     // destroyed before you create another instance of the pool allocation.
     // This should generally be ok since the all allocators are singletons.
     {
-        AZStd::lock_guard<AZStd::recursive_mutex> lock(m_mutex);
+        ContentionLockGuard<AZStd::recursive_mutex> lock(m_mutex, m_lockContention);
         if (!m_threads.empty())
         {
+            // send all pending elements to their owners before we free them
+            for (size_t i = 0; i < m_threads.size(); ++i)
+            {
+                if (m_threads[i])
+                {
+                    m_threads[i]->FlushAllRemoteFrees();
+                }
+            }
+
             for (size_t i = 0; i < m_threads.size(); ++i)
             {
                 if (m_threads[i])
@@ -1150,7 +1238,7 @@ ThreadPoolSchemaImpl::~ThreadPoolSchemaImpl()
         }
 #   else
         {
-            AZStd::lock_guard<AZStd::recursive_mutex> lock(m_mutex);
+            ContentionLockGuard<AZStd::recursive_mutex> lock(m_mutex, m_lockContention);
             while (!m_freePages.empty())
             {
                 page = &m_freePages.front();
@@ -1185,30 +1273,13 @@ ThreadPoolSchemaImpl::Allocate(ThreadPoolSchema::size_type byteSize, ThreadPoolS
 #ifdef AZ_THREAD_LOCAL
     (void)flags;
 
-    ThreadPoolData* threadData = m_threadPoolGetter();
-
-    if (threadData == nullptr)
-    {
-        threadData = aznew ThreadPoolData(this, m_pageSize, m_minAllocationSize, m_maxAllocationSize);
-        m_threadPoolSetter(threadData);
-        {
-            AZStd::lock_guard<AZStd::recursive_mutex> lock(m_mutex);
-            m_threads.push_back(threadData);
-        }
-    }
-    else
-    {
-        // deallocate elements if they were freed from other threads
-        Page::FakeNodeLF* fakeLFNode;
-        while ((fakeLFNode = threadData->m_freedElements.pop())!=0)
-        {
-            threadData->m_allocator.DeAllocate(fakeLFNode);
-        }
-    }
+    ThreadPoolData* threadData = GetThreadData();
+    // deallocate elements if they were freed from other threads
+    threadData->ReclaimRemoteFrees();
 
     return threadData->m_allocator.Allocate(byteSize, alignment);
 #else
-    AZStd::lock_guard<AZStd::recursive_mutex> lock(m_mutex);
+    ContentionLockGuard<AZStd::recursive_mutex> lock(m_mutex, m_lockContention);
     return m_allocator.Allocate(byteSize, alignment, flags);
 #endif
 }
@@ -1228,7 +1299,7 @@ ThreadPoolSchemaImpl::DeAllocate(ThreadPoolSchema::pointer_type ptr)
         return;
     }
     AZ_Assert(page->m_threadData!=0, ("We must have valid page thread data for the page!"));
-    ThreadPoolData* threadData = m_threadPoolGetter();
+    ThreadPoolData* threadData = GetThreadData();
     if (threadData == page->m_threadData)
     {
         // we can free here
@@ -1236,22 +1307,67 @@ ThreadPoolSchemaImpl::DeAllocate(ThreadPoolSchema::pointer_type ptr)
     }
     else
     {
-        // push this element to be deleted from it's own thread!
-        // cast the pointer to a fake lock free node
-        Page::FakeNodeLF*   fakeLFNode = reinterpret_cast<Page::FakeNodeLF*>(ptr);
-#ifdef AZ_DEBUG_BUILD
-        // we need to reset the fakeLFNode because we share the memory.
-        // otherwise we will assert the node is in the list
-        fakeLFNode->m_next = 0;
-#endif
-        page->m_threadData->m_freedElements.push(*fakeLFNode);
+        // batch this element to be deleted from it's own thread!
+        threadData->PushRemoteFree(page->m_threadData, ptr);
     }
 #else
-    AZStd::lock_guard<AZStd::recursive_mutex> lock(m_mutex);
+    ContentionLockGuard<AZStd::recursive_mutex> lock(m_mutex, m_lockContention);
     m_allocator.DeAllocate(ptr);
 #endif
 }
 
+#ifdef AZ_THREAD_LOCAL
+//=========================================================================
+// GetThreadData
+//=========================================================================
+inline ThreadPoolData*
+ThreadPoolSchemaImpl::GetThreadData()
+{
+    ThreadPoolData* threadData = m_threadPoolGetter();
+    if (threadData == nullptr)
+    {
+        threadData = aznew ThreadPoolData(this, m_pageSize, m_minAllocationSize, m_maxAllocationSize);
+        m_threadPoolSetter(threadData);
+#   ifdef AZ_THREADPOOL_EXIT_HOOK
+        pthread_setspecific(m_exitKey, this);
+#   endif
+        {
+            ContentionLockGuard<AZStd::recursive_mutex> lock(m_mutex, m_lockContention);
+            m_threads.push_back(threadData);
+        }
+    }
+    return threadData;
+}
+
+#   ifdef AZ_THREADPOOL_EXIT_HOOK
+AZStd::spin_mutex ThreadPoolSchemaImpl::s_liveMutex;
+ThreadPoolSchemaImpl* ThreadPoolSchemaImpl::s_liveSchemas = nullptr;
+
+//=========================================================================
+// ThreadExit
+//=========================================================================
+void
+ThreadPoolSchemaImpl::ThreadExit(void* schema)
+{
+    // a thread which freed a few elements of other threads and exits would keep them forever, nobody else can send
+    // its batches. The thread local storage is still valid while the key destructors run.
+    AZStd::lock_guard<AZStd::spin_mutex> lock(s_liveMutex);
+    for (ThreadPoolSchemaImpl* live = s_liveSchemas; live; live = live->m_nextLive)
+    {
+        if (live == schema)
+        {
+            if (ThreadPoolData* threadData = live->m_threadPoolGetter())
+            {
+                threadData->FlushAllRemoteFrees();
+                threadData->ReclaimRemoteFrees();
+            }
+            break;
+        }
+    }
+}
+#   endif // AZ_THREADPOOL_EXIT_HOOK
+#endif // AZ_THREAD_LOCAL
+
 //=========================================================================
 // AllocationSize
 // [11/22/2010]
@@ -1268,7 +1384,7 @@ ThreadPoolSchemaImpl::AllocationSize(ThreadPoolSchema::pointer_type ptr)
     AZ_Assert(page->m_threadData!=0, ("We must have valid page thread data for the page!"));
     return page->m_threadData->m_allocator.AllocationSize(ptr);
 #else
-    AZStd::lock_guard<AZStd::recursive_mutex> lock(m_mutex);
+    ContentionLockGuard<AZStd::recursive_mutex> lock(m_mutex, m_lockContention);
     return m_allocator.AllocationSize(ptr);
 #endif
 }
@@ -1286,7 +1402,7 @@ ThreadPoolSchemaImpl::PopFreePage()
     page = m_freePages.pop();
 #   else
     {
-        AZStd::lock_guard<AZStd::recursive_mutex> lock(m_mutex);
+        ContentionLockGuard<AZStd::recursive_mutex> lock(m_mutex, m_lockContention);
         if (m_freePages.empty())
         {
             page = NULL;
@@ -1328,7 +1444,7 @@ ThreadPoolSchemaImpl::PushFreePage(Page* page)
     m_freePages.push(*page);
 #   else
     {
-        AZStd::lock_guard<AZStd::recursive_mutex> lock(m_mutex);
+        ContentionLockGuard<AZStd::recursive_mutex> lock(m_mutex, m_lockContention);
         m_freePages.push_front(*page);
     }
 #   endif // AZ_THREADPOOL_USE_STAMPED_STACK
@@ -1346,6 +1462,13 @@ void
 ThreadPoolSchemaImpl::GarbageCollect()
 {
 #ifdef AZ_THREAD_LOCAL
+    // send our pending elements to their owners and take back the ones freed from other threads
+    if (ThreadPoolData* threadData = m_threadPoolGetter())
+    {
+        threadData->FlushAllRemoteFrees();
+        threadData->ReclaimRemoteFrees();
+    }
+
     if (!m_isDynamic)
     {
         return;                // we have the memory statically allocated, can't collect garbage.
@@ -1371,7 +1494,7 @@ ThreadPoolSchemaImpl::GarbageCollect()
 #   else
     {
         FreePagesType staticPages;
-        AZStd::lock_guard<AZStd::recursive_mutex> lock(m_mutex);
+        ContentionLockGuard<AZStd::recursive_mutex> lock(m_mutex, m_lockContention);
         while (!m_freePages.empty())
         {
             Page* page = &m_freePages.front();
@@ -1395,7 +1518,7 @@ ThreadPoolSchemaImpl::GarbageCollect()
 #   endif // AZ_THREADPOOL_USE_STAMPED_STACK
 
 #else
-    AZStd::lock_guard<AZStd::recursive_mutex> lock(m_mutex);
+    ContentionLockGuard<AZStd::recursive_mutex> lock(m_mutex, m_lockContention);
     m_allocator.GarbageCollect();
 #endif
 }
@@ -1426,7 +1549,17 @@ ThreadPoolSchemaImpl::Page::SetupFreeList(size_t elementSize, size_t pageDataBlo
 //=========================================================================
 ThreadPoolData::ThreadPoolData(ThreadPoolSchemaImpl* alloc, size_t pageSize, size_t minAllocationSize, size_t maxAllocationSize)
     : m_allocator(alloc, pageSize, minAllocationSize, maxAllocationSize)
-{}
+    , m_nextRemoteFreeBatch(0)
+    , m_remoteFreed(nullptr)
+{
+    for (unsigned int i = 0; i < NumRemoteFreeBatches; ++i)
+    {
+        m_remoteFreeBatches[i].m_owner = nullptr;
+        m_remoteFreeBatches[i].m_first = nullptr;
+        m_remoteFreeBatches[i].m_last = nullptr;
+        m_remoteFreeBatches[i].m_numElements = 0;
+    }
+}
 
 //=========================================================================
 // ThreadPoolData::~ThreadPoolData
@@ -1434,11 +1567,111 @@ ThreadPoolData::ThreadPoolData(ThreadPoolSchemaImpl* alloc, size_t pageSize, siz
 //=========================================================================
 ThreadPoolData::~ThreadPoolData()
 {
+#ifdef AZ_DEBUG_BUILD
+    for (unsigned int i = 0; i < NumRemoteFreeBatches; ++i)
+    {
+        AZ_Assert(m_remoteFreeBatches[i].m_numElements == 0, "All remote frees should be flushed before we destroy the thread data!");
+    }
+#endif
     // deallocate elements if they were freed from other threads
-    ThreadPoolSchemaImpl::Page::FakeNodeLF* fakeLFNode;
-    while ((fakeLFNode = m_freedElements.pop())!=0)
+    ReclaimRemoteFrees();
+}
+
+//=========================================================================
+// ThreadPoolData::PushRemoteFree
+//=========================================================================
+inline void
+ThreadPoolData::PushRemoteFree(ThreadPoolData* owner, void* ptr)
+{
+    RemoteFreeNode* node = reinterpret_cast<RemoteFreeNode*>(ptr);
+    RemoteFreeBatch* batch = nullptr;
+    RemoteFreeBatch* freeBatch = nullptr;
+    for (unsigned int i = 0; i < NumRemoteFreeBatches; ++i)
+    {
+        if (m_remoteFreeBatches[i].m_owner == owner)
+        {
+            batch = &m_remoteFreeBatches[i];
+            break;
+        }
+        if (freeBatch == nullptr && m_remoteFreeBatches[i].m_owner == nullptr)
+        {
+            freeBatch = &m_remoteFreeBatches[i];
+        }
+    }
+
+    if (batch == nullptr)
+    {
+        batch = freeBatch;
+        if (batch == nullptr)
+        {
+            // all batches are in use, send one of them now
+            batch = &m_remoteFreeBatches[m_nextRemoteFreeBatch];
+            m_nextRemoteFreeBatch = (m_nextRemoteFreeBatch + 1) % NumRemoteFreeBatches;
+            FlushRemoteFrees(*batch);
+        }
+        batch->m_owner = owner;
+        batch->m_last = node;
+    }
+
+    node->m_next = batch->m_first;
+    batch->m_first = node;
+    if (++batch->m_numElements == RemoteFreeBatchSize)
+    {
+        FlushRemoteFrees(*batch);
+    }
+}
+
+//=========================================================================
+// ThreadPoolData::FlushRemoteFrees
+//=========================================================================
+void
+ThreadPoolData::FlushRemoteFrees(RemoteFreeBatch& batch)
+{
+    if (batch.m_numElements)
+    {
+        // push the whole chain in one go
+        AZStd::atomic<RemoteFreeNode*>& inbox = batch.m_owner->m_remoteFreed;
+        RemoteFreeNode* head = inbox.load(AZStd::memory_order_relaxed);
+        do
+        {
+            batch.m_last->m_next = head;
+        } while (!inbox.compare_exchange_weak(head, batch.m_first, AZStd::memory_order_release, AZStd::memory_order_relaxed));
+    }
+    batch.m_owner = nullptr;
+    batch.m_first = nullptr;
+    batch.m_last = nullptr;
+    batch.m_numElements = 0;
+}
+
+//=========================================================================
+// ThreadPoolData::FlushAllRemoteFrees
+//=========================================================================
+void
+ThreadPoolData::FlushAllRemoteFrees()
+{
+    for (unsigned int i = 0; i < NumRemoteFreeBatches; ++i)
+    {
+        FlushRemoteFrees(m_remoteFreeBatches[i]);
+    }
+}
+
+//=========================================================================
+// ThreadPoolData::ReclaimRemoteFrees
+//=========================================================================
+inline void
+ThreadPoolData::ReclaimRemoteFrees()
+{
+    // read first, so we don't steal the cache line from the other threads when there is nothing to do
+    if (m_remoteFreed.load(AZStd::memory_order_relaxed) == nullptr)
+    {
+        return;
+    }
+    RemoteFreeNode* node = m_remoteFreed.exchange(nullptr, AZStd::memory_order_acquire);
+    while (node)
     {
-        m_allocator.DeAllocate(fakeLFNode);
+        RemoteFreeNode* next = node->m_next;
+        m_allocator.DeAllocate(node);
+        node = next;
     }
 }
 #endif //  AZ_THREAD_LOCAL
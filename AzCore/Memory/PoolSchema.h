@@ -92,6 +92,8 @@ namespace AZ
         * Thread safe pool allocator. For pool details \ref PoolSchema.
         * IMPORTNAT: Keep in mind the thread pool allocator will create separate pools,
         * for each thread. So there will be some memory overhead, especially if you use fixed pool sizes.
+        * Memory freed from a thread that doesn't own it is batched and handed to the owner thread, which reuses it
+        * on its next allocation. Pending batches are flushed when full or on GarbageCollect (for the calling thread).
         */
     class ThreadPoolSchema
     {
@@ -123,6 +125,8 @@ namespace AZ
 
         size_type       NumAllocatedBytes() const;
         size_type       Capacity() const;
+        /// Number of times a thread had to wait for the shared page lock.
+        size_type       GetLockContentionCount() const;
         IAllocatorAllocate* GetPageAllocator();
 
     protected:
@@ -0,0 +1,648 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZ_UNITY_BUILD
+
+#include <AzCore/Memory/SlabSchema.h>
+#include <AzCore/Math/MathUtils.h>
+
+namespace AZ
+{
+    /**
+     * SlabSchema Implementation... to keep the header clean.
+     */
+    class SlabSchemaImpl
+    {
+    public:
+        AZ_CLASS_ALLOCATOR(SlabSchemaImpl, SystemAllocator, 0)
+
+        /**
+         * Slab header, located at the start of the slab followed by the free bitmap. The objects are
+         * stored backwards from the slab end (which is slab size aligned) so they are naturally aligned.
+         */
+        struct Slab
+        {
+            Slab*   m_next;
+            Slab*   m_prev;
+            u32     m_classIndex;
+            u32     m_numObjects;
+            u32     m_numFree;
+            u32     m_firstFreeWord;    ///< All bitmap words before it are 0.
+            u64     m_freeBits[1];      ///< One bit per object, set when the object is free.
+        };
+
+        /**
+         * Slabs of a size class, the ones with free objects are at the front of the list and the full ones at the back.
+         */
+        struct SizeClass
+        {
+            Slab*   m_first;
+            Slab*   m_last;
+            u32     m_size;
+            u32     m_numObjects;
+            u32     m_numWords;
+            u64     m_reciprocal;       ///< 2^40 / m_size rounded up, to find the object index without a division
+        };
+
+        static const size_t SlabHeaderSize = offsetof(Slab, m_freeBits);
+        static const unsigned int NumLinearClasses = 10;    // 8, 16, 24, 32, 48, 64, 80, 96, 112, 128
+        static const unsigned int MaxNumClasses = NumLinearClasses + 4 * 24;
+        static const unsigned int ReciprocalShift = 40;
+
+        SlabSchemaImpl(const SlabSchema::Descriptor& desc);
+        ~SlabSchemaImpl();
+
+        AZ_FORCE_INLINE unsigned int SizeToClass(size_t byteSize) const
+        {
+            if (byteSize <= 128)
+            {
+                return m_smallClasses[(byteSize + 7) >> 3];
+            }
+            unsigned int shift = FloorLog2(byteSize - 1);
+            return NumLinearClasses + (shift - 7) * 4 + static_cast<unsigned int>(((byteSize - 1) >> (shift - 2)) & 3);
+        }
+
+        AZ_FORCE_INLINE Slab* SlabFromAddress(void* address) const
+        {
+            return reinterpret_cast<Slab*>(reinterpret_cast<size_t>(address) & ~(m_slabSize - 1));
+        }
+
+        AZ_FORCE_INLINE char* SlabEnd(Slab* slab) const
+        {
+            return reinterpret_cast<char*>(slab) + m_slabSize;
+        }
+
+        unsigned int    AlignedClass(size_t byteSize, size_t alignment) const;
+        void*           Allocate(size_t byteSize, size_t alignment);
+        void            DeAllocate(void* ptr);
+        size_t          AllocationSize(void* ptr);
+        size_t          AllocateBulk(size_t byteSize, size_t alignment, void** ptrs, size_t count);
+        void            GarbageCollect();
+
+        Slab*           AcquireSlab(unsigned int classIndex);
+        void            ReleaseSlab(Slab* slab);
+        void            OnSlabFull(Slab* slab);
+        void            LinkFront(SizeClass& sizeClass, Slab* slab);
+        void            LinkBack(SizeClass& sizeClass, Slab* slab);
+        void            Unlink(SizeClass& sizeClass, Slab* slab);
+
+        IAllocatorAllocate*     m_pageAllocator;
+        size_t                  m_slabSize;
+        unsigned int            m_numClasses;
+        SizeClass               m_classes[MaxNumClasses];
+        unsigned char           m_smallClasses[128 / 8 + 1];
+        Slab*                   m_freeSlabs;        ///< Empty slabs ready to be used by any class, linked with m_next.
+        size_t                  m_numSlabs;
+        size_t                  m_numBytesAllocated;
+    };
+}
+
+using namespace AZ;
+
+//=========================================================================
+// SlabSchemaImpl
+//=========================================================================
+SlabSchemaImpl::SlabSchemaImpl(const SlabSchema::Descriptor& desc)
+    : m_pageAllocator(desc.m_pageAllocator)
+    , m_slabSize(desc.m_slabSize)
+    , m_freeSlabs(nullptr)
+    , m_numSlabs(0)
+    , m_numBytesAllocated(0)
+{
+    AZ_Assert((m_slabSize & (m_slabSize - 1)) == 0 && m_slabSize >= 4 * 1024, "Slab size must be a power of 2 (and at least 4KB)!");
+    AZ_Assert(m_slabSize <= (static_cast<size_t>(1) << (ReciprocalShift - 16)), "Slab size is too big, the object index would overflow!");
+    AZ_Assert(desc.m_maxAllocationSize <= m_slabSize / 4, "Max allocation size must be at most a quarter of the slab size!");
+    if (m_pageAllocator == nullptr)
+    {
+        m_pageAllocator = &AllocatorInstance<SystemAllocator>::Get();  // use the SystemAllocator if no page allocator is provided
+    }
+
+    m_numClasses = SizeToClass(desc.m_maxAllocationSize < 8 ? 8 : desc.m_maxAllocationSize) + 1;
+    AZ_Assert(m_numClasses <= MaxNumClasses, "Too many size classes!");
+    for (unsigned int i = 0; i < m_numClasses; ++i)
+    {
+        u32 size;
+        if (i < 4)
+        {
+            size = (i + 1) * 8;
+        }
+        else if (i < NumLinearClasses)
+        {
+            size = (i - 1) * 16;
+        }
+        else
+        {
+            u32 shift = 7 + (i - NumLinearClasses) / 4;
+            size = (1 << shift) + ((i - NumLinearClasses) % 4 + 1) * (1 << (shift - 2));
+        }
+
+        SizeClass& sizeClass = m_classes[i];
+        sizeClass.m_first = sizeClass.m_last = nullptr;
+        sizeClass.m_size = size;
+        sizeClass.m_reciprocal = ((static_cast<u64>(1) << ReciprocalShift) / size) + 1;
+        // fit as many objects as we can with the bitmap
+        size_t numObjects = (m_slabSize - SlabHeaderSize) / size;
+        while (SlabHeaderSize + ((numObjects + 63) / 64) * sizeof(u64) > m_slabSize - numObjects * size)
+        {
+            --numObjects;
+        }
+        sizeClass.m_numObjects = static_cast<u32>(numObjects);
+        sizeClass.m_numWords = static_cast<u32>((numObjects + 63) / 64);
+    }
+
+    for (unsigned int i = 0; i <= 128 / 8; ++i)
+    {
+        unsigned int classIndex = 0;
+        while (m_classes[classIndex].m_size < i * 8)
+        {
+            ++classIndex;
+        }
+        m_smallClasses[i] = static_cast<unsigned char>(classIndex);
+    }
+}
+
+//=========================================================================
+// ~SlabSchemaImpl
+//=========================================================================
+SlabSchemaImpl::~SlabSchemaImpl()
+{
+    AZ_Assert(m_numBytesAllocated == 0, "We still have %d bytes allocated from the slabs, they are leaked!", static_cast<int>(m_numBytesAllocated));
+    // force release the slabs, including the ones with live objects
+    for (unsigned int i = 0; i < m_numClasses; ++i)
+    {
+        while (Slab* slab = m_classes[i].m_first)
+        {
+            Unlink(m_classes[i], slab);
+            ReleaseSlab(slab);
+        }
+    }
+    GarbageCollect();
+}
+
+//=========================================================================
+// AlignedClass
+//=========================================================================
+unsigned int
+SlabSchemaImpl::AlignedClass(size_t byteSize, size_t alignment) const
+{
+    // objects are aligned to the largest power of 2 that divides the class size
+    unsigned int classIndex = SizeToClass(byteSize < alignment ? alignment : byteSize);
+    while (classIndex < m_numClasses && (m_classes[classIndex].m_size & (alignment - 1)))
+    {
+        ++classIndex;
+    }
+    return classIndex;
+}
+
+//=========================================================================
+// LinkFront
+//=========================================================================
+AZ_FORCE_INLINE void
+SlabSchemaImpl::LinkFront(SizeClass& sizeClass, Slab* slab)
+{
+    slab->m_prev = nullptr;
+    slab->m_next = sizeClass.m_first;
+    if (sizeClass.m_first)
+    {
+        sizeClass.m_first->m_prev = slab;
+    }
+    else
+    {
+        sizeClass.m_last = slab;
+    }
+    sizeClass.m_first = slab;
+}
+
+//=========================================================================
+// LinkBack
+//=========================================================================
+AZ_FORCE_INLINE void
+SlabSchemaImpl::LinkBack(SizeClass& sizeClass, Slab* slab)
+{
+    slab->m_next = nullptr;
+    slab->m_prev = sizeClass.m_last;
+    if (sizeClass.m_last)
+    {
+        sizeClass.m_last->m_next = slab;
+    }
+    else
+    {
+        sizeClass.m_first = slab;
+    }
+    sizeClass.m_last = slab;
+}
+
+//=========================================================================
+// Unlink
+//=========================================================================
+AZ_FORCE_INLINE void
+SlabSchemaImpl::Unlink(SizeClass& sizeClass, Slab* slab)
+{
+    if (slab->m_prev)
+    {
+        slab->m_prev->m_next = slab->m_next;
+    }
+    else
+    {
+        sizeClass.m_first = slab->m_next;
+    }
+    if (slab->m_next)
+    {
+        slab->m_next->m_prev = slab->m_prev;
+    }
+    else
+    {
+        sizeClass.m_last = slab->m_prev;
+    }
+}
+
+//=========================================================================
+// AcquireSlab
+//=========================================================================
+SlabSchemaImpl::Slab*
+SlabSchemaImpl::AcquireSlab(unsigned int classIndex)
+{
+    Slab* slab = m_freeSlabs;
+    if (slab)
+    {
+        m_freeSlabs = slab->m_next;
+    }
+    else
+    {
+        slab = reinterpret_cast<Slab*>(m_pageAllocator->Allocate(m_slabSize, m_slabSize, 0, "AZSystem::SlabSchema::Slab", __FILE__, __LINE__));
+        if (slab == nullptr)
+        {
+            return nullptr;
+        }
+        ++m_numSlabs;
+    }
+
+    SizeClass& sizeClass = m_classes[classIndex];
+    slab->m_classIndex = classIndex;
+    slab->m_numObjects = sizeClass.m_numObjects;
+    slab->m_numFree = sizeClass.m_numObjects;
+    slab->m_firstFreeWord = 0;
+    u32 lastWord = sizeClass.m_numWords - 1;
+    for (u32 i = 0; i < lastWord; ++i)
+    {
+        slab->m_freeBits[i] = ~static_cast<u64>(0);
+    }
+    u32 numLastBits = sizeClass.m_numObjects - lastWord * 64;
+    slab->m_freeBits[lastWord] = numLastBits == 64 ? ~static_cast<u64>(0) : (static_cast<u64>(1) << numLastBits) - 1;
+    LinkFront(sizeClass, slab);
+    return slab;
+}
+
+//=========================================================================
+// ReleaseSlab
+//=========================================================================
+AZ_FORCE_INLINE void
+SlabSchemaImpl::ReleaseSlab(Slab* slab)
+{
+    slab->m_next = m_freeSlabs;
+    m_freeSlabs = slab;
+}
+
+//=========================================================================
+// OnSlabFull
+//=========================================================================
+AZ_FORCE_INLINE void
+SlabSchemaImpl::OnSlabFull(Slab* slab)
+{
+    // keep the slabs with free objects in front
+    SizeClass& sizeClass = m_classes[slab->m_classIndex];
+    if (sizeClass.m_last != slab)
+    {
+        Unlink(sizeClass, slab);
+        LinkBack(sizeClass, slab);
+    }
+}
+
+//=========================================================================
+// Allocate
+//=========================================================================
+void*
+SlabSchemaImpl::Allocate(size_t byteSize, size_t alignment)
+{
+    AZ_Assert(byteSize > 0, "You can not allocate 0 bytes!");
+    AZ_Assert(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be >0 and power of 2!");
+
+    unsigned int classIndex = alignment <= 8 ? SizeToClass(byteSize) : AlignedClass(byteSize, alignment);
+    if (classIndex >= m_numClasses)
+    {
+        AZ_Assert(false, "Allocation size (%d) is too big (max: %d) for slabs!", static_cast<int>(byteSize), static_cast<int>(m_classes[m_numClasses - 1].m_size));
+        return nullptr;
+    }
+
+    SizeClass& sizeClass = m_classes[classIndex];
+    Slab* slab = sizeClass.m_first;
+    if (slab == nullptr || slab->m_numFree == 0)
+    {
+        slab = AcquireSlab(classIndex);
+        if (slab == nullptr)
+        {
+            return nullptr;
+        }
+    }
+
+    u32 word = slab->m_firstFreeWord;
+    while (slab->m_freeBits[word] == 0)
+    {
+        ++word;
+    }
+    u64 bits = slab->m_freeBits[word];
+    slab->m_freeBits[word] = bits & (bits - 1);
+    slab->m_firstFreeWord = word;
+    if (--slab->m_numFree == 0)
+    {
+        OnSlabFull(slab);
+    }
+
+    m_numBytesAllocated += sizeClass.m_size;
+    size_t index = word * 64 + CountTrailingZeros(bits);
+    return SlabEnd(slab) - (index + 1) * sizeClass.m_size;
+}
+
+//=========================================================================
+// AllocateBulk
+//=========================================================================
+size_t
+SlabSchemaImpl::AllocateBulk(size_t byteSize, size_t alignment, void** ptrs, size_t count)
+{
+    AZ_Assert(byteSize > 0, "You can not allocate 0 bytes!");
+    AZ_Assert(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be >0 and power of 2!");
+
+    unsigned int classIndex = alignment <= 8 ? SizeToClass(byteSize) : AlignedClass(byteSize, alignment);
+    if (classIndex >= m_numClasses)
+    {
+        AZ_Assert(false, "Allocation size (%d) is too big (max: %d) for slabs!", static_cast<int>(byteSize), static_cast<int>(m_classes[m_numClasses - 1].m_size));
+        return 0;
+    }
+
+    SizeClass& sizeClass = m_classes[classIndex];
+    size_t numAllocated = 0;
+    while (numAllocated < count)
+    {
+        Slab* slab = sizeClass.m_first;
+        if (slab == nullptr || slab->m_numFree == 0)
+        {
+            slab = AcquireSlab(classIndex);
+            if (slab == nullptr)
+            {
+                break;
+            }
+        }
+
+        // drain whole bitmap words
+        char* slabEnd = SlabEnd(slab);
+        size_t numTaken = 0;
+        size_t numWanted = count - numAllocated;
+        if (numWanted > slab->m_numFree)
+        {
+            numWanted = slab->m_numFree;
+        }
+        u32 word = slab->m_firstFreeWord;
+        while (numTaken < numWanted)
+        {
+            u64 bits = slab->m_freeBits[word];
+            while (bits && numTaken < numWanted)
+            {
+                size_t index = word * 64 + CountTrailingZeros(bits);
+                bits &= bits - 1;
+                ptrs[numAllocated + numTaken++] = slabEnd - (index + 1) * sizeClass.m_size;
+            }
+            slab->m_freeBits[word] = bits;
+            if (bits == 0 && numTaken < numWanted)
+            {
+                ++word;
+            }
+        }
+        slab->m_firstFreeWord = word;
+        slab->m_numFree -= static_cast<u32>(numTaken);
+        if (slab->m_numFree == 0)
+        {
+            OnSlabFull(slab);
+        }
+        numAllocated += numTaken;
+    }
+
+    m_numBytesAllocated += numAllocated * sizeClass.m_size;
+    return numAllocated;
+}
+
+//=========================================================================
+// DeAllocate
+//=========================================================================
+void
+SlabSchemaImpl::DeAllocate(void* ptr)
+{
+    Slab* slab = SlabFromAddress(ptr);
+    SizeClass& sizeClass = m_classes[slab->m_classIndex];
+    size_t offset = SlabEnd(slab) - reinterpret_cast<char*>(ptr);
+    u32 index = static_cast<u32>((offset * sizeClass.m_reciprocal) >> ReciprocalShift) - 1;
+    AZ_Assert(offset == (index + 1) * sizeClass.m_size, "Address %p is not a slab allocation!", ptr);
+    u32 word = index / 64;
+    u64 bit = static_cast<u64>(1) << (index % 64);
+    AZ_Assert((slab->m_freeBits[word] & bit) == 0, "Address %p is already free!", ptr);
+    slab->m_freeBits[word] |= bit;
+    if (word < slab->m_firstFreeWord)
+    {
+        slab->m_firstFreeWord = word;
+    }
+
+    m_numBytesAllocated -= sizeClass.m_size;
+    ++slab->m_numFree;
+    if (slab->m_numFree == 1)
+    {
+        // it was full, move it to the front
+        if (sizeClass.m_first != slab)
+        {
+            Unlink(sizeClass, slab);
+            LinkFront(sizeClass, slab);
+        }
+    }
+    else if (slab->m_numFree == slab->m_numObjects)
+    {
+        // keep the only slab with free objects, otherwise it's ready for any class
+        if (sizeClass.m_first != slab || (slab->m_next && slab->m_next->m_numFree))
+        {
+            Unlink(sizeClass, slab);
+            ReleaseSlab(slab);
+        }
+    }
+}
+
+//=========================================================================
+// AllocationSize
+//=========================================================================
+size_t
+SlabSchemaImpl::AllocationSize(void* ptr)
+{
+    return m_classes[SlabFromAddress(ptr)->m_classIndex].m_size;
+}
+
+//=========================================================================
+// GarbageCollect
+//=========================================================================
+void
+SlabSchemaImpl::GarbageCollect()
+{
+    // release the empty slabs we keep for the classes
+    for (unsigned int i = 0; i < m_numClasses; ++i)
+    {
+        Slab* slab = m_classes[i].m_first;
+        if (slab && slab->m_numFree == slab->m_numObjects)
+        {
+            Unlink(m_classes[i], slab);
+            ReleaseSlab(slab);
+        }
+    }
+
+    while (Slab* slab = m_freeSlabs)
+    {
+        m_freeSlabs = slab->m_next;
+        m_pageAllocator->DeAllocate(slab, m_slabSize, m_slabSize);
+        --m_numSlabs;
+    }
+}
+
+//=========================================================================
+// SlabSchema
+//=========================================================================
+SlabSchema::SlabSchema()
+    : m_impl(nullptr)
+{
+}
+
+//=========================================================================
+// ~SlabSchema
+//=========================================================================
+SlabSchema::~SlabSchema()
+{
+    AZ_Assert(m_impl == nullptr, "You did not destroy the slab schema!");
+    delete m_impl;
+}
+
+//=========================================================================
+// Create
+//=========================================================================
+bool SlabSchema::Create(const Descriptor& desc)
+{
+    AZ_Assert(m_impl == nullptr, "SlabSchema already created!");
+    if (m_impl == nullptr)
+    {
+        m_impl = aznew SlabSchemaImpl(desc);
+    }
+    return (m_impl != nullptr);
+}
+
+//=========================================================================
+// Destroy
+//=========================================================================
+bool SlabSchema::Destroy()
+{
+    delete m_impl;
+    m_impl = nullptr;
+    return true;
+}
+
+//=========================================================================
+// Allocate
+//=========================================================================
+SlabSchema::pointer_type
+SlabSchema::Allocate(size_type byteSize, size_type alignment, int flags)
+{
+    (void)flags;
+    return m_impl->Allocate(byteSize, alignment);
+}
+
+//=========================================================================
+// DeAllocate
+//=========================================================================
+void
+SlabSchema::DeAllocate(pointer_type ptr)
+{
+    if (ptr)
+    {
+        m_impl->DeAllocate(ptr);
+    }
+}
+
+//=========================================================================
+// AllocationSize
+//=========================================================================
+SlabSchema::size_type
+SlabSchema::AllocationSize(pointer_type ptr)
+{
+    return ptr ? m_impl->AllocationSize(ptr) : 0;
+}
+
+//=========================================================================
+// AllocateBulk
+//=========================================================================
+SlabSchema::size_type
+SlabSchema::AllocateBulk(size_type byteSize, size_type alignment, pointer_type* ptrs, size_type count)
+{
+    return m_impl->AllocateBulk(byteSize, alignment, ptrs, count);
+}
+
+//=========================================================================
+// DeAllocateBulk
+//=========================================================================
+void
+SlabSchema::DeAllocateBulk(pointer_type* ptrs, size_type count)
+{
+    for (size_type i = 0; i < count; ++i)
+    {
+        if (ptrs[i])
+        {
+            m_impl->DeAllocate(ptrs[i]);
+        }
+    }
+}
+
+//=========================================================================
+// GarbageCollect
+//=========================================================================
+void
+SlabSchema::GarbageCollect()
+{
+    m_impl->GarbageCollect();
+}
+
+//=========================================================================
+// NumAllocatedBytes
+//=========================================================================
+SlabSchema::size_type
+SlabSchema::NumAllocatedBytes() const
+{
+    return m_impl->m_numBytesAllocated;
+}
+
+//=========================================================================
+// Capacity
+//=========================================================================
+SlabSchema::size_type
+SlabSchema::Capacity() const
+{
+    return m_impl->m_numSlabs * m_impl->m_slabSize;
+}
+
+//=========================================================================
+// GetPageAllocator
+//=========================================================================
+IAllocatorAllocate*
+SlabSchema::GetPageAllocator()
+{
+    return m_impl->m_pageAllocator;
+}
+
+#endif // #ifndef AZ_UNITY_BUILD
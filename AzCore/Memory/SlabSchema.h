@@ -0,0 +1,89 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZ_SLAB_ALLOCATION_SCHEME_H
+#define AZ_SLAB_ALLOCATION_SCHEME_H
+
+#include <AzCore/Memory/SystemAllocator.h>
+
+namespace AZ
+{
+    /**
+     * Slab allocator schema
+     * Small allocations are rounded up to geometric size classes (8 to 32 bytes in 8 byte steps, 16 byte steps up to
+     * 128 bytes, then 4 classes per power of 2) and served from slabs which hold objects of one class. Each slab tracks its free objects with a bitmap,
+     * so allocating scans for the first set bit and freeing clears it, keeping the slabs dense and allocations local.
+     * Compared to the PoolSchema the memory waste for mixed sizes is bounded by the class spacing (< 25% above 128 bytes) and the number
+     * of buckets is small. Objects are naturally aligned to the largest power of 2 that divides their class size.
+     * Slab Schema is NOT thread safe, do the sync yourself.
+     */
+    class SlabSchema
+    {
+    public:
+        typedef void*       pointer_type;
+        typedef size_t      size_type;
+        typedef ptrdiff_t   difference_type;
+
+        /**
+        * Slab allocator descriptor.
+        * Slabs are aligned on their size so we can find the slab of an address. Allocations up to m_maxAllocationSize are
+        * supported, it can be at most m_slabSize / 4.
+        */
+        struct Descriptor
+        {
+            Descriptor()
+                : m_slabSize(128 * 1024)
+                , m_minAllocationSize(8)
+                , m_maxAllocationSize(32 * 1024)
+                , m_pageAllocator(nullptr)
+            {}
+            size_t              m_slabSize;             ///< Slab size in bytes, must be a power of 2.
+            size_t              m_minAllocationSize;    ///< The smallest class is always 8 bytes, kept for the PoolAllocatorHelper.
+            size_t              m_maxAllocationSize;    ///< Maximum allocation size, rounded up to a size class.
+            IAllocatorAllocate* m_pageAllocator;        ///< If you provide this interface we will use it for slab allocations, otherwise SystemAllocator will be used.
+        };
+
+        SlabSchema();
+        ~SlabSchema();
+
+        bool Create(const Descriptor& desc);
+        bool Destroy();
+
+        pointer_type    Allocate(size_type byteSize, size_type alignment, int flags = 0);
+        void            DeAllocate(pointer_type ptr);
+        size_type       AllocationSize(pointer_type ptr);
+
+        /**
+         * Allocates count blocks of the same size into the ptrs array, filling it from whole bitmap words at a time.
+         * Returns the number of blocks allocated, which is less than count only if we run out of memory.
+         */
+        size_type       AllocateBulk(size_type byteSize, size_type alignment, pointer_type* ptrs, size_type count);
+        /// Frees count blocks from the ptrs array, they don't need to be the same size.
+        void            DeAllocateBulk(pointer_type* ptrs, size_type count);
+
+        /// Return unused memory to the OS. Don't call this too often because you will force unnecessary allocations.
+        void            GarbageCollect();
+
+        size_type       NumAllocatedBytes() const;
+        /// Returns the bytes of all slabs we own.
+        size_type       Capacity() const;
+        IAllocatorAllocate* GetPageAllocator();
+
+    protected:
+        SlabSchema(const SlabSchema&);
+        SlabSchema& operator=(const SlabSchema&);
+
+        class SlabSchemaImpl*             m_impl;
+    };
+}
+
+#endif // AZ_SLAB_ALLOCATION_SCHEME_H
+#pragma once
@@ -15,6 +15,7 @@
 #include <AzCore/Memory/AllocatorManager.h>
 
 #include <AzCore/Memory/OSAllocator.h>
+#include <AzCore/Memory/AllocationSampler.h>
 
 #include <AzCore/std/functional.h>
 
@@ -99,6 +100,9 @@ SystemAllocator::Create(const Descriptor& desc)
         }
         heapDesc.m_subAllocator = desc.m_heap.m_subAllocator;
         heapDesc.m_isPoolAllocations = desc.m_heap.m_isPoolAllocations;
+        heapDesc.m_isThreadCache = desc.m_heap.m_isThreadCache;
+        heapDesc.m_hugePageSize = desc.m_heap.m_hugePageSize;
+        heapDesc.m_decommitMinSize = desc.m_heap.m_decommitMinSize;
 #else
         HeapSchema::Descriptor      heapDesc;
         memcpy(heapDesc.m_memoryBlocks, desc.m_heap.m_memoryBlocks, sizeof(heapDesc.m_memoryBlocks));
@@ -199,6 +203,15 @@ SystemAllocator::Allocate(size_type byteSize, size_type alignment, int flags, co
 
     AZ_Assert(address != 0, "SystemAllocator: Failed to allocate %d bytes aligned on %d (flags: 0x%08x) %s : %s (%d)!", byteSize, alignment, flags, name ? name : "(no name)", fileName ? fileName : "(no file name)", lineNum);
 
+    if (m_statistics.OnAllocation(byteSize))
+    {
+        m_statistics.UpdatePeak(m_allocator->NumAllocatedBytes());
+    }
+    if (m_sampler)
+    {
+        m_sampler->OnAllocation(address, byteSize, suppressStackRecord + 1);
+    }
+
     return address;
 }
 
@@ -209,6 +222,14 @@ SystemAllocator::Allocate(size_type byteSize, size_type alignment, int flags, co
 void
 SystemAllocator::DeAllocate(pointer_type ptr, size_type byteSize, size_type alignment)
 {
+    if (ptr)
+    {
+        m_statistics.OnDeAllocation();
+        if (m_sampler)
+        {
+            m_sampler->OnDeAllocation(ptr);
+        }
+    }
     m_allocator->DeAllocate(ptr, byteSize, alignment);
 }
 
@@ -220,6 +241,23 @@ SystemAllocator::pointer_type
 SystemAllocator::ReAllocate(pointer_type ptr, size_type newSize, size_type newAlignment)
 {
     pointer_type newAddress = m_allocator->ReAllocate(ptr, newSize, newAlignment);
+    // a failed reallocation leaves ptr allocated, keep counting it and keep its sample
+    if (ptr && (newAddress || newSize == 0))
+    {
+        m_statistics.OnDeAllocation();
+        if (m_sampler)
+        {
+            m_sampler->OnDeAllocation(ptr);
+        }
+    }
+    if (newAddress)
+    {
+        m_statistics.OnAllocation(newSize);
+        if (m_sampler)
+        {
+            m_sampler->OnAllocation(newAddress, newSize);
+        }
+    }
     return newAddress;
 }
 
@@ -13,6 +13,7 @@
 #define AZCORE_SYS_ALLOCATOR_H
 
 #include <AzCore/Memory/Memory.h>
+#include <AzCore/Memory/OSPageSize.h>
 
 namespace AZ
 {
@@ -62,8 +63,11 @@ namespace AZ
                     : m_pageSize(m_defaultPageSize)
                     , m_poolPageSize(m_defaultPoolPageSize)
                     , m_isPoolAllocations(true)
+                    , m_isThreadCache(false)
                     , m_numMemoryBlocks(0)
                     , m_subAllocator(0)
+                    , m_hugePageSize(OS_PAGE_SIZE_DEFAULT)
+                    , m_decommitMinSize(0)
                 {}
 #if defined(AZ_PLATFORM_WINDOWS) || defined(AZ_PLATFORM_X360) || defined(AZ_PLATFORM_PS3) || defined(AZ_PLATFORM_PS4) || defined(AZ_PLATFORM_XBONE) || defined(AZ_PLATFORM_LINUX) || defined(AZ_PLATFORM_ANDROID) || defined(AZ_PLATFORM_APPLE) // ACCEPTED_USE
                 static const int        m_defaultPageSize = 64 * 1024;
@@ -76,10 +80,13 @@ namespace AZ
                 unsigned int            m_pageSize;                                 ///< Page allocation size must be 1024 bytes aligned. (default m_defaultPageSize)
                 unsigned int            m_poolPageSize;                             ///< Page size used to small memory allocations. Must be less or equal to m_pageSize and a multiple of it. (default m_defaultPoolPageSize)
                 bool                    m_isPoolAllocations;                        ///< True (default) if we use pool for small allocations (< 256 bytes), otherwise false. IMPORTANT: Changing this to false will degrade performance!
+                bool                    m_isThreadCache;                            ///< True to cache small allocations per thread, to avoid lock contention on the pools (default false). \ref HphaSchema::Descriptor::m_isThreadCache
                 int                     m_numMemoryBlocks;                          ///< Number of memory blocks to use.
                 void*                   m_memoryBlocks[m_maxNumBlocks];             ///< Pointers to provided memory blocks or NULL if you want the system to allocate them for you with the System Allocator.
                 size_t                  m_memoryBlocksByteSize[m_maxNumBlocks];     ///< Sizes of different memory blocks (MUST be multiple of m_pageSize), if m_memoryBlock is 0 the block will be allocated for you with the System Allocator.
                 IAllocatorAllocate*     m_subAllocator;                             ///< Allocator that m_memoryBlocks memory was allocated from or should be allocated (if NULL).
+                OSPageSize              m_hugePageSize;                             ///< Page size to map the heap memory with, huge pages reduce the TLB misses on big heaps (default OS pages). \ref HphaSchema::Descriptor::m_hugePageSize
+                size_t                  m_decommitMinSize;                          ///< GarbageCollect returns the physical pages of free blocks at least this big to the OS (default 0, disabled).
             }                           m_heap;
             bool                        m_allocationRecords;    ///< True if we want to track memory allocations, otherwise false.
             unsigned char               m_stackRecordLevels;    ///< If stack recording is enabled, how many stack levels to record.
@@ -107,6 +114,7 @@ namespace AZ
         /// Keep in mind this operation will execute GarbageCollect to make sure it returns, max allocation. This function WILL be slow.
         virtual size_type       GetMaxAllocationSize() const    { return m_allocator->GetMaxAllocationSize(); }
         virtual size_type       GetUnAllocatedMemory(bool isPrint = false) const    { return m_allocator->GetUnAllocatedMemory(isPrint); }
+        virtual size_type       GetLockContentionCount() const  { return m_allocator->GetLockContentionCount(); }
         virtual IAllocatorAllocate*  GetSubAllocator()          { return m_isCustom ? m_allocator : m_allocator->GetSubAllocator(); }
         //////////////////////////////////////////////////////////////////////////
 
@@ -4658,6 +4658,100 @@ static void* tmalloc_small(mstate m, size_t nb)
 
 /* --------------------------- realloc support --------------------------- */
 
+/*
+  AZ: Resize a chunk without moving it, must be called with the lock held.
+  Shrinks, extends into top, into dv or into the next free chunk (same as
+  try_realloc_chunk in dlmalloc 2.8.5+). Returns 0 if the chunk can't be
+  resized in place. If the chunk was shrunk the remainder is returned in
+  extra and must be freed after the lock is released.
+*/
+static mchunkptr az_try_realloc_chunk(mstate m, mchunkptr oldp, size_t nb, void** extra)
+{
+    size_t oldsize = chunksize(oldp);
+    mchunkptr next = chunk_plus_offset(oldp, oldsize);
+    mchunkptr newp = 0;
+    if (is_mmapped(oldp))
+    {
+        newp = mmap_resize(m, oldp, nb);
+    }
+    else if (oldsize >= nb) /* already big enough */
+    {
+        size_t rsize = oldsize - nb;
+        newp = oldp;
+        if (rsize >= MIN_CHUNK_SIZE)
+        {
+            mchunkptr remainder = chunk_plus_offset(newp, nb);
+            set_inuse(m, newp, nb);
+            set_inuse_and_pinuse(m, remainder, rsize);
+            *extra = chunk2mem(remainder);
+        }
+    }
+    else if (next == m->top)
+    {
+        if (oldsize + m->topsize > nb)
+        {
+            /* Expand into top */
+            size_t newsize = oldsize + m->topsize;
+            size_t newtopsize = newsize - nb;
+            mchunkptr newtop = chunk_plus_offset(oldp, nb);
+            set_inuse(m, oldp, nb);
+            newtop->head = newtopsize | PINUSE_BIT;
+            m->top = newtop;
+            m->topsize = newtopsize;
+            newp = oldp;
+        }
+    }
+    else if (next == m->dv)
+    {
+        size_t dvs = m->dvsize;
+        if (oldsize + dvs >= nb)
+        {
+            /* Expand into dv */
+            size_t dsize = oldsize + dvs - nb;
+            if (dsize >= MIN_CHUNK_SIZE)
+            {
+                mchunkptr r = chunk_plus_offset(oldp, nb);
+                mchunkptr n = chunk_plus_offset(r, dsize);
+                set_inuse(m, oldp, nb);
+                set_size_and_pinuse_of_free_chunk(r, dsize);
+                clear_pinuse(n);
+                m->dvsize = dsize;
+                m->dv = r;
+            }
+            else /* exhaust dv */
+            {
+                set_inuse(m, oldp, (oldsize + dvs));
+                m->dvsize = 0;
+                m->dv = 0;
+            }
+            newp = oldp;
+        }
+    }
+    else if (!cinuse(next))
+    {
+        size_t nextsize = chunksize(next);
+        if (oldsize + nextsize >= nb)
+        {
+            /* Expand into the next free chunk */
+            size_t rsize = oldsize + nextsize - nb;
+            unlink_chunk(m, next, nextsize);
+            if (rsize < MIN_CHUNK_SIZE)
+            {
+                set_inuse(m, oldp, (oldsize + nextsize));
+            }
+            else
+            {
+                mchunkptr remainder = chunk_plus_offset(oldp, nb);
+                set_inuse(m, oldp, nb);
+                set_inuse_and_pinuse(m, remainder, rsize);
+                *extra = chunk2mem(remainder);
+            }
+            newp = oldp;
+        }
+    }
+    return newp;
+}
+
 static void* internal_realloc(mstate m, void* oldmem, size_t bytes)
 {
     if (bytes >= MAX_REQUEST)
@@ -4669,44 +4763,15 @@ static void* internal_realloc(mstate m, void* oldmem, size_t bytes)
     {
         mchunkptr oldp = mem2chunk(oldmem);
         size_t oldsize = chunksize(oldp);
-        mchunkptr next = chunk_plus_offset(oldp, oldsize);
         mchunkptr newp = 0;
         void* extra = 0;
 
-        /* Try to either shrink or extend into top. Else malloc-copy-free */
+        /* Try to resize in place (AZ: including free neighbours). Else malloc-copy-free */
 
         if (RTCHECK(ok_address(m, oldp) && ok_inuse(oldp) &&
-                ok_next(oldp, next) && ok_pinuse(next)))
+                ok_next(oldp, chunk_plus_offset(oldp, oldsize)) && ok_pinuse(chunk_plus_offset(oldp, oldsize))))
         {
-            size_t nb = request2size(bytes);
-            if (is_mmapped(oldp))
-            {
-                newp = mmap_resize(m, oldp, nb);
-            }
-            else if (oldsize >= nb) /* already big enough */
-            {
-                size_t rsize = oldsize - nb;
-                newp = oldp;
-                if (rsize >= MIN_CHUNK_SIZE)
-                {
-                    mchunkptr remainder = chunk_plus_offset(newp, nb);
-                    set_inuse(m, newp, nb);
-                    set_inuse_and_pinuse(m, remainder, rsize);
-                    extra = chunk2mem(remainder);
-                }
-            }
-            else if (next == m->top && oldsize + m->topsize > nb)
-            {
-                /* Expand into top */
-                size_t newsize = oldsize + m->topsize;
-                size_t newtopsize = newsize - nb;
-                mchunkptr newtop = chunk_plus_offset(oldp, nb);
-                set_inuse(m, oldp, nb);
-                newtop->head = newtopsize | PINUSE_BIT;
-                m->top = newtop;
-                m->topsize = newtopsize;
-                newp = oldp;
-            }
+            newp = az_try_realloc_chunk(m, oldp, request2size(bytes), &extra);
         }
         else
         {
@@ -5574,6 +5639,52 @@ postaction:
 #define AZ_MSPACE_DO_NOT_EXPAND  (1)
 #define is_not_expandable(M)    ((M)->exts & AZ_MSPACE_DO_NOT_EXPAND)
 
+    //=========================================================================
+    // Resize a memory block in place (never moves it), returns the new usable size
+    //=========================================================================
+    size_t mspace_az_resize(void* mem, size_t bytes)
+    {
+        if (mem == 0 || bytes >= MAX_REQUEST)
+        {
+            return 0;
+        }
+        mchunkptr oldp = mem2chunk(mem);
+#if FOOTERS
+        mstate ms = get_mstate_for(oldp);
+#else /* FOOTERS */
+        mstate ms = gm;
+#endif /* FOOTERS */
+        if (!ok_magic(ms))
+        {
+            USAGE_ERROR_ACTION(ms, ms);
+            return 0;
+        }
+        size_t usableSize = 0;
+        void* extra = 0;
+        if (!PREACTION(ms))
+        {
+            if (RTCHECK(ok_address(ms, oldp) && ok_inuse(oldp) &&
+                    ok_next(oldp, chunk_plus_offset(oldp, chunksize(oldp))) && ok_pinuse(chunk_plus_offset(oldp, chunksize(oldp)))))
+            {
+                if (!is_mmapped(oldp))  // resizing mmapped chunks can move them
+                {
+                    az_try_realloc_chunk(ms, oldp, request2size(bytes), &extra);
+                }
+                usableSize = chunksize(oldp) - overhead_for(oldp);
+            }
+            else
+            {
+                USAGE_ERROR_ACTION(ms, mem);
+            }
+            POSTACTION(ms);
+        }
+        if (extra != 0)
+        {
+            internal_free(ms, extra);
+        }
+        return usableSize;
+    }
+
     //=========================================================================
     // Flag to decide if we can expand an mspace or not
     // [12/2/2010]
@@ -100,7 +100,7 @@ namespace AZStd
         {
             // initialize from [pos, pos + count) elements in string
             AZStd::size_t num;
-            AZSTD_CONTAINER_ASSERT(str.size() >= pos, "Invalid position %d (%d)", pos, str.size());
+            AZSTD_CONTAINER_ASSERT(str.size() >= pos, "Invalid position %d (%d)", static_cast<int>(pos), static_cast<int>(str.size()));
 
             if (str.size() - pos < count)
             {
@@ -206,7 +206,7 @@ namespace AZStd
 
         AZ_FORCE_INLINE this_type& set(AZStd::size_t pos, bool value = true)
         {   // set bit at pos to value
-            AZSTD_CONTAINER_ASSERT(NumBits > pos, "Invalid position %d (%d)", pos, NumBits);
+            AZSTD_CONTAINER_ASSERT(NumBits > pos, "Invalid position %d (%d)", static_cast<int>(pos), static_cast<int>(NumBits));
             if (value)
             {
                 m_bits[pos / BitsPerWord] |= (word_t)1 << pos % BitsPerWord;
@@ -241,7 +241,7 @@ namespace AZStd
 
         AZ_FORCE_INLINE this_type& flip(AZStd::size_t pos)
         {   // flip bit at pos
-            AZSTD_CONTAINER_ASSERT(NumBits > pos, "Invalid position %d (%d)", pos, NumBits);
+            AZSTD_CONTAINER_ASSERT(NumBits > pos, "Invalid position %d (%d)", static_cast<int>(pos), static_cast<int>(NumBits));
             m_bits[pos / BitsPerWord] ^= (word_t)1 << pos % BitsPerWord;
             return *this;
         }
@@ -333,7 +333,7 @@ namespace AZStd
             return value;
         }
 
-        AZ_FORCE_INLINE AZStd::size_t size()                    {   return NumBits; }
+        AZ_FORCE_INLINE AZStd::size_t size() const              {   return NumBits; }
 
         AZ_FORCE_INLINE bool operator==(const this_type& rhs) const
         {
@@ -362,7 +362,7 @@ namespace AZStd
 
         AZ_FORCE_INLINE bool test(AZStd::size_t pos) const
         {   // test if bit at pos is set
-            AZSTD_CONTAINER_ASSERT(NumBits > pos, "Invalid position %d (%d)", pos, NumBits);
+            AZSTD_CONTAINER_ASSERT(NumBits > pos, "Invalid position %d (%d)", static_cast<int>(pos), static_cast<int>(NumBits));
             return ((m_bits[pos / BitsPerWord] & ((word_t)1 << pos % BitsPerWord)) != 0);
         }
 
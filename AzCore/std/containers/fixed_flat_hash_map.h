@@ -0,0 +1,117 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZSTD_FIXED_FLAT_HASH_MAP_H
+#define AZSTD_FIXED_FLAT_HASH_MAP_H 1
+
+#include <AzCore/std/containers/flat_hash_map.h>
+
+namespace AZStd
+{
+    /**
+     * Fixed flat hash map is a \ref flat_hash_map with inline storage for FixedNumElements elements.
+     * No allocations will occur using this container, inserting more than FixedNumElements elements asserts.
+     * The slot array is rounded up to 2^n - 1 slots, that keep the load factor under 7/8.
+     */
+    template<class Key, class MappedType, AZStd::size_t FixedNumElements, class Hasher = AZStd::hash<Key>, class EqualKey = AZStd::equal_to<Key> >
+    class fixed_flat_hash_map
+        : public flat_hash_table< Internal::FlatHashMapTableTraits<Key, MappedType, Hasher, EqualKey, AZStd::no_default_allocator, false, FixedNumElements> >
+    {
+        enum
+        {
+            CONTAINER_VERSION = 1
+        };
+
+        typedef fixed_flat_hash_map<Key, MappedType, FixedNumElements, Hasher, EqualKey> this_type;
+        typedef flat_hash_table< Internal::FlatHashMapTableTraits<Key, MappedType, Hasher, EqualKey, AZStd::no_default_allocator, false, FixedNumElements> > base_type;
+    public:
+        typedef typename base_type::key_type    key_type;
+        typedef typename base_type::key_eq      key_eq;
+        typedef typename base_type::hasher      hasher;
+        typedef MappedType                      mapped_type;
+
+        typedef typename base_type::allocator_type              allocator_type;
+        typedef typename base_type::size_type                   size_type;
+        typedef typename base_type::difference_type             difference_type;
+        typedef typename base_type::pointer                     pointer;
+        typedef typename base_type::const_pointer               const_pointer;
+        typedef typename base_type::reference                   reference;
+        typedef typename base_type::const_reference             const_reference;
+
+        typedef typename base_type::iterator                    iterator;
+        typedef typename base_type::const_iterator              const_iterator;
+
+        typedef typename base_type::value_type                  value_type;
+
+        typedef typename base_type::pair_iter_bool              pair_iter_bool;
+
+        AZ_FORCE_INLINE fixed_flat_hash_map()
+            : base_type(hasher(), key_eq()) {}
+        AZ_FORCE_INLINE fixed_flat_hash_map(const hasher& hash, const key_eq& keyEqual)
+            : base_type(hash, keyEqual) {}
+        template<class Iterator>
+        fixed_flat_hash_map(Iterator first, Iterator last, const hasher& hash = hasher(), const key_eq& keyEqual = key_eq())
+            : base_type(hash, keyEqual)
+        {
+            base_type::insert(first, last);
+        }
+#if defined(AZ_HAS_INITIALIZERS_LIST)
+        fixed_flat_hash_map(const std::initializer_list<value_type>& list, const hasher& hash = hasher(), const key_eq& keyEqual = key_eq())
+            : base_type(hash, keyEqual)
+        {
+            base_type::insert(list.begin(), list.end());
+        }
+#endif // #if defined(AZ_HAS_INITIALIZERS_LIST)
+
+        /**
+        * Look up operator if element doesn't exists inserts a new one with (key,mapped_type()).
+        */
+        AZ_FORCE_INLINE mapped_type& operator[](const key_type& key)
+        {
+            pair_iter_bool iterBool = insert_key(key);
+            return iterBool.first->second;
+        }
+        /**
+        * Returns mapped type with based on the key, if the element doesn't exist an assert it triggered!
+        */
+        AZ_FORCE_INLINE mapped_type& at(const key_type& key)
+        {
+            iterator iter = base_type::find(key);
+            AZSTD_CONTAINER_ASSERT(iter != base_type::end(), "Element with key is not present");
+            return iter->second;
+        }
+        AZ_FORCE_INLINE const mapped_type& at(const key_type& key) const
+        {
+            const_iterator iter = base_type::find(key);
+            AZSTD_CONTAINER_ASSERT(iter != base_type::end(), "Element with key is not present");
+            return iter->second;
+        }
+
+        /**
+         * Insert a pair with default value base on a key only (AKA lazy insert). This can be a speed up when
+         * the object has complicated assignment function.
+         */
+        AZ_FORCE_INLINE pair_iter_bool insert_key(const key_type& key)
+        {
+            Internal::ConvertKeyTypeFlat<key_type> converter;
+            return base_type::insert_from(key, converter, base_type::m_hasher, base_type::m_keyEqual);
+        }
+    };
+
+    template<class Key, class MappedType, AZStd::size_t FixedNumElements, class Hasher, class EqualKey>
+    AZ_FORCE_INLINE void swap(fixed_flat_hash_map<Key, MappedType, FixedNumElements, Hasher, EqualKey>& left, fixed_flat_hash_map<Key, MappedType, FixedNumElements, Hasher, EqualKey>& right)
+    {
+        left.swap(right);
+    }
+}
+
+#endif // AZSTD_FIXED_FLAT_HASH_MAP_H
+#pragma once
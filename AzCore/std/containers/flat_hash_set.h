@@ -0,0 +1,166 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZSTD_FLAT_HASH_SET_H
+#define AZSTD_FLAT_HASH_SET_H 1
+
+#include <AzCore/std/flat_hash_table.h>
+#include <AzCore/std/allocator.h>
+
+namespace AZStd
+{
+    namespace Internal
+    {
+        template<class Key, class Hasher, class EqualKey, class Allocator, bool IsDynamic, AZStd::size_t FixedNumElements>
+        struct FlatHashSetTableTraits
+        {
+            typedef Key         key_type;
+            typedef EqualKey    key_eq;
+            typedef Hasher      hasher;
+            typedef Key         value_type;
+            typedef Allocator   allocator_type;
+            enum
+            {
+                is_dynamic = IsDynamic,
+                fixed_num_elements = FixedNumElements // NOT used for dynamic sets
+            };
+            static AZ_FORCE_INLINE const key_type& key_from_value(const value_type& value)  { return value; }
+        };
+    }
+
+    /**
+     * Flat hash set is an open addressing (Swiss table) version of \ref unordered_set, all Keys are unique.
+     * All elements live in a single array of slots, so there are no per element allocations.
+     *
+     * Unlike unordered_set, inserts invalidate all iterators and element references, check \ref flat_hash_table for
+     * all the differences and the extensions.
+     */
+    template<class Key, class Hasher = AZStd::hash<Key>, class EqualKey = AZStd::equal_to<Key>, class Allocator = AZStd::allocator >
+    class flat_hash_set
+        : public flat_hash_table< Internal::FlatHashSetTableTraits<Key, Hasher, EqualKey, Allocator, true, 1> >
+    {
+        enum
+        {
+            CONTAINER_VERSION = 1
+        };
+
+        typedef flat_hash_set<Key, Hasher, EqualKey, Allocator> this_type;
+        typedef flat_hash_table< Internal::FlatHashSetTableTraits<Key, Hasher, EqualKey, Allocator, true, 1> > base_type;
+    public:
+        typedef typename base_type::traits_type traits_type;
+
+        typedef typename base_type::key_type    key_type;
+        typedef typename base_type::key_eq      key_eq;
+        typedef typename base_type::hasher      hasher;
+
+        typedef typename base_type::allocator_type              allocator_type;
+        typedef typename base_type::size_type                   size_type;
+        typedef typename base_type::difference_type             difference_type;
+        typedef typename base_type::pointer                     pointer;
+        typedef typename base_type::const_pointer               const_pointer;
+        typedef typename base_type::reference                   reference;
+        typedef typename base_type::const_reference             const_reference;
+
+        typedef typename base_type::iterator                    iterator;
+        typedef typename base_type::const_iterator              const_iterator;
+
+        typedef typename base_type::value_type                  value_type;
+
+        typedef typename base_type::pair_iter_bool              pair_iter_bool;
+
+        AZ_FORCE_INLINE flat_hash_set()
+            : base_type(hasher(), key_eq(), allocator_type()) {}
+        AZ_FORCE_INLINE flat_hash_set(const flat_hash_set& rhs)
+            : base_type(rhs) {}
+        AZ_FORCE_INLINE flat_hash_set(const hasher& hash, const key_eq& keyEqual, const allocator_type& allocator)
+            : base_type(hash, keyEqual, allocator) {}
+        /// Reserves space for numElementsHint elements.
+        AZ_FORCE_INLINE explicit flat_hash_set(size_type numElementsHint)
+            : base_type(hasher(), key_eq(), allocator_type())
+        {
+            base_type::reserve(numElementsHint);
+        }
+        AZ_FORCE_INLINE flat_hash_set(size_type numElementsHint, const hasher& hash, const key_eq& keyEqual, const allocator_type& allocator = allocator_type())
+            : base_type(hash, keyEqual, allocator)
+        {
+            base_type::reserve(numElementsHint);
+        }
+        template<class Iterator>
+        AZ_FORCE_INLINE flat_hash_set(Iterator first, Iterator last, const hasher& hash = hasher(), const key_eq& keyEqual = key_eq(), const allocator_type& allocator = allocator_type())
+            : base_type(hash, keyEqual, allocator)
+        {
+            base_type::insert(first, last);
+        }
+#if defined(AZ_HAS_INITIALIZERS_LIST)
+        AZ_FORCE_INLINE flat_hash_set(const std::initializer_list<value_type>& list, const hasher& hash = hasher(), const key_eq& keyEqual = key_eq(), const allocator_type& allocator = allocator_type())
+            : base_type(hash, keyEqual, allocator)
+        {
+            base_type::reserve(list.size());
+            for (const value_type& i : list)
+            {
+                base_type::insert(i);
+            }
+        }
+#endif // #if defined(AZ_HAS_INITIALIZERS_LIST)
+
+#ifdef AZ_HAS_RVALUE_REFS
+        AZ_FORCE_INLINE flat_hash_set(this_type&& rhs)
+            : base_type(AZStd::move(rhs))
+        {
+        }
+
+        this_type& operator=(this_type&& rhs)
+        {
+            base_type::operator=(AZStd::move(rhs));
+            return *this;
+        }
+#endif // AZ_HAS_RVALUE_REFS
+
+        AZ_FORCE_INLINE this_type& operator=(const this_type& rhs)
+        {
+            base_type::operator=(rhs);
+            return *this;
+        }
+    };
+
+    template<class Key, class Hasher, class EqualKey, class Allocator>
+    AZ_FORCE_INLINE void swap(flat_hash_set<Key, Hasher, EqualKey, Allocator>& left, flat_hash_set<Key, Hasher, EqualKey, Allocator>& right)
+    {
+        left.swap(right);
+    }
+
+    template <class Key, class Hasher, class EqualKey, class Allocator>
+    AZ_FORCE_INLINE bool operator==(const flat_hash_set<Key, Hasher, EqualKey, Allocator>& a, const flat_hash_set<Key, Hasher, EqualKey, Allocator>& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+
+        for (decltype(a.begin()) ait = a.begin(); ait != a.end(); ++ait)
+        {
+            if (b.find(*ait) == b.end())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <class Key, class Hasher, class EqualKey, class Allocator>
+    AZ_FORCE_INLINE bool operator!=(const flat_hash_set<Key, Hasher, EqualKey, Allocator>& a, const flat_hash_set<Key, Hasher, EqualKey, Allocator>& b)
+    {
+        return !(a == b);
+    }
+}
+
+#endif // AZSTD_FLAT_HASH_SET_H
+#pragma once
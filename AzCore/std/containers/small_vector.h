@@ -0,0 +1,1218 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZSTD_SMALL_VECTOR_H
+#define AZSTD_SMALL_VECTOR_H 1
+
+#include <AzCore/std/allocator.h>
+#include <AzCore/std/algorithm.h>
+#include <AzCore/std/createdestroy.h>
+#include <AzCore/std/typetraits/aligned_storage.h>
+#include <AzCore/std/typetraits/alignment_of.h>
+
+namespace AZStd
+{
+    /**
+     * Common part of all \ref small_vector "small vectors" with the same value type and allocator. It has the full
+     * vector interface, but it can't be created on it's own. Use it to pass small vectors around without
+     * baking the inline capacity into the function signature:
+     * \code
+     * void GatherEntities(AZStd::small_vector_base<AZ::EntityId>& result);
+     *
+     * AZStd::small_vector<AZ::EntityId, 16> entities;
+     * GatherEntities(entities);
+     * \endcode
+     * The elements are stored in the inline buffer of the small_vector until it's full, after that they are
+     * moved to a memory block from the allocator, which grows by 50% just like the \ref vector does.
+     */
+    template< class T, class Allocator = AZStd::allocator >
+    class small_vector_base
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+        : public Debug::checked_container_base
+#endif
+    {
+        enum
+        {
+            CONTAINER_VERSION = 1
+        };
+
+        typedef small_vector_base<T, Allocator>          this_type;
+    public:
+        //#pragma region Type definitions
+        typedef T*                                      pointer;
+        typedef const T*                                const_pointer;
+
+        typedef T&                                      reference;
+        typedef const T&                                const_reference;
+        typedef typename Allocator::difference_type     difference_type;
+        typedef typename Allocator::size_type           size_type;
+
+        typedef pointer                                 iterator_impl;
+        typedef const_pointer                           const_iterator_impl;
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+        typedef Debug::checked_randomaccess_iterator<iterator_impl, this_type>       iterator;
+        typedef Debug::checked_randomaccess_iterator<const_iterator_impl, this_type> const_iterator;
+#else
+        typedef iterator_impl                           iterator;
+        typedef const_iterator_impl                     const_iterator;
+#endif
+        typedef AZStd::reverse_iterator<iterator>       reverse_iterator;
+        typedef AZStd::reverse_iterator<const_iterator> const_reverse_iterator;
+        typedef T                                       value_type;
+        typedef Allocator                               allocator_type;
+
+        // AZSTD extension.
+        /**
+         * \brief Allocation node type. Common for all AZStd containers.
+         * When the inline buffer is exceeded we allocate always "sizeof(node_type)*capacity" block.
+         */
+        typedef value_type                              node_type;
+        //#pragma endregion
+
+        this_type& operator=(const this_type& rhs)
+        {
+            if (this == &rhs)
+            {
+                return *this;
+            }
+
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            orphan_all();
+#endif
+            size_type newSize = rhs.m_last - rhs.m_start;
+            size_type size = m_last - m_start;
+            if (newSize > size_type(m_end - m_start))
+            {
+                // Not enough capacity, drop the current elements so we don't move them to the new block.
+                clear();
+                size = 0;
+                reserve(newSize);
+            }
+
+            if (size >= newSize)
+            {
+                pointer newLast = Internal::copy(rhs.m_start, rhs.m_last, m_start, has_trivial_assign<value_type>());
+                // Destroy the rest.
+                Internal::destroy<pointer>::range(newLast, m_last);
+                m_last = newLast;
+            }
+            else
+            {
+                pointer newLast = Internal::copy(rhs.m_start, rhs.m_start + size, m_start, has_trivial_assign<value_type>());
+                m_last = AZStd::uninitialized_copy(rhs.m_start + size, rhs.m_last, newLast, has_trivial_copy<value_type>());
+            }
+
+            return *this;
+        }
+
+#ifdef AZ_HAS_RVALUE_REFS
+        this_type& operator=(this_type&& rhs)
+        {
+            assign_rv(AZStd::forward<this_type>(rhs));
+            return *this;
+        }
+
+        void assign_rv(this_type&& rhs)
+        {
+            if (this == &rhs)
+            {
+                return;
+            }
+            if (!rhs.is_inline() && m_allocator == rhs.m_allocator && size_type(rhs.m_end - rhs.m_start) > m_inlineCapacity)
+            {
+                // Take over the allocated block (if it's bigger than our inline buffer, otherwise we will just use the buffer).
+                Internal::destroy<pointer>::range(m_start, m_last);
+                if (!is_inline())
+                {
+                    deallocate_memory(typename allocator_type::allow_memory_leaks(), 0);
+                }
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+                orphan_all();
+                swap_all(rhs);
+#endif
+                m_start = rhs.m_start;
+                m_last = rhs.m_last;
+                m_end = rhs.m_end;
+
+                rhs.m_start = rhs.m_inlineStart;
+                rhs.m_last = rhs.m_inlineStart;
+                rhs.m_end = rhs.m_inlineStart + rhs.m_inlineCapacity;
+            }
+            else
+            {
+                // Elements in the inline buffer (or from a different allocator) have to be moved one by one.
+                clear();
+                reserve(rhs.m_last - rhs.m_start);
+                m_last = AZStd::uninitialized_move(rhs.m_start, rhs.m_last, m_start, Internal::is_fast_copy<pointer, pointer>());
+                rhs.clear();
+            }
+        }
+
+        void push_back(value_type&& value)
+        {
+            pointer element = AZStd::addressof(value);
+            if (m_last == m_end)
+            {
+                if (element >= m_start && element < m_last)
+                {
+                    // value is in the vector, find it again after we grow.
+                    size_type index = element - m_start;
+                    grow(size_type(m_last - m_start) + 1);
+                    element = m_start + index;
+                }
+                else
+                {
+                    grow(size_type(m_last - m_start) + 1);
+                }
+            }
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            orphan_range(m_last, m_last);
+#endif
+            Internal::construct<pointer>::single(m_last, AZStd::forward<value_type>(*element));
+            ++m_last;
+        }
+
+        template<class ... Args>
+        inline void emplace_back(Args&& ... args)
+        {
+            if (m_last == m_end)
+            {
+                grow(size_type(m_last - m_start) + 1);
+            }
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            orphan_range(m_last, m_last);
+#endif
+            Internal::construct<pointer>::single(m_last, AZStd::forward<Args>(args) ...);
+            ++m_last;
+        }
+
+        inline iterator insert(const_iterator pos, value_type&& value)
+        {
+            return emplace(pos, AZStd::forward<value_type>(value));
+        }
+
+        template<class ... Args>
+        inline iterator emplace(const_iterator pos, Args&& ... args)
+        {
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            AZ_Assert(pos.m_container == this, "Iterator doesn't belong to this container");
+            pointer element = const_cast<pointer>(pos.m_iter);
+#else
+            pointer element = const_cast<pointer>(pos);
+#endif
+            AZ_Assert(element >= m_start && element <= m_last, "where iterator outsize small_vector range [0,%d]", static_cast<int>(size()));
+            size_type offset = element - m_start;
+            emplace_back(AZStd::forward<Args>(args) ...);
+            AZStd::rotate(m_start + offset, m_last - 1, m_last);
+            return iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_start + offset));
+        }
+#endif // AZ_HAS_RVALUE_REFS
+
+#if defined(AZ_HAS_INITIALIZERS_LIST)
+        this_type& operator=(std::initializer_list<T> list)
+        {
+            assign(list.begin(), list.end());
+            return *this;
+        }
+#endif // AZ_HAS_INITIALIZERS_LIST
+
+        AZ_FORCE_INLINE size_type   size() const        { return m_last - m_start; }
+        AZ_FORCE_INLINE size_type   max_size() const    { return m_allocator.get_max_size() / sizeof(node_type); }
+        AZ_FORCE_INLINE bool        empty() const       { return m_start == m_last; }
+
+        void reserve(size_type numElements)
+        {
+            if (numElements > size_type(m_end - m_start))
+            {
+                size_type expandedSize = expand_in_place(numElements);
+                if (numElements > size_type(m_end - m_start))
+                {
+                    reallocate(m_last, 0, numElements, expandedSize);
+                }
+            }
+        }
+        /// Releases the unused capacity, elements are moved back to the inline buffer when they fit in it.
+        void shrink_to_fit()
+        {
+            set_capacity(m_last - m_start);
+        }
+        AZ_FORCE_INLINE size_type               capacity() const    { return m_end - m_start; }
+
+        AZ_FORCE_INLINE iterator                begin()             { return iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_start)); }
+        AZ_FORCE_INLINE const_iterator          begin() const       { return const_iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_start)); }
+        AZ_FORCE_INLINE iterator                end()               { return iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_last)); }
+        AZ_FORCE_INLINE const_iterator          end() const         { return const_iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_last)); }
+
+        AZ_FORCE_INLINE reverse_iterator        rbegin()            { return reverse_iterator(end()); }
+        AZ_FORCE_INLINE const_reverse_iterator  rbegin() const      { return const_reverse_iterator(end()); }
+        AZ_FORCE_INLINE reverse_iterator        rend()              { return reverse_iterator(begin()); }
+        AZ_FORCE_INLINE const_reverse_iterator  rend() const        { return const_reverse_iterator(begin()); }
+
+        AZ_FORCE_INLINE const_iterator          cbegin() const      { return const_iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_start)); }
+        AZ_FORCE_INLINE const_iterator          cend() const        { return const_iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_last)); }
+        AZ_FORCE_INLINE const_reverse_iterator  crbegin() const     { return const_reverse_iterator(end()); }
+        AZ_FORCE_INLINE const_reverse_iterator  crend() const       { return const_reverse_iterator(begin()); }
+
+        AZ_FORCE_INLINE void resize(size_type newSize)
+        {
+            size_type size = m_last - m_start;
+            if (size < newSize)
+            {
+                reserve(newSize);
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+                orphan_range(m_last, m_last);
+#endif
+                pointer newLast = m_start + newSize;
+                // We always want to construct default value even for integral types, according to the standard
+                Internal::construct<pointer, value_type, AZStd::false_type>::range(m_last, newLast);
+                m_last = newLast;
+            }
+            else if (newSize < size)
+            {
+                erase(const_iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_start)) + newSize, const_iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_last)));
+            }
+        }
+
+        /*!
+        * Extension it will set the increase size without calling default constructors.
+        * This is provided so we can use the small_vector as a generic buffer where we don't have to pay the cost of elements that we will construct over.
+        */
+        void resize_no_construct(size_type newSize)
+        {
+            size_type size = m_last - m_start;
+            if (size < newSize)
+            {
+                reserve(newSize);
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+                orphan_range(m_last, m_last);
+#endif
+                m_last = m_start + newSize;
+            }
+            else if (newSize < size)
+            {
+                erase(const_iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_start)) + newSize, const_iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_last)));
+            }
+        }
+
+        AZ_FORCE_INLINE void resize(size_type newSize, const_reference value)
+        {
+            size_type size = m_last - m_start;
+            if (size < newSize)
+            {
+                insert(const_iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_last)), newSize - size, value);
+            }
+            else if (newSize < size)
+            {
+                erase(const_iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_start)) + newSize, const_iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_last)));
+            }
+        }
+
+        AZ_FORCE_INLINE reference at(size_type position)
+        {
+            AZSTD_CONTAINER_ASSERT(position < size_type(m_last - m_start), "AZStd::small_vector<>::at - position is out of range");
+            return *(m_start + position);
+        }
+        AZ_FORCE_INLINE const_reference at(size_type position) const
+        {
+            AZSTD_CONTAINER_ASSERT(position < size_type(m_last - m_start), "AZStd::small_vector<>::at - position is out of range");
+            return *(m_start + position);
+        }
+
+        AZ_FORCE_INLINE reference operator[](size_type position)
+        {
+            AZSTD_CONTAINER_ASSERT(position < size_type(m_last - m_start), "AZStd::small_vector<>::at - position is out of range");
+            return *(m_start + position);
+        }
+        AZ_FORCE_INLINE const_reference operator[](size_type position) const
+        {
+            AZSTD_CONTAINER_ASSERT(position < size_type(m_last - m_start), "AZStd::small_vector<>::at - position is out of range");
+            return *(m_start + position);
+        }
+
+        AZ_FORCE_INLINE reference       front()         { AZSTD_CONTAINER_ASSERT(m_last != m_start, "AZStd::small_vector<>::front - container is empty!"); return *m_start; }
+        AZ_FORCE_INLINE const_reference front() const   { AZSTD_CONTAINER_ASSERT(m_last != m_start, "AZStd::small_vector<>::front - container is empty!"); return *m_start; }
+        AZ_FORCE_INLINE reference       back()          { AZSTD_CONTAINER_ASSERT(m_last != m_start, "AZStd::small_vector<>::back - container is empty!"); return *(m_last - 1); }
+        AZ_FORCE_INLINE const_reference back() const    { AZSTD_CONTAINER_ASSERT(m_last != m_start, "AZStd::small_vector<>::back - container is empty!"); return *(m_last - 1); }
+
+        inline void     push_back(const_reference value)
+        {
+            if (m_last != m_end)
+            {
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+                orphan_range(m_last, m_last);
+#endif
+                AZStd::uninitialized_fill_n(m_last, 1, value, Internal::is_fast_fill<pointer>());
+                ++m_last;
+            }
+            else
+            {
+                insert(end(), value);
+            }
+        }
+
+        inline void     pop_back()
+        {
+            AZSTD_CONTAINER_ASSERT(m_start != m_last, "AZStd::small_vector<>::pop_back - no element to pop!");
+            pointer toDestroy = m_last - 1;
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            orphan_range(toDestroy, m_last);
+#endif
+            Internal::destroy<pointer>::single(toDestroy);
+            m_last = toDestroy;
+        }
+
+        inline void     assign(size_type numElements, const_reference value)
+        {
+            value_type valueCopy = value;   // in case value is in sequence
+            clear();
+            insert(begin(), numElements, valueCopy);
+        }
+
+        template<class InputIterator>
+        AZ_FORCE_INLINE void        assign(const InputIterator& first, const InputIterator& last)
+        {
+            assign_iter(first, last, is_integral<InputIterator>());
+        }
+
+#if defined(AZ_HAS_INITIALIZERS_LIST)
+        AZ_FORCE_INLINE void        assign(std::initializer_list<T> list)
+        {
+            assign_iter(list.begin(), list.end(), is_integral<std::initializer_list<T> >());
+        }
+#endif // AZ_HAS_INITIALIZERS_LIST
+
+        inline iterator insert(const_iterator insertPos, const_reference value)
+        {
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            const_pointer insertPosPtr = insertPos.get_iterator();
+#else
+            const_pointer insertPosPtr = insertPos;
+#endif
+            size_type offset = insertPosPtr - m_start;
+            insert(insertPos, (size_type)1, value);
+            return iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_start)) + offset;
+        }
+
+        void    insert(const_iterator insertPos, size_type numElements, const_reference value)
+        {
+            if (numElements == 0)
+            {
+                return;
+            }
+
+            const_pointer valuePtr = AZStd::addressof(value);
+            if (valuePtr >= m_start && valuePtr < m_last)
+            {
+                // value is in the vector make a copy first, so we can move the elements around freely.
+                value_type valueCopy = value;
+                insert(insertPos, numElements, valueCopy);
+                return;
+            }
+
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            pointer insertPosPtr = const_cast<pointer>(insertPos.get_iterator());
+#else
+            pointer insertPosPtr = const_cast<pointer>(insertPos);
+#endif
+            size_type newSize = size_type(m_last - m_start) + numElements;
+            if (size_type(m_end - m_start) < newSize)
+            {
+                size_type offset = insertPosPtr - m_start;
+                size_type expandedSize = expand_in_place(newSize);
+                if (size_type(m_end - m_start) < newSize)
+                {
+                    // Not enough room so reallocate, leaving a gap for the new elements.
+                    pointer gap = reallocate(insertPosPtr, numElements, grow_capacity(newSize), expandedSize);
+                    AZStd::uninitialized_fill_n(gap, numElements, value, Internal::is_fast_fill<pointer>());
+                    return;
+                }
+                insertPosPtr = m_start + offset;
+            }
+
+            if (size_type(m_last - insertPosPtr) < numElements)
+            {
+                // Number of elements we can just set not init needed.
+                size_type numInitializedToFill = size_type(m_last - insertPosPtr);
+
+                // Move the elements after insert position.
+                pointer newLast = AZStd::uninitialized_move(insertPosPtr, m_last, insertPosPtr + numElements, Internal::is_fast_copy<pointer, pointer>());
+
+                // Add new elements to uninitialized elements.
+                AZStd::uninitialized_fill_n(m_last, numElements - numInitializedToFill, value, Internal::is_fast_fill<pointer>());
+
+                // Add new data
+                Internal::fill_n(insertPosPtr, numInitializedToFill, value, Internal::is_fast_fill<pointer>());
+
+                m_last = newLast;
+            }
+            else
+            {
+                pointer nonOverlap = m_last - numElements;
+
+                // first copy the data that will not overlap.
+                pointer newLast = AZStd::uninitialized_move(nonOverlap, m_last, m_last, Internal::is_fast_copy<pointer, pointer>());
+
+                // move the area with overlapping
+                Internal::move_backward(insertPosPtr, nonOverlap, m_last, Internal::is_fast_copy<pointer, pointer>());
+
+                // add new elements
+                Internal::fill_n(insertPosPtr, numElements, value, Internal::is_fast_fill<pointer>());
+
+                m_last = newLast;
+            }
+
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            orphan_range(insertPosPtr, m_last);
+#endif
+        }
+
+        template<class InputIterator>
+        AZ_FORCE_INLINE void        insert(const_iterator insertPos, const InputIterator& first, const InputIterator& last)
+        {
+            insert_impl(insertPos, first, last, is_integral<InputIterator>());
+        }
+
+#if defined(AZ_HAS_INITIALIZERS_LIST)
+        AZ_FORCE_INLINE void insert(const_iterator insertPos, std::initializer_list<T> ilist)
+        {
+            insert_impl(insertPos, ilist.begin(), ilist.end(), is_integral<std::initializer_list<T> >());
+        }
+#endif // AZ_HAS_INITIALIZERS_LIST
+
+        inline iterator erase(const_iterator elementIter)
+        {
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            pointer element = const_cast<pointer>(elementIter.get_iterator());
+            orphan_range(element, m_last);
+#else
+            pointer element = const_cast<pointer>(elementIter);
+#endif
+            size_type offset = element - m_start;
+            // unless we have 1 elements we have memory overlapping, so we need to use move.
+            Internal::move(element + 1, m_last, element, Internal::is_fast_copy<pointer, pointer>());
+            --m_last;
+            Internal::destroy<pointer>::single(m_last);
+
+            return iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_start)) + offset;
+        }
+
+        inline iterator erase(const_iterator first, const_iterator last)
+        {
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            pointer firstPtr = const_cast<pointer>(first.get_iterator());
+            pointer lastPtr = const_cast<pointer>(last.get_iterator());
+            orphan_range(firstPtr, m_last);
+#else
+            pointer firstPtr = const_cast<pointer>(first);
+            pointer lastPtr = const_cast<pointer>(last);
+#endif
+
+            size_type offset = firstPtr - m_start;
+            if (firstPtr == lastPtr)
+            {
+                // nothing to erase, don't move the elements onto themselves.
+                return iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_start)) + offset;
+            }
+            // unless we have 1 elements we have memory overlapping, so we need to use move.
+            pointer newLast = Internal::move(lastPtr, m_last, firstPtr, Internal::is_fast_copy<pointer, pointer>());
+            Internal::destroy<pointer>::range(newLast, m_last);
+            m_last = newLast;
+            return iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_start)) + offset;
+        }
+
+        /// Destroys all elements, the capacity is kept (call shrink_to_fit to go back to the inline buffer).
+        AZ_FORCE_INLINE void        clear()
+        {
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            orphan_all();
+#endif
+            Internal::destroy<pointer>::range(m_start, m_last);
+            m_last = m_start;
+        }
+
+        /// Swaps the content with any small vector of the same type, the inline capacities don't need to match.
+        void        swap(this_type& rhs)
+        {
+            if (this == &rhs)
+            {
+                return;
+            }
+            if (!is_inline() && !rhs.is_inline() && m_allocator == rhs.m_allocator &&
+                size_type(m_end - m_start) > rhs.m_inlineCapacity && size_type(rhs.m_end - rhs.m_start) > m_inlineCapacity)
+            {
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+                swap_all(rhs);
+#endif
+                // Both use allocated blocks from the same allocator (big enough for the other side), swap them.
+                AZStd::swap(m_start, rhs.m_start);
+                AZStd::swap(m_last, rhs.m_last);
+                AZStd::swap(m_end, rhs.m_end);
+            }
+            else
+            {
+                // Swap the common elements in place and move the rest to the shorter vector.
+                this_type* shorter = this;
+                this_type* longer = &rhs;
+                if (size() > rhs.size())
+                {
+                    AZStd::swap(shorter, longer);
+                }
+                size_type numCommon = shorter->size();
+                for (size_type i = 0; i < numCommon; ++i)
+                {
+                    AZStd::swap(m_start[i], rhs.m_start[i]);
+                }
+                shorter->reserve(longer->size());
+                for (pointer element = longer->m_start + numCommon; element != longer->m_last; ++element)
+                {
+#ifdef AZ_HAS_RVALUE_REFS
+                    shorter->push_back(AZStd::move(*element));
+#else
+                    shorter->push_back(*element);
+#endif
+                }
+                longer->erase(longer->begin() + numCommon, longer->end());
+            }
+        }
+
+        /**
+         * \anchor SmallVectorExtensions
+         * \name Extensions
+         * @{
+         */
+
+        /// TR1 Extension. Return pointer to the vector data. The vector data is guaranteed to be stored as an array.
+        AZ_FORCE_INLINE pointer         data()          { return m_start; }
+        AZ_FORCE_INLINE const_pointer   data() const    { return m_start; }
+
+        /// The only difference from the standard is that we return the allocator instance, not a copy.
+        AZ_FORCE_INLINE allocator_type&         get_allocator()         { return m_allocator; }
+        AZ_FORCE_INLINE const allocator_type&   get_allocator() const   { return m_allocator; }
+        /// Set the vector allocator. If different than then current all allocated elements will be reallocated.
+        void                                    set_allocator(const allocator_type& allocator)
+        {
+            if (m_allocator != allocator)
+            {
+                if (!is_inline())
+                {
+                    allocator_type newAllocator = allocator;
+                    size_type size = m_last - m_start;
+                    pointer newStart = m_inlineStart;
+                    size_type newCapacity = m_inlineCapacity;
+                    if (size > m_inlineCapacity)
+                    {
+                        newStart = reinterpret_cast<pointer>(newAllocator.allocate(sizeof(node_type) * size, alignment_of<node_type>::value));
+                        newCapacity = size;
+                    }
+                    pointer newLast = AZStd::uninitialized_move(m_start, m_last, newStart, Internal::is_fast_copy<pointer, pointer>());
+
+                    // destroy objects
+                    Internal::destroy<pointer>::range(m_start, m_last);
+                    // Free memory (if needed).
+                    deallocate_memory(typename allocator_type::allow_memory_leaks(), 0);
+
+                    m_start = newStart;
+                    m_last  = newLast;
+                    m_end   = newStart + newCapacity;
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+                    orphan_all();
+#endif
+                }
+
+                m_allocator = allocator;
+            }
+        }
+
+        /// Returns the number of elements we can store without allocating memory.
+        AZ_FORCE_INLINE size_type   inline_capacity() const { return m_inlineCapacity; }
+        /// Returns true if the elements are stored in the inline buffer.
+        AZ_FORCE_INLINE bool        is_inline() const       { return m_start == m_inlineStart; }
+
+        // Validate container status.
+        AZ_FORCE_INLINE bool    validate() const
+        {
+            if (m_last > m_end || m_start > m_last)
+            {
+                return false;
+            }
+            if (is_inline() ? (m_end != m_inlineStart + m_inlineCapacity) : (size_type(m_end - m_start) <= m_inlineCapacity))
+            {
+                return false;
+            }
+            return true;
+        }
+        /// Validates an iter iterator. Returns a combination of \ref iterator_status_flag.
+        AZ_FORCE_INLINE int     validate_iterator(const iterator& iter) const
+        {
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            AZ_Assert(iter.m_container == this, "Iterator doesn't belong to this container");
+            pointer iterPtr = iter.m_iter;
+#else
+            pointer iterPtr = iter;
+#endif
+            if (iterPtr < m_start || iterPtr > m_last)
+            {
+                return isf_none;
+            }
+            else if (iterPtr == m_last)
+            {
+                return isf_valid;
+            }
+
+            return isf_valid | isf_can_dereference;
+        }
+        AZ_FORCE_INLINE int     validate_iterator(const const_iterator& iter) const
+        {
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            AZ_Assert(iter.m_container == this, "Iterator doesn't belong to this container");
+            const_pointer iterPtr = iter.m_iter;
+#else
+            const_pointer iterPtr = iter;
+#endif
+            if (iterPtr < m_start || iterPtr > m_last)
+            {
+                return isf_none;
+            }
+            else if (iterPtr == m_last)
+            {
+                return isf_valid;
+            }
+
+            return isf_valid | isf_can_dereference;
+        }
+        AZ_FORCE_INLINE int     validate_iterator(const reverse_iterator& iter) const       { return validate_iterator(iter.base()); }
+        AZ_FORCE_INLINE int     validate_iterator(const const_reverse_iterator& iter) const { return validate_iterator(iter.base()); }
+
+        /**
+         *  Pushes an element at the end of the vector without a provided instance. This can be used for value types
+         *  with expensive constructors so we don't want to create temporary one.
+         */
+        inline void push_back()
+        {
+            if (m_last == m_end)
+            {
+                grow(size_type(m_last - m_start) + 1);
+            }
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            orphan_range(m_last, m_last);
+#endif
+            Internal::construct<pointer>::single(m_last);
+            ++m_last;
+        }
+
+        /**
+        * Resets the container to the inline buffer without deallocating any memory or calling any destructor.
+        * This function should be used when we need very quick tear down. Generally it's used for temporary vectors and we can just nuke them that way.
+        */
+        AZ_FORCE_INLINE void leak_and_reset()
+        {
+            m_start = m_inlineStart;
+            m_last = m_inlineStart;
+            m_end = m_inlineStart + m_inlineCapacity;
+
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            orphan_all();
+#endif
+        }
+
+        /**
+         * Set the capacity of the vector, if necessary it will destroy elements at the end of the container to match the new capacity.
+         * The capacity never drops below the inline capacity, elements are moved back to the inline buffer when they fit in it.
+         */
+        void                set_capacity(size_type numElements)
+        {
+            if (numElements < m_inlineCapacity)
+            {
+                numElements = m_inlineCapacity;
+            }
+            if (numElements < size_type(m_last - m_start))
+            {
+                erase(const_iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_start)) + numElements, const_iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_last)));
+            }
+            if (numElements > size_type(m_end - m_start))
+            {
+                reserve(numElements);
+            }
+            else if (numElements < size_type(m_end - m_start))
+            {
+                // we are not inline, as the inline capacity is the smallest one.
+                reallocate(m_last, 0, numElements, 0);
+            }
+        }
+
+        /// @}
+    protected:
+        small_vector_base(pointer inlineStart, size_type inlineCapacity)
+            : m_start(inlineStart)
+            , m_last(inlineStart)
+            , m_end(inlineStart + inlineCapacity)
+            , m_inlineStart(inlineStart)
+            , m_inlineCapacity(inlineCapacity)
+        {}
+
+        small_vector_base(pointer inlineStart, size_type inlineCapacity, const allocator_type& allocator)
+            : m_start(inlineStart)
+            , m_last(inlineStart)
+            , m_end(inlineStart + inlineCapacity)
+            , m_allocator(allocator)
+            , m_inlineStart(inlineStart)
+            , m_inlineCapacity(inlineCapacity)
+        {}
+
+        /// The elements are destroyed by the small_vector (\ref destroy_storage), as it owns the inline buffer.
+        ~small_vector_base() {}
+
+        void destroy_storage()
+        {
+            // Call destructor if we need to.
+            Internal::destroy<pointer>::range(m_start, m_last);
+            if (!is_inline())
+            {
+                // Free memory if we need to.
+                deallocate_memory(typename allocator_type::allow_memory_leaks(), 0);
+            }
+        }
+
+        void construct_fill(size_type numElements, const_reference value)
+        {
+            reserve(numElements);
+            AZStd::uninitialized_fill_n(m_start, numElements, value, Internal::is_fast_fill<pointer>());
+            m_last = m_start + numElements;
+        }
+
+        template <class InputIterator>
+        AZ_FORCE_INLINE void    construct_iter(const InputIterator& first, const InputIterator& last, const true_type& /* is_integral<InputIterator> */)
+        {
+            // ok so we did not really mean iterators when the called this function.
+            construct_fill((size_type)first, (value_type)last);
+        }
+
+        template <class InputIterator>
+        AZ_FORCE_INLINE void    construct_iter(const InputIterator& first, const InputIterator& last, const false_type& /* !is_integral<InputIterator> */)
+        {
+            insert(const_iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_start)), first, last);
+        }
+
+    private:
+        small_vector_base(const this_type&);    // Copy a small_vector instead.
+
+        //#pragma region Deallocate memory specializations
+        AZ_FORCE_INLINE void    deallocate_memory(const true_type& /* allocator::allow_memory_leaks */, size_type /*expandedSize*/)
+        {
+        }
+
+        AZ_FORCE_INLINE void    deallocate_memory(const false_type& /* !allocator::allow_memory_leaks */, size_type expandedSize)
+        {
+            size_type byteSize = (expandedSize == 0) ? (sizeof(node_type) * (m_end - m_start)) : expandedSize;
+            m_allocator.deallocate(m_start, byteSize, alignment_of<node_type>::value);
+        }
+        //#pragma endregion
+
+        //#pragma region Growing
+        /// Returns the capacity to grow to, so we can store newSize elements (grow by 50%, if we can).
+        AZ_FORCE_INLINE size_type grow_capacity(size_type newSize) const
+        {
+            size_type capacity = m_end - m_start;
+            capacity += capacity / 2;
+            return capacity < newSize ? newSize : capacity;
+        }
+
+        /// If we have an allocated block and we need more memory, try to expand it first. Returns the expanded block size or 0.
+        size_type expand_in_place(size_type numElements)
+        {
+            size_type expandedSize = 0;
+            if (!is_inline())
+            {
+                expandedSize = m_allocator.resize(m_start, numElements * sizeof(node_type));
+                if (expandedSize % sizeof(node_type) == 0) // we need exact size to be able to compute the size on free
+                {
+                    size_type expandedCapacity = expandedSize / sizeof(node_type);
+                    if (size_type(m_end - m_start) < expandedCapacity)
+                    {
+                        m_end = m_start + expandedCapacity;
+                    }
+                }
+            }
+            return expandedSize;
+        }
+
+        void grow(size_type newSize)
+        {
+            size_type expandedSize = expand_in_place(newSize);
+            if (size_type(m_end - m_start) < newSize)
+            {
+                reallocate(m_last, 0, grow_capacity(newSize), expandedSize);
+            }
+        }
+
+        /**
+         * Moves the elements to a block with newCapacity elements, leaving numElements uninitialized elements at insertPosPtr.
+         * When newCapacity fits in the inline buffer (we must not be inline already) the elements go back to it. Returns the start of the gap.
+         */
+        pointer reallocate(pointer insertPosPtr, size_type numElements, size_type newCapacity, size_type expandedSize)
+        {
+            pointer newStart;
+            if (newCapacity <= m_inlineCapacity)
+            {
+                AZSTD_CONTAINER_ASSERT(!is_inline(), "AZStd::small_vector::reallocate - elements are already in the inline buffer!");
+                newStart = m_inlineStart;
+                newCapacity = m_inlineCapacity;
+            }
+            else
+            {
+                newStart = reinterpret_cast<pointer>(m_allocator.allocate(sizeof(node_type) * newCapacity, alignment_of<node_type>::value));
+            }
+
+            // Move the elements before insert position.
+            pointer gap = AZStd::uninitialized_move(m_start, insertPosPtr, newStart, Internal::is_fast_copy<pointer, pointer>());
+            // Move the elements after the insert position.
+            pointer newLast = AZStd::uninitialized_move(insertPosPtr, m_last, gap + numElements, Internal::is_fast_copy<pointer, pointer>());
+
+            // Destroy old array
+            Internal::destroy<pointer>::range(m_start, m_last);
+            if (!is_inline())
+            {
+                // Free memory (if needed).
+                deallocate_memory(typename allocator_type::allow_memory_leaks(), expandedSize);
+            }
+
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            orphan_all();
+#endif
+            m_start = newStart;
+            m_last  = newLast;
+            m_end   = newStart + newCapacity;
+            return gap;
+        }
+        //#pragma endregion
+
+        //#pragma region Insert iterator specializations
+        template<class Iterator>
+        AZ_FORCE_INLINE void insert_impl(const_iterator insertPos, const Iterator& first, const Iterator& last, const true_type& /* is_integral<Iterator> */)
+        {
+            // we actually are calling this with integral types.
+            insert(insertPos, (size_type)first, (const_reference)last);
+        }
+
+        template<class Iterator>
+        AZ_FORCE_INLINE void insert_impl(const_iterator insertPos, const Iterator& first, const Iterator& last, const false_type& /* is_integral<Iterator> */)
+        {
+            // specialize for specific interators.
+            insert_iter(insertPos, first, last, typename iterator_traits<Iterator>::iterator_category());
+        }
+
+        template<class Iterator>
+        void insert_iter(const_iterator insertPos, const Iterator& first, const Iterator& last, const forward_iterator_tag&)
+        {
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            pointer insertPosPtr = const_cast<pointer>(insertPos.get_iterator());
+#else
+            pointer insertPosPtr = const_cast<pointer>(insertPos);
+#endif
+
+            size_type numElements = distance(first, last, typename iterator_traits<Iterator>::iterator_category());
+            if (numElements == 0)
+            {
+                return;
+            }
+
+            size_type newSize = size_type(m_last - m_start) + numElements;
+            if (size_type(m_end - m_start) < newSize)
+            {
+                size_type offset = insertPosPtr - m_start;
+                size_type expandedSize = expand_in_place(newSize);
+                if (size_type(m_end - m_start) < newSize)
+                {
+                    // No enough room, reallocate leaving a gap for the new elements.
+                    pointer gap = reallocate(insertPosPtr, numElements, grow_capacity(newSize), expandedSize);
+                    AZStd::uninitialized_copy(first, last, gap, Internal::is_fast_copy<Iterator, pointer>());
+                    return;
+                }
+                insertPosPtr = m_start + offset;
+            }
+
+            if (size_type(m_last - insertPosPtr) < numElements)
+            {
+                // Copy the elements after insert position.
+                pointer newLast = AZStd::uninitialized_move(insertPosPtr, m_last, insertPosPtr + numElements, Internal::is_fast_copy<pointer, pointer>());
+
+                // Number of elements we can assign.
+                size_type numInitializedToFill = size_type(m_last - insertPosPtr);
+
+                // get last iterator to fill
+                Iterator lastToAssign = first;
+                AZStd::advance(lastToAssign, numInitializedToFill);
+
+                // Add new elements to uninitialized elements.
+                AZStd::uninitialized_copy(lastToAssign, last, m_last, Internal::is_fast_copy<Iterator, pointer>());
+
+                m_last = newLast;
+
+                // Add assign new data
+                Internal::copy(first, lastToAssign, insertPosPtr, Internal::is_fast_copy<Iterator, pointer>());
+            }
+            else
+            {
+                // first copy the data that will not overlap.
+                pointer nonOverlap = m_last - numElements;
+                pointer newLast = AZStd::uninitialized_move(nonOverlap, m_last, m_last, Internal::is_fast_copy<pointer, pointer>());
+
+                // move the area with overlapping
+                Internal::move_backward(insertPosPtr, nonOverlap, m_last, Internal::is_fast_copy<pointer, pointer>());
+
+                // add new elements
+                Internal::copy(first, last, insertPosPtr, Internal::is_fast_copy<Iterator, pointer>());
+
+                m_last = newLast;
+            }
+
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+            orphan_range(insertPosPtr, m_last);
+#endif
+        }
+
+        template<class Iterator>
+        inline void insert_iter(const_iterator insertPos, const Iterator& first, const Iterator& last, const input_iterator_tag&)
+        {
+            const_iterator start(AZSTD_POINTER_ITERATOR_PARAMS(m_start));
+            size_type offset = AZStd::distance(start, insertPos);
+
+            Iterator iter(first);
+            for (; iter != last; ++iter, ++offset)
+            {
+                insert(const_iterator(AZSTD_POINTER_ITERATOR_PARAMS(m_start)) + offset, *iter);
+            }
+        }
+        //#pragma endregion
+
+        //#pragma region Assign iterator specializations (assign_iter)
+        template <class InputIterator>
+        AZ_FORCE_INLINE void    assign_iter(const InputIterator& numElements, const InputIterator& value, const true_type& /* is_integral<InputIterator> */)
+        {
+            assign((size_type)numElements, value);
+        }
+
+        template <class InputIterator>
+        AZ_FORCE_INLINE void    assign_iter(const InputIterator& first, const InputIterator& last, const false_type& /* !is_integral<InputIterator> */)
+        {
+            clear();
+            insert(begin(), first, last);
+        }
+        //#pragma endregion
+
+    protected:
+        pointer         m_start;            ///< Pointer to the first element, either the inline buffer or an allocated block.
+        pointer         m_last;             ///< Pointer after the last used element.
+        pointer         m_end;              ///< Pointer after the last available element.
+        allocator_type  m_allocator;        ///< Instance of the allocator.
+        pointer         m_inlineStart;      ///< Inline buffer of the small_vector.
+        size_type       m_inlineCapacity;   ///< Number of elements in the inline buffer.
+
+        // Debug
+#ifdef AZSTD_HAS_CHECKED_ITERATORS
+        inline void orphan_range(pointer first, pointer last) const
+        {
+#ifdef AZSTD_CHECKED_ITERATORS_IN_MULTI_THREADS
+            AZ_GLOBAL_SCOPED_LOCK(get_global_section());
+#endif
+            Debug::checked_iterator_base* iter = m_iteratorList;
+            while (iter != 0)
+            {
+                AZ_Assert(iter->m_container == static_cast<const checked_container_base*>(this), "small_vector::orphan_range - iterator was corrupted!");
+                pointer iterPtr = static_cast<iterator*>(iter)->m_iter;
+
+                if (iterPtr >= first && iterPtr <= last)
+                {
+                    // orphan the iterator
+                    iter->m_container = 0;
+
+                    if (iter->m_prevIterator)
+                    {
+                        iter->m_prevIterator->m_nextIterator = iter->m_nextIterator;
+                    }
+                    else
+                    {
+                        m_iteratorList = iter->m_nextIterator;
+                    }
+
+                    if (iter->m_nextIterator)
+                    {
+                        iter->m_nextIterator->m_prevIterator = iter->m_prevIterator;
+                    }
+                }
+
+                iter = iter->m_nextIterator;
+            }
+        }
+#endif
+    };
+
+    /**
+     * Vector with inline storage for N elements (AKA small buffer optimization). As long as the size is within N
+     * no memory is allocated, after that the elements spill to the allocator. Unlike the \ref fixed_vector it can hold any
+     * number of elements, so it's a good fit for temporary lists that are usually small. It has the complete \ref vector
+     * interface (see \ref small_vector_base) and converts to small_vector_base<T, Allocator>&, so functions can take
+     * small vectors with any inline capacity.
+     * \note Moving a small_vector that uses the inline buffer moves the elements one by one, a vector would just swap pointers.
+     */
+    template< class T, AZStd::size_t N, class Allocator = AZStd::allocator >
+    class small_vector
+        : public small_vector_base<T, Allocator>
+    {
+        AZ_STATIC_ASSERT(N > 0, "small_vector needs an inline capacity, use vector otherwise!");
+
+        typedef small_vector<T, N, Allocator>            this_type;
+        typedef small_vector_base<T, Allocator>          base_type;
+    public:
+        //#pragma region Type definitions
+        typedef typename base_type::pointer             pointer;
+        typedef typename base_type::const_pointer       const_pointer;
+        typedef typename base_type::reference           reference;
+        typedef typename base_type::const_reference     const_reference;
+        typedef typename base_type::difference_type     difference_type;
+        typedef typename base_type::size_type           size_type;
+        typedef typename base_type::iterator            iterator;
+        typedef typename base_type::const_iterator      const_iterator;
+        typedef typename base_type::reverse_iterator    reverse_iterator;
+        typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+        typedef typename base_type::value_type          value_type;
+        typedef typename base_type::allocator_type      allocator_type;
+        typedef typename base_type::node_type           node_type;
+        //#pragma endregion
+
+        AZ_FORCE_INLINE small_vector()
+            : base_type(inline_start(), N)
+        {}
+
+        AZ_FORCE_INLINE explicit small_vector(const allocator_type& allocator)
+            : base_type(inline_start(), N, allocator)
+        {}
+
+        explicit small_vector(size_type numElements, const_reference value = value_type())
+            : base_type(inline_start(), N)
+        {
+            this->construct_fill(numElements, value);
+        }
+        small_vector(size_type numElements, const_reference value, const allocator_type& allocator)
+            : base_type(inline_start(), N, allocator)
+        {
+            this->construct_fill(numElements, value);
+        }
+
+        template <class InputIterator>
+        small_vector(const InputIterator& first, const InputIterator& last)
+            : base_type(inline_start(), N)
+        {
+            // We need some help here, since this function can be mistaken with the small_vector(size_type, const_reference value) one...
+            // so we need to handle this case.
+            this->construct_iter(first, last, is_integral<InputIterator>());
+        }
+        template <class InputIterator>
+        small_vector(const InputIterator& first, const InputIterator& last, const allocator_type& allocator)
+            : base_type(inline_start(), N, allocator)
+        {
+            this->construct_iter(first, last, is_integral<InputIterator>());
+        }
+#if defined(AZ_HAS_INITIALIZERS_LIST)
+        small_vector(std::initializer_list<T> list, const allocator_type& allocator = allocator_type())
+            : base_type(inline_start(), N, allocator)
+        {
+            this->construct_iter(list.begin(), list.end(), is_integral<std::initializer_list<T> >());
+        }
+#endif // #if defined(AZ_HAS_INITIALIZERS_LIST)
+
+        small_vector(const this_type& rhs)
+            : base_type(inline_start(), N, rhs.get_allocator())
+        {
+            this->construct_iter(rhs.begin(), rhs.end(), false_type());
+        }
+        /// Copy from a small vector with a different inline capacity.
+        small_vector(const base_type& rhs)
+            : base_type(inline_start(), N, rhs.get_allocator())
+        {
+            this->construct_iter(rhs.begin(), rhs.end(), false_type());
+        }
+
+#ifdef AZ_HAS_RVALUE_REFS
+        small_vector(this_type&& rhs)
+            : base_type(inline_start(), N, rhs.get_allocator())
+        {
+            this->assign_rv(AZStd::forward<this_type>(rhs));
+        }
+        small_vector(base_type&& rhs)
+            : base_type(inline_start(), N, rhs.get_allocator())
+        {
+            this->assign_rv(AZStd::forward<base_type>(rhs));
+        }
+        small_vector(base_type&& rhs, const allocator_type& allocator)
+            : base_type(inline_start(), N, allocator)
+        {
+            this->assign_rv(AZStd::forward<base_type>(rhs));
+        }
+        this_type& operator=(this_type&& rhs)
+        {
+            this->assign_rv(AZStd::forward<this_type>(rhs));
+            return *this;
+        }
+        this_type& operator=(base_type&& rhs)
+        {
+            this->assign_rv(AZStd::forward<base_type>(rhs));
+            return *this;
+        }
+#endif // AZ_HAS_RVALUE_REFS
+
+        ~small_vector()
+        {
+            this->destroy_storage();
+        }
+
+        // We must not use the default assignment, it will copy the inline buffer too.
+        this_type& operator=(const this_type& rhs)
+        {
+            base_type::operator=(rhs);
+            return *this;
+        }
+        this_type& operator=(const base_type& rhs)
+        {
+            base_type::operator=(rhs);
+            return *this;
+        }
+#if defined(AZ_HAS_INITIALIZERS_LIST)
+        this_type& operator=(std::initializer_list<T> list)
+        {
+            this->assign(list.begin(), list.end());
+            return *this;
+        }
+#endif // AZ_HAS_INITIALIZERS_LIST
+
+    private:
+        AZ_FORCE_INLINE pointer inline_start() { return reinterpret_cast<pointer>(&m_inlineData); }
+
+        typename aligned_storage<N* sizeof(T), alignment_of<T>::value>::type   m_inlineData;    ///< Inline buffer for the first N elements.
+    };
+
+    //#pragma region Small vector equality/inequality
+    template <class T, class Allocator>
+    AZ_FORCE_INLINE bool operator==(const small_vector_base<T, Allocator>& a, const small_vector_base<T, Allocator>& b)
+    {
+        return (a.size() == b.size() && equal(a.begin(), a.end(), b.begin()));
+    }
+
+    template <class T, class Allocator>
+    AZ_FORCE_INLINE bool operator!=(const small_vector_base<T, Allocator>& a, const small_vector_base<T, Allocator>& b)
+    {
+        return !(a == b);
+    }
+    //#pragma endregion
+}
+
+#endif // AZSTD_SMALL_VECTOR_H
+#pragma once
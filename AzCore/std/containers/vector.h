@@ -27,7 +27,7 @@ namespace AZStd
     * every time the 50% more memory then then current number of elements. This way to insert ~1000 elements
     * 1 by 1 it will take 17 allocations. Of course if you know that in advance it will be smart to set the
     * capacity in advance, this way you will have only 1 allocation \ref AZStdExamples.
-    * When you need a vector with preset capacity use \ref fixed_vector.
+    * When you need a vector with preset capacity use \ref fixed_vector, for short lists that can still grow use \ref small_vector.
     */
     template< class T, class Allocator = AZStd::allocator >
     class vector
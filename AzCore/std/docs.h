@@ -447,6 +447,9 @@ namespace AZStd
      * \li forward_list
      * \li rope
      * \li ring_buffer
+     * \li flat_hash_set
+     * \li flat_hash_map
+     * \li small_vector
      *
      * \subsection FixedContainers Fixed containers
      * \li fixed_vector
@@ -462,6 +465,8 @@ namespace AZStd
      * \li fixed_unordered_multiset
      * \li fixed_unordered_map
      * \li fixed_unordered_multimap
+     * \li fixed_flat_hash_set
+     * \li fixed_flat_hash_map
      *
      * \subsection IntrusiveContainers Intrusive containers
      * Intrusive containers never allocate any memory, destroy or create any objects. Just uses the provided nodes via the hook
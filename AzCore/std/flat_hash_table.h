@@ -0,0 +1,1113 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZSTD_FLAT_HASH_TABLE_H
+#define AZSTD_FLAT_HASH_TABLE_H 1
+
+#include <AzCore/std/algorithm.h>
+#include <AzCore/std/hash.h>
+#include <AzCore/std/utils.h>
+#include <AzCore/std/functional_basic.h>
+#include <AzCore/std/createdestroy.h>
+#include <AzCore/std/typetraits/aligned_storage.h>
+#include <AzCore/std/typetraits/alignment_of.h>
+#include <AzCore/Math/MathUtils.h>
+
+#if defined(AZ_PLATFORM_WINDOWS) || defined(AZ_PLATFORM_XBONE) || defined(AZ_PLATFORM_PS4) || defined(AZ_PLATFORM_LINUX) || defined(AZ_PLATFORM_APPLE_OSX) // ACCEPTED_USE
+#   define AZSTD_FLAT_HASH_TABLE_SSE2
+#   include <emmintrin.h>
+#endif
+
+namespace AZStd
+{
+    template<class Traits>
+    class flat_hash_table;
+
+    namespace Internal
+    {
+        /**
+         * Control byte values. Full slots store the low 7 bits of the element hash (0..127), everything else is negative.
+         * The sentinel marks the end of the control array, it's used to stop iteration.
+         */
+        enum flat_hash_control
+        {
+            flat_hash_empty = -128,
+            flat_hash_deleted = -2,
+            flat_hash_sentinel = -1,
+        };
+
+#if defined(AZSTD_FLAT_HASH_TABLE_SSE2)
+        /**
+         * A group of 16 control bytes that we match in parallel with SSE2. Masks have one bit per control byte.
+         */
+        struct flat_hash_group
+        {
+            enum
+            {
+                width = 16
+            };
+            typedef AZ::u32 mask_type;
+
+            AZ_FORCE_INLINE explicit flat_hash_group(const signed char* control)
+                : m_control(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control)))
+            {}
+
+            /// Returns the slots with that hash (control byte).
+            AZ_FORCE_INLINE mask_type match(signed char hash) const
+            {
+                return static_cast<mask_type>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(hash), m_control)));
+            }
+            AZ_FORCE_INLINE mask_type match_empty() const
+            {
+                return match(static_cast<signed char>(flat_hash_empty));
+            }
+            AZ_FORCE_INLINE mask_type match_empty_or_deleted() const
+            {
+                return static_cast<mask_type>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(static_cast<signed char>(flat_hash_sentinel)), m_control)));
+            }
+            /// Returns the number of empty or deleted slots at the start of the group.
+            AZ_FORCE_INLINE AZStd::size_t count_leading_empty_or_deleted() const
+            {
+                return AZ::CountTrailingZeros(~match_empty_or_deleted());
+            }
+
+            static AZ_FORCE_INLINE AZStd::size_t lowest(mask_type mask)      { return AZ::CountTrailingZeros(mask); }
+            static AZ_FORCE_INLINE AZStd::size_t highest(mask_type mask)     { return AZ::FloorLog2(mask); }
+            static AZ_FORCE_INLINE mask_type     clear_lowest(mask_type mask) { return mask & (mask - 1); }
+
+            __m128i m_control;
+        };
+#else
+        /**
+         * A group of 8 control bytes matched in parallel within a 64 bit integer. Masks have the high bit of each control byte set.
+         * \ref match can report false positives after a real match, which is fine since we compare the keys anyway.
+         */
+        struct flat_hash_group
+        {
+            enum
+            {
+                width = 8
+            };
+            typedef AZ::u64 mask_type;
+
+            static const AZ::u64 lsbs = 0x0101010101010101ull;
+            static const AZ::u64 msbs = 0x8080808080808080ull;
+
+            AZ_FORCE_INLINE explicit flat_hash_group(const signed char* control)
+                : m_control(0)
+            {
+                // compose in little endian order so the byte index is the same on all platforms
+                for (int i = 0; i < width; ++i)
+                {
+                    m_control |= static_cast<AZ::u64>(static_cast<unsigned char>(control[i])) << (i * 8);
+                }
+            }
+
+            AZ_FORCE_INLINE mask_type match(signed char hash) const
+            {
+                AZ::u64 x = m_control ^ (lsbs * static_cast<unsigned char>(hash));
+                return (x - lsbs) & ~x & msbs;
+            }
+            AZ_FORCE_INLINE mask_type match_empty() const
+            {
+                return (m_control & (~m_control << 6)) & msbs;
+            }
+            AZ_FORCE_INLINE mask_type match_empty_or_deleted() const
+            {
+                return (m_control & (~m_control << 7)) & msbs;
+            }
+            AZ_FORCE_INLINE AZStd::size_t count_leading_empty_or_deleted() const
+            {
+                const AZ::u64 gaps = 0x00FEFEFEFEFEFEFEull;
+                return (AZ::CountTrailingZeros(((~m_control & (m_control >> 7)) | gaps) + 1) + 7) >> 3;
+            }
+
+            static AZ_FORCE_INLINE AZStd::size_t lowest(mask_type mask)      { return AZ::CountTrailingZeros(mask) >> 3; }
+            static AZ_FORCE_INLINE AZStd::size_t highest(mask_type mask)     { return AZ::FloorLog2(mask) >> 3; }
+            static AZ_FORCE_INLINE mask_type     clear_lowest(mask_type mask) { return mask & (mask - 1); }
+
+            AZ::u64 m_control;
+        };
+#endif // AZSTD_FLAT_HASH_TABLE_SSE2
+
+        /**
+         * Control bytes of a table with no capacity, a sentinel followed by empty slots. Lookups stop on the first group
+         * and begin() == end(), so empty tables don't need any memory.
+         */
+        template<class T = void>
+        struct flat_hash_empty_group
+        {
+            static const signed char s_control[flat_hash_group::width];
+        };
+
+        template<class T>
+        const signed char flat_hash_empty_group<T>::s_control[flat_hash_group::width] =
+        {
+            flat_hash_sentinel, flat_hash_empty, flat_hash_empty, flat_hash_empty, flat_hash_empty, flat_hash_empty, flat_hash_empty, flat_hash_empty,
+#if defined(AZSTD_FLAT_HASH_TABLE_SSE2)
+            flat_hash_empty, flat_hash_empty, flat_hash_empty, flat_hash_empty, flat_hash_empty, flat_hash_empty, flat_hash_empty, flat_hash_empty,
+#endif
+        };
+
+        /// Max number of elements before we need to grow (or drop the deleted slots), this keeps the load factor at 7/8.
+        template<AZStd::size_t Capacity>
+        struct flat_hash_capacity_to_growth
+        {
+            // when there is no padding after the cloned control bytes we must keep at least one empty slot, so lookups terminate.
+            static const AZStd::size_t value = Capacity - Capacity / 8 - ((Capacity >= flat_hash_group::width - 1 && Capacity / 8 == 0) ? 1 : 0);
+        };
+
+        /// Smallest capacity (2^n - 1) that can store NumElements.
+        template<AZStd::size_t NumElements, AZStd::size_t Capacity = 1, bool IsEnough = (flat_hash_capacity_to_growth<Capacity>::value >= NumElements)>
+        struct flat_hash_fixed_capacity
+        {
+            static const AZStd::size_t value = Capacity;
+        };
+
+        template<AZStd::size_t NumElements, AZStd::size_t Capacity>
+        struct flat_hash_fixed_capacity<NumElements, Capacity, false>
+        {
+            static const AZStd::size_t value = flat_hash_fixed_capacity<NumElements, Capacity * 2 + 1>::value;
+        };
+
+        /**
+         * Flat hash table iterator. It walks the control bytes and skips the empty and deleted slots a group at a time.
+         */
+        template<class ValueType, class Pointer, class Reference>
+        class flat_hash_table_iterator
+        {
+            template<class Traits>
+            friend class AZStd::flat_hash_table;
+            template<class V, class P, class R>
+            friend class flat_hash_table_iterator;
+        public:
+            typedef ValueType                       value_type;
+            typedef AZStd::ptrdiff_t                difference_type;
+            typedef Pointer                         pointer;
+            typedef Reference                       reference;
+            typedef AZStd::forward_iterator_tag     iterator_category;
+
+            AZ_FORCE_INLINE flat_hash_table_iterator()
+                : m_control(nullptr)
+                , m_slot(nullptr)
+            {}
+            /// Converts an iterator to a const_iterator. A template, so it doesn't replace the implicit copy constructor/assignment.
+            template<class OtherPointer, class OtherReference>
+            AZ_FORCE_INLINE flat_hash_table_iterator(const flat_hash_table_iterator<ValueType, OtherPointer, OtherReference>& rhs,
+                typename AZStd::enable_if<AZStd::is_same<OtherPointer, ValueType*>::value>::type* = nullptr)
+                : m_control(rhs.m_control)
+                , m_slot(rhs.m_slot)
+            {}
+
+            AZ_FORCE_INLINE reference operator*() const     { return *m_slot; }
+            AZ_FORCE_INLINE pointer operator->() const      { return m_slot; }
+            AZ_FORCE_INLINE flat_hash_table_iterator& operator++()
+            {
+                ++m_control;
+                ++m_slot;
+                skip_empty_or_deleted();
+                return *this;
+            }
+            AZ_FORCE_INLINE flat_hash_table_iterator operator++(int)
+            {
+                flat_hash_table_iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            AZ_FORCE_INLINE bool operator==(const flat_hash_table_iterator& rhs) const  { return m_control == rhs.m_control; }
+            AZ_FORCE_INLINE bool operator!=(const flat_hash_table_iterator& rhs) const  { return m_control != rhs.m_control; }
+
+        protected:
+            AZ_FORCE_INLINE flat_hash_table_iterator(const signed char* control, ValueType* slot)
+                : m_control(control)
+                , m_slot(slot)
+            {}
+
+            AZ_FORCE_INLINE void skip_empty_or_deleted()
+            {
+                while (*m_control < flat_hash_sentinel)
+                {
+                    AZStd::size_t shift = flat_hash_group(m_control).count_leading_empty_or_deleted();
+                    m_control += shift;
+                    m_slot += shift;
+                }
+            }
+
+            const signed char*  m_control;
+            ValueType*          m_slot;
+        };
+
+        /**
+         * Flat hash table data storage class. It's different for dynamic and fixed hash tables, the dynamic one allocates
+         * the control bytes and the slots in one block, the fixed one has them inline.
+         * It's considered part of the hash table. Encapsulation is avoided to avoid too many function calls.
+         */
+        template<class Traits, bool IsDynamic = Traits::is_dynamic>
+        class flat_hash_table_storage
+        {
+            typedef flat_hash_table_storage<Traits, IsDynamic> this_type;
+        public:
+            typedef typename Traits::allocator_type     allocator_type;
+            typedef typename Traits::value_type         value_type;
+            typedef AZStd::size_t                       size_type;
+
+            AZ_FORCE_INLINE flat_hash_table_storage(const allocator_type& alloc)
+                : m_allocator(alloc)
+            {
+                init_empty();
+            }
+
+            AZ_FORCE_INLINE signed char*    control() const     { return m_control; }
+            AZ_FORCE_INLINE value_type*     slots() const       { return m_slots; }
+            AZ_FORCE_INLINE size_type       capacity() const    { return m_capacity; }
+
+            AZ_FORCE_INLINE void init_empty()
+            {
+                m_control = const_cast<signed char*>(flat_hash_empty_group<>::s_control); // never written, tables with no capacity are always "full"
+                m_slots = nullptr;
+                m_capacity = 0;
+            }
+
+            /// Allocates new control bytes and slots, the caller owns the old ones.
+            void allocate(size_type capacity)
+            {
+                size_type controlSize = control_byte_size(capacity);
+                char* data = reinterpret_cast<char*>(m_allocator.allocate(controlSize + capacity * sizeof(value_type), alignment()));
+                m_control = reinterpret_cast<signed char*>(data);
+                m_slots = reinterpret_cast<value_type*>(data + controlSize);
+                m_capacity = capacity;
+            }
+
+            void deallocate(signed char* control, size_type capacity)
+            {
+                deallocate(typename allocator_type::allow_memory_leaks(), control, capacity);
+            }
+
+            void swap(this_type& rhs)
+            {
+                AZStd::swap(m_allocator, rhs.m_allocator);
+                AZStd::swap(m_control, rhs.m_control);
+                AZStd::swap(m_slots, rhs.m_slots);
+                AZStd::swap(m_capacity, rhs.m_capacity);
+            }
+
+            allocator_type  m_allocator;
+
+        private:
+            static AZ_FORCE_INLINE size_type alignment()
+            {
+                return AZStd::GetMax<size_type>(alignment_of<value_type>::value, 16);
+            }
+            static AZ_FORCE_INLINE size_type control_byte_size(size_type capacity)
+            {
+                // control bytes: capacity + sentinel + cloned bytes (width - 1)
+                return (capacity + flat_hash_group::width + alignment() - 1) & ~(alignment() - 1);
+            }
+
+            AZ_FORCE_INLINE void deallocate(const true_type& /* allocator::allow_memory_leaks */, signed char*, size_type) {}
+            AZ_FORCE_INLINE void deallocate(const false_type& /* !allocator::allow_memory_leaks */, signed char* control, size_type capacity)
+            {
+                if (capacity)
+                {
+                    m_allocator.deallocate(control, control_byte_size(capacity) + capacity * sizeof(value_type), alignment());
+                }
+            }
+
+            signed char*    m_control;      ///< Control bytes, capacity + 1 (sentinel) + flat_hash_group::width - 1 (cloned first bytes) in size.
+            value_type*     m_slots;        ///< Elements, capacity in size.
+            size_type       m_capacity;     ///< Always 2^n - 1 (or 0) so it can be used as a mask.
+        };
+
+        template<class Traits>
+        class flat_hash_table_storage<Traits, false>
+        {
+            typedef flat_hash_table_storage<Traits, false> this_type;
+        public:
+            typedef typename Traits::allocator_type     allocator_type;
+            typedef typename Traits::value_type         value_type;
+            typedef AZStd::size_t                       size_type;
+
+            static const size_type fixed_capacity = flat_hash_fixed_capacity<Traits::fixed_num_elements>::value;
+
+            AZ_FORCE_INLINE flat_hash_table_storage(const allocator_type&)  {}
+
+            AZ_FORCE_INLINE signed char*    control() const     { return const_cast<signed char*>(m_control); }
+            AZ_FORCE_INLINE value_type*     slots() const       { return reinterpret_cast<value_type*>(const_cast<typename this_type::slots_type*>(&m_slots)); }
+            AZ_FORCE_INLINE size_type       capacity() const    { return fixed_capacity; }
+
+            AZ_FORCE_INLINE void init_empty()   {}
+            AZ_FORCE_INLINE void allocate(size_type capacity)   { (void)capacity; AZSTD_CONTAINER_ASSERT(capacity == fixed_capacity, "AZStd::fixed flat hash table can't change the capacity!"); }
+            AZ_FORCE_INLINE void deallocate(signed char*, size_type)   {}
+
+            allocator_type  m_allocator;
+
+        private:
+            typedef typename AZStd::aligned_storage<fixed_capacity* sizeof(value_type), alignment_of<value_type>::value>::type slots_type;
+
+            signed char     m_control[fixed_capacity + flat_hash_group::width];
+            slots_type      m_slots;
+        };
+    }
+
+    /**
+     * Flat hash table is internal container used as a base class for the open addressing unordered containers
+     * (\ref flat_hash_map, \ref flat_hash_set and their fixed versions).
+     * Unlike \ref hash_table the elements are stored in one array of slots with no per element allocation. Each slot has
+     * a control byte with 7 bits of the hash (or empty/deleted), we probe a group of control bytes at once (with SSE2 when available)
+     * and we compare keys only for the slots whose control byte match. The capacity is 2^n - 1 and we grow by 2x at 7/8 load.
+     * This is Swiss table style hashing, lookups usually touch one control group and one slot.
+     *
+     * Differences from \ref hash_table:
+     * - inserts and rehash move the elements, so they invalidate all iterators, pointers and references. Erase invalidates only the erased element.
+     * - iteration order is not defined and there are no multi element versions, or buckets.
+     * - the hash is mixed before we use it, so the default identity integer hashes are fine.
+     *
+     * Traits should have the following members
+     * typedef xxx  key_type;
+     * typedef xxx  key_eq;
+     * typedef xxx  hasher;
+     * typedef xxx  value_type;
+     * typedef xxx  allocator_type;
+     * enum
+     * {
+     *   is_dynamic = true or false,    // false for fixed containers, which store fixed_num_elements elements inline.
+     *   fixed_num_elements = xxx,      // Number of elements to pre-allocate for fixed containers.
+     * }
+     *
+     * static inline key_type key_from_value(const value_type& value);
+     */
+    template<class Traits>
+    class flat_hash_table
+    {
+        typedef flat_hash_table<Traits>                             this_type;
+        typedef AZStd::integral_constant<bool, Traits::is_dynamic>   is_dynamic;
+        typedef Internal::flat_hash_table_storage<Traits>           storage_type;
+        typedef Internal::flat_hash_group                           group_type;
+    public:
+        typedef Traits                          traits_type;
+
+        typedef typename Traits::key_type       key_type;
+        typedef typename Traits::key_eq         key_eq;
+        typedef typename Traits::hasher         hasher;
+
+        typedef typename Traits::allocator_type     allocator_type;
+        typedef typename Traits::value_type         value_type;
+        typedef AZStd::size_t                       size_type;
+        typedef AZStd::ptrdiff_t                    difference_type;
+        typedef value_type*                         pointer;
+        typedef const value_type*                   const_pointer;
+        typedef value_type&                         reference;
+        typedef const value_type&                   const_reference;
+
+        typedef Internal::flat_hash_table_iterator<value_type, value_type*, value_type&>                iterator;
+        typedef Internal::flat_hash_table_iterator<value_type, const value_type*, const value_type&>    const_iterator;
+
+        typedef AZStd::pair<iterator, bool>                     pair_iter_bool;
+        typedef AZStd::pair<iterator, iterator>                 pair_iter_iter;
+        typedef AZStd::pair<const_iterator, const_iterator>     pair_citer_citer;
+
+        AZ_FORCE_INLINE explicit flat_hash_table(const hasher& hash, const key_eq& keyEqual, const allocator_type& alloc = allocator_type())
+            : m_data(alloc)
+            , m_keyEqual(keyEqual)
+            , m_hasher(hash)
+        {
+            init_control();
+        }
+
+        flat_hash_table(const this_type& rhs)
+            : m_data(rhs.m_data.m_allocator)
+            , m_keyEqual(rhs.m_keyEqual)
+            , m_hasher(rhs.m_hasher)
+        {
+            init_control();
+            copy(rhs);
+        }
+
+#if defined(AZ_HAS_RVALUE_REFS)
+        flat_hash_table(this_type&& rhs)
+            : m_data(rhs.m_data.m_allocator)
+            , m_keyEqual(rhs.m_keyEqual)
+            , m_hasher(rhs.m_hasher)
+        {
+            init_control();
+            assign_rv(AZStd::forward<this_type>(rhs), is_dynamic());
+        }
+
+        this_type& operator=(this_type&& rhs)
+        {
+            if (this != &rhs)
+            {
+                clear();
+                m_keyEqual = rhs.m_keyEqual;
+                m_hasher = rhs.m_hasher;
+                assign_rv(AZStd::forward<this_type>(rhs), is_dynamic());
+            }
+            return *this;
+        }
+#endif // AZ_HAS_RVALUE_REFS
+
+        this_type& operator=(const this_type& rhs)
+        {
+            if (this != &rhs)
+            {
+                clear();
+                m_keyEqual = rhs.m_keyEqual;
+                m_hasher = rhs.m_hasher;
+                copy(rhs);
+            }
+            return *this;
+        }
+
+        ~flat_hash_table()
+        {
+            destroy_elements();
+            m_data.deallocate(m_data.control(), m_data.capacity());
+        }
+
+        AZ_FORCE_INLINE iterator            begin()
+        {
+            iterator iter(m_data.control(), m_data.slots());
+            iter.skip_empty_or_deleted();
+            return iter;
+        }
+        AZ_FORCE_INLINE const_iterator      begin() const
+        {
+            const_iterator iter(m_data.control(), m_data.slots());
+            iter.skip_empty_or_deleted();
+            return iter;
+        }
+        AZ_FORCE_INLINE iterator            end()           { return iterator(m_data.control() + m_data.capacity(), m_data.slots() + m_data.capacity()); }
+        AZ_FORCE_INLINE const_iterator      end() const     { return const_iterator(m_data.control() + m_data.capacity(), m_data.slots() + m_data.capacity()); }
+
+        AZ_FORCE_INLINE size_type       size() const                { return m_size; }
+        AZ_FORCE_INLINE size_type       max_size() const            { return Traits::is_dynamic ? capacity_to_growth(~size_type(0) / 2 / sizeof(value_type)) : capacity_to_growth(m_data.capacity()); }
+        AZ_FORCE_INLINE bool            empty() const               { return m_size == 0; }
+        AZ_FORCE_INLINE key_eq          key_equal() const           { return m_keyEqual; }
+        AZ_FORCE_INLINE hasher          get_hasher() const          { return m_hasher; }
+        /// Number of slots, the table grows when there are more than 7/8 capacity elements.
+        AZ_FORCE_INLINE size_type       capacity() const            { return m_data.capacity(); }
+        AZ_FORCE_INLINE size_type       bucket_count() const        { return m_data.capacity(); }
+        AZ_FORCE_INLINE float           load_factor() const         { return m_data.capacity() ? (float)m_size / (float)m_data.capacity() : 0.0f; }
+        /// The max load factor is always 7/8, the control bytes probing relies on it.
+        AZ_FORCE_INLINE float           max_load_factor() const     { return 0.875f; }
+        AZ_FORCE_INLINE void            max_load_factor(float newMaxLoadFactor) { (void)newMaxLoadFactor; }
+
+        /// Makes sure we can have numElements without growing.
+        void reserve(size_type numElements)
+        {
+            if (numElements > capacity_to_growth(m_data.capacity()))
+            {
+                resize(normalize_capacity(numElements + numElements / 7), is_dynamic());
+            }
+        }
+        /// Sets the capacity to at least numSlotsMin (and what's needed for the current size), it can shrink the table.
+        void rehash(size_type numSlotsMin)
+        {
+            if (numSlotsMin == 0 && m_size == 0)
+            {
+                clear();
+                deallocate_table(is_dynamic());
+                return;
+            }
+            size_type newCapacity = normalize_capacity(AZStd::GetMax(numSlotsMin, m_size + m_size / 7));
+            if (newCapacity != m_data.capacity())
+            {
+                resize(newCapacity, is_dynamic());
+            }
+        }
+
+        AZ_FORCE_INLINE pair_iter_bool  insert(const value_type& value)     { return insert_impl(value); }
+        AZ_FORCE_INLINE iterator        insert(const_iterator, const value_type& value) { return insert_impl(value).first; }
+#if defined(AZ_HAS_RVALUE_REFS)
+        AZ_FORCE_INLINE pair_iter_bool  insert(value_type&& value)          { return insert_impl(AZStd::forward<value_type>(value)); }
+        AZ_FORCE_INLINE iterator        insert(const_iterator, value_type&& value) { return insert_impl(AZStd::forward<value_type>(value)).first; }
+
+        template <typename... Args>
+        pair_iter_bool emplace(Args&&... arguments)
+        {
+            // we need the key before we know the slot, construct a temporary and move it in
+            typename aligned_storage<sizeof(value_type), alignment_of<value_type>::value>::type buffer;
+            pointer value = new(&buffer) value_type(AZStd::forward<Args>(arguments)...);
+            pair_iter_bool result = insert_impl(AZStd::move(*value));
+            Internal::destroy<pointer>::single(value);
+            return result;
+        }
+#endif // AZ_HAS_RVALUE_REFS
+
+#if defined(AZ_HAS_INITIALIZERS_LIST)
+        AZ_FORCE_INLINE void insert(std::initializer_list<value_type> list)
+        {
+            insert(list.begin(), list.end());
+        }
+#endif // #if defined(AZ_HAS_INITIALIZERS_LIST)
+
+        template<class Iterator>
+        void            insert(Iterator first, Iterator last)
+        {
+            for (; first != last; ++first)
+            {
+                insert_impl(*first);
+            }
+        }
+
+        iterator        erase(const_iterator erasePos)
+        {
+            iterator next(erasePos.m_control, const_cast<pointer>(erasePos.m_slot));
+            ++next;
+            erase_index(erasePos.m_slot - m_data.slots());
+            return next;
+        }
+        size_type       erase(const key_type& keyValue)
+        {
+            size_type index = find_index(keyValue, m_hasher, m_keyEqual);
+            if (index == m_data.capacity())
+            {
+                return 0;
+            }
+            erase_index(index);
+            return 1;
+        }
+        iterator        erase(const_iterator first, const_iterator last)
+        {
+            // erase doesn't move the other elements, so the iterators stay valid
+            while (first != last)
+            {
+                first = erase(first);
+            }
+            return iterator(last.m_control, const_cast<pointer>(last.m_slot));
+        }
+
+        void            clear()
+        {
+            if (m_size)
+            {
+                destroy_elements();
+            }
+            init_control();
+        }
+
+        AZ_FORCE_INLINE iterator        find(const key_type& keyValue)
+        {
+            return iterator_at(find_index(keyValue, m_hasher, m_keyEqual));
+        }
+        AZ_FORCE_INLINE const_iterator  find(const key_type& keyValue) const
+        {
+            return const_iterator_at(find_index(keyValue, m_hasher, m_keyEqual));
+        }
+        AZ_FORCE_INLINE size_type       count(const key_type& keyValue) const
+        {
+            return find_index(keyValue, m_hasher, m_keyEqual) != m_data.capacity() ? 1 : 0;
+        }
+        pair_iter_iter  equal_range(const key_type& keyValue)
+        {
+            iterator iter = find(keyValue);
+            return iter == end() ? pair_iter_iter(iter, iter) : pair_iter_iter(iter, AZStd::next(iter));
+        }
+        pair_citer_citer equal_range(const key_type& keyValue) const
+        {
+            const_iterator iter = find(keyValue);
+            return iter == end() ? pair_citer_citer(iter, iter) : pair_citer_citer(iter, AZStd::next(iter));
+        }
+
+        void swap(this_type& rhs)
+        {
+            if (this != &rhs)
+            {
+                swap_impl(rhs, is_dynamic());
+                AZStd::swap(m_keyEqual, rhs.m_keyEqual);
+                AZStd::swap(m_hasher, rhs.m_hasher);
+            }
+        }
+
+        /**
+        * \anchor FlatHashExtensions
+        * \name Extensions
+        * @{
+        */
+        AZ_FORCE_INLINE allocator_type&         get_allocator()         { return m_data.m_allocator; }
+        AZ_FORCE_INLINE const allocator_type&   get_allocator() const   { return m_data.m_allocator; }
+        void set_allocator(const allocator_type& allocator)
+        {
+            // move the elements to memory from the new allocator
+            this_type tmp(m_hasher, m_keyEqual, allocator);
+            tmp.reserve(m_size);
+            for (iterator iter = begin(); iter != end(); ++iter)
+            {
+                tmp.insert_impl(AZStd::move(*iter));
+            }
+            clear();
+            deallocate_table(is_dynamic());
+            m_data.swap(tmp.m_data);
+            AZStd::swap(m_size, tmp.m_size);
+            AZStd::swap(m_growthLeft, tmp.m_growthLeft);
+        }
+
+        /**
+        * Find an element with a key compatible type, the hash must be the same as the hasher's for the equal key.
+        * Similar to \ref hash_table::find_as.
+        */
+        template<class ComparableToKey, class Hasher, class KeyEqual>
+        iterator        find_as(const ComparableToKey& keyCmp, const Hasher& hash, const KeyEqual& keyEq)
+        {
+            return iterator_at(find_index(keyCmp, hash, keyEq));
+        }
+        template<class ComparableToKey, class Hasher, class KeyEqual>
+        const_iterator  find_as(const ComparableToKey& keyCmp, const Hasher& hash, const KeyEqual& keyEq) const
+        {
+            return const_iterator_at(find_index(keyCmp, hash, keyEq));
+        }
+
+        /**
+        * Inserts from a value and converter object, the value is created with to_value only if the key is not in the table.
+        * Check \ref hash_table::insert_from for the converter interface.
+        */
+        template<class U, class Converter, class Hasher, class KeyEqual>
+        pair_iter_bool insert_from(const U& userValue, const Converter& convert, const Hasher& hash, const KeyEqual& keyEq)
+        {
+            (void)convert;
+            const typename Converter::key_type& valueKey = convert.to_key(userValue);
+            size_type hashValue = mix_hash(hash(valueKey));
+            size_type index = find_index(valueKey, hashValue, keyEq);
+            if (index != m_data.capacity())
+            {
+                return pair_iter_bool(iterator_at(index), false);
+            }
+            index = prepare_insert(hashValue);
+            if (index == m_data.capacity())
+            {
+                return pair_iter_bool(end(), false); // fixed table is full
+            }
+            new(m_data.slots() + index) value_type(convert.to_value(userValue));
+            return pair_iter_bool(iterator_at(index), true);
+        }
+
+        /// Checks that the control bytes are consistent with the number of elements.
+        bool            validate() const
+        {
+            const signed char* control = m_data.control();
+            size_type capacity = m_data.capacity();
+            if (control[capacity] != Internal::flat_hash_sentinel)
+            {
+                return false;
+            }
+            size_type numElements = 0;
+            for (size_type i = 0; i < capacity; ++i)
+            {
+                numElements += control[i] >= 0 ? 1 : 0;
+                if (i < group_type::width - 1 && control[capacity + 1 + i] != control[i])
+                {
+                    return false; // cloned byte doesn't match
+                }
+            }
+            return numElements == m_size && m_growthLeft <= capacity_to_growth(capacity);
+        }
+
+        /**
+        * Resets the container without deallocating any memory or calling any destructor.
+        * This function should be used when we need very quick tear down. \ref hash_table::leak_and_reset
+        */
+        void            leak_and_reset()
+        {
+            m_data.init_empty();
+            init_control();
+        }
+        /// @}
+
+    protected:
+        static AZ_FORCE_INLINE size_type mix_hash(size_type hash)
+        {
+            // The default integer hashes are the identity, spread the bits so we can use the low 7 bits and the rest separately.
+            AZ::u64 mixed = static_cast<AZ::u64>(hash) * 0x9E3779B97F4A7C15ull;
+            return static_cast<size_type>(mixed ^ (mixed >> 32));
+        }
+        static AZ_FORCE_INLINE size_type    hash_position(size_type hash)   { return hash >> 7; }
+        static AZ_FORCE_INLINE signed char  hash_control(size_type hash)    { return static_cast<signed char>(hash & 0x7f); }
+
+        static AZ_FORCE_INLINE size_type capacity_to_growth(size_type capacity)
+        {
+            size_type growth = capacity - capacity / 8;
+            if (capacity >= group_type::width - 1 && growth == capacity)
+            {
+                --growth; // keep an empty slot so lookups terminate, see flat_hash_capacity_to_growth
+            }
+            return growth;
+        }
+        /// Returns the smallest 2^n - 1 >= numSlots.
+        static AZ_FORCE_INLINE size_type normalize_capacity(size_type numSlots)
+        {
+            return numSlots ? (size_type(2) << AZ::FloorLog2(numSlots)) - 1 : 1;
+        }
+
+        /// Triangular probing over groups, it visits all groups when the capacity is 2^n - 1.
+        struct probe_sequence
+        {
+            AZ_FORCE_INLINE probe_sequence(size_type hash, size_type mask)
+                : m_mask(mask)
+                , m_offset(hash & mask)
+                , m_index(0)
+            {}
+            AZ_FORCE_INLINE size_type   offset(size_type i) const   { return (m_offset + i) & m_mask; }
+            AZ_FORCE_INLINE void        next()
+            {
+                m_index += group_type::width;
+                m_offset = (m_offset + m_index) & m_mask;
+            }
+
+            size_type m_mask;
+            size_type m_offset;
+            size_type m_index;
+        };
+
+        AZ_FORCE_INLINE iterator        iterator_at(size_type index)        { return iterator(m_data.control() + index, m_data.slots() + index); }
+        AZ_FORCE_INLINE const_iterator  const_iterator_at(size_type index) const { return const_iterator(m_data.control() + index, m_data.slots() + index); }
+
+        template<class ComparableToKey, class Hasher, class KeyEqual>
+        AZ_FORCE_INLINE size_type find_index(const ComparableToKey& keyCmp, const Hasher& hash, const KeyEqual& keyEq) const
+        {
+            return find_index(keyCmp, mix_hash(hash(keyCmp)), keyEq);
+        }
+
+        /// Returns the element index or capacity if the key is not in the table.
+        template<class ComparableToKey, class KeyEqual>
+        size_type find_index(const ComparableToKey& keyCmp, size_type hash, const KeyEqual& keyEq) const
+        {
+            const signed char* control = m_data.control();
+            const value_type* slots = m_data.slots();
+            probe_sequence probe(hash_position(hash), m_data.capacity());
+            signed char hashControl = hash_control(hash);
+            for (;; )
+            {
+                group_type group(control + probe.m_offset);
+                for (typename group_type::mask_type match = group.match(hashControl); match; match = group_type::clear_lowest(match))
+                {
+                    size_type index = probe.offset(group_type::lowest(match));
+                    if (keyEq(keyCmp, Traits::key_from_value(slots[index])))
+                    {
+                        return index;
+                    }
+                }
+                if (group.match_empty())
+                {
+                    return m_data.capacity();
+                }
+                probe.next();
+            }
+        }
+
+        /// Returns the first empty or deleted slot on the probe sequence.
+        size_type find_first_non_full(size_type hash) const
+        {
+            const signed char* control = m_data.control();
+            probe_sequence probe(hash_position(hash), m_data.capacity());
+            for (;; )
+            {
+                typename group_type::mask_type mask = group_type(control + probe.m_offset).match_empty_or_deleted();
+                if (mask)
+                {
+                    return probe.offset(group_type::lowest(mask));
+                }
+                probe.next();
+            }
+        }
+
+        /// Sets the control byte and its clone (the first width - 1 bytes are cloned after the sentinel).
+        AZ_FORCE_INLINE void set_control(size_type index, signed char value)
+        {
+            const size_type numCloned = group_type::width - 1;
+            size_type capacity = m_data.capacity();
+            signed char* control = m_data.control();
+            control[index] = value;
+            control[((index - numCloned) & capacity) + (numCloned & capacity)] = value;
+        }
+
+        void init_control()
+        {
+            size_type capacity = m_data.capacity();
+            if (capacity)
+            {
+                signed char* control = m_data.control();
+                memset(control, Internal::flat_hash_empty, capacity + group_type::width);
+                control[capacity] = Internal::flat_hash_sentinel;
+            }
+            m_size = 0;
+            m_growthLeft = capacity_to_growth(capacity);
+        }
+
+        void destroy_elements()
+        {
+            const signed char* control = m_data.control();
+            pointer slots = m_data.slots();
+            for (size_type i = 0; i < m_data.capacity(); ++i)
+            {
+                if (control[i] >= 0)
+                {
+                    pointer slot = slots + i;
+                    Internal::destroy<pointer>::single(slot);
+                }
+            }
+        }
+
+        /// Finds a slot for a new element and marks it as full, returns capacity if a fixed table is full.
+        size_type prepare_insert(size_type hash)
+        {
+            size_type index = find_first_non_full(hash);
+            if (m_growthLeft == 0 && m_data.control()[index] != Internal::flat_hash_deleted)
+            {
+                if (!grow(is_dynamic()))
+                {
+                    return m_data.capacity();
+                }
+                index = find_first_non_full(hash);
+            }
+            ++m_size;
+            m_growthLeft -= m_data.control()[index] == Internal::flat_hash_empty ? 1 : 0;
+            set_control(index, hash_control(hash));
+            return index;
+        }
+
+        template <typename V>
+        pair_iter_bool insert_impl(V&& value)
+        {
+            const key_type& valueKey = Traits::key_from_value(value);
+            size_type hash = mix_hash(m_hasher(valueKey));
+            size_type index = find_index(valueKey, hash, m_keyEqual);
+            if (index != m_data.capacity())
+            {
+                return pair_iter_bool(iterator_at(index), false);
+            }
+            index = prepare_insert(hash);
+            if (index == m_data.capacity())
+            {
+                return pair_iter_bool(end(), false); // fixed table is full
+            }
+            new(m_data.slots() + index) value_type(AZStd::forward<V>(value));
+            return pair_iter_bool(iterator_at(index), true);
+        }
+
+        void erase_index(size_type index)
+        {
+            pointer slot = m_data.slots() + index;
+            Internal::destroy<pointer>::single(slot);
+            --m_size;
+
+            // If the slot was never part of a full group (there is an empty slot within a group width on both sides), no probe
+            // sequence went past it, so we can mark it empty. Otherwise we need a tombstone.
+            const signed char* control = m_data.control();
+            size_type indexBefore = (index - group_type::width) & m_data.capacity();
+            typename group_type::mask_type emptyAfter = group_type(control + index).match_empty();
+            typename group_type::mask_type emptyBefore = group_type(control + indexBefore).match_empty();
+            bool isNeverFull = emptyBefore && emptyAfter &&
+                group_type::lowest(emptyAfter) + (group_type::width - 1 - group_type::highest(emptyBefore)) < group_type::width;
+            if (isNeverFull)
+            {
+                set_control(index, Internal::flat_hash_empty);
+                ++m_growthLeft;
+            }
+            else
+            {
+                set_control(index, Internal::flat_hash_deleted);
+            }
+        }
+
+        /// Moves all elements to a new table of newCapacity slots.
+        void resize(size_type newCapacity, const true_type& /* is_dynamic */)
+        {
+            signed char* oldControl = m_data.control();
+            pointer oldSlots = m_data.slots();
+            size_type oldCapacity = m_data.capacity();
+            size_type numElements = m_size;
+
+            m_data.allocate(newCapacity);
+            init_control();
+            pointer slots = m_data.slots();
+            for (size_type i = 0; i < oldCapacity; ++i)
+            {
+                if (oldControl[i] >= 0)
+                {
+                    pointer oldSlot = oldSlots + i;
+                    size_type hash = mix_hash(m_hasher(Traits::key_from_value(*oldSlot)));
+                    size_type index = find_first_non_full(hash);
+                    set_control(index, hash_control(hash));
+                    new(slots + index) value_type(AZStd::move(*oldSlot));
+                    Internal::destroy<pointer>::single(oldSlot);
+                }
+            }
+            m_size = numElements;
+            m_growthLeft -= numElements;
+            m_data.deallocate(oldControl, oldCapacity);
+        }
+        AZ_FORCE_INLINE void resize(size_type newCapacity, const false_type& /* !is_dynamic */)
+        {
+            (void)newCapacity;
+            AZSTD_CONTAINER_ASSERT(newCapacity <= m_data.capacity(), "AZStd::fixed flat hash table can't hold more than %d elements!", static_cast<int>(capacity_to_growth(m_data.capacity())));
+        }
+
+        void deallocate_table(const true_type& /* is_dynamic */)
+        {
+            m_data.deallocate(m_data.control(), m_data.capacity());
+            m_data.init_empty();
+            init_control();
+        }
+        AZ_FORCE_INLINE void deallocate_table(const false_type& /* !is_dynamic */)    {}
+
+        /// Makes room for one more element, by dropping the tombstones when there are many or by growing the table.
+        bool grow(const true_type& /* is_dynamic */)
+        {
+            size_type capacity = m_data.capacity();
+            if (capacity == 0)
+            {
+                resize(1, is_dynamic());
+            }
+            else if (capacity > group_type::width && static_cast<AZ::u64>(m_size) * 32 <= static_cast<AZ::u64>(capacity) * 25)
+            {
+                drop_deleted(); // many tombstones, cleaning them is cheaper than growing
+            }
+            else
+            {
+                resize(capacity * 2 + 1, is_dynamic());
+            }
+            return true;
+        }
+        bool grow(const false_type& /* !is_dynamic */)
+        {
+            if (m_size < capacity_to_growth(m_data.capacity()))
+            {
+                drop_deleted();
+                return true;
+            }
+            AZSTD_CONTAINER_ASSERT(false, "AZStd::fixed flat hash table is full (%d elements)!", static_cast<int>(m_size));
+            return false;
+        }
+
+        /// Rehash in place, all deleted slots become empty and the elements move closer to their ideal position.
+        void drop_deleted()
+        {
+            signed char* control = m_data.control();
+            pointer slots = m_data.slots();
+            size_type capacity = m_data.capacity();
+
+            // deleted -> empty, full -> deleted (so we know what to move)
+            for (size_type i = 0; i < capacity; ++i)
+            {
+                control[i] = control[i] < 0 ? static_cast<signed char>(Internal::flat_hash_empty) : static_cast<signed char>(Internal::flat_hash_deleted);
+            }
+            // update the clones the same way set_control does, small tables clone only capacity bytes (the rest stay empty)
+            const size_type numCloned = capacity < group_type::width - 1 ? capacity : group_type::width - 1;
+            memcpy(control + capacity + 1, control, numCloned);
+            control[capacity] = Internal::flat_hash_sentinel;
+
+            typename aligned_storage<sizeof(value_type), alignment_of<value_type>::value>::type buffer;
+            pointer tmp = reinterpret_cast<pointer>(&buffer);
+            for (size_type i = 0; i < capacity; ++i)
+            {
+                if (control[i] != Internal::flat_hash_deleted)
+                {
+                    continue;
+                }
+                size_type hash = mix_hash(m_hasher(Traits::key_from_value(slots[i])));
+                size_type newIndex = find_first_non_full(hash);
+                // if both are in the same probe group, the element is already where a lookup will find it.
+                size_type probeOffset = probe_sequence(hash_position(hash), capacity).m_offset;
+                if ((((i - probeOffset) & capacity) / group_type::width) == (((newIndex - probeOffset) & capacity) / group_type::width))
+                {
+                    set_control(i, hash_control(hash));
+                    continue;
+                }
+                if (control[newIndex] == Internal::flat_hash_empty)
+                {
+                    set_control(newIndex, hash_control(hash));
+                    new(slots + newIndex) value_type(AZStd::move(slots[i]));
+                    pointer slot = slots + i;
+                    Internal::destroy<pointer>::single(slot);
+                    set_control(i, Internal::flat_hash_empty);
+                }
+                else
+                {
+                    // the new position has an element we still need to place, swap them and process the slot again.
+                    set_control(newIndex, hash_control(hash));
+                    pointer slot = slots + i;
+                    pointer newSlot = slots + newIndex;
+                    new(tmp) value_type(AZStd::move(*slot));
+                    Internal::destroy<pointer>::single(slot);
+                    new(slot) value_type(AZStd::move(*newSlot));
+                    Internal::destroy<pointer>::single(newSlot);
+                    new(newSlot) value_type(AZStd::move(*tmp));
+                    Internal::destroy<pointer>::single(tmp);
+                    --i;
+                }
+            }
+            m_growthLeft = capacity_to_growth(capacity) - m_size;
+        }
+
+        void copy(const this_type& rhs)
+        {
+            reserve(rhs.m_size);
+            for (const_iterator iter = rhs.begin(); iter != rhs.end(); ++iter)
+            {
+                insert_impl(*iter);
+            }
+        }
+
+#if defined(AZ_HAS_RVALUE_REFS)
+        void assign_rv(this_type&& rhs, const true_type& /* is_dynamic */)
+        {
+            // take the memory
+            deallocate_table(is_dynamic());
+            m_data.swap(rhs.m_data);
+            AZStd::swap(m_size, rhs.m_size);
+            AZStd::swap(m_growthLeft, rhs.m_growthLeft);
+        }
+        void assign_rv(this_type&& rhs, const false_type& /* !is_dynamic */)
+        {
+            for (iterator iter = rhs.begin(); iter != rhs.end(); ++iter)
+            {
+                insert_impl(AZStd::move(*iter));
+            }
+            rhs.clear();
+        }
+#endif // AZ_HAS_RVALUE_REFS
+
+        void swap_impl(this_type& rhs, const true_type& /* is_dynamic */)
+        {
+            m_data.swap(rhs.m_data);
+            AZStd::swap(m_size, rhs.m_size);
+            AZStd::swap(m_growthLeft, rhs.m_growthLeft);
+        }
+        void swap_impl(this_type& rhs, const false_type& /* !is_dynamic */)
+        {
+            this_type tmp(rhs.m_hasher, rhs.m_keyEqual);
+            for (iterator iter = rhs.begin(); iter != rhs.end(); ++iter)
+            {
+                tmp.insert_impl(AZStd::move(*iter));
+            }
+            rhs.clear();
+            for (iterator iter = begin(); iter != end(); ++iter)
+            {
+                rhs.insert_impl(AZStd::move(*iter));
+            }
+            clear();
+            for (iterator iter = tmp.begin(); iter != tmp.end(); ++iter)
+            {
+                insert_impl(AZStd::move(*iter));
+            }
+        }
+
+        storage_type    m_data;
+        size_type       m_size;
+        size_type       m_growthLeft;   ///< Number of empty slots we can fill before we need to grow (deleted slots don't count).
+        key_eq          m_keyEqual;
+        hasher          m_hasher;
+    };
+}
+
+#endif // AZSTD_FLAT_HASH_TABLE_H
+#pragma once
@@ -13,6 +13,15 @@
 #define AZSTD_HASH_H 1
 
 #include <AzCore/std/utils.h>
+#include <AzCore/std/typetraits/is_integral.h>
+
+#include <string.h>
+
+#if defined(AZ_COMPILER_MSVC) && (defined(AZ_PLATFORM_WINDOWS_X64) || defined(AZ_PLATFORM_XBONE))
+#   include <intrin.h>
+#   pragma intrinsic(_umul128)
+#   define AZSTD_HASH_UMUL128 1
+#endif
 
 namespace AZStd
 {
@@ -57,6 +66,115 @@ namespace AZStd
         }
     };
 
+    namespace Internal
+    {
+        /// Full 64x64->128 bit multiply, returns the low 64 bits in lo and the high 64 bits in hi.
+        AZ_FORCE_INLINE void hash_mum(AZ::u64& lo, AZ::u64& hi)
+        {
+#if defined(__SIZEOF_INT128__)
+            __uint128_t r = static_cast<__uint128_t>(lo) * hi;
+            lo = static_cast<AZ::u64>(r);
+            hi = static_cast<AZ::u64>(r >> 64);
+#elif defined(AZSTD_HASH_UMUL128)
+            lo = _umul128(lo, hi, &hi);
+#else
+            AZ::u64 ha = lo >> 32, hb = hi >> 32, la = static_cast<AZ::u32>(lo), lb = static_cast<AZ::u32>(hi);
+            AZ::u64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+            AZ::u64 c = t < rl;
+            lo = t + (rm1 << 32);
+            c += lo < t;
+            hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+        }
+
+        AZ_FORCE_INLINE AZ::u64 hash_mix(AZ::u64 a, AZ::u64 b)
+        {
+            hash_mum(a, b);
+            return a ^ b;
+        }
+
+        AZ_FORCE_INLINE AZ::u64 hash_read8(const unsigned char* p)   { AZ::u64 v; memcpy(&v, p, 8); return v; }
+        AZ_FORCE_INLINE AZ::u64 hash_read4(const unsigned char* p)   { AZ::u32 v; memcpy(&v, p, 4); return v; }
+        AZ_FORCE_INLINE AZ::u64 hash_read3(const unsigned char* p, AZStd::size_t length)
+        {
+            return (static_cast<AZ::u64>(p[0]) << 16) | (static_cast<AZ::u64>(p[length >> 1]) << 8) | p[length - 1];
+        }
+
+        static const AZ::u64 s_hashSecret[4] = { 0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull };
+
+        /// Contiguous ranges of these types are hashed as raw bytes, their hash<T> is a plain cast of the value.
+        template<class It>
+        struct hash_range_is_bytes
+            : public AZStd::false_type {};
+        template<class T>
+        struct hash_range_is_bytes<T*>
+            : public AZStd::integral_constant<bool, AZStd::is_integral<T>::value || AZStd::is_enum<T>::value> {};
+        template<class T>
+        struct hash_range_is_bytes<const T*>
+            : public hash_range_is_bytes<T*> {};
+    }
+
+    /**
+     * Hashes length bytes of memory. This is the wyhash function (Wang Yi, public domain): inputs up to 16 bytes take
+     * a couple of multiplies, longer inputs are consumed 48 bytes at a time in 3 independent 64x64->128 multiply lanes.
+     * It passes SMHasher, all output bits depend on all input bits, and it runs at memory speed for large inputs.
+     * The result is not stable across endianness, do not persist it (use Crc32 for that).
+     */
+    inline AZStd::size_t hash_bytes(const void* data, AZStd::size_t length, AZ::u64 seed = 0)
+    {
+        using namespace Internal;
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        seed ^= hash_mix(seed ^ s_hashSecret[0], s_hashSecret[1]);
+        AZ::u64 a, b;
+        if (length <= 16)
+        {
+            if (length >= 4)
+            {
+                AZStd::size_t offset = (length >> 3) << 2;
+                a = (hash_read4(p) << 32) | hash_read4(p + offset);
+                b = (hash_read4(p + length - 4) << 32) | hash_read4(p + length - 4 - offset);
+            }
+            else if (length > 0)
+            {
+                a = hash_read3(p, length);
+                b = 0;
+            }
+            else
+            {
+                a = b = 0;
+            }
+        }
+        else
+        {
+            AZStd::size_t i = length;
+            if (i > 48)
+            {
+                AZ::u64 seed1 = seed, seed2 = seed;
+                do
+                {
+                    seed = hash_mix(hash_read8(p) ^ s_hashSecret[1], hash_read8(p + 8) ^ seed);
+                    seed1 = hash_mix(hash_read8(p + 16) ^ s_hashSecret[2], hash_read8(p + 24) ^ seed1);
+                    seed2 = hash_mix(hash_read8(p + 32) ^ s_hashSecret[3], hash_read8(p + 40) ^ seed2);
+                    p += 48;
+                    i -= 48;
+                } while (i > 48);
+                seed ^= seed1 ^ seed2;
+            }
+            while (i > 16)
+            {
+                seed = hash_mix(hash_read8(p) ^ s_hashSecret[1], hash_read8(p + 8) ^ seed);
+                i -= 16;
+                p += 16;
+            }
+            a = hash_read8(p + i - 16);
+            b = hash_read8(p + i - 8);
+        }
+        a ^= s_hashSecret[1];
+        b ^= seed;
+        hash_mum(a, b);
+        return static_cast<AZStd::size_t>(hash_mix(a ^ s_hashSecret[0] ^ length, b ^ s_hashSecret[1]));
+    }
+
     template <class T>
     AZ_FORCE_INLINE void hash_combine(AZStd::size_t& seed, T const& v)
     {
@@ -64,24 +182,37 @@ namespace AZStd
         seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
     }
 
+    namespace Internal
+    {
+        template <class It>
+        AZ_FORCE_INLINE void hash_range(AZStd::size_t& seed, It first, It last, const AZStd::false_type& /* is bytes */)
+        {
+            for (; first != last; ++first)
+            {
+                hash_combine(seed, *first);
+            }
+        }
+
+        template <class It>
+        AZ_FORCE_INLINE void hash_range(AZStd::size_t& seed, It first, It last, const AZStd::true_type& /* is bytes */)
+        {
+            seed = hash_bytes(first, static_cast<AZStd::size_t>(last - first) * sizeof(*first), seed);
+        }
+    }
+
+    /// Hashes a range of elements. Contiguous ranges of integral and enum types are hashed in one pass with hash_bytes.
     template <class It>
     AZ_FORCE_INLINE AZStd::size_t hash_range(It first, It last)
     {
         AZStd::size_t seed = 0;
-        for (; first != last; ++first)
-        {
-            hash_combine(seed, *first);
-        }
+        Internal::hash_range(seed, first, last, Internal::hash_range_is_bytes<It>());
         return seed;
     }
 
     template <class It>
     AZ_FORCE_INLINE void hash_range(AZStd::size_t& seed, It first, It last)
     {
-        for (; first != last; ++first)
-        {
-            hash_combine(seed, *first);
-        }
+        Internal::hash_range(seed, first, last, Internal::hash_range_is_bytes<It>());
     }
 
     template< class T, unsigned N >
@@ -0,0 +1,203 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef AZSTD_PARALLEL_CONTAINERS_LOCK_FREE_BOUNDED_QUEUE_H
+#define AZSTD_PARALLEL_CONTAINERS_LOCK_FREE_BOUNDED_QUEUE_H 1
+
+#include <AzCore/std/parallel/atomic.h>
+#include <AzCore/std/allocator.h>
+
+namespace AZStd
+{
+    /**
+     * A bounded multi-producer multi-consumer queue on a ring buffer, lock-free. Each cell has a sequence number
+     * telling whether it's free or published for the current lap of the ring (based on Dmitry Vyukov's bounded MPMC
+     * queue), so producers and consumers only contend on their own end of the queue.
+     * Batch push and pop claim a run of consecutive cells with a single compare and swap, they only claim cells
+     * which are already free (or published), so they never wait for another thread.
+     * T must be trivially copyable, the capacity is rounded up to a power of 2 and can't change. Push fails when
+     * the queue is full, it's up to the user to handle the overflow.
+     */
+    template<typename T, class Allocator = AZStd::allocator>
+    class lock_free_bounded_queue
+    {
+    public:
+        typedef T           value_type;
+        typedef size_t      size_type;
+        typedef Allocator   allocator_type;
+
+        explicit lock_free_bounded_queue(size_type capacity, const Allocator& allocator = Allocator())
+            : m_allocator(allocator)
+        {
+            size_type powerOf2 = 2;
+            while (powerOf2 < capacity)
+            {
+                powerOf2 <<= 1;
+            }
+            m_mask = powerOf2 - 1;
+            m_cells = reinterpret_cast<Cell*>(m_allocator.allocate(sizeof(Cell) * powerOf2, alignment_of<Cell>::value));
+            for (size_type i = 0; i < powerOf2; ++i)
+            {
+                new(&m_cells[i]) Cell();
+                m_cells[i].m_sequence.store(i, memory_order_relaxed);
+            }
+            m_enqueuePos.store(0, memory_order_relaxed);
+            m_dequeuePos.store(0, memory_order_release);
+        }
+
+        ~lock_free_bounded_queue()
+        {
+            for (size_type i = 0; i <= m_mask; ++i)
+            {
+                m_cells[i].~Cell();
+            }
+            m_allocator.deallocate(m_cells, sizeof(Cell) * (m_mask + 1), alignment_of<Cell>::value);
+        }
+
+        size_type capacity() const { return m_mask + 1; }
+
+        /// Only a hint when other threads are using the queue.
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        /// Only a hint when other threads are using the queue, counts values which are claimed but not published yet.
+        size_type size() const
+        {
+            size_type dequeuePos = m_dequeuePos.load(memory_order_acquire);
+            size_type enqueuePos = m_enqueuePos.load(memory_order_acquire);
+            return static_cast<ptrdiff_t>(enqueuePos - dequeuePos) > 0 ? enqueuePos - dequeuePos : 0;
+        }
+
+        /// Returns false if the queue is full.
+        bool push(const T& value)
+        {
+            return push(&value, 1) == 1;
+        }
+
+        /// Pushes as many values as there are free cells, up to count, and returns the number of values pushed.
+        size_type push(const T* values, size_type count)
+        {
+            size_type pos = m_enqueuePos.load(memory_order_relaxed);
+            size_type numClaimed;
+            for (;; )
+            {
+                //count the free cells from our position, a cell is free for this lap when its sequence equals its position
+                numClaimed = 0;
+                while (numClaimed < count)
+                {
+                    size_type sequence = m_cells[(pos + numClaimed) & m_mask].m_sequence.load(memory_order_acquire);
+                    if (sequence != pos + numClaimed)
+                    {
+                        break;
+                    }
+                    ++numClaimed;
+                }
+
+                if (numClaimed == 0)
+                {
+                    size_type sequence = m_cells[pos & m_mask].m_sequence.load(memory_order_acquire);
+                    if (static_cast<ptrdiff_t>(sequence - pos) < 0)
+                    {
+                        return 0; //the cell still holds a value from the previous lap, the queue is full
+                    }
+                    pos = m_enqueuePos.load(memory_order_relaxed); //another producer got there first
+                    continue;
+                }
+
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + numClaimed, memory_order_relaxed, memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+
+            for (size_type i = 0; i < numClaimed; ++i)
+            {
+                Cell& cell = m_cells[(pos + i) & m_mask];
+                cell.m_value = values[i];
+                cell.m_sequence.store(pos + i + 1, memory_order_release);
+            }
+            return numClaimed;
+        }
+
+        /// Returns false if the queue is empty.
+        bool pop(T* value_out)
+        {
+            return pop(value_out, 1) == 1;
+        }
+
+        /// Pops as many published values as available, up to maxCount, and returns the number of values popped.
+        size_type pop(T* values_out, size_type maxCount)
+        {
+            size_type pos = m_dequeuePos.load(memory_order_relaxed);
+            size_type numClaimed;
+            for (;; )
+            {
+                //count the published cells from our position, a cell is published when its sequence is one past its position
+                numClaimed = 0;
+                while (numClaimed < maxCount)
+                {
+                    size_type sequence = m_cells[(pos + numClaimed) & m_mask].m_sequence.load(memory_order_acquire);
+                    if (sequence != pos + numClaimed + 1)
+                    {
+                        break;
+                    }
+                    ++numClaimed;
+                }
+
+                if (numClaimed == 0)
+                {
+                    size_type sequence = m_cells[pos & m_mask].m_sequence.load(memory_order_acquire);
+                    if (static_cast<ptrdiff_t>(sequence - (pos + 1)) < 0)
+                    {
+                        return 0; //nothing published at the front, the queue is empty (or the producer is not done yet)
+                    }
+                    pos = m_dequeuePos.load(memory_order_relaxed); //another consumer got there first
+                    continue;
+                }
+
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + numClaimed, memory_order_relaxed, memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+
+            for (size_type i = 0; i < numClaimed; ++i)
+            {
+                Cell& cell = m_cells[(pos + i) & m_mask];
+                values_out[i] = cell.m_value;
+                cell.m_sequence.store(pos + i + m_mask + 1, memory_order_release); //free for the next lap
+            }
+            return numClaimed;
+        }
+
+    private:
+        //non-copyable
+        lock_free_bounded_queue(const lock_free_bounded_queue&);
+        lock_free_bounded_queue& operator=(const lock_free_bounded_queue&);
+
+        struct Cell
+        {
+            atomic<size_type> m_sequence;
+            T m_value;
+        };
+
+        Cell* m_cells;
+        size_type m_mask;
+        Allocator m_allocator;
+        AZ_ALIGN(atomic<size_type> m_enqueuePos, 64); //alignment to avoid cache line sharing between producers and consumers
+        AZ_ALIGN(atomic<size_type> m_dequeuePos, 64);
+    };
+}
+
+#endif
+#pragma once
@@ -103,6 +103,30 @@ namespace AZStd
             }
         }
 
+        /// Pushes several items, they are published together to stealing threads when there is room in the array.
+        void local_push_bottom(const T* items, unsigned int count)
+        {
+            int oldBottom = m_bottom.load(memory_order_acquire);
+            int oldTop = m_top.load(memory_order_acquire);
+            CircularArray* currentArray = m_array.load(memory_order_acquire);
+            int size = oldBottom - oldTop;
+            if (size + static_cast<int>(count) < currentArray->GetCapacity() - 1)
+            {
+                for (unsigned int i = 0; i < count; ++i)
+                {
+                    currentArray->SetItem(oldBottom + i, items[i]);
+                }
+                m_bottom.store(oldBottom + static_cast<int>(count), memory_order_release);
+            }
+            else
+            {
+                for (unsigned int i = 0; i < count; ++i)
+                {
+                    local_push_bottom(items[i]);
+                }
+            }
+        }
+
         bool local_pop_bottom(T* item_out)
         {
             int oldBottom = m_bottom.load(memory_order_acquire);
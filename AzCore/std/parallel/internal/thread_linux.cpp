@@ -73,12 +73,25 @@ namespace AZStd
 
                 pthread_attr_setdetachstate(&attr, desc->m_isJoinable ? PTHREAD_CREATE_JOINABLE : PTHREAD_CREATE_DETACHED);
 
-                if (desc->m_cpuId >= 0) // TODO: add a proper mask to support more than one core that can run the thread!!!
+                if (desc->m_cpuMask.any() || desc->m_cpuId >= 0)
                 {
 #if !defined(AZ_PLATFORM_APPLE) && !defined(AZ_PLATFORM_ANDROID)
                     cpu_set_t cpuset;
                     CPU_ZERO(&cpuset);
-                    CPU_SET(desc->m_cpuId, &cpuset);
+                    if (desc->m_cpuMask.any())
+                    {
+                        for (size_t cpu = 0; cpu < CPU_SETSIZE && cpu < desc->m_cpuMask.size(); ++cpu)
+                        {
+                            if (desc->m_cpuMask.test(cpu))
+                            {
+                                CPU_SET(cpu, &cpuset);
+                            }
+                        }
+                    }
+                    else
+                    {
+                        CPU_SET(desc->m_cpuId, &cpuset);
+                    }
 
                     int result = pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
                     (void)result;
@@ -113,7 +126,7 @@ namespace AZStd
             AZ_Assert(res == 0, "pthread failed %s", strerror(errno));
             pthread_attr_destroy(&attr);
 #if defined(AZ_PLATFORM_APPLE)
-            if (desc && desc->m_cpuId >= 0) // TODO: add a proper mask to support more than one core that can run the thread!!!
+            if (desc && desc->m_cpuId >= 0) // affinity on OSX is only a hint (affinity tag), masks are not supported
             {
                 mach_port_t mach_thread = pthread_mach_thread_np(tId);
                 thread_affinity_policy_data_t policyData = { desc->m_cpuId };
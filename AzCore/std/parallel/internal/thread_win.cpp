@@ -68,7 +68,19 @@ namespace AZStd
                 ::SetThreadPriority(hThread, desc->m_priority);
             }
 
-            if (desc && desc->m_cpuId >= 0 && desc->m_cpuId < 32)
+            if (desc && desc->m_cpuMask.any())
+            {
+                DWORD_PTR affinityMask = 0;
+                for (size_t cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu)
+                {
+                    if (desc->m_cpuMask.test(cpu))
+                    {
+                        affinityMask |= DWORD_PTR(1) << cpu;
+                    }
+                }
+                SetThreadAffinityMask(hThread, affinityMask);
+            }
+            else if (desc && desc->m_cpuId >= 0 && desc->m_cpuId < 32)
             {
                 SetThreadAffinityMask(hThread, DWORD_PTR(1) << desc->m_cpuId);
             }
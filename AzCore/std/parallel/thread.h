@@ -16,6 +16,7 @@
 #include <AzCore/std/allocator.h>
 #include <AzCore/std/typetraits/alignment_of.h>
 #include <AzCore/std/chrono/types.h>
+#include <AzCore/std/containers/bitset.h>
 
 namespace AZStd
 {
@@ -48,6 +49,9 @@ namespace AZStd
     }
     // Extension
 
+    /// Thread affinity mask, bit N allows the thread to run on cpu N.
+    typedef bitset<1024> thread_cpu_mask;
+
     struct thread_desc
     {
         // Default thread desc settings
@@ -86,6 +90,12 @@ namespace AZStd
          */
         int             m_cpuId;
 
+        /**
+         *  Affinity mask, bit N allows the thread to run on core N. When any bit is set it is used instead of m_cpuId.
+         *  Windows: Only cores of the current processor group are supported.
+         */
+        thread_cpu_mask m_cpuMask;
+
         bool            m_isJoinable;   ///< If we can join the thread.
         const char*    m_name;          ///< Debug thread name.
     };
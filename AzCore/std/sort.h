@@ -196,7 +196,7 @@ namespace AZStd
         // merge [first, mid) with [mid, last), using predicate
         if (count1 + count2 == 2)
         {   // order two one-element partitions
-            if (*mid < *first)
+            if (comp(*mid, *first))
             {
                 AZStd::iter_swap(first, mid);
             }
@@ -204,12 +204,44 @@ namespace AZStd
         else if (count1 <= count2 && count1 <= Difference(buffer.capacity()))
         {   // buffer left partition, then merge
             buffer.copy(first, mid);
-            merge(buffer.begin(), buffer.end(), mid, last, first, comp);
+            typename Buffer::iterator bufferFirst = buffer.begin();
+            typename Buffer::iterator bufferLast = buffer.end();
+            for (; bufferFirst != bufferLast && mid != last; ++first)
+            {
+                if (comp(*mid, *bufferFirst))
+                {
+                    *first = *mid;
+                    ++mid;
+                }
+                else
+                {
+                    *first = *bufferFirst;
+                    ++bufferFirst;
+                }
+            }
+            // what is left of the right partition is already in place
+            Internal::copy(bufferFirst, bufferLast, first, Internal::is_fast_copy<typename Buffer::iterator, BidirectionalIterator>());
         }
         else if (count2 <= Difference(buffer.capacity()))
         {   // buffer right partition, then merge
             buffer.copy(mid, last);
-            merge_backward(first, mid, buffer.begin(), buffer.end(), last, comp);
+            typename Buffer::iterator bufferFirst = buffer.begin();
+            typename Buffer::iterator bufferLast = buffer.end();
+            while (bufferFirst != bufferLast && first != mid)
+            {
+                if (comp(*--bufferLast, *--mid))
+                {
+                    *--last = *mid;
+                    ++bufferLast;
+                }
+                else
+                {
+                    *--last = *bufferLast;
+                    ++mid;
+                }
+            }
+            // what is left of the left partition is already in place
+            Internal::copy_backward(bufferFirst, bufferLast, last, Internal::is_fast_copy<typename Buffer::iterator, BidirectionalIterator>());
         }
         else
         {   // buffer too small, divide and conquer
@@ -246,13 +278,13 @@ namespace AZStd
         if (count1 <= count2 && count1 <= Difference(buffer.capacity()))
         {   // buffer left partition, then copy parts
             buffer.copy(first, mid);
-            Internal::copy(mid, last, first, Internal::is_fast_copy<BidirectionalIterator, BidirectionalIterator>());
+            Internal::move(mid, last, first, Internal::is_fast_copy<BidirectionalIterator, BidirectionalIterator>());
             return Internal::copy_backward(buffer.begin(), buffer.end(), last, Internal::is_fast_copy<typename Buffer::iterator, BidirectionalIterator>());
         }
         else if (count2 <= Difference(buffer.capacity()))
         {   // buffer right partition, then copy parts
             buffer.copy(mid, last);
-            Internal::copy_backward(first, mid, last, Internal::is_fast_copy<BidirectionalIterator, BidirectionalIterator>());
+            Internal::move_backward(first, mid, last, Internal::is_fast_copy<BidirectionalIterator, BidirectionalIterator>());
             return Internal::copy(buffer.begin(), buffer.end(), first, Internal::is_fast_copy<typename Buffer::iterator, BidirectionalIterator>());
         }
         else
@@ -22,6 +22,7 @@
 #include <AzCore/std/allocator.h>
 #include <AzCore/std/typetraits/alignment_of.h>
 #include <AzCore/std/typetraits/is_integral.h>
+#include <AzCore/std/hash.h>
 
 namespace AZStd
 {
@@ -1858,27 +1859,11 @@ namespace AZStd
     //wstring to_wstring(unsigned long long val);
     //wstring to_wstring(long double val);
 
-    template<class T>
-    struct hash;
-
-    /// For string hashing we are using FNV-1a algorithm with 32 and 64 bit versions.
+    /// Strings are hashed with hash_bytes over all length characters (not just the first length bytes for wide strings).
     template<class RandomAccessIterator>
     AZ_FORCE_INLINE AZStd::size_t hash_string(RandomAccessIterator first, AZStd::size_t length)
     {
-#ifdef AZ_OS64
-        size_t hash = 14695981039346656037ULL;
-        const size_t fnvPrime = 1099511628211ULL;
-#else
-        size_t hash = 2166136261U;
-        const size_t fnvPrime = 16777619U;
-#endif
-        const char* cptr = reinterpret_cast<const char*>(&(*first));
-        for (; length; --length)
-        {
-            hash ^= static_cast<size_t>(*cptr++);
-            hash *= fnvPrime;
-        }
-        return hash;
+        return hash_bytes(&(*first), length * sizeof(*first));
     }
 
     template<class Element, class Traits, class Allocator>
@@ -0,0 +1,421 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+
+/**
+ * Hash benchmark, compares AZStd::hash_bytes with the hashes it replaced (FNV-1a used by hash_string and the
+ * per element hash_combine used by hash_range) for throughput and quality.
+ *
+ * Usage: HashBenchmark [--hash name] [--test name]
+ *  --hash  only run hash functions whose name contains this string
+ *  --test  only run this test (throughput, avalanche, distribution, container)
+ *
+ *  throughput      GB/s and ns per hash for inputs from 4 bytes to 1MB
+ *  avalanche       worst bias of any output bit when flipping any input bit (0% is ideal, 100% means the output bit
+ *                  never or always changes), with 1000 trials per size a random function shows about 12%
+ *  distribution    collisions of the full hash and chi-square of the low and high bits into 64K buckets for keys
+ *                  that differ little from each other (1.0 is what a random function gives)
+ *  container       insert and find of string keys in an AZStd::unordered_map with each hash
+ *
+ * Build and run it on Linux with the Makefile next to this file, e.g.
+ *  make -C HashBenchmark run ARGS="--test throughput"
+ */
+
+#include <AzCore/Memory/SystemAllocator.h>
+#include <AzCore/std/hash.h>
+#include <AzCore/std/algorithm.h>
+#include <AzCore/std/sort.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/containers/unordered_map.h>
+#include <AzCore/std/string/string.h>
+#include <AzCore/std/time.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace HashBenchmark
+{
+    using namespace AZ;
+
+    struct Options
+    {
+        Options()
+            : m_hashFilter(nullptr)
+            , m_testFilter(nullptr)
+        {}
+
+        const char* m_hashFilter;
+        const char* m_testFilter;
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    // Hash functions
+
+    typedef AZStd::size_t (*HashFunction)(const void* data, AZStd::size_t length);
+
+    static AZStd::size_t HashBytes(const void* data, AZStd::size_t length)
+    {
+        return AZStd::hash_bytes(data, length);
+    }
+
+    /// FNV-1a as used by AZStd::hash_string before hash_bytes.
+    static AZStd::size_t HashFnv1a(const void* data, AZStd::size_t length)
+    {
+#ifdef AZ_OS64
+        AZStd::size_t hash = 14695981039346656037ULL;
+        const AZStd::size_t fnvPrime = 1099511628211ULL;
+#else
+        AZStd::size_t hash = 2166136261U;
+        const AZStd::size_t fnvPrime = 16777619U;
+#endif
+        const char* cptr = static_cast<const char*>(data);
+        for (; length; --length)
+        {
+            hash ^= static_cast<AZStd::size_t>(*cptr++);
+            hash *= fnvPrime;
+        }
+        return hash;
+    }
+
+    /// One hash_combine per byte as done by AZStd::hash_range before hash_bytes.
+    static AZStd::size_t HashCombine(const void* data, AZStd::size_t length)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        AZStd::size_t seed = 0;
+        for (AZStd::size_t i = 0; i < length; ++i)
+        {
+            seed ^= static_cast<AZStd::size_t>(bytes[i]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        }
+        return seed;
+    }
+
+    struct Target
+    {
+        const char*     m_name;
+        HashFunction    m_hash;
+    };
+
+    static const Target s_targets[] =
+    {
+        { "hash_bytes", &HashBytes },
+        { "fnv1a", &HashFnv1a },
+        { "hash_combine", &HashCombine },
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    // Helpers
+
+    /// xorshift64*, the benchmark needs repeatable inputs, not good random numbers.
+    class Random
+    {
+    public:
+        Random(u64 seed = 0x9E3779B97F4A7C15ull)
+            : m_state(seed) {}
+
+        u64 Next()
+        {
+            m_state ^= m_state >> 12;
+            m_state ^= m_state << 25;
+            m_state ^= m_state >> 27;
+            return m_state * 0x2545F4914F6CDD1Dull;
+        }
+
+        void Fill(unsigned char* data, AZStd::size_t length)
+        {
+            for (AZStd::size_t i = 0; i < length; ++i)
+            {
+                data[i] = static_cast<unsigned char>(Next() >> 56);
+            }
+        }
+
+    private:
+        u64 m_state;
+    };
+
+    static volatile AZStd::size_t s_sink;   ///< Keeps the compiler from dropping hashes nobody reads.
+
+    static double Seconds(AZStd::sys_time_t start)
+    {
+        return double(AZStd::GetTimeNowTicks() - start) / double(AZStd::GetTimeTicksPerSecond());
+    }
+
+    /// Returns chi-square / buckets for the hashes mapped to buckets with (hash >> shift) & mask, about 1.0 for a random function.
+    static double BucketChiSquare(const AZStd::vector<AZStd::size_t>& hashes, unsigned int shift, unsigned int numBuckets)
+    {
+        AZStd::vector<unsigned int> buckets(numBuckets, 0);
+        for (AZStd::size_t hash : hashes)
+        {
+            ++buckets[(hash >> shift) & (numBuckets - 1)];
+        }
+        double expected = double(hashes.size()) / double(numBuckets);
+        double chiSquare = 0.0;
+        for (unsigned int count : buckets)
+        {
+            chiSquare += (double(count) - expected) * (double(count) - expected) / expected;
+        }
+        return chiSquare / double(numBuckets);
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Tests
+
+    static void RunThroughput(const Target& target)
+    {
+        static const AZStd::size_t sizes[] = { 4, 8, 16, 32, 64, 256, 1024, 4096, 65536, 1024 * 1024 };
+        static const AZStd::size_t bufferSize = 4 * 1024 * 1024;
+        static const AZStd::size_t bytesPerSize = 256 * 1024 * 1024;
+
+        AZStd::vector<unsigned char> buffer(bufferSize + 1024 * 1024);
+        Random random;
+        random.Fill(buffer.data(), buffer.size());
+
+        for (AZStd::size_t size : sizes)
+        {
+            AZStd::size_t numHashes = bytesPerSize / size;
+            AZStd::size_t step = AZStd::GetMax<AZStd::size_t>(size, 64);
+            AZStd::size_t sink = 0;
+            AZStd::size_t offset = 0;
+            AZStd::sys_time_t start = AZStd::GetTimeNowTicks();
+            for (AZStd::size_t i = 0; i < numHashes; ++i)
+            {
+                // feed the previous result into the input position so the calls can't be overlapped or hoisted
+                sink += target.m_hash(buffer.data() + offset + (sink & 7), size);
+                offset += step;
+                if (offset + size > bufferSize)
+                {
+                    offset = 0;
+                }
+            }
+            double seconds = Seconds(start);
+            s_sink = sink;
+            printf("%-14s %-14s %10zu %10.2f %10.1f\n", target.m_name, "throughput", size, double(numHashes * size) / seconds / 1e9,
+                seconds * 1e9 / double(numHashes));
+            fflush(stdout);
+        }
+    }
+
+    static void RunAvalanche(const Target& target)
+    {
+        static const AZStd::size_t sizes[] = { 4, 8, 16, 32, 64 };
+        static const unsigned int numTrials = 1000;
+        static const unsigned int outputBits = sizeof(AZStd::size_t) * 8;
+
+        Random random;
+        for (AZStd::size_t size : sizes)
+        {
+            unsigned int inputBits = static_cast<unsigned int>(size * 8);
+            AZStd::vector<unsigned int> flips(inputBits * outputBits, 0);
+            unsigned char input[64];
+            for (unsigned int trial = 0; trial < numTrials; ++trial)
+            {
+                random.Fill(input, size);
+                AZStd::size_t hash = target.m_hash(input, size);
+                for (unsigned int bit = 0; bit < inputBits; ++bit)
+                {
+                    input[bit / 8] ^= static_cast<unsigned char>(1 << (bit % 8));
+                    AZStd::size_t changed = hash ^ target.m_hash(input, size);
+                    input[bit / 8] ^= static_cast<unsigned char>(1 << (bit % 8));
+                    for (unsigned int outputBit = 0; outputBit < outputBits; ++outputBit)
+                    {
+                        flips[bit * outputBits + outputBit] += (changed >> outputBit) & 1;
+                    }
+                }
+            }
+            double worstBias = 0.0;
+            for (unsigned int count : flips)
+            {
+                worstBias = AZStd::GetMax(worstBias, fabs(2.0 * double(count) / double(numTrials) - 1.0));
+            }
+            printf("%-14s %-14s %10zu %9.1f%%\n", target.m_name, "avalanche", size, worstBias * 100.0);
+            fflush(stdout);
+        }
+    }
+
+    static void RunDistribution(const Target& target)
+    {
+        static const unsigned int numKeys = 1 << 20;
+        static const unsigned int numBuckets = 1 << 16;
+        static const unsigned int outputBits = sizeof(AZStd::size_t) * 8;
+
+        for (int keySet = 0; keySet < 3; ++keySet)
+        {
+            const char* keySetName = nullptr;
+            AZStd::vector<AZStd::size_t> hashes;
+            hashes.reserve(numKeys);
+            for (unsigned int i = 0; i < numKeys; ++i)
+            {
+                if (keySet == 0)
+                {
+                    // names, e.g. entity or asset names
+                    keySetName = "names";
+                    char name[64];
+                    int length = snprintf(name, sizeof(name), "Level/Entity_%u", i);
+                    hashes.push_back(target.m_hash(name, length));
+                }
+                else if (keySet == 1)
+                {
+                    // small integer tuples, e.g. grid coordinates
+                    keySetName = "int[3]";
+                    u32 key[3] = { i & 0xff, (i >> 8) & 0xff, i >> 16 };
+                    hashes.push_back(target.m_hash(key, sizeof(key)));
+                }
+                else
+                {
+                    // 16 byte ids that only differ in a counter in the last bytes
+                    keySetName = "id";
+                    unsigned char id[16] = { 0x5c, 0x8f, 0x12, 0x77, 0xa1, 0x00, 0x4e, 0x9b, 0x81, 0x33 };
+                    memcpy(id + 12, &i, sizeof(i));
+                    hashes.push_back(target.m_hash(id, sizeof(id)));
+                }
+            }
+            double lowChiSquare = BucketChiSquare(hashes, 0, numBuckets);
+            double highChiSquare = BucketChiSquare(hashes, outputBits - 16, numBuckets);
+            AZStd::sort(hashes.begin(), hashes.end());
+            unsigned int collisions = 0;
+            for (AZStd::size_t i = 1; i < hashes.size(); ++i)
+            {
+                collisions += hashes[i] == hashes[i - 1] ? 1 : 0;
+            }
+            printf("%-14s %-14s %10s %10u %10.2f %10.2f\n", target.m_name, "distribution", keySetName, collisions, lowChiSquare, highChiSquare);
+            fflush(stdout);
+        }
+    }
+
+    struct TargetHasher
+    {
+        explicit TargetHasher(HashFunction hash = nullptr)
+            : m_hash(hash) {}
+        AZStd::size_t operator()(const AZStd::string& value) const  { return m_hash(value.c_str(), value.length()); }
+
+        HashFunction m_hash;
+    };
+
+    static void RunContainer(const Target& target)
+    {
+        static const unsigned int numKeys = 1 << 18;
+        static const unsigned int keyLengths[] = { 8, 32, 128 };
+
+        typedef AZStd::unordered_map<AZStd::string, unsigned int, TargetHasher> MapType;
+
+        Random random;
+        for (unsigned int keyLength : keyLengths)
+        {
+            AZStd::vector<AZStd::string> keys;
+            keys.reserve(numKeys);
+            for (unsigned int i = 0; i < numKeys; ++i)
+            {
+                AZStd::string key = AZStd::string::format("%u_", i);
+                while (key.length() < keyLength)
+                {
+                    key.push_back(static_cast<char>('a' + random.Next() % 26));
+                }
+                keys.push_back(key);
+            }
+
+            double insertSeconds, findSeconds;
+            unsigned int found = 0;
+            {
+                MapType map(numKeys, TargetHasher(target.m_hash), MapType::key_eq());
+                AZStd::sys_time_t start = AZStd::GetTimeNowTicks();
+                for (unsigned int i = 0; i < numKeys; ++i)
+                {
+                    map.insert(AZStd::make_pair(keys[i], i));
+                }
+                insertSeconds = Seconds(start);
+                start = AZStd::GetTimeNowTicks();
+                for (int pass = 0; pass < 4; ++pass)
+                {
+                    for (const AZStd::string& key : keys)
+                    {
+                        found += map.find(key) != map.end() ? 1 : 0;
+                    }
+                }
+                findSeconds = Seconds(start) / 4.0;
+            }
+            printf("%-14s %-14s %10u %10.1f %10.1f%s\n", target.m_name, "container", keyLength, insertSeconds * 1e9 / double(numKeys),
+                findSeconds * 1e9 / double(numKeys), found == numKeys * 4 ? "" : " (lost keys)");
+            fflush(stdout);
+        }
+    }
+
+    struct Test
+    {
+        const char* m_name;
+        const char* m_header;
+        void (*m_run)(const Target&);
+    };
+
+    static const Test s_tests[] =
+    {
+        { "throughput", "bytes       GB/s    ns/hash", &RunThroughput },
+        { "avalanche", "bytes  worst bias", &RunAvalanche },
+        { "distribution", "keys  collisions    low bits  high bits", &RunDistribution },
+        { "container", "key bytes  insert(ns)   find(ns)", &RunContainer },
+    };
+
+    static void Run(const Options& options)
+    {
+        for (const Test& test : s_tests)
+        {
+            if (options.m_testFilter && strcmp(options.m_testFilter, test.m_name) != 0)
+            {
+                continue;
+            }
+            printf("%-14s %-14s %s\n", "hash", "test", test.m_header);
+            for (const Target& target : s_targets)
+            {
+                if (options.m_hashFilter && !strstr(target.m_name, options.m_hashFilter))
+                {
+                    continue;
+                }
+                test.m_run(target);
+            }
+            printf("\n");
+        }
+    }
+
+    static int Main(int argc, char* argv[])
+    {
+        Options options;
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            if (strcmp(argv[i], "--hash") == 0)
+            {
+                options.m_hashFilter = argv[i + 1];
+            }
+            else if (strcmp(argv[i], "--test") == 0)
+            {
+                options.m_testFilter = argv[i + 1];
+            }
+            else
+            {
+                fprintf(stderr, "Unknown option %s!\n", argv[i]);
+                return 1;
+            }
+        }
+
+        SystemAllocator::Descriptor systemDesc;
+        systemDesc.m_allocationRecords = false;
+        AllocatorInstance<SystemAllocator>::Create(systemDesc);
+
+        Run(options);
+
+        AllocatorInstance<SystemAllocator>::Destroy();
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    return HashBenchmark::Main(argc, argv);
+}
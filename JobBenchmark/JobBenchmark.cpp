@@ -0,0 +1,456 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+
+/**
+ * Job benchmark, measures how fast non-worker threads can submit jobs to the JobManager (through the global job
+ * queue) for 1 to N producer threads, and how fast workers run a fork/join tree with and without fibers.
+ *
+ * Usage: JobBenchmark [--producers N] [--workers N] [--jobs N] [--fib N] [--test name]
+ *  --producers maximum number of producer threads, we run 1, 2, 4 ... N (default 64)
+ *  --workers   number of worker threads (default hardware concurrency)
+ *  --jobs      jobs per run, split between the producers (default 1000000)
+ *  --fib       fibonacci number computed by the fork/join test (default 22)
+ *  --test      only run this test (submit, submit-batch, forkjoin, coroutine)
+ *
+ *  submit          every producer starts its jobs one by one with Job::Start
+ *  submit-batch    every producer starts its jobs in batches of 64 with Job::StartJobs
+ *  forkjoin        fib(n) where every job starts two children with StartAsChild and waits with WaitForChildren, on 1
+ *                  worker and on --workers workers, with and without fibers
+ *  coroutine       fib(n) as a JobTask which co_awaits fib(n-1) as a nested JobTask and fib(n-2) as a FibonacciJob, near
+ *                  the leaves it co_awaits both halves as jobs with AwaitJobs. Only in the C++20 build.
+ *
+ * For the submit tests it reports the submit rate (jobs / time until the slowest producer has started all its jobs)
+ * and the completion rate (jobs / time until the workers have processed all of them). For the fork/join test it
+ * reports the rate at which the tree's jobs complete.
+ *
+ * Build and run it on Linux with the Makefile next to this file, e.g.
+ *  make -C JobBenchmark run ARGS="--workers 8"
+ *  make -C JobBenchmark run-coroutine ARGS="--test coroutine"
+ */
+
+#include <AzCore/Memory/SystemAllocator.h>
+#include <AzCore/Memory/PoolAllocator.h>
+#include <AzCore/Jobs/JobManager.h>
+#include <AzCore/Jobs/JobContext.h>
+#include <AzCore/Jobs/JobFunction.h>
+#include <AzCore/Jobs/JobCompletion.h>
+#include <AzCore/Jobs/JobCoroutine.h>
+#include <AzCore/std/parallel/thread.h>
+#include <AzCore/std/parallel/atomic.h>
+#include <AzCore/std/time.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace JobBenchmark
+{
+    using namespace AZ;
+
+    static const unsigned int MaxProducers = 64;
+    static const unsigned int BatchSize = 64;
+
+    struct Options
+    {
+        Options()
+            : m_maxProducers(MaxProducers)
+            , m_numWorkers(AZStd::GetMax(AZStd::thread::hardware_concurrency(), 1u))
+            , m_numJobs(1000000)
+            , m_fibonacci(22)
+            , m_testFilter(nullptr)
+        {}
+
+        unsigned int    m_maxProducers;
+        unsigned int    m_numWorkers;
+        unsigned int    m_numJobs;
+        unsigned int    m_fibonacci;
+        const char*     m_testFilter;
+    };
+
+    struct Result
+    {
+        double  m_submitJobsPerSecond;
+        double  m_completeJobsPerSecond;
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    // Submit
+
+    /// Producer threads starting jobs which only count themselves, so the queues are the bottleneck.
+    class SubmitRunner
+    {
+    public:
+        SubmitRunner(JobContext& context, unsigned int numProducers, unsigned int numJobs, bool isBatch)
+            : m_context(context)
+            , m_numProducers(numProducers)
+            , m_jobsPerProducer(numJobs / numProducers)
+            , m_isBatch(isBatch)
+            , m_numReady(0)
+            , m_isStarted(false)
+            , m_numSubmitted(0)
+            , m_numProcessed(0)
+        {}
+
+        Result Run()
+        {
+            AZStd::thread* threads[MaxProducers];
+            for (unsigned int i = 0; i < m_numProducers; ++i)
+            {
+                threads[i] = new AZStd::thread([this]() { ProducerMain(); });
+            }
+            // release all producers at once
+            while (m_numReady.load(AZStd::memory_order_acquire) != m_numProducers)
+            {
+                AZStd::this_thread::yield();
+            }
+            AZStd::sys_time_t startTime = AZStd::GetTimeNowTicks();
+            m_isStarted.store(true, AZStd::memory_order_release);
+
+            AZ::u64 numJobs = AZ::u64(m_jobsPerProducer) * m_numProducers;
+            while (m_numSubmitted.load(AZStd::memory_order_acquire) != m_numProducers)
+            {
+                AZStd::this_thread::yield();
+            }
+            AZStd::sys_time_t submitTime = AZStd::GetTimeNowTicks();
+            while (m_numProcessed.load(AZStd::memory_order_acquire) != numJobs)
+            {
+                AZStd::this_thread::yield();
+            }
+            AZStd::sys_time_t completeTime = AZStd::GetTimeNowTicks();
+
+            for (unsigned int i = 0; i < m_numProducers; ++i)
+            {
+                threads[i]->join();
+                delete threads[i];
+            }
+
+            double ticksPerSecond = double(AZStd::GetTimeTicksPerSecond());
+            Result result;
+            result.m_submitJobsPerSecond = submitTime > startTime ? double(numJobs) * ticksPerSecond / double(submitTime - startTime) : 0.0;
+            result.m_completeJobsPerSecond = completeTime > startTime ? double(numJobs) * ticksPerSecond / double(completeTime - startTime) : 0.0;
+            return result;
+        }
+
+    private:
+        void ProducerMain()
+        {
+            AZStd::atomic<AZ::u64>* numProcessed = &m_numProcessed;
+            auto countJob = [numProcessed]() { numProcessed->fetch_add(1, AZStd::memory_order_relaxed); };
+
+            m_numReady.fetch_add(1, AZStd::memory_order_acq_rel);
+            while (!m_isStarted.load(AZStd::memory_order_acquire))
+            {
+                AZStd::this_thread::yield();
+            }
+
+            if (m_isBatch)
+            {
+                Job* jobs[BatchSize];
+                for (unsigned int i = 0; i < m_jobsPerProducer; i += BatchSize)
+                {
+                    unsigned int numJobs = AZStd::GetMin(BatchSize, m_jobsPerProducer - i);
+                    for (unsigned int j = 0; j < numJobs; ++j)
+                    {
+                        jobs[j] = CreateJobFunction(countJob, true, &m_context);
+                    }
+                    Job::StartJobs(jobs, numJobs);
+                }
+            }
+            else
+            {
+                for (unsigned int i = 0; i < m_jobsPerProducer; ++i)
+                {
+                    CreateJobFunction(countJob, true, &m_context)->Start();
+                }
+            }
+            m_numSubmitted.fetch_add(1, AZStd::memory_order_acq_rel);
+        }
+
+        JobContext&                 m_context;
+        unsigned int                m_numProducers;
+        unsigned int                m_jobsPerProducer;
+        bool                        m_isBatch;
+        AZStd::atomic<unsigned int> m_numReady;
+        AZStd::atomic<bool>         m_isStarted;
+        AZStd::atomic<unsigned int> m_numSubmitted;
+        AZStd::atomic<AZ::u64>      m_numProcessed;
+    };
+
+    static void RunSubmit(const Options& options, const char* testName, bool isBatch)
+    {
+        JobManagerDesc desc;
+        for (unsigned int i = 0; i < options.m_numWorkers; ++i)
+        {
+            desc.m_workerThreads.push_back(JobManagerThreadDesc());
+        }
+        JobManager* jobManager = aznew JobManager(desc);
+        JobContext* context = aznew JobContext(*jobManager);
+
+        for (unsigned int numProducers = 1; ; numProducers *= 2)
+        {
+            numProducers = AZStd::GetMin(numProducers, options.m_maxProducers);
+            SubmitRunner* runner = new SubmitRunner(*context, numProducers, options.m_numJobs, isBatch);
+            Result result = runner->Run();
+            delete runner;
+            printf("%-14s %7u %9u %14.2f %14.2f\n", testName, options.m_numWorkers, numProducers,
+                result.m_submitJobsPerSecond / 1e6, result.m_completeJobsPerSecond / 1e6);
+            fflush(stdout);
+            if (numProducers == options.m_maxProducers)
+            {
+                break;
+            }
+        }
+
+        delete context;
+        delete jobManager;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Fork/join
+
+    /// Computes fib(n) by starting fib(n-1) and fib(n-2) as children and waiting for them.
+    class FibonacciJob
+        : public Job
+    {
+    public:
+        AZ_CLASS_ALLOCATOR(FibonacciJob, ThreadPoolAllocator, 0)
+
+        FibonacciJob(unsigned int n, AZ::u64* result, JobContext* context)
+            : Job(true, context)
+            , m_n(n)
+            , m_result(result)
+        {
+        }
+
+        static AZ::u64 GetNumJobs(unsigned int n)
+        {
+            return n < 2 ? 1 : 1 + GetNumJobs(n - 1) + GetNumJobs(n - 2);
+        }
+
+    protected:
+        void Process() override
+        {
+            if (m_n < 2)
+            {
+                *m_result = m_n;
+                return;
+            }
+            AZ::u64 result1 = 0;
+            AZ::u64 result2 = 0;
+            StartAsChild(aznew FibonacciJob(m_n - 1, &result1, GetContext()));
+            StartAsChild(aznew FibonacciJob(m_n - 2, &result2, GetContext()));
+            WaitForChildren();
+            *m_result = result1 + result2;
+        }
+
+        unsigned int    m_n;
+        AZ::u64*        m_result;
+    };
+
+    static AZ::u64 GetFibonacci(unsigned int n)
+    {
+        AZ::u64 fib[2] = { 0, 1 };
+        for (unsigned int i = 2; i <= n; ++i)
+        {
+            AZ::u64 next = fib[0] + fib[1];
+            fib[0] = fib[1];
+            fib[1] = next;
+        }
+        return n == 0 ? 0 : fib[1];
+    }
+
+    static void RunForkJoin(const Options& options, unsigned int numWorkers, bool useFibers)
+    {
+        JobManagerDesc desc;
+        desc.m_useFibers = useFibers;
+        for (unsigned int i = 0; i < numWorkers; ++i)
+        {
+            desc.m_workerThreads.push_back(JobManagerThreadDesc());
+        }
+        JobManager* jobManager = aznew JobManager(desc);
+        JobContext* context = aznew JobContext(*jobManager);
+
+        AZStd::sys_time_t startTime = AZStd::GetTimeNowTicks();
+        AZ::u64 result = 0;
+        JobCompletion completion(context);
+        FibonacciJob* job = aznew FibonacciJob(options.m_fibonacci, &result, context);
+        job->SetDependent(&completion);
+        job->Start();
+        completion.StartAndWaitForCompletion();
+        AZStd::sys_time_t endTime = AZStd::GetTimeNowTicks();
+
+        double seconds = double(endTime - startTime) / double(AZStd::GetTimeTicksPerSecond());
+        double numJobs = double(FibonacciJob::GetNumJobs(options.m_fibonacci));
+        printf("%-14s %7u %9s %14s %14.2f%s\n", "forkjoin", numWorkers, useFibers ? "fibers" : "nested", "-",
+            seconds > 0.0 ? numJobs / seconds / 1e6 : 0.0, result == GetFibonacci(options.m_fibonacci) ? "" : " (wrong result)");
+        fflush(stdout);
+
+        delete context;
+        delete jobManager;
+    }
+
+#if defined(AZ_JOBS_COROUTINES)
+    //////////////////////////////////////////////////////////////////////////
+    // Coroutine
+
+    static const unsigned int CoroutineBatchCutoff = 8;
+
+    /// Computes fib(n), awaiting fib(n-1) as a nested task and fib(n-2) as a job, or both as a batch of jobs near the leaves.
+    static JobTask FibonacciTask(unsigned int n, AZ::u64* result, JobContext* context)
+    {
+        if (n < 2)
+        {
+            *result = n;
+            co_return;
+        }
+        AZ::u64 result1 = 0;
+        AZ::u64 result2 = 0;
+        if (n < CoroutineBatchCutoff)
+        {
+            Job* jobs[] = { aznew FibonacciJob(n - 1, &result1, context), aznew FibonacciJob(n - 2, &result2, context) };
+            co_await AwaitJobs(jobs, AZ_ARRAY_SIZE(jobs));
+        }
+        else
+        {
+            co_await FibonacciTask(n - 1, &result1, context);
+            co_await *aznew FibonacciJob(n - 2, &result2, context);
+        }
+        *result = result1 + result2;
+    }
+
+    static void RunCoroutine(const Options& options, bool useFibers)
+    {
+        JobManagerDesc desc;
+        desc.m_useFibers = useFibers;
+        for (unsigned int i = 0; i < options.m_numWorkers; ++i)
+        {
+            desc.m_workerThreads.push_back(JobManagerThreadDesc());
+        }
+        JobManager* jobManager = aznew JobManager(desc);
+        JobContext* context = aznew JobContext(*jobManager);
+        //JobTask takes the context of the job creating it, the global one at the top level
+        JobContext::SetGlobalContext(context);
+
+        AZStd::sys_time_t startTime = AZStd::GetTimeNowTicks();
+        AZ::u64 result = 0;
+        JobTask task = FibonacciTask(options.m_fibonacci, &result, context);
+        //wait for the task from a job, like the fork/join test, this thread would assist with nested jobs otherwise
+        JobCompletion completion(context);
+        Job* job = CreateJobFunction([&task]() { task.StartAndWaitForCompletion(); }, true, context);
+        job->SetDependent(&completion);
+        job->Start();
+        completion.StartAndWaitForCompletion();
+        AZStd::sys_time_t endTime = AZStd::GetTimeNowTicks();
+
+        double seconds = double(endTime - startTime) / double(AZStd::GetTimeTicksPerSecond());
+        double numJobs = double(FibonacciJob::GetNumJobs(options.m_fibonacci));
+        printf("%-14s %7u %9s %14s %14.2f%s\n", "coroutine", options.m_numWorkers, useFibers ? "fibers" : "nested", "-",
+            seconds > 0.0 ? numJobs / seconds / 1e6 : 0.0, result == GetFibonacci(options.m_fibonacci) ? "" : " (wrong result)");
+        fflush(stdout);
+
+        JobContext::SetGlobalContext(nullptr);
+        delete context;
+        delete jobManager;
+    }
+#endif // AZ_JOBS_COROUTINES
+
+    //////////////////////////////////////////////////////////////////////////
+    // Runner
+
+    static bool IsFiltered(const char* name, const char* filter)
+    {
+        return filter != nullptr && strcmp(name, filter) != 0;
+    }
+
+    static void Run(const Options& options)
+    {
+        printf("%-14s %7s %9s %14s %14s\n", "test", "workers", "producers", "submit(Mj/s)", "complete(Mj/s)");
+        if (!IsFiltered("submit", options.m_testFilter))
+        {
+            RunSubmit(options, "submit", false);
+        }
+        if (!IsFiltered("submit-batch", options.m_testFilter))
+        {
+            RunSubmit(options, "submit-batch", true);
+        }
+        if (!IsFiltered("forkjoin", options.m_testFilter))
+        {
+            for (int useFibers = 0; useFibers < 2; ++useFibers)
+            {
+                // a single worker has nobody to steal the children of a waiting job, it must run them itself
+                RunForkJoin(options, 1, useFibers != 0);
+                if (options.m_numWorkers > 1)
+                {
+                    RunForkJoin(options, options.m_numWorkers, useFibers != 0);
+                }
+            }
+        }
+#if defined(AZ_JOBS_COROUTINES)
+        if (!IsFiltered("coroutine", options.m_testFilter))
+        {
+            for (int useFibers = 0; useFibers < 2; ++useFibers)
+            {
+                RunCoroutine(options, useFibers != 0);
+            }
+        }
+#endif
+    }
+
+    static int Main(int argc, char* argv[])
+    {
+        Options options;
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            if (strcmp(argv[i], "--producers") == 0)
+            {
+                options.m_maxProducers = AZStd::GetMin(AZStd::GetMax(static_cast<unsigned int>(atoi(argv[i + 1])), 1u), MaxProducers);
+            }
+            else if (strcmp(argv[i], "--workers") == 0)
+            {
+                options.m_numWorkers = AZStd::GetMin(AZStd::GetMax(static_cast<unsigned int>(atoi(argv[i + 1])), 1u), 64u);
+            }
+            else if (strcmp(argv[i], "--jobs") == 0)
+            {
+                options.m_numJobs = AZStd::GetMax(static_cast<unsigned int>(atoi(argv[i + 1])), MaxProducers);
+            }
+            else if (strcmp(argv[i], "--fib") == 0)
+            {
+                options.m_fibonacci = AZStd::GetMin(static_cast<unsigned int>(atoi(argv[i + 1])), 40u);
+            }
+            else if (strcmp(argv[i], "--test") == 0)
+            {
+                options.m_testFilter = argv[i + 1];
+            }
+            else
+            {
+                fprintf(stderr, "Unknown option %s!\n", argv[i]);
+                return 1;
+            }
+        }
+
+        SystemAllocator::Descriptor systemDesc;
+        systemDesc.m_allocationRecords = false;
+        AllocatorInstance<SystemAllocator>::Create(systemDesc);
+        AllocatorInstance<ThreadPoolAllocator>::Create();
+
+        Run(options);
+
+        AllocatorInstance<ThreadPoolAllocator>::Destroy();
+        AllocatorInstance<SystemAllocator>::Destroy();
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    return JobBenchmark::Main(argc, argv);
+}